@@ -822,8 +822,8 @@ arithmetic_interpolate_region(struct arithmeticparams *p,
     }
 
   /* For tests.
-  gal_fits_img_write(lab, "test-out.fits", NULL, NULL);
-  gal_fits_img_write(in, "test-out.fits", NULL, NULL);
+  gal_fits_img_write(lab, "test-out.fits", NULL, NULL, 0);
+  gal_fits_img_write(in, "test-out.fits", NULL, NULL, 0);
   printf("\n...%s...\n", __func__); exit(0);
   */
 
@@ -1104,9 +1104,9 @@ arithmetic_tofile(struct arithmeticparams *p, char *token, int freeflag)
   popped->wcs=p->refdata.wcs;
   if(popped->ndim==1 && p->onedasimage==0)
     gal_table_write(popped, NULL, NULL, p->cp.tableformat, filename,
-                    "ARITHMETIC", 0);
+                    "ARITHMETIC", 0, p->cp.numthreads);
   else
-    gal_fits_img_write(popped, filename, NULL, PROGRAM_NAME);
+    gal_fits_img_write(popped, filename, NULL, PROGRAM_NAME, p->cp.compress);
   if(!p->cp.quiet)
     printf(" - Write: %s\n", filename);
 
@@ -1608,7 +1608,7 @@ arithmetic_final_read_file(struct arithmeticparams *p,
   if( gal_fits_file_recognized(filename) )
     {
       /* Read the data, note that the WCS has already been set. */
-      out=gal_array_read_one_ch(filename, hdu, NULL,
+      out=gal_array_read_one_ch(filename, hdu, NULL, p->cp.numthreads,
                                 p->cp.minmapsize,
                                 p->cp.quietmmap);
       out->ndim=gal_dimension_remove_extra(out->ndim, out->dsize,
@@ -1785,10 +1785,11 @@ reversepolish(struct arithmeticparams *p)
       if(data->ndim==1 && p->onedasimage==0)
         gal_table_write(data, NULL, NULL, p->cp.tableformat,
                         p->onedonstdout ? NULL : p->cp.output,
-                        "ARITHMETIC", 0);
+                        "ARITHMETIC", 0, p->cp.numthreads);
       else
         for(tmp=data; tmp!=NULL; tmp=tmp->next)
-          gal_fits_img_write(tmp, p->cp.output, NULL, PROGRAM_NAME);
+          gal_fits_img_write(tmp, p->cp.output, NULL, PROGRAM_NAME,
+                             p->cp.compress);
 
       /* Let the user know that the job is done. */
       if(!p->cp.quiet)
@@ -662,13 +662,15 @@ convolve_frequency(struct convolveparams *p)
       /* Save the padded input image. */
       complextoreal(p->pimg, p->ps0*p->ps1, COMPLEX_TO_REAL_REAL, &tmp);
       data->array=tmp; data->name="input padded";
-      gal_fits_img_write(data, p->freqstepsname, NULL, PROGRAM_NAME);
+      gal_fits_img_write(data, p->freqstepsname, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       free(tmp); data->name=NULL;
 
       /* Save the padded kernel image. */
       complextoreal(p->pker, p->ps0*p->ps1, COMPLEX_TO_REAL_REAL, &tmp);
       data->array=tmp; data->name="kernel padded";
-      gal_fits_img_write(data, p->freqstepsname, NULL, PROGRAM_NAME);
+      gal_fits_img_write(data, p->freqstepsname, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       free(tmp); data->name=NULL;
     }
 
@@ -686,12 +688,14 @@ convolve_frequency(struct convolveparams *p)
     {
       complextoreal(p->pimg, p->ps0*p->ps1, COMPLEX_TO_REAL_SPEC, &tmp);
       data->array=tmp; data->name="input transformed";
-      gal_fits_img_write(data, p->freqstepsname, NULL, PROGRAM_NAME);
+      gal_fits_img_write(data, p->freqstepsname, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       free(tmp); data->name=NULL;
 
       complextoreal(p->pker, p->ps0*p->ps1, COMPLEX_TO_REAL_SPEC, &tmp);
       data->array=tmp; data->name="kernel transformed";
-      gal_fits_img_write(data, p->freqstepsname, NULL, PROGRAM_NAME);
+      gal_fits_img_write(data, p->freqstepsname, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       free(tmp); data->name=NULL;
     }
 
@@ -713,7 +717,8 @@ convolve_frequency(struct convolveparams *p)
     {
       complextoreal(p->pimg, p->ps0*p->ps1, COMPLEX_TO_REAL_SPEC, &tmp);
       data->array=tmp; data->name=p->makekernel ? "Divided" : "Multiplied";
-      gal_fits_img_write(data, p->freqstepsname, NULL, PROGRAM_NAME);
+      gal_fits_img_write(data, p->freqstepsname, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       free(tmp); data->name=NULL;
     }
 
@@ -729,7 +734,8 @@ convolve_frequency(struct convolveparams *p)
   if(p->checkfreqsteps)
     {
       data->array=p->rpad; data->name="padded output";
-      gal_fits_img_write(data, p->freqstepsname, NULL, PROGRAM_NAME);
+      gal_fits_img_write(data, p->freqstepsname, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       data->name=NULL; data->array=NULL;
     }
 
@@ -789,7 +795,8 @@ convolve(struct convolveparams *p)
       if(multidim && cp->tl.tilecheckname)
         {
           check=gal_tile_block_check_tiles(cp->tl.tiles);
-          gal_fits_img_write(check, cp->tl.tilecheckname, NULL, PROGRAM_NAME);
+          gal_fits_img_write(check, cp->tl.tilecheckname, NULL, PROGRAM_NAME,
+                             cp->compress);
           gal_data_free(check);
         }
 
@@ -814,10 +821,10 @@ convolve(struct convolveparams *p)
   /* Save the output (which is in p->input) array. */
   if(p->input->ndim==1)
     gal_table_write(p->input, NULL, NULL, p->cp.tableformat, p->cp.output,
-                    "CONVOLVED", 0);
+                    "CONVOLVED", 0, p->cp.numthreads);
   else
     gal_fits_img_write_to_type(p->input, cp->output, NULL, PROGRAM_NAME,
-                               cp->type);
+                               cp->type, cp->compress);
 
   /* Write Convolve's parameters as keywords into the first extension of
      the output. */
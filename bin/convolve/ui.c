@@ -446,7 +446,7 @@ ui_read_input(struct convolveparams *p)
     if (p->isfits && p->hdu_type==IMAGE_HDU)
       {
         p->input=gal_array_read_one_ch_to_type(p->filename, p->cp.hdu, NULL,
-                                               INPUT_USE_TYPE,
+                                               INPUT_USE_TYPE, p->cp.numthreads,
                                                p->cp.minmapsize,
                                                p->cp.quietmmap);
         p->input->wcs=gal_wcs_read(p->filename, p->cp.hdu,
@@ -484,6 +484,7 @@ ui_read_kernel(struct convolveparams *p)
     {
       p->kernel = gal_array_read_one_ch_to_type(p->kernelname, p->khdu,
                                                 NULL, INPUT_USE_TYPE,
+                                                p->cp.numthreads,
                                                 p->cp.minmapsize,
                                                 p->cp.quietmmap);
       p->kernel->ndim=gal_dimension_remove_extra(p->kernel->ndim,
@@ -167,6 +167,19 @@ struct argp_option program_options[] =
       GAL_OPTIONS_NOT_MANDATORY,
       GAL_OPTIONS_NOT_SET
     },
+    {
+      "stamps",
+      UI_KEY_STAMPS,
+      "STR",
+      0,
+      "All crops in one file: 'cube' or 'table'.",
+      GAL_OPTIONS_GROUP_OUTPUT,
+      &p->stampsstr,
+      GAL_TYPE_STRING,
+      GAL_OPTIONS_RANGE_ANY,
+      GAL_OPTIONS_NOT_MANDATORY,
+      GAL_OPTIONS_NOT_SET
+    },
 
 
 
@@ -29,7 +29,9 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 #include <string.h>
 #include <stdlib.h>
 
+#include <gnuastro/box.h>
 #include <gnuastro/fits.h>
+#include <gnuastro/qsort.h>
 #include <gnuastro/threads.h>
 #include <gnuastro/pointer.h>
 
@@ -39,6 +41,7 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 #include "main.h"
 
 #include "onecrop.h"
+#include "stamps.h"
 #include "wcsmode.h"
 
 
@@ -195,6 +198,114 @@ crop_write_to_log(struct onecropparams *crp)
 
 
 
+/* Find the region of the input image that is used by a crop from the
+   catalog (in image mode). If there is no overlap, return 0. */
+static int
+crop_img_region(struct cropparams *p, size_t ind, long *naxes,
+                long *fpixel, long *lpixel)
+{
+  long fpixel_o[2], lpixel_o[2];
+  double center[2]={p->centercoords[0][ind], p->centercoords[1][ind]};
+
+  gal_box_border_from_center(center, 2, p->iwidth, fpixel, lpixel);
+  return gal_box_overlap(naxes, fpixel, lpixel, fpixel_o, lpixel_o, 2);
+}
+
+
+
+
+
+/* In image mode, sort the crops by their position along the second
+   dimension (rows of the image) and give each thread a contiguous part
+   of the sorted crops. In this way, each thread reads the input image
+   sequentially (and in bands, see 'crop_img_band'), not randomly. */
+static void
+crop_order_img(struct cropparams *p, size_t *indexs, size_t nt,
+               size_t thrdcols)
+{
+  size_t i, j, k=0, *perm;
+
+  /* Sort the crops by the second coordinate of their center. */
+  perm=gal_pointer_allocate(GAL_TYPE_SIZE_T, p->numout, 0, __func__,
+                            "perm");
+  for(i=0;i<p->numout;++i) perm[i]=i;
+  gal_qsort_index_single=p->centercoords[1];
+  qsort(perm, p->numout, sizeof *perm, gal_qsort_index_single_float64_i);
+
+  /* Give each thread a contiguous part of the sorted crops. */
+  for(i=0;i<nt;++i)
+    for(j=0; indexs[i*thrdcols+j]!=GAL_BLANK_SIZE_T; ++j)
+      indexs[i*thrdcols+j]=perm[k++];
+
+  /* Clean up. */
+  free(perm);
+}
+
+
+
+
+
+/* Reading many small and randomly positioned regions from a large image
+   is very slow (each read needs a separate seek in the file). So when the
+   crops are sorted by their position (see 'crop_order_img'), we read one
+   band of the input that contains the regions of the next crops (starting
+   from crop 'i' of this thread) and the crops are copied from the
+   band. The band is only read when at least two crops can use it and its
+   size is limited to 'BANDMAXSIZE' bytes. In any case, the crops until
+   'crp->bandend' don't need a new band. */
+static void
+crop_img_band(struct onecropparams *crp, size_t i)
+{
+  struct cropparams *p=crp->p;
+  struct inputimgs *img=&p->imgs[0];
+
+  size_t j, n=0, w=gal_type_sizeof(p->type);
+  int status=0, anynul=0, datatype=gal_fits_type_to_datatype(p->type);
+  long f[2], l[2], bf[2], bl[2], inc[2]={1,1}, ff0, ll0, ll1;
+  long naxes[2]={img->dsize[1], img->dsize[0]};
+
+  /* Free the previous band. */
+  free(crp->band);
+  crp->band=NULL;
+
+  /* Find the crops that can use the same band. */
+  for(j=i; crp->indexs[j]!=GAL_BLANK_SIZE_T; ++j)
+    if( crop_img_region(p, crp->indexs[j], naxes, f, l) )
+      {
+        if(n==0)
+          { bf[0]=f[0]; bf[1]=f[1]; bl[0]=l[0]; bl[1]=l[1]; }
+        else
+          {
+            ff0 = f[0]<bf[0] ? f[0] : bf[0];
+            ll0 = l[0]>bl[0] ? l[0] : bl[0];
+            ll1 = l[1]>bl[1] ? l[1] : bl[1];
+            if( f[1]<bf[1]
+                || (ll0-ff0+1)*(ll1-bf[1]+1)*w > BANDMAXSIZE )
+              break;
+            bf[0]=ff0; bl[0]=ll0; bl[1]=ll1;
+          }
+        ++n;
+      }
+  crp->bandend=j;
+
+  /* Only read the band when it is used by more than one crop. Otherwise,
+     the crops until 'j' (that don't overlap with the image, or the one
+     crop that does) are read directly from the input ('crp->band' is
+     NULL), so they don't need to be checked again. */
+  if(n<2) return;
+  crp->band=gal_pointer_allocate(p->type, (bl[0]-bf[0]+1)*(bl[1]-bf[1]+1),
+                                 0, __func__, "crp->band");
+  if( fits_read_subset(crp->infits, datatype, bf, bl, inc, p->blankptrread,
+                       crp->band, &anynul, &status) )
+    gal_fits_io_error(status, NULL);
+  crp->bandf[0]=bf[0]; crp->bandf[1]=bf[1];
+  crp->bandl[0]=bl[0]; crp->bandl[1]=bl[1];
+}
+
+
+
+
+
 static void *
 crop_mode_img(void *inparam)
 {
@@ -212,6 +323,8 @@ crop_mode_img(void *inparam)
      information here:*/
   img=&p->imgs[crp->in_ind];
   crp->infits=gal_fits_hdu_open_format(img->name, p->cp.hdu, 0);
+  crp->band=NULL;
+  crp->bandend=0;
 
   /* Go over all the outputs that are assigned to this thread: */
   for(i=0; crp->indexs[i]!=GAL_BLANK_SIZE_T; ++i)
@@ -219,18 +332,27 @@ crop_mode_img(void *inparam)
       /* Set all the output parameters: */
       crp->out_ind=crp->indexs[i];
       crp->outfits=NULL;
+      crp->array=NULL;
       crp->numimg=1;   /* In Image mode there is only one input image. */
       onecrop_name(crp);
 
+      /* For crops from a catalog, read a band of the input that contains
+         this and the next crops (if necessary). */
+      if(p->catname && img->ndim==2 && i>=crp->bandend)
+        crop_img_band(crp, i);
+
       /* Crop the image. */
       onecrop(crp);
 
-      /* If there was no overlap, then no FITS pointer is created, so
-         'numimg' should be set to zero. */
-      if(crp->outfits==NULL) crp->numimg=0;
+      /* If there was no overlap, then no FITS pointer (or stamp) is
+         created, so 'numimg' should be set to zero. */
+      if( (p->stamps ? crp->array : (void *)crp->outfits)==NULL )
+        crp->numimg=0;
 
       /* Check the final output: */
-      if(crp->numimg)
+      if(p->stamps)
+        stamps_push(crp);
+      else if(crp->numimg)
         {
           /* Check if the center of the crop is filled or not. */
           crp->centerfilled=onecrop_center_filled(crp);
@@ -261,6 +383,7 @@ crop_mode_img(void *inparam)
 
   /* Close the input image. */
   status=0;
+  free(crp->band);
   if( fits_close_file(crp->infits, &status) )
     gal_fits_io_error(status, "could not close FITS file");
 
@@ -275,14 +398,65 @@ crop_mode_img(void *inparam)
 
 
 
+/* Return the opened pointer to the input image 'crp->in_ind'. Each
+   thread keeps the last 'INFITSCACHESIZE' input images that it used open,
+   so when neighboring crops use the same input images (which is usually
+   the case, see 'wcsmode_order'), they don't have to be opened again. */
+static fitsfile *
+crop_infits_cached(struct onecropparams *crp)
+{
+  int status=0;
+  size_t i, ind;
+  struct cropparams *p=crp->p;
+
+  /* If this image is already open, use it. */
+  for(i=0;i<crp->numcached;++i)
+    if(crp->cachein[i]==crp->in_ind)
+      {
+        crp->cacheused[i]=++crp->cachecounter;
+        return crp->cachefits[i];
+      }
+
+  /* If the cache is full, close the least recently used image. */
+  if(crp->numcached==INFITSCACHESIZE)
+    {
+      ind=0;
+      for(i=1;i<crp->numcached;++i)
+        if(crp->cacheused[i]<crp->cacheused[ind]) ind=i;
+      if( fits_close_file(crp->cachefits[ind], &status) )
+        gal_fits_io_error(status, "could not close FITS file");
+    }
+  else ind=crp->numcached++;
+
+  /* Open the input image and keep it. */
+  crp->cachein[ind]=crp->in_ind;
+  crp->cacheused[ind]=++crp->cachecounter;
+  crp->cachefits[ind]=gal_fits_hdu_open_format(p->imgs[crp->in_ind].name,
+                                               p->cp.hdu, 0);
+  return crp->cachefits[ind];
+}
+
+
+
+
+
 static void *
 crop_mode_wcs(void *inparam)
 {
   struct onecropparams *crp=(struct onecropparams *)inparam;
   struct cropparams *p=crp->p;
 
-  size_t i;
   int status;
+  size_t i, c, numcand;
+
+  /* Allocate the space to keep the candidate input images and initialize
+     the cache of open input images. */
+  crp->band=NULL;
+  crp->numcached=crp->cachecounter=0;
+  crp->candidates=gal_pointer_allocate(GAL_TYPE_SIZE_T, p->numin, 0,
+                                       __func__, "crp->candidates");
+  crp->checked=gal_pointer_allocate(GAL_TYPE_UINT8, p->numin, 1,
+                                    __func__, "crp->checked");
 
 
   /* Go over all the output objects for this thread. */
@@ -291,6 +465,7 @@ crop_mode_wcs(void *inparam)
       /* Set all the output parameters: */
       crp->out_ind=crp->indexs[i];
       crp->outfits=NULL;
+      crp->array=NULL;
       crp->name=NULL;
       crp->numimg=0;
 
@@ -299,43 +474,45 @@ crop_mode_wcs(void *inparam)
       wcsmode_crop_corners(crp);
 
 
-      /* Go over all the images to see if this target is within their
-         range or not. */
-      crp->in_ind=0;
-      do
-        if(wcsmode_overlap(crp))
-          {
-            /* Open the input FITS file. */
-            crp->infits=gal_fits_hdu_open_format(p->imgs[crp->in_ind].name,
-                                                 p->cp.hdu, 0);
-
-            /* If a name isn't set yet, set it. */
-            if(crp->name==NULL) onecrop_name(crp);
-
-            /* Increment the number of images used (necessary for the
-               header keywords that are written in 'onecrop'). Then do the
-               crop. However, the previously WCS-based overlap can be
-               slightly different from the final overlap, so if we finally
-               don't find any overlap we'll decrement the 'numimg'. */
-            ++crp->numimg;
-            if( onecrop(crp)==0 ) --crp->numimg;
-
-            /* Close the file. */
-            status=0;
-            if( fits_close_file(crp->infits, &status) )
-              gal_fits_io_error(status, "could not close FITS file");
-          }
-      while ( ++(crp->in_ind) < p->numin );
+      /* Go over all the images that may overlap with this crop (see
+         'wcsmode_index') to see if this target is within their range or
+         not. */
+      numcand=wcsmode_candidates(crp);
+      for(c=0;c<numcand;++c)
+        {
+          crp->in_ind=crp->candidates[c];
+          if( wcsmode_overlap(crp)==0 ) continue;
+
+          /* Get the (possibly already) opened input FITS file. */
+          crp->infits=crop_infits_cached(crp);
+
+          /* If a name isn't set yet, set it. */
+          if(crp->name==NULL) onecrop_name(crp);
+
+          /* Increment the number of images used (necessary for the
+             header keywords that are written in 'onecrop'). Then do the
+             crop. However, the previously WCS-based overlap can be
+             slightly different from the final overlap, so if we finally
+             don't find any overlap we'll decrement the 'numimg'. */
+          ++crp->numimg;
+          if( onecrop(crp)==0 ) --crp->numimg;
+        }
 
 
-      /* Correct in_ind. The loop above went until 'in_ind' is one more
-         than the index for the last input image (that is how it exited the
-         loop). But 'crp->in_ind' is needed later, so correct it here. */
-      --crp->in_ind;
+      /* After the loop above, 'crp->in_ind' is the last candidate image
+         (or isn't set at all when there were no candidates). The steps
+         below (when there was no overlap) need it to be the same input
+         image for all crops, so the last input image is used. */
+      crp->in_ind=p->numin-1;
 
 
       /* Check the final output: */
-      if(crp->numimg)
+      if(p->stamps)
+        {
+          if(crp->name==NULL) onecrop_name(crp);
+          stamps_push(crp);
+        }
+      else if(crp->numimg)
         {
           /* See if the center is filled. */
           crp->centerfilled=onecrop_center_filled(crp);
@@ -367,6 +544,16 @@ crop_mode_wcs(void *inparam)
       if(p->cp.log)    crop_write_to_log(crp);
     }
 
+  /* Close the cached input images and clean up. */
+  for(i=0;i<crp->numcached;++i)
+    {
+      status=0;
+      if( fits_close_file(crp->cachefits[i], &status) )
+        gal_fits_io_error(status, "could not close FITS file");
+    }
+  free(crp->candidates);
+  free(crp->checked);
+
   /* Wait until all other threads finish, then return. */
   if(p->cp.numthreads>1)
     pthread_barrier_wait(crp->b);
@@ -435,6 +622,22 @@ crop(struct cropparams *p)
                                        &indexs, &thrdcols);
 
 
+  /* In WCS-mode, build the index of the input images and order the crops
+     so each thread gets neighboring crops. In image mode, order the crops
+     so each thread reads the input sequentially. */
+  if(p->mode==IMGCROP_MODE_WCS)
+    {
+      wcsmode_index(p);
+      if(p->catname) wcsmode_order(p, indexs, nt, thrdcols);
+    }
+  else if(p->catname && p->imgs->ndim==2)
+    crop_order_img(p, indexs, nt, thrdcols);
+
+
+  /* With '--stamps', prepare the output and start the writer thread. */
+  if(p->stamps) stamps_init(p);
+
+
   /* Run the job, if there is only one thread, don't go through the
      trouble of spinning off a thread! */
   if(nt==1)
@@ -473,6 +676,10 @@ crop(struct cropparams *p)
     }
 
 
+  /* Write the remaining stamps (if necessary). */
+  if(p->stamps) stamps_finish(p);
+
+
   /* Print the log file. */
   if(p->cp.log)
     {
@@ -492,6 +699,8 @@ crop(struct cropparams *p)
   /* Print the final verbose info, save log, and clean up: */
   if(mmapname) gal_pointer_mmap_free(&mmapname, p->cp.quietmmap);
   else         free(indexs);
+  if(p->mode==IMGCROP_MODE_WCS)
+    { free(p->decbinstart); free(p->decbinimgs); }
   crop_verbose_final(p);
   free(crp);
 }
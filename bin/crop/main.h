@@ -41,6 +41,8 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 #define LOGFILENAME             PROGRAM_EXEC".log"
 #define FILENAME_BUFFER_IN_VERB 30
 #define MAXDIM                  3
+#define INFITSCACHESIZE         8
+#define BANDMAXSIZE             67108864 /* Bytes of band in image mode. */
 
 
 /* Modes to interpret coordinates. */
@@ -53,6 +55,16 @@ enum crop_modes
 };
 
 
+/* Outputs of '--stamps'. */
+enum crop_stamps
+{
+  CROP_STAMPS_NONE,             /* One file for each crop.     */
+
+  CROP_STAMPS_CUBE,             /* All crops in one cube.      */
+  CROP_STAMPS_TABLE,            /* All crops in a table column.*/
+};
+
+
 
 
 /* The sides of the image keep the celestial coordinates of the four
@@ -69,6 +81,7 @@ struct inputimgs
   double     corners[24];  /* WCS of corners (24: for 3D, 8: for 2D).     */
   double   sized[MAXDIM];  /* Width and height of image in degrees.       */
   double  equatorcorr[2];  /* If image crosses the equator, see wcsmode.c.*/
+  double     decrange[2];  /* Minimum and maximum declination of image.   */
 };
 
 
@@ -102,6 +115,7 @@ struct cropparams
   uint8_t           polygonout;  /* ==1: Keep the inner polygon region.   */
   uint8_t          polygonsort;  /* Don't sort polygon vertices.          */
   char               *metaname;  /* Output's EXTNAME keyword.             */
+  char              *stampsstr;  /* Value given to '--stamps'.            */
 
   /* Internal */
   size_t                 numin;  /* Number of input images.               */
@@ -120,8 +134,15 @@ struct cropparams
   void           *blankptrread;  /* Null value for reading of output type.*/
   void          *blankptrwrite;  /* Null value for writing of output type.*/
   struct inputimgs       *imgs;  /* WCS and size information for inputs.  */
+  double             decbinmin;  /* Minimum declination in input index.   */
+  double           decbinwidth;  /* Width of declination bins in index.   */
+  size_t            numdecbins;  /* Number of declination bins in index.  */
+  size_t          *decbinstart;  /* Start of each bin in 'decbinimgs'.    */
+  size_t           *decbinimgs;  /* Input images in each declination bin. */
   gal_data_t              *log;  /* Log file contents.                    */
   int            oneelemstdout;  /* Print one element crops on stdout.    */
+  uint8_t               stamps;  /* Write all crops into one file.        */
+  struct stampswriter  *writer;  /* Thread writing all the stamps.        */
 };
 
 #endif
@@ -43,6 +43,7 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 #include "main.h"
 
 #include "onecrop.h"
+#include "stamps.h"
 #include "wcsmode.h"
 
 
@@ -387,8 +388,18 @@ onecrop_name(struct onecropparams *crp)
   struct cropparams *p=crp->p;
   struct gal_options_common_params *cp=&p->cp;
 
+  /* With '--stamps', all crops are in one file, so the name is only an
+     identifier (for the log and verbose outputs). */
+  if(p->stamps)
+    {
+      if(p->name)
+        gal_checkset_allocate_copy(p->name[crp->out_ind], &crp->name);
+      else if( asprintf(&crp->name, "%zu", crp->out_ind+1)<0 )
+        error(EXIT_FAILURE, 0, "%s: asprintf allocation", __func__);
+    }
+
   /* Set the output name and crop sides: */
-  if(p->catname)
+  else if(p->catname)
     {
       /* If a name column was set, use it, otherwise, use the ID of the
          profile. */
@@ -641,6 +652,35 @@ onecrop_make_array(struct onecropparams *crp, long *fpixel_i,
 
 
 
+/* If the band of the input that was read for many crops (see
+   'crop_img_band') contains the desired region, copy the region from it
+   and return 1. Otherwise, return 0. */
+static int
+onecrop_from_band(struct onecropparams *crp, void *array, long *fpixel_i,
+                  long *lpixel_i)
+{
+  char *in=crp->band, *out=array;
+  size_t w=gal_type_sizeof(crp->p->type);
+  long j, nx=lpixel_i[0]-fpixel_i[0]+1, bw=crp->bandl[0]-crp->bandf[0]+1;
+
+  /* See if the band covers this region. */
+  if( crp->band==NULL
+      || fpixel_i[0]<crp->bandf[0] || lpixel_i[0]>crp->bandl[0]
+      || fpixel_i[1]<crp->bandf[1] || lpixel_i[1]>crp->bandl[1] )
+    return 0;
+
+  /* Copy the region row by row. */
+  for(j=fpixel_i[1];j<=lpixel_i[1];++j)
+    memcpy(out + w*(j-fpixel_i[1])*nx,
+           in + w*( (j-crp->bandf[1])*bw + fpixel_i[0]-crp->bandf[0] ),
+           w*nx);
+  return 1;
+}
+
+
+
+
+
 /* The starting and ending points are set in the onecropparams structure
    for one crop from one image. Crop that region out of the input.
 
@@ -695,8 +735,11 @@ onecrop(struct onecropparams *crp)
 
       /* Make the output FITS image and initialize it with an array of NaN
          or BLANK values. But only when '--oneelemstdout' isn't called and
-         the output is single-element. */
-      if(crp->outfits==NULL && !( p->oneelemstdout && hasoneelem) )
+         the output is single-element. With '--stamps', the crop is
+         built in memory (and written later). */
+      if(p->stamps)
+        { if(crp->array==NULL) stamps_start(crp, fpixel_i, fpixel_o); }
+      else if(crp->outfits==NULL && !( p->oneelemstdout && hasoneelem) )
         onecrop_make_array(crp, fpixel_i, lpixel_i, fpixel_o, lpixel_o);
       ofp=crp->outfits;
 
@@ -706,9 +749,10 @@ onecrop(struct onecropparams *crp)
       status=0;
       for(i=0;i<ndim;++i) cropsize *= ( lpixel_i[i] - fpixel_i[i] + 1 );
       array=gal_pointer_allocate(p->type, cropsize, 0, __func__, "array");
-      if(fits_read_subset(ifp, gal_fits_type_to_datatype(p->type),
-                          fpixel_i, lpixel_i, inc, p->blankptrread, array,
-                          &anynul, &status))
+      if( onecrop_from_band(crp, array, fpixel_i, lpixel_i)==0
+          && fits_read_subset(ifp, gal_fits_type_to_datatype(p->type),
+                              fpixel_i, lpixel_i, inc, p->blankptrread,
+                              array, &anynul, &status) )
         gal_fits_io_error(status, NULL);
 
 
@@ -739,9 +783,11 @@ onecrop(struct onecropparams *crp)
         }
 
 
-      /* Write the output (either to a file or standard output if its a
-         single element and the user asked for it). */
-      if(crp->outfits)
+      /* Write the output (either to the stamp, to a file or standard
+         output if its a single element and the user asked for it). */
+      if(p->stamps)
+        stamps_copy(crp, array, fpixel_i, lpixel_i, fpixel_o);
+      else if(crp->outfits)
         {
           /* Write the array into the image. */
           status=0;
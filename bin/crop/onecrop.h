@@ -29,7 +29,7 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 
 struct onecropparams
 {
-  void *array;
+  void *array;                 /* Stamp in memory (with '--stamps').       */
 
   /* Pointer to basic structure: */
   struct   cropparams *p;
@@ -40,6 +40,21 @@ struct onecropparams
   long        fpixel[MAXDIM];  /* Position of first pixel in input image.  */
   long        lpixel[MAXDIM];  /* Position of last pixel in input image.   */
   double           *ipolygon;  /* Input image based polygon vertices.      */
+  size_t         *candidates;  /* Input images that may overlap (WCS).     */
+  uint8_t           *checked;  /* Flag for images in 'candidates'.         */
+
+  /* Recently used input images (WCS mode). */
+  size_t            numcached;  /* Number of open input images.            */
+  size_t        cachecounter;  /* Counter to find the least recently used. */
+  size_t cachein[INFITSCACHESIZE];    /* Index of cached input images.     */
+  size_t cacheused[INFITSCACHESIZE];  /* Counter when last used.           */
+  fitsfile *cachefits[INFITSCACHESIZE]; /* Open pointer to input images.   */
+
+  /* Band of the input image shared by many crops (image mode). */
+  void                 *band;  /* Pixels of the band (or NULL).            */
+  long              bandf[2];  /* First pixel of the band in input image.  */
+  long              bandl[2];  /* Last pixel of the band in input image.   */
+  size_t             bandend;  /* Crops before this are in the band.       */
 
   /* Output (cropped) image. */
   size_t             out_ind;  /* Index of this crop in the output list.   */
@@ -0,0 +1,520 @@
+/*********************************************************************
+Crop - Crop a given size from one or multiple images.
+Crop is part of GNU Astronomy Utilities (Gnuastro) package.
+
+Original author:
+     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+Contributing author(s):
+Copyright (C) 2015-2022 Free Software Foundation, Inc.
+
+Gnuastro is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+Gnuastro is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
+**********************************************************************/
+#include <config.h>
+
+#include <errno.h>
+#include <error.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <gnuastro/fits.h>
+#include <gnuastro/blank.h>
+#include <gnuastro/pointer.h>
+
+#include <gnuastro-internal/checkset.h>
+
+#include "main.h"
+
+#include "onecrop.h"
+#include "stamps.h"
+
+
+
+
+
+
+
+
+
+
+/**************************************************************/
+/************          Building each stamp        *************/
+/**************************************************************/
+/* When '--stamps' is given, all the crops have the same size ('p->iwidth')
+   and are written into one file. So instead of a separate FITS file, each
+   crop is built in memory ('crp->array'). This is called on the first
+   input image that overlaps with the crop. */
+void
+stamps_start(struct onecropparams *crp, long *fpixel_i, long *fpixel_o)
+{
+  struct cropparams *p=crp->p;
+  struct stampswriter *sw=p->writer;
+  struct inputimgs *img=&p->imgs[crp->in_ind];
+
+  size_t i;
+
+  /* Allocate the stamp and initialize it to blank. */
+  crp->array=gal_pointer_allocate(p->type, sw->stampsize, 0, __func__,
+                                  "crp->array");
+  gal_blank_initialize_array(crp->array, sw->stampsize, p->type);
+
+  /* The WCS of this input (with the CRPIX of this stamp) is the WCS of
+     the stamp (same as 'onecrop_make_array'). Note that the crops of
+     different threads have different indexs, so there is no problem in
+     writing in these arrays. */
+  sw->input[crp->out_ind]=crp->in_ind+1;
+  if(img->wcs)
+    for(i=0;i<img->ndim;++i)
+      sw->crpix[i][crp->out_ind] = ( img->wcs->crpix[i] - (fpixel_i[i]-1)
+                                     + (fpixel_o[i]-1) );
+}
+
+
+
+
+
+/* Copy the pixels read from one input image ('array', from 'fpixel_i' to
+   'lpixel_i' in the input) into the stamp (starting from 'fpixel_o'). */
+void
+stamps_copy(struct onecropparams *crp, void *array, long *fpixel_i,
+            long *lpixel_i, long *fpixel_o)
+{
+  struct cropparams *p=crp->p;
+
+  long j, k, *naxes=p->iwidth;
+  char *in=array, *out=crp->array;
+  size_t ndim=p->imgs->ndim, w=gal_type_sizeof(p->type);
+  long nx=lpixel_i[0]-fpixel_i[0]+1, ny=lpixel_i[1]-fpixel_i[1]+1;
+  long nz = ndim==3 ? lpixel_i[2]-fpixel_i[2]+1 : 1;
+  long oz = ndim==3 ? fpixel_o[2]-1 : 0;
+
+  /* Copy each row of the read region into its place in the stamp. */
+  for(k=0;k<nz;++k)
+    for(j=0;j<ny;++j)
+      memcpy( out + w*( ((oz+k)*naxes[1] + fpixel_o[1]-1+j) * naxes[0]
+                        + fpixel_o[0]-1 ),
+              in + w*(k*ny+j)*nx, w*nx );
+}
+
+
+
+
+
+/* Same as 'onecrop_center_filled', but on the stamp in memory. */
+static uint8_t
+stamps_center_filled(struct onecropparams *crp)
+{
+  struct cropparams *p=crp->p;
+
+  char *arr=crp->array;
+  long checkcenter=p->checkcenter;
+  long i, j, k, *naxes=p->iwidth;
+  long fpixel[3]={1,1,1}, lpixel[3]={1,1,1};
+  size_t d, ndim=p->imgs->ndim, w=gal_type_sizeof(p->type);
+
+  /* If checkcenter is zero, then don't check. */
+  if(checkcenter==0) return GAL_BLANK_UINT8;
+
+  /* Range of the central region to check. */
+  for(d=0;d<ndim;++d)
+    {
+      fpixel[d] = ( naxes[d]>checkcenter
+                    ? ((naxes[d]/2+1)-checkcenter/2) : 1 );
+      lpixel[d] = ( naxes[d]>checkcenter
+                    ? ((naxes[d]/2+1)+checkcenter/2) : naxes[d] );
+    }
+
+  /* If any of the central pixels is blank, the center isn't filled. */
+  for(k=fpixel[2]-1;k<lpixel[2];++k)
+    for(j=fpixel[1]-1;j<lpixel[1];++j)
+      for(i=fpixel[0]-1;i<lpixel[0];++i)
+        if( gal_blank_is(arr + w*((k*naxes[1]+j)*naxes[0]+i), p->type) )
+          return 0;
+  return 1;
+}
+
+
+
+
+
+/* The crop is complete: keep its information and give the stamp to the
+   writer thread. When the queue is full, wait for the writer to catch
+   up (so the stamps don't fill the memory). */
+void
+stamps_push(struct onecropparams *crp)
+{
+  struct cropparams *p=crp->p;
+  struct stampswriter *sw=p->writer;
+
+  struct stampsitem *item;
+
+  /* Keep the information of this stamp. */
+  crp->centerfilled = crp->array ? stamps_center_filled(crp) : 0;
+  sw->numimg[crp->out_ind]=crp->numimg;
+  sw->centerfilled[crp->out_ind]=crp->centerfilled;
+
+  /* Stamps with no overlap will be written as blank in the end. */
+  if(crp->array==NULL) return;
+
+  /* Build the queue item. */
+  errno=0;
+  item=malloc(sizeof *item);
+  if(item==NULL)
+    error(EXIT_FAILURE, errno, "%s: allocating %zu bytes for 'item'",
+          __func__, sizeof *item);
+  item->ind=crp->out_ind;
+  item->array=crp->array;
+  crp->array=NULL;
+
+  /* Put it in the queue. */
+  pthread_mutex_lock(&sw->mutex);
+  while(sw->numqueued>=sw->maxqueued)
+    pthread_cond_wait(&sw->nonfull, &sw->mutex);
+  item->next=sw->first;
+  sw->first=item;
+  ++sw->numqueued;
+  pthread_cond_signal(&sw->nonempty);
+  pthread_mutex_unlock(&sw->mutex);
+}
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+/**************************************************************/
+/************          Writing the stamps         *************/
+/**************************************************************/
+/* Write one stamp in its place: the plane of the cube or the row of the
+   table. */
+static void
+stamps_write_one(struct cropparams *p, size_t ind, void *array)
+{
+  int status=0;
+  struct stampswriter *sw=p->writer;
+  int datatype=gal_fits_type_to_datatype(p->type);
+
+  if(p->stamps==CROP_STAMPS_CUBE)
+    fits_write_img(sw->fptr, datatype, ind*sw->stampsize+1, sw->stampsize,
+                   array, &status);
+  else
+    fits_write_col(sw->fptr, datatype, 1, ind+1, 1, sw->stampsize, array,
+                   &status);
+  gal_fits_io_error(status, "writing stamp");
+}
+
+
+
+
+
+/* The writer thread: take all the stamps in the queue and write them
+   until all the crops are done. Since CFITSIO can't write into one file
+   from multiple threads, only this thread writes into the output. */
+static void *
+stamps_writer(void *in_prm)
+{
+  struct cropparams *p=(struct cropparams *)in_prm;
+  struct stampswriter *sw=p->writer;
+
+  struct stampsitem *list, *tmp;
+
+  while(1)
+    {
+      /* Take all the stamps in the queue (or leave when all the stamps
+         have been written). */
+      pthread_mutex_lock(&sw->mutex);
+      while(sw->first==NULL && sw->finished==0)
+        pthread_cond_wait(&sw->nonempty, &sw->mutex);
+      list=sw->first;
+      sw->first=NULL;
+      sw->numqueued=0;
+      pthread_cond_broadcast(&sw->nonfull);
+      pthread_mutex_unlock(&sw->mutex);
+      if(list==NULL) break;
+
+      /* Write the stamps and free them. */
+      while(list)
+        {
+          stamps_write_one(p, list->ind, list->array);
+          tmp=list->next;
+          free(list->array);
+          free(list);
+          list=tmp;
+        }
+    }
+
+  return NULL;
+}
+
+
+
+
+
+/* Add a column definition for 'fits_create_tbl'. */
+static void
+stamps_add_col(char **ttype, char **tform, char **tunit, size_t *ncols,
+               char *name, char *form, char *unit)
+{
+  gal_checkset_allocate_copy(name, &ttype[*ncols]);
+  gal_checkset_allocate_copy(form, &tform[*ncols]);
+  gal_checkset_allocate_copy(unit, &tunit[*ncols]);
+  ++*ncols;
+}
+
+
+
+
+
+/* Make the table that keeps the information of each stamp (in 'table'
+   mode, the stamps are also the first column of this table). */
+static void
+stamps_make_table(struct cropparams *p)
+{
+  struct stampswriter *sw=p->writer;
+
+  int status=0;
+  char *ttype[16], *tform[16], *tunit[16];
+  char *cunit = p->mode==IMGCROP_MODE_WCS ? "deg" : "pixel";
+  size_t i, ncols=0, maxlen=1, ndim=p->imgs->ndim;
+  char name[FLEN_KEYWORD], form[FLEN_VALUE], cform[2]={'D', '\0'};
+
+  /* The stamps column. */
+  if(p->stamps==CROP_STAMPS_TABLE)
+    {
+      sprintf(form, "%zu%c", sw->stampsize,
+              gal_fits_type_to_bin_tform(p->type));
+      stamps_add_col(ttype, tform, tunit, &ncols, "STAMP", form, "");
+    }
+
+  /* The columns from the catalog. */
+  stamps_add_col(ttype, tform, tunit, &ncols, "ID", "1K", "counter");
+  if(p->name)
+    {
+      for(i=0;i<p->numout;++i)
+        if(strlen(p->name[i])>maxlen) maxlen=strlen(p->name[i]);
+      sprintf(form, "%zuA", maxlen);
+      stamps_add_col(ttype, tform, tunit, &ncols, "NAME", form, "name");
+    }
+  for(i=0;i<ndim;++i)
+    {
+      sprintf(name, "CENTER_%zu", i+1);
+      stamps_add_col(ttype, tform, tunit, &ncols, name, cform, cunit);
+    }
+
+  /* The columns of the crop. */
+  stamps_add_col(ttype, tform, tunit, &ncols, "NUM_INPUTS", "1U", "count");
+  stamps_add_col(ttype, tform, tunit, &ncols, "CENTER_FILLED", "1B", "bool");
+  stamps_add_col(ttype, tform, tunit, &ncols, "INPUT", "1J", "counter");
+  for(i=0;i<ndim;++i)
+    {
+      sprintf(name, "CRPIX_%zu", i+1);
+      stamps_add_col(ttype, tform, tunit, &ncols, name, cform, "pixel");
+    }
+
+  /* Create the table. */
+  if( fits_create_tbl(sw->fptr, BINARY_TBL, p->numout, ncols, ttype, tform,
+                      tunit, p->stamps==CROP_STAMPS_TABLE
+                      ? p->metaname : "STAMPS-INFO", &status) )
+    gal_fits_io_error(status, "creating table of stamps");
+  fits_get_hdu_num(sw->fptr, &sw->infohdu);
+
+  /* Clean up. */
+  for(i=0;i<ncols;++i) { free(ttype[i]); free(tform[i]); free(tunit[i]); }
+}
+
+
+
+
+
+/* Create the output file and start the writer thread. */
+void
+stamps_init(struct cropparams *p)
+{
+  fitsfile *fptr;
+  struct stampswriter *sw;
+  int err, status=0;
+  char basekeyname[FLEN_KEYWORD-5];
+  gal_fits_list_key_t *headers=NULL;
+  long naxes[MAXDIM+1]={0}, nnaxes[MAXDIM];
+  size_t i, ndim=p->imgs->ndim, maxqueued=4*p->cp.numthreads;
+
+  /* Allocate the writer's parameters. */
+  errno=0;
+  sw=p->writer=calloc(1, sizeof *sw);
+  if(sw==NULL)
+    error(EXIT_FAILURE, errno, "%s: allocating %zu bytes for 'sw'",
+          __func__, sizeof *sw);
+  sw->stampsize=1;
+  for(i=0;i<ndim;++i) sw->stampsize *= (naxes[i]=p->iwidth[i]);
+  naxes[ndim]=p->numout;
+  sw->maxqueued = maxqueued<16 ? 16 : maxqueued;
+  sw->numimg=gal_pointer_allocate(GAL_TYPE_UINT16, p->numout, 1, __func__,
+                                  "sw->numimg");
+  sw->centerfilled=gal_pointer_allocate(GAL_TYPE_UINT8, p->numout, 1,
+                                        __func__, "sw->centerfilled");
+  sw->input=gal_pointer_allocate(GAL_TYPE_INT32, p->numout, 1, __func__,
+                                 "sw->input");
+  for(i=0;i<ndim;++i)
+    {
+      sw->crpix[i]=gal_pointer_allocate(GAL_TYPE_FLOAT64, p->numout, 0,
+                                        __func__, "sw->crpix[i]");
+      gal_blank_initialize_array(sw->crpix[i], p->numout, GAL_TYPE_FLOAT64);
+    }
+  sw->blankstamp=gal_pointer_allocate(p->type, sw->stampsize, 0, __func__,
+                                      "sw->blankstamp");
+  gal_blank_initialize_array(sw->blankstamp, sw->stampsize, p->type);
+
+  /* Create the output (the stamps are in the first extension unless
+     '--primaryimghdu' is given for a cube, same as each crop). */
+  if(p->stamps==CROP_STAMPS_CUBE && p->primaryimghdu)
+    {
+      if( fits_create_file(&sw->fptr, p->cp.output, &status) )
+        gal_fits_io_error(status, "creating file");
+    }
+  else sw->fptr=gal_fits_open_to_write(p->cp.output);
+  fptr=sw->fptr;
+
+  /* Make the HDU(s). */
+  if(p->stamps==CROP_STAMPS_CUBE)
+    {
+      if( fits_create_img(fptr, gal_fits_type_to_bitpix(p->type), ndim+1,
+                          naxes, &status) )
+        gal_fits_io_error(status, "creating cube of stamps");
+      fits_update_key(fptr, TSTRING, "EXTNAME", p->metaname,
+                      "Name of HDU (extension).", &status);
+      if( p->type!=GAL_TYPE_FLOAT32 && p->type!=GAL_TYPE_FLOAT64 )
+        fits_write_key(fptr, gal_fits_type_to_datatype(p->type), "BLANK",
+                       p->blankptrwrite, "Pixels with no data.", &status);
+      gal_fits_io_error(status, "writing keywords of stamps");
+      fits_get_hdu_num(fptr, &sw->stamphdu);
+      stamps_make_table(p);
+    }
+  else
+    {
+      stamps_make_table(p);
+      sw->stamphdu=sw->infohdu;
+      for(i=0;i<ndim;++i) nnaxes[i]=naxes[i];
+      fits_write_tdim(fptr, 1, ndim, nnaxes, &status);
+      if( p->type!=GAL_TYPE_FLOAT32 && p->type!=GAL_TYPE_FLOAT64 )
+        fits_write_key(fptr, gal_fits_type_to_datatype(p->type), "TNULL1",
+                       p->blankptrwrite, "Blank value of stamps.", &status);
+      gal_fits_io_error(status, "writing keywords of stamps");
+    }
+
+  /* Keep the names of the input images (their index is the 'INPUT'
+     column). */
+  for(i=0;i<p->numin;++i)
+    {
+      sprintf(basekeyname, "INP%zu", i+1);
+      gal_fits_key_write_filename(basekeyname, p->imgs[i].name, &headers,
+                                  0, p->cp.quiet);
+    }
+  gal_fits_key_write_title_in_ptr("Crop information", fptr);
+  gal_fits_key_write_in_ptr(&headers, fptr);
+
+  /* Go back to the stamps HDU for the writer. */
+  if( fits_movabs_hdu(fptr, sw->stamphdu, NULL, &status) )
+    gal_fits_io_error(status, NULL);
+
+  /* Start the writer thread. */
+  pthread_mutex_init(&sw->mutex, NULL);
+  pthread_cond_init(&sw->nonempty, NULL);
+  pthread_cond_init(&sw->nonfull, NULL);
+  err=pthread_create(&sw->thread, NULL, stamps_writer, p);
+  if(err)
+    error(EXIT_FAILURE, 0, "%s: can't create the writer thread", __func__);
+}
+
+
+
+
+
+/* All the crops are done: wait for the writer thread to finish, then
+   write the stamps that had no overlap and the information of each
+   stamp. */
+void
+stamps_finish(struct cropparams *p)
+{
+  struct stampswriter *sw=p->writer;
+
+  int64_t *id;
+  int status=0;
+  fitsfile *fptr=sw->fptr;
+  size_t i, c=0, ndim=p->imgs->ndim;
+
+  /* Tell the writer that there are no more stamps and wait for it. */
+  pthread_mutex_lock(&sw->mutex);
+  sw->finished=1;
+  pthread_cond_signal(&sw->nonempty);
+  pthread_mutex_unlock(&sw->mutex);
+  pthread_join(sw->thread, NULL);
+
+  /* Stamps without any overlap. */
+  for(i=0;i<p->numout;++i)
+    if(sw->numimg[i]==0)
+      stamps_write_one(p, i, sw->blankstamp);
+
+  /* Write the information of each stamp. */
+  if( fits_movabs_hdu(fptr, sw->infohdu, NULL, &status) )
+    gal_fits_io_error(status, NULL);
+  if(p->stamps==CROP_STAMPS_TABLE) ++c;
+  id=gal_pointer_allocate(GAL_TYPE_INT64, p->numout, 0, __func__, "id");
+  for(i=0;i<p->numout;++i) id[i]=i+1;
+  fits_write_col(fptr, TLONGLONG, ++c, 1, 1, p->numout, id, &status);
+  if(p->name)
+    fits_write_col(fptr, TSTRING, ++c, 1, 1, p->numout, p->name, &status);
+  for(i=0;i<ndim;++i)
+    fits_write_col(fptr, TDOUBLE, ++c, 1, 1, p->numout, p->centercoords[i],
+                   &status);
+  fits_write_col(fptr, TUSHORT, ++c, 1, 1, p->numout, sw->numimg, &status);
+  fits_write_col(fptr, TBYTE, ++c, 1, 1, p->numout, sw->centerfilled,
+                 &status);
+  fits_write_col(fptr, TINT, ++c, 1, 1, p->numout, sw->input, &status);
+  for(i=0;i<ndim;++i)
+    fits_write_col(fptr, TDOUBLE, ++c, 1, 1, p->numout, sw->crpix[i],
+                   &status);
+  gal_fits_io_error(status, "writing information of stamps");
+
+  /* Add the version keywords and close the file. */
+  gal_fits_key_write_version_in_ptr(NULL, NULL, fptr);
+  if( fits_close_file(fptr, &status) )
+    gal_fits_io_error(status, "closing the stamps");
+
+  /* Clean up. */
+  free(id);
+  free(sw->input);
+  free(sw->numimg);
+  free(sw->blankstamp);
+  free(sw->centerfilled);
+  for(i=0;i<ndim;++i) free(sw->crpix[i]);
+  pthread_cond_destroy(&sw->nonfull);
+  pthread_cond_destroy(&sw->nonempty);
+  pthread_mutex_destroy(&sw->mutex);
+  free(sw);
+  p->writer=NULL;
+}
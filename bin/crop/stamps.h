@@ -0,0 +1,72 @@
+/*********************************************************************
+Crop - Crop a given size from one or multiple images.
+Crop is part of GNU Astronomy Utilities (Gnuastro) package.
+
+Original author:
+     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+Contributing author(s):
+Copyright (C) 2015-2022 Free Software Foundation, Inc.
+
+Gnuastro is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+Gnuastro is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
+**********************************************************************/
+#ifndef STAMPS_H
+#define STAMPS_H
+
+/* A finished stamp that is waiting to be written. */
+struct stampsitem
+{
+  size_t                 ind;  /* Index of stamp in the output.           */
+  void                *array;  /* Pixels of the stamp.                    */
+  struct stampsitem    *next;  /* Next stamp in the queue.                */
+};
+
+/* Parameters of the (single) thread that writes all the stamps. */
+struct stampswriter
+{
+  fitsfile             *fptr;  /* Pointer to the output file.             */
+  int               stamphdu;  /* HDU number of the stamps.               */
+  int                infohdu;  /* HDU number of the table of stamp info.  */
+  size_t           stampsize;  /* Number of pixels in each stamp.         */
+  void           *blankstamp;  /* A stamp with only blank pixels.         */
+  pthread_t           thread;  /* ID of the writer thread.                */
+  pthread_mutex_t      mutex;  /* Mutex for the queue.                    */
+  pthread_cond_t    nonempty;  /* The queue has a stamp (or finished).    */
+  pthread_cond_t     nonfull;  /* The queue has space for a new stamp.    */
+  struct stampsitem   *first;  /* Queue of stamps to write.               */
+  size_t           numqueued;  /* Number of stamps in the queue.          */
+  size_t           maxqueued;  /* Maximum number of stamps in the queue.  */
+  int               finished;  /* ==1: all stamps have been queued.       */
+  uint16_t           *numimg;  /* Number of inputs used in each stamp.    */
+  uint8_t      *centerfilled;  /* If the center of each stamp is filled.  */
+  int32_t             *input;  /* Input image (counting from 1) of WCS.   */
+  double     *crpix[MAXDIM];  /* CRPIX of input's WCS in each stamp.     */
+};
+
+void
+stamps_init(struct cropparams *p);
+
+void
+stamps_start(struct onecropparams *crp, long *fpixel_i, long *fpixel_o);
+
+void
+stamps_copy(struct onecropparams *crp, void *array, long *fpixel_i,
+            long *lpixel_i, long *fpixel_o);
+
+void
+stamps_push(struct onecropparams *crp);
+
+void
+stamps_finish(struct cropparams *p);
+
+#endif
@@ -151,6 +151,10 @@ ui_initialize_options(struct cropparams *p,
         case GAL_OPTIONS_KEY_STDINTIMEOUT:
           cp->coptions[i].group=OPTION_HIDDEN;
           break;
+
+        case GAL_OPTIONS_KEY_COMPRESS:
+          cp->coptions[i].flags=OPTION_HIDDEN;
+          break;
         }
 
       /* Select by group. */
@@ -434,6 +438,23 @@ ui_read_check_only_options(struct cropparams *p)
     error(EXIT_FAILURE, 0, "'--noblanks' ('-b') is only for image mode. "
           "You have called it with WCS mode");
 
+  /* Output of all crops in one file. */
+  if(p->stampsstr)
+    {
+      if     ( !strcmp(p->stampsstr, "cube")  ) p->stamps=CROP_STAMPS_CUBE;
+      else if( !strcmp(p->stampsstr, "table") ) p->stamps=CROP_STAMPS_TABLE;
+      else
+        error(EXIT_FAILURE, 0, "'%s' (value to '--stamps') not recognized. "
+              "Recognized values are 'cube' and 'table'", p->stampsstr);
+      if(p->catname==NULL)
+        error(EXIT_FAILURE, 0, "'--stamps' is only for crops from a "
+              "catalog ('--catalog')");
+      if(p->noblank)
+        error(EXIT_FAILURE, 0, "'--stamps' and '--noblank' cannot be "
+              "called together: all the stamps must have the same size");
+    }
+  else p->stamps=CROP_STAMPS_NONE;
+
   /* If '--apend' has been called, set 'cp.keep' to 1 (since we don't want
      to delete the output file). */
   if(p->append) p->cp.keep=1;
@@ -446,6 +467,8 @@ ui_read_check_only_options(struct cropparams *p)
 static void
 ui_check_options_and_arguments(struct cropparams *p)
 {
+  char *notdir, *basename, *suffix, *outname;
+
   /* Make sure we actually have inputs. */
   if(p->inputs==NULL)
     error(EXIT_FAILURE, 0, "no input file given");
@@ -499,8 +522,32 @@ ui_check_options_and_arguments(struct cropparams *p)
         }
 #endif
 
-      /* Make sure the given output is a directory. */
-      gal_checkset_check_dir_write_add_slash(&p->cp.output);
+      /* With '--stamps' the output is a single file (if a directory is
+         given, the name is set from the catalog's name). Otherwise, make
+         sure the given output is a directory. */
+      if(p->stamps)
+        {
+          if( gal_checkset_dir_0_file_1(&p->cp, p->cp.output,
+                                        p->catname)==0 )
+            {
+              gal_checkset_check_dir_write_add_slash(&p->cp.output);
+              notdir=gal_checkset_not_dir_part(p->catname);
+              basename=gal_checkset_suffix_separate(notdir, &suffix);
+              if( asprintf(&outname, "%s%s_stamps.fits", p->cp.output,
+                           basename)<0 )
+                error(EXIT_FAILURE, 0, "%s: asprintf allocation",
+                      __func__);
+              gal_checkset_writable_remove(outname, p->catname,
+                                           p->cp.keep, p->cp.dontdelete);
+              free(p->cp.output);
+              p->cp.output=outname;
+              free(basename);
+              free(suffix);
+              free(notdir);
+            }
+        }
+      else
+        gal_checkset_check_dir_write_add_slash(&p->cp.output);
     }
   else
     {
@@ -1287,6 +1334,7 @@ ui_free_report(struct cropparams *p, struct timeval *t1)
 
   /* Free the simple arrays (if they were set). */
   free(p->metaname);
+  free(p->stampsstr);
   free(p->blankptrread);
   free(p->blankptrwrite);
   gal_data_free(p->center);
@@ -76,6 +76,7 @@ enum option_keys_enum
   UI_KEY_POLYGONSORT,
   UI_KEY_CHECKCENTER,
   UI_KEY_PRIMARYIMGHDU,
+  UI_KEY_STAMPS,
 };
 
 
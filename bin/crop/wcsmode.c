@@ -31,6 +31,7 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 #include <stdlib.h>
 
 #include <gnuastro/wcs.h>
+#include <gnuastro/qsort.h>
 #include <gnuastro/pointer.h>
 
 #include "main.h"
@@ -690,3 +691,222 @@ wcsmode_overlap(struct onecropparams *crp)
   /* If control reaches here, there was no overlap. */
   return 0;
 }
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+/*******************************************************************/
+/************        Index of input footprints        **************/
+/*******************************************************************/
+/* Find the range of declinations that are covered by a footprint (from
+   its corners and size, the declination is the second coordinate in both
+   2D and 3D datasets). */
+static void
+wcsmode_dec_range(double *corners, double *sized, size_t ndim,
+                  double *range)
+{
+  double d;
+  size_t i, ncorners = ndim==2 ? 4 : 8;
+
+  range[0]=range[1]=corners[1];
+  if(corners[1]+sized[1]<range[0]) range[0]=corners[1]+sized[1];
+  if(corners[1]+sized[1]>range[1]) range[1]=corners[1]+sized[1];
+  for(i=0;i<ncorners;++i)
+    {
+      d=corners[i*ndim+1];
+      if(d<range[0]) range[0]=d;
+      if(d>range[1]) range[1]=d;
+    }
+}
+
+
+
+
+
+/* Declination bin of the given declination. */
+static size_t
+wcsmode_dec_bin(struct cropparams *p, double dec)
+{
+  size_t bin;
+
+  if(dec<=p->decbinmin) return 0;
+  bin=(dec-p->decbinmin)/p->decbinwidth;
+  return bin<p->numdecbins ? bin : p->numdecbins-1;
+}
+
+
+
+
+
+/* When there are many input images, checking every crop with every input
+   image (with 'wcsmode_overlap') will be very slow. So we build an index
+   of the input images over bins in declination: the input images that
+   cover each bin are kept in 'p->decbinimgs' (from 'p->decbinstart[i]' to
+   'p->decbinstart[i+1]' for bin 'i').
+
+   'wcsmode_overlap' can only find an overlap when the declination ranges
+   of the crop and the input image overlap. So only the images in the bins
+   of each crop (and with an overlapping declination range) need to be
+   checked with 'wcsmode_overlap' and the result will be identical. The
+   width of each bin is the average height of the input images. */
+void
+wcsmode_index(struct cropparams *p)
+{
+  struct inputimgs *img;
+  size_t i, b, *cursor, ndim=p->imgs->ndim;
+  double decmin=DBL_MAX, decmax=-DBL_MAX, sumheight=0.0f;
+
+  /* Find the declination range of each image. */
+  for(i=0;i<p->numin;++i)
+    {
+      img=&p->imgs[i];
+      wcsmode_dec_range(img->corners, img->sized, ndim, img->decrange);
+      if(img->decrange[0]<decmin) decmin=img->decrange[0];
+      if(img->decrange[1]>decmax) decmax=img->decrange[1];
+      sumheight += img->decrange[1] - img->decrange[0];
+    }
+
+  /* Set the bins (there is no need for more bins than four times the
+     number of images). */
+  p->decbinmin=decmin;
+  p->decbinwidth=sumheight/p->numin;
+  if(p->decbinwidth<(decmax-decmin)/(4*p->numin))
+    p->decbinwidth=(decmax-decmin)/(4*p->numin);
+  p->numdecbins = ( p->decbinwidth>0.0f
+                    ? (decmax-decmin)/p->decbinwidth + 1
+                    : 1 );
+  if(p->decbinwidth<=0.0f) p->decbinwidth=1.0f;
+
+  /* Count the number of images in each bin (the counts are put in the
+     next element, so the cumulative sum is the start of each bin). */
+  p->decbinstart=gal_pointer_allocate(GAL_TYPE_SIZE_T, p->numdecbins+1, 1,
+                                      __func__, "p->decbinstart");
+  for(i=0;i<p->numin;++i)
+    for(b=wcsmode_dec_bin(p, p->imgs[i].decrange[0]);
+        b<=wcsmode_dec_bin(p, p->imgs[i].decrange[1]); ++b)
+      ++p->decbinstart[b+1];
+  for(b=0;b<p->numdecbins;++b)
+    p->decbinstart[b+1]+=p->decbinstart[b];
+
+  /* Put the image indexs in their bins. */
+  p->decbinimgs=gal_pointer_allocate(GAL_TYPE_SIZE_T,
+                                     p->decbinstart[p->numdecbins], 0,
+                                     __func__, "p->decbinimgs");
+  cursor=gal_pointer_allocate(GAL_TYPE_SIZE_T, p->numdecbins, 0, __func__,
+                              "cursor");
+  memcpy(cursor, p->decbinstart, p->numdecbins*sizeof *cursor);
+  for(i=0;i<p->numin;++i)
+    for(b=wcsmode_dec_bin(p, p->imgs[i].decrange[0]);
+        b<=wcsmode_dec_bin(p, p->imgs[i].decrange[1]); ++b)
+      p->decbinimgs[ cursor[b]++ ]=i;
+
+  /* Clean up. */
+  free(cursor);
+}
+
+
+
+
+
+/* Put the indexs of the input images that may overlap with this crop
+   (its corners should already be set) in 'crp->candidates' and return
+   the number of candidates. The candidates are sorted by their index, so
+   they are used in the same order as the input images. */
+size_t
+wcsmode_candidates(struct onecropparams *crp)
+{
+  double range[2];
+  struct cropparams *p=crp->p;
+  size_t b, bf, i, k, n=0, ndim=p->imgs->ndim;
+
+  /* The declination range of the crop. */
+  wcsmode_dec_range(crp->corners, crp->sized, ndim, range);
+
+  /* Go over the images in the bins of this range. */
+  bf=wcsmode_dec_bin(p, range[1]);
+  for(b=wcsmode_dec_bin(p, range[0]); b<=bf; ++b)
+    for(k=p->decbinstart[b]; k<p->decbinstart[b+1]; ++k)
+      {
+        i=p->decbinimgs[k];
+        if( crp->checked[i]==0
+            && p->imgs[i].decrange[0]<=range[1]
+            && p->imgs[i].decrange[1]>=range[0] )
+          {
+            crp->checked[i]=1;
+            crp->candidates[n++]=i;
+          }
+      }
+
+  /* Reset the flags and sort the candidates (there are only a few
+     candidates, so a simple insertion sort is enough). */
+  for(k=0;k<n;++k)
+    {
+      i=crp->candidates[k];
+      crp->checked[i]=0;
+      for(b=k; b>0 && crp->candidates[b-1]>i; --b)
+        crp->candidates[b]=crp->candidates[b-1];
+      crp->candidates[b]=i;
+    }
+  return n;
+}
+
+
+
+
+
+/* Neighboring crops usually use the same input images, so to benefit from
+   the cache of open input images in each thread, it is best that each
+   thread crops a group of neighboring crops. So we sort the crops over
+   the declination bins of the index (going back and forth in RA within
+   the bins) and give each thread a contiguous part of this sorted list.
+   Note that only the order of the crops changes: their outputs and
+   log rows are still set by their index in the catalog. */
+void
+wcsmode_order(struct cropparams *p, size_t *indexs, size_t nt,
+              size_t thrdcols)
+{
+  size_t i, b, j, k=0, *perm;
+  double ra, *key, *ras=p->centercoords[0], *decs=p->centercoords[1];
+
+  /* Set the sorting key of each crop. */
+  key=gal_pointer_allocate(GAL_TYPE_FLOAT64, p->numout, 0, __func__,
+                           "key");
+  perm=gal_pointer_allocate(GAL_TYPE_SIZE_T, p->numout, 0, __func__,
+                            "perm");
+  for(i=0;i<p->numout;++i)
+    {
+      perm[i]=i;
+      b=wcsmode_dec_bin(p, decs[i]);
+      ra = ras[i]<0 ? ras[i]+360 : ras[i];
+      key[i] = b*720.0f + (b%2 ? 360.0f-ra : ra);
+    }
+
+  /* Sort the crops by their key. */
+  gal_qsort_index_single=key;
+  qsort(perm, p->numout, sizeof *perm, gal_qsort_index_single_float64_i);
+
+  /* Give each thread a contiguous part of the sorted crops. */
+  for(i=0;i<nt;++i)
+    for(j=0; indexs[i*thrdcols+j]!=GAL_BLANK_SIZE_T; ++j)
+      indexs[i*thrdcols+j]=perm[k++];
+
+  /* Clean up. */
+  free(key);
+  free(perm);
+}
@@ -35,4 +35,14 @@ fillcrpipolygon(struct onecropparams *crp);
 int
 wcsmode_overlap(struct onecropparams *crp);
 
+void
+wcsmode_index(struct cropparams *p);
+
+size_t
+wcsmode_candidates(struct onecropparams *crp);
+
+void
+wcsmode_order(struct cropparams *p, size_t *indexs, size_t nt,
+              size_t thrdcols);
+
 #endif
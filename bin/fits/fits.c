@@ -312,7 +312,8 @@ fits_print_extension_info(struct fitsparams *p)
                "etc).\n");
       printf("-----\n");
     }
-  gal_table_write(cols, NULL, NULL, GAL_TABLE_FORMAT_TXT, NULL, NULL, 0);
+  gal_table_write(cols, NULL, NULL, GAL_TABLE_FORMAT_TXT, NULL, NULL, 0,
+                  p->cp.numthreads);
   gal_list_data_free(cols);
 }
 
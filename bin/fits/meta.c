@@ -68,7 +68,7 @@ meta_initialize(struct fitsparams *p, gal_warp_wcsalign_t *wa)
 
   /* Read the input image and its WCS, must free it when done. */
   input=gal_array_read_one_ch_to_type(inputname, hdu, NULL,
-                                      GAL_TYPE_FLOAT64, -1,  0);
+                                      GAL_TYPE_FLOAT64, cp->numthreads, -1,  0);
   input->wcs=gal_wcs_read(inputname, hdu, 0, 0, 0, &input->nwcs);
 
   /* Prepare the essential warping variables. */
@@ -122,7 +122,8 @@ meta_write_to_file(struct fitsparams *p, gal_warp_wcsalign_t *wa)
   /* Convert to type and write to file. */
   if(p->cp.type!=output->type)
     output=gal_data_copy_to_new_type_free(output, p->cp.type);
-  gal_fits_img_write(output, p->cp.output, headers, PROGRAM_NAME);
+  gal_fits_img_write(output, p->cp.output, headers, PROGRAM_NAME,
+                     p->cp.compress);
 
   /* Clean up. */
   wa->output=NULL; /* Must be here to prevent double freeing. */
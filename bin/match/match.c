@@ -405,7 +405,7 @@ match_catalog_read_write_all(struct matchparams *p, size_t *permutation,
     {
       /* Write the catalog to a file. */
       gal_table_write(cat, NULL, NULL, p->cp.tableformat, outname,
-                      extname, 0);
+                      extname, 0, p->cp.numthreads);
 
       /* Clean up. */
       gal_list_data_free(cat);
@@ -481,7 +481,7 @@ match_catalog_write_one_row(struct matchparams *p, gal_data_t *a,
       /* Reverse the table and write it out. */
       gal_list_data_reverse(&cat);
       gal_table_write(cat, NULL, NULL, p->cp.tableformat,
-                      p->out1name, "MATCHED", 0);
+                      p->out1name, "MATCHED", 0, p->cp.numthreads);
       gal_list_data_free(cat);
     }
 
@@ -489,7 +489,7 @@ match_catalog_write_one_row(struct matchparams *p, gal_data_t *a,
      it ('a' will be freed in the higher-level function). */
   else
     gal_table_write(a, NULL, NULL, p->cp.tableformat, p->out1name,
-                    "MATCHED", 0);
+                    "MATCHED", 0, p->cp.numthreads);
 }
 
 
@@ -547,7 +547,7 @@ match_catalog_write_one_col(struct matchparams *p, gal_data_t *a,
   /* Reverse the table and write it out. */
   gal_list_data_reverse(&cat);
   gal_table_write(cat, NULL, NULL, p->cp.tableformat, p->out1name,
-                  "MATCHED", 0);
+                  "MATCHED", 0, p->cp.numthreads);
   gal_list_data_free(cat);
 }
 
@@ -590,7 +590,7 @@ match_catalog_kdtree_build(struct matchparams *p)
                             MATCH_KDTREE_ROOT_KEY, 0,
                             &root, 0, comment, 0, unit, 0);
   gal_table_write(kdtree, &keylist, NULL, GAL_TABLE_FORMAT_BFITS,
-                  p->out1name, "kdtree", 0);
+                  p->out1name, "kdtree", 0, p->cp.numthreads);
 
   /* Let the user know that the k-d tree has been built. */
   if(!p->cp.quiet)
@@ -812,7 +812,7 @@ match_catalog(struct matchparams *p)
 
       /* Write them into the table. */
       gal_table_write(mcols, NULL, NULL, p->cp.tableformat, p->logname,
-                      "LOG_INFO", 0);
+                      "LOG_INFO", 0, p->cp.numthreads);
 
       /* Set the comment pointer to NULL: they weren't allocated. */
       mcols->comment=NULL;
@@ -122,6 +122,7 @@ ui_initialize_options(struct matchparams *p,
           cp->coptions[i].doc="Extension name or number of first input.";
           break;
         case GAL_OPTIONS_KEY_TYPE:
+        case GAL_OPTIONS_KEY_COMPRESS:
           cp->coptions[i].flags=OPTION_HIDDEN;
           break;
         }
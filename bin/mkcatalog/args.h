@@ -84,6 +84,84 @@ struct argp_option program_options[] =
       GAL_OPTIONS_NOT_MANDATORY,
       GAL_OPTIONS_NOT_SET
     },
+    {
+      "bandfile",
+      UI_KEY_BANDFILE,
+      "FITS",
+      0,
+      "File of an extra band (can be called many times).",
+      GAL_OPTIONS_GROUP_INPUT,
+      &p->bandfile,
+      GAL_TYPE_STRLL,
+      GAL_OPTIONS_RANGE_ANY,
+      GAL_OPTIONS_NOT_MANDATORY,
+      GAL_OPTIONS_NOT_SET
+    },
+    {
+      "bandhdu",
+      UI_KEY_BANDHDU,
+      "STR",
+      0,
+      "HDU of an extra band (can be called many times).",
+      GAL_OPTIONS_GROUP_INPUT,
+      &p->bandhdu,
+      GAL_TYPE_STRLL,
+      GAL_OPTIONS_RANGE_ANY,
+      GAL_OPTIONS_NOT_MANDATORY,
+      GAL_OPTIONS_NOT_SET
+    },
+    {
+      "bandsky",
+      UI_KEY_BANDSKY,
+      "FITS/FLT",
+      0,
+      "Sky value or file of an extra band.",
+      GAL_OPTIONS_GROUP_INPUT,
+      &p->bandsky,
+      GAL_TYPE_STRLL,
+      GAL_OPTIONS_RANGE_ANY,
+      GAL_OPTIONS_NOT_MANDATORY,
+      GAL_OPTIONS_NOT_SET
+    },
+    {
+      "bandskyhdu",
+      UI_KEY_BANDSKYHDU,
+      "STR",
+      0,
+      "HDU of the Sky of an extra band.",
+      GAL_OPTIONS_GROUP_INPUT,
+      &p->bandskyhdu,
+      GAL_TYPE_STRLL,
+      GAL_OPTIONS_RANGE_ANY,
+      GAL_OPTIONS_NOT_MANDATORY,
+      GAL_OPTIONS_NOT_SET
+    },
+    {
+      "bandstd",
+      UI_KEY_BANDSTD,
+      "FITS/FLT",
+      0,
+      "Sky STD value or file of an extra band.",
+      GAL_OPTIONS_GROUP_INPUT,
+      &p->bandstd,
+      GAL_TYPE_STRLL,
+      GAL_OPTIONS_RANGE_ANY,
+      GAL_OPTIONS_NOT_MANDATORY,
+      GAL_OPTIONS_NOT_SET
+    },
+    {
+      "bandstdhdu",
+      UI_KEY_BANDSTDHDU,
+      "STR",
+      0,
+      "HDU of the Sky STD of an extra band.",
+      GAL_OPTIONS_GROUP_INPUT,
+      &p->bandstdhdu,
+      GAL_TYPE_STRLL,
+      GAL_OPTIONS_RANGE_ANY,
+      GAL_OPTIONS_NOT_MANDATORY,
+      GAL_OPTIONS_NOT_SET
+    },
     {
       "insky",
       UI_KEY_INSKY,
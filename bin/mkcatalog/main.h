@@ -217,6 +217,12 @@ struct mkcatalogparams
   char           *objectsfile;  /* Input filename.                      */
   char            *valuesfile;  /* File name of objects file.           */
   char             *valueshdu;  /* HDU of objects image.                */
+  gal_list_str_t    *bandfile;  /* Files of extra bands.                */
+  gal_list_str_t     *bandhdu;  /* HDUs of extra bands.                 */
+  gal_list_str_t     *bandsky;  /* Sky values or files of extra bands.  */
+  gal_list_str_t  *bandskyhdu;  /* HDUs of the Sky of extra bands.      */
+  gal_list_str_t     *bandstd;  /* Sky STD values or files of bands.    */
+  gal_list_str_t  *bandstdhdu;  /* HDUs of the Sky STD of extra bands.  */
   char            *clumpsfile;  /* File name of objects file.           */
   char             *clumpshdu;  /* HDU of objects image.                */
   char               *skyfile;  /* File name of sky file.               */
@@ -252,6 +258,7 @@ struct mkcatalogparams
   char           *relabclumps;  /* Name of new file for clump labels.   */
   time_t              rawtime;  /* Starting time of the program.        */
   gal_data_t          *values;  /* Input.                               */
+  size_t             numbands;  /* Number of extra bands.               */
   gal_data_t         *objects;  /* Object labels.                       */
   gal_data_t          *clumps;  /* Clump labels.                        */
   gal_data_t             *sky;  /* Sky.                                 */
@@ -267,6 +274,8 @@ struct mkcatalogparams
   gal_data_t      *objectcols;  /* Output columns for the objects.      */
   gal_data_t       *clumpcols;  /* Output columns for the clumps.       */
   gal_data_t           *tiles;  /* Tiles to cover each object.          */
+  gal_data_t         *objruns;  /* Runs of pixels in each object label. */
+  size_t           numobjruns;  /* Number of elements in 'objruns'.     */
   char            *objectsout;  /* Output objects catalog.              */
   char             *clumpsout;  /* Output clumps catalog.               */
   char            *upcheckout;  /* Name of upperlimit check table.      */
@@ -642,48 +642,106 @@ sort_clumps_by_objid(struct mkcatalogparams *p)
 
 
 
-/* Write the produced columns into the output */
+/* Write the object and clump catalogs. 'band' is zero for the main values
+   image and the band's counter (from 1) for the extra bands: each band's
+   catalogs are written in separate extensions (when the output is FITS)
+   or separate files (when the output is plain text). */
 static void
-mkcatalog_write_outputs(struct mkcatalogparams *p)
+mkcatalog_write_catalogs(struct mkcatalogparams *p, size_t band)
 {
-  size_t i, scounter;
-  char str[200], *fname;
   gal_fits_list_key_t *keylist;
   gal_list_str_t *comments=NULL;
   int outisfits=gal_fits_name_is_fits(p->objectsout);
+  char oext[40]="OBJECTS", cext[40]="CLUMPS", str[40];
+  char *oname=p->objectsout, *cname=p->clumpsout;
 
-  /* If a catalog is to be generated. */
-  if(p->objectcols)
+  /* Set the names of the extra band's outputs. */
+  if(band)
+    {
+      if(outisfits)
+        {
+          sprintf(oext, "OBJECTS_BAND%zu", band);
+          sprintf(cext, "CLUMPS_BAND%zu", band);
+        }
+      else
+        {
+          sprintf(str, "-band-%zu.txt", band);
+          oname=gal_checkset_automatic_output(&p->cp, p->objectsout, str);
+          if(p->clumps)
+            cname=gal_checkset_automatic_output(&p->cp, p->clumpsout, str);
+        }
+    }
+
+  /* OBJECT catalog */
+  keylist=mkcatalog_outputs_keys(p, 0);
+
+  /* Reverse the comments list (so it is printed in the same order
+     here), write the objects catalog and free the comments. */
+  gal_list_str_reverse(&comments);
+  gal_table_write(p->objectcols, &keylist, NULL, p->cp.tableformat,
+                  oname, oext, 0, p->cp.numthreads);
+  gal_list_str_free(comments, 1);
+
+
+  /* CLUMPS catalog */
+  if(p->clumps)
     {
-      /* OBJECT catalog */
-      keylist=mkcatalog_outputs_keys(p, 0);
+      /* Make the comments. */
+      keylist=mkcatalog_outputs_keys(p, 1);
 
-      /* Reverse the comments list (so it is printed in the same order
+      /* Write objects catalog
+         ---------------------
+
+         Reverse the comments list (so it is printed in the same order
          here), write the objects catalog and free the comments. */
       gal_list_str_reverse(&comments);
-      gal_table_write(p->objectcols, &keylist, NULL, p->cp.tableformat,
-                      p->objectsout, "OBJECTS", 0);
+      gal_table_write(p->clumpcols, NULL, comments, p->cp.tableformat,
+                      cname, cext, 0, p->cp.numthreads);
       gal_list_str_free(comments, 1);
+    }
 
-
-      /* CLUMPS catalog */
-      if(p->clumps)
+  /* Inform the user about the extra band's outputs (the main outputs are
+     reported at the end of 'mkcatalog_write_outputs'). */
+  if(band && !p->cp.quiet)
+    {
+      if(outisfits)
+        {
+          if(p->clumps)
+            printf("  - Band %zu catalogs in '%s' and '%s' extensions.\n",
+                   band, oext, cext);
+          else
+            printf("  - Band %zu catalog in '%s' extension.\n", band,
+                   oext);
+        }
+      else
         {
-          /* Make the comments. */
-          keylist=mkcatalog_outputs_keys(p, 1);
-
-          /* Write objects catalog
-             ---------------------
-
-             Reverse the comments list (so it is printed in the same order
-             here), write the objects catalog and free the comments. */
-          gal_list_str_reverse(&comments);
-          gal_table_write(p->clumpcols, NULL, comments, p->cp.tableformat,
-                          p->clumpsout, "CLUMPS", 0);
-          gal_list_str_free(comments, 1);
+          printf("  - Band %zu objects catalog: %s\n", band, oname);
+          if(p->clumps)
+            printf("  - Band %zu clumps catalog: %s\n", band, cname);
         }
     }
 
+  /* Clean up. */
+  if(oname!=p->objectsout) free(oname);
+  if(cname!=p->clumpsout) free(cname);
+}
+
+
+
+
+
+/* Write the produced columns into the output */
+static void
+mkcatalog_write_outputs(struct mkcatalogparams *p)
+{
+  size_t i, scounter;
+  char str[200], *fname;
+  int outisfits=gal_fits_name_is_fits(p->objectsout);
+
+  /* If a catalog is to be generated. */
+  if(p->objectcols)
+    mkcatalog_write_catalogs(p, 0);
+
   /* Spectra. */
   if(p->spectra)
     {
@@ -710,7 +768,7 @@ mkcatalog_write_outputs(struct mkcatalogparams *p)
                 sprintf(str, "SPECTRUM_%zu", i+1);
                 gal_table_write(&p->spectra[i], NULL, NULL,
                                 GAL_TABLE_FORMAT_BFITS,
-                                p->objectsout, str, 0);
+                                p->objectsout, str, 0, p->cp.numthreads);
               }
             else
               {
@@ -718,7 +776,7 @@ mkcatalog_write_outputs(struct mkcatalogparams *p)
                 fname=gal_checkset_automatic_output(&p->cp, p->objectsout,
                                                     str);
                 gal_table_write(&p->spectra[i], NULL, NULL, GAL_TABLE_FORMAT_TXT,
-                                fname, NULL, 0);
+                                fname, NULL, 0, p->cp.numthreads);
                 free(fname);
               }
           }
@@ -790,13 +848,10 @@ mkcatalog_write_outputs(struct mkcatalogparams *p)
 /*********************************************************************/
 /*****************       Top-level function        *******************/
 /*********************************************************************/
-void
-mkcatalog(struct mkcatalogparams *p)
+/* Fill all the columns using the current values image. */
+static void
+mkcatalog_measure(struct mkcatalogparams *p)
 {
-  /* When more than one thread is to be used, initialize the mutex: we need
-     it to assign a column to the clumps in the final catalog. */
-  if( p->cp.numthreads > 1 ) pthread_mutex_init(&p->mutex, NULL);
-
   /* Do the processing on each thread. */
   gal_threads_spin_off(mkcatalog_single_object, p, p->numobjects,
                        p->cp.numthreads, p->cp.minmapsize,
@@ -810,10 +865,91 @@ mkcatalog(struct mkcatalogparams *p)
      need to be made (possibly to both the objects and clumps catalogs). */
   if(p->hostobjid_c)
     sort_clumps_by_objid(p);
+}
+
+
+
+
+
+/* Measure the catalog(s) of each extra band. Everything that only depends
+   on the labels (the tiles and runs of each object, the output columns and
+   their metadata) was prepared once and is shared between the bands, so
+   only the measurements are repeated on each band. Every row of the
+   columns is over-written in each measurement, so they can be re-used.
+
+   Each band (and its own Sky and Sky standard deviation) is only read
+   when it is measured and freed afterwards (see 'ui_read_band'). While it
+   is measured, it is put in place of the values image (along with the
+   file names and values that depend on it, so the band's output has the
+   correct keywords). They are restored afterwards. The upper-limit check
+   table is only for the main values image (otherwise each band would
+   over-write it). */
+static void
+mkcatalog_bands(struct mkcatalogparams *p)
+{
+  size_t b;
+  float medstd=p->medstd, cpscorr=p->cpscorr;
+  uint8_t hasblank=p->hasblank;
+  int32_t checkuplim=p->checkuplim[0];
+  gal_data_t *values=p->values, *sky=p->sky, *std=p->std;
+  char *valueshdu=p->valueshdu, *usedvaluesfile=p->usedvaluesfile;
+  char *skyhdu=p->skyhdu, *usedskyfile=p->usedskyfile;
+  char *stdhdu=p->stdhdu, *usedstdfile=p->usedstdfile;
+
+  /* Go over the bands. */
+  p->checkuplim[0]=GAL_BLANK_INT32;
+  for(b=1; b<=p->numbands; ++b)
+    {
+      /* Read the band (and its Sky and STD) as the values image. */
+      ui_read_band(p, b);
+
+      /* Do the measurements and write the catalog(s). */
+      p->clumprowsfilled=0;
+      mkcatalog_measure(p);
+      mkcatalog_write_catalogs(p, b);
+
+      /* Free the band's datasets. */
+      gal_data_free(p->values);
+      if(p->sky) gal_data_free(p->sky);
+      if(p->std) gal_data_free(p->std);
+    }
+
+  /* Restore the main values image. */
+  p->std=std;
+  p->sky=sky;
+  p->values=values;
+  p->skyhdu=skyhdu;
+  p->stdhdu=stdhdu;
+  p->medstd=medstd;
+  p->cpscorr=cpscorr;
+  p->hasblank=hasblank;
+  p->valueshdu=valueshdu;
+  p->usedskyfile=usedskyfile;
+  p->usedstdfile=usedstdfile;
+  p->checkuplim[0]=checkuplim;
+  p->usedvaluesfile=usedvaluesfile;
+}
+
+
+
+
+
+void
+mkcatalog(struct mkcatalogparams *p)
+{
+  /* When more than one thread is to be used, initialize the mutex: we need
+     it to assign a column to the clumps in the final catalog. */
+  if( p->cp.numthreads > 1 ) pthread_mutex_init(&p->mutex, NULL);
+
+  /* Measure the columns on the main values image. */
+  mkcatalog_measure(p);
 
   /* Write the filled columns into the output. */
   mkcatalog_write_outputs(p);
 
+  /* Measure and write the catalogs of the extra bands. */
+  if(p->numbands) mkcatalog_bands(p);
+
   /* Destroy the mutex. */
   if( p->cp.numthreads>1 ) pthread_mutex_destroy(&p->mutex);
 }
@@ -423,7 +423,7 @@ parse_spectrum(struct mkcatalog_passparams *pp, gal_data_t *xybin)
 
   /* For a check.
   gal_table_write(pp->spectrum, NULL, NULL, GAL_TABLE_FORMAT_BFITS,
-                  "spectrum.fits", "SPECTRUM", 0);
+                  "spectrum.fits", "SPECTRUM", 0, 1);
   */
 }
 
@@ -431,6 +431,100 @@ parse_spectrum(struct mkcatalog_passparams *pp, gal_data_t *xybin)
 
 
 
+/* Index of a pixel in the 2D (XY) projection of a 3D tile. 'increment' is
+   the pixel's offset from the tile's first pixel (in the block). */
+static size_t
+parse_projection_index(struct mkcatalogparams *p, size_t *tsize,
+                       size_t increment)
+{
+  size_t *dsize=p->objects->dsize;
+  size_t inslice=increment % (dsize[1]*dsize[2]);
+  return (inslice / dsize[2]) * tsize[2] + inslice % dsize[2];
+}
+
+
+
+
+
+/* Groups of per-pixel measurements. The per-pixel loops below can update
+   many intermediate columns, but usually only a few of them are
+   requested. Checking the flag of each column for every pixel is
+   expensive: the flags are in memory (and since they are 'uint8_t', the
+   compiler has to assume every write into the (double) intermediate
+   arrays may have changed them). So before parsing the pixels, we put
+   the groups of columns that are needed in a local bit-flag and the
+   per-pixel loop only checks the columns within a group when the group
+   is necessary. */
+#define PARSE_GROUP_GEO     0x1   /* Geometric (value independent) sums.   */
+#define PARSE_GROUP_CGEO    0x2   /* Geometric sums over the clumps.       */
+#define PARSE_GROUP_VSUM    0x4   /* Sums of values.                       */
+#define PARSE_GROUP_CVSUM   0x8   /* Sums of values over the clumps.       */
+#define PARSE_GROUP_WHT     0x10  /* Measurements on positive values.      */
+#define PARSE_GROUP_CWHT    0x20  /* Positive measurements over clumps.    */
+#define PARSE_GROUP_VAR     0x40  /* Sky standard deviation measurements.  */
+#define PARSE_GROUP_POSEXT  0x80  /* Position extrema.                     */
+#define PARSE_GROUP_NUMALL  0x100 /* Number of pixels (also for extrema).  */
+
+static uint32_t
+parse_groups_objects(struct mkcatalog_passparams *pp)
+{
+  uint32_t out=0;
+  uint8_t *oif=pp->p->oiflag;
+
+  if( oif[ OCOL_GX ] || oif[ OCOL_GY ] || oif[ OCOL_GZ ] )
+    out |= PARSE_GROUP_GEO;
+  if( oif[    OCOL_C_NUMALL ] || oif[ OCOL_C_GX ]
+      || oif[ OCOL_C_GY     ] || oif[ OCOL_C_GZ ] )
+    out |= PARSE_GROUP_CGEO;
+  if( oif[ OCOL_NUM ] || oif[ OCOL_SUM ] || oif[ OCOL_SUMP2 ] )
+    out |= PARSE_GROUP_VSUM;
+  if( oif[ OCOL_C_NUM ] || oif[ OCOL_C_SUM ] )
+    out |= PARSE_GROUP_CVSUM;
+  if( oif[    OCOL_C_NUMWHT ] || oif[ OCOL_C_SUMWHT ]
+      || oif[ OCOL_C_VX     ] || oif[ OCOL_C_VY     ] || oif[ OCOL_C_VZ ] )
+    out |= PARSE_GROUP_CWHT;
+  if( (out & PARSE_GROUP_CWHT) || pp->shift
+      || oif[ OCOL_NUMWHT ] || oif[ OCOL_SUMWHT ]
+      || oif[ OCOL_VX     ] || oif[ OCOL_VY     ] || oif[ OCOL_VZ ] )
+    out |= PARSE_GROUP_WHT;
+  if( oif[ OCOL_SUMVAR ] || oif[ OCOL_SUM_VAR ] )
+    out |= PARSE_GROUP_VAR;
+  return out;
+}
+
+
+
+
+
+static uint32_t
+parse_groups_clumps(struct mkcatalog_passparams *pp)
+{
+  uint32_t out=0;
+  uint8_t *cif=pp->p->ciflag;
+
+  if( cif[ CCOL_GX ] || cif[ CCOL_GY ] || cif[ CCOL_GZ ] )
+    out |= PARSE_GROUP_GEO;
+  if( cif[    CCOL_MINX ] || cif[ CCOL_MAXX ]
+      || cif[ CCOL_MINY ] || cif[ CCOL_MAXY ]
+      || cif[ CCOL_MINZ ] || cif[ CCOL_MAXZ ] )
+    out |= PARSE_GROUP_POSEXT;
+  if( (out & PARSE_GROUP_POSEXT) || cif[ CCOL_NUMALL ] )
+    out |= PARSE_GROUP_NUMALL;
+  if( cif[ CCOL_NUM ] || cif[ CCOL_SUM ] || cif[ CCOL_SUMP2 ] )
+    out |= PARSE_GROUP_VSUM;
+  if( pp->shift
+      || cif[ CCOL_NUMWHT ] || cif[ CCOL_SUMWHT ]
+      || cif[ CCOL_VX     ] || cif[ CCOL_VY     ] || cif[ CCOL_VZ ] )
+    out |= PARSE_GROUP_WHT;
+  if( cif[ CCOL_SUMVAR ] || cif[ CCOL_SUM_VAR ] )
+    out |= PARSE_GROUP_VAR;
+  return out;
+}
+
+
+
+
+
 void
 parse_objects(struct mkcatalog_passparams *pp)
 {
@@ -441,9 +535,12 @@ parse_objects(struct mkcatalog_passparams *pp)
   double *oi=pp->oi;
   gal_data_t *xybin=NULL;
   size_t *tsize=pp->tile->dsize;
+  uint32_t og=parse_groups_objects(pp);
   uint8_t *u, *uf, goodvalue, *xybinarr=NULL;
   double minima_v=FLT_MAX, maxima_v=-FLT_MAX;
-  size_t d, pind=0, increment=0, num_increment=1;
+  size_t d, r, pind=0, increment;
+  size_t *runs=p->objruns[pp->object].array;
+  size_t numruns=p->objruns[pp->object].size/2;
   int32_t *O, *OO, *C=NULL, *objarr=p->objects->array;
   float var, sval, varval, skyval, *V=NULL, *SK=NULL, *ST=NULL;
   float *std=p->std?p->std->array:NULL, *sky=p->sky?p->sky->array:NULL;
@@ -499,216 +596,222 @@ parse_objects(struct mkcatalog_passparams *pp)
       xybinarr=xybin->array;
     }
 
-  /* Parse each contiguous patch of memory covered by this object. */
-  while( pp->start_end_inc[0] + increment <= pp->start_end_inc[1] )
+  /* Parse each run of pixels in this object (see 'gal_label_runs'). */
+  for(r=0;r<numruns;++r)
     {
-      /* Set the contiguous range to parse. The pixel-to-pixel counting
-         along the fastest dimension will be done over the 'O' pointer. */
+      /* Set the contiguous range to parse: 'increment' is the offset of
+         this run's first pixel from the tile's first pixel. The
+         pixel-to-pixel counting will be done over the 'O' pointer. */
+      increment = runs[2*r] - pp->start_end_inc[0];
       if( p->clumps            ) C  = pp->st_c   + increment;
       if( p->values            ) V  = pp->st_v   + increment;
       if( p->sky && pp->st_sky ) SK = pp->st_sky + increment;
       if( p->std && pp->st_std ) ST = pp->st_std + increment;
-      OO = ( O = pp->st_o + increment ) + tsize[ndim-1];
+      OO = ( O = pp->st_o + increment ) + runs[2*r+1];
 
-      /* Parse the tile. */
+      /* Index of the run's first pixel in the 2D projection. */
+      if(xybin) pind=parse_projection_index(p, tsize, increment);
+
+      /* Parse the run (all its pixels are in this object). */
       do
         {
-          /* If this pixel belongs to the requested object then do the
-             processing.  */
-          if( *O==pp->object )
-            {
-              /* INTERNAL: Get the number of clumps in this object: it is
-                 the largest clump ID over each object. */
-              if( p->clumps && *C>0 )
-                pp->clumpsinobj = *C > pp->clumpsinobj ? *C : pp->clumpsinobj;
+          /* INTERNAL: Get the number of clumps in this object: it is
+             the largest clump ID over each object. */
+          if( p->clumps && *C>0 )
+            pp->clumpsinobj = *C > pp->clumpsinobj ? *C : pp->clumpsinobj;
 
 
-              /* Add to the area of this object. */
-              if(xybin) xybinarr[ pind ]=1;
-              if(oif[ OCOL_NUMALL   ]) oi[ OCOL_NUMALL ]++;
+          /* Add to the area of this object. */
+          if(xybin) xybinarr[ pind ]=1;
+          if(oif[ OCOL_NUMALL   ]) oi[ OCOL_NUMALL ]++;
 
 
-              /* Geometric coordinate measurements. */
-              if(c)
-                {
-                  /* Convert the index to coordinate. */
-                  gal_dimension_index_to_coord(O-objarr, ndim, dsize, c);
+          /* Geometric coordinate measurements. */
+          if(c)
+            {
+              /* Convert the index to coordinate. */
+              gal_dimension_index_to_coord(O-objarr, ndim, dsize, c);
 
-                  /* If we need tile-ID, get the tile ID now. */
-                  if(tid!=GAL_BLANK_SIZE_T)
-                    tid=gal_tile_full_id_from_coord(&p->cp.tl, c);
+              /* If we need tile-ID, get the tile ID now. */
+              if(tid!=GAL_BLANK_SIZE_T)
+                tid=gal_tile_full_id_from_coord(&p->cp.tl, c);
 
-                  /* Do the general geometric (independent of pixel value)
-                     calculations. */
+              /* Do the general geometric (independent of pixel value)
+                 calculations. */
+              if(og & PARSE_GROUP_GEO)
+                {
                   if(oif[ OCOL_GX ]) oi[ OCOL_GX ] += c[ ndim-1 ]+1;
                   if(oif[ OCOL_GY ]) oi[ OCOL_GY ] += c[ ndim-2 ]+1;
                   if(oif[ OCOL_GZ ]) oi[ OCOL_GZ ] += c[ ndim-3 ]+1;
-                  if(pp->shift)
-                    {
-                      /* Calculate the shifted coordinates for second order
-                         calculations. The coordinate is incremented because
-                         from now on, the positions are in the FITS standard
-                         (starting from one).  */
-                      for(d=0;d<ndim;++d) sc[d] = c[d] + 1 - pp->shift[d];
-
-                      /* Include the shifted values, note that the second
-                         order moments are never needed independently, they
-                         are used together to find the ellipticity
-                         parameters. */
-                      oi[ OCOL_GXX ] += sc[1] * sc[1];
-                      oi[ OCOL_GYY ] += sc[0] * sc[0];
-                      oi[ OCOL_GXY ] += sc[1] * sc[0];
-                    }
-                  if(p->clumps && *C>0)
-                    {
-                      if(oif[ OCOL_C_NUMALL ]) oi[ OCOL_C_NUMALL ]++;
-                      if(oif[ OCOL_C_GX ]) oi[ OCOL_C_GX ] += c[ ndim-1 ]+1;
-                      if(oif[ OCOL_C_GY ]) oi[ OCOL_C_GY ] += c[ ndim-2 ]+1;
-                      if(oif[ OCOL_C_GZ ]) oi[ OCOL_C_GZ ] += c[ ndim-3 ]+1;
-                    }
                 }
+              if(pp->shift)
+                {
+                  /* Calculate the shifted coordinates for second order
+                     calculations. The coordinate is incremented because
+                     from now on, the positions are in the FITS standard
+                     (starting from one).  */
+                  for(d=0;d<ndim;++d) sc[d] = c[d] + 1 - pp->shift[d];
+
+                  /* Include the shifted values, note that the second
+                     order moments are never needed independently, they
+                     are used together to find the ellipticity
+                     parameters. */
+                  oi[ OCOL_GXX ] += sc[1] * sc[1];
+                  oi[ OCOL_GYY ] += sc[0] * sc[0];
+                  oi[ OCOL_GXY ] += sc[1] * sc[0];
+                }
+              if( (og & PARSE_GROUP_CGEO) && p->clumps && *C>0 )
+                {
+                  if(oif[ OCOL_C_NUMALL ]) oi[ OCOL_C_NUMALL ]++;
+                  if(oif[ OCOL_C_GX ]) oi[ OCOL_C_GX ] += c[ ndim-1 ]+1;
+                  if(oif[ OCOL_C_GY ]) oi[ OCOL_C_GY ] += c[ ndim-2 ]+1;
+                  if(oif[ OCOL_C_GZ ]) oi[ OCOL_C_GZ ] += c[ ndim-3 ]+1;
+                }
+            }
 
 
-              /* Value related measurements. */
-              goodvalue=0;
-              if( p->values && !( p->hasblank && isnan(*V) ) )
-                {
-                  /* For the standard-deviation measurements later. */
-                  goodvalue=1;
+          /* Value related measurements. */
+          goodvalue=0;
+          if( p->values && !( p->hasblank && isnan(*V) ) )
+            {
+              /* For the standard-deviation measurements later. */
+              goodvalue=1;
 
-                  /* General flux summations. */
-                  if(xybin) xybinarr[ pind ]=2;
+              /* General flux summations. */
+              if(xybin) xybinarr[ pind ]=2;
+              if(og & PARSE_GROUP_VSUM)
+                {
                   if(oif[ OCOL_NUM ])   oi[ OCOL_NUM   ]++;
                   if(oif[ OCOL_SUM ])   oi[ OCOL_SUM   ] += *V;
                   if(oif[ OCOL_SUMP2 ]) oi[ OCOL_SUMP2 ] += *V * *V;
+                }
 
-                  /* Get the necessary clump information. */
-                  if(p->clumps && *C>0)
+              /* Get the necessary clump information. */
+              if( (og & PARSE_GROUP_CVSUM) && p->clumps && *C>0 )
+                {
+                  if(oif[ OCOL_C_NUM ]) oi[ OCOL_C_NUM ]++;
+                  if(oif[ OCOL_C_SUM ]) oi[ OCOL_C_SUM ] += *V;
+                }
+
+              /* Get the extrema of the values. Note that if the minima
+                 or maxima value's coordinates are requested in any
+                 dimension, then 'OCOL_MINVNUM' or 'OCOL_MAXVNUM' will
+                 be activated). */
+              if( oif[ OCOL_MINVNUM ] && *V<=minima_v )
+                {
+                  /* If the value is smaller than the smallest found so
+                     far, reset the counter to one, and reset the sum
+                     of positions this one's position. */
+                  if( *V<minima_v )
                     {
-                      if(oif[ OCOL_C_NUM ]) oi[ OCOL_C_NUM ]++;
-                      if(oif[ OCOL_C_SUM ]) oi[ OCOL_C_SUM ] += *V;
+                      minima_v = *V;
+                      oi[ OCOL_MINVNUM ]=1;
+                      if(oif[OCOL_MINVX]) oi[ OCOL_MINVX ] = c[ ndim-1 ]+1;
+                      if(oif[OCOL_MINVY]) oi[ OCOL_MINVY ] = c[ ndim-2 ]+1;
+                      if(oif[OCOL_MINVZ]) oi[ OCOL_MINVZ ] = c[ ndim-3 ]+1;
                     }
-
-                  /* Get the extrema of the values. Note that if the minima
-                     or maxima value's coordinates are requested in any
-                     dimension, then 'OCOL_MINVNUM' or 'OCOL_MAXVNUM' will
-                     be activated). */
-                  if( oif[ OCOL_MINVNUM ] && *V<=minima_v )
+                  else
                     {
-                      /* If the value is smaller than the smallest found so
-                         far, reset the counter to one, and reset the sum
-                         of positions this one's position. */
-                      if( *V<minima_v )
-                        {
-                          minima_v = *V;
-                          oi[ OCOL_MINVNUM ]=1;
-                          if(oif[OCOL_MINVX]) oi[ OCOL_MINVX ] = c[ ndim-1 ]+1;
-                          if(oif[OCOL_MINVY]) oi[ OCOL_MINVY ] = c[ ndim-2 ]+1;
-                          if(oif[OCOL_MINVZ]) oi[ OCOL_MINVZ ] = c[ ndim-3 ]+1;
-                        }
-                      else
-                        {
-                          oi[ OCOL_MINVNUM ]++;
-                          if(oif[OCOL_MINVX]) oi[ OCOL_MINVX ] += c[ ndim-1 ]+1;
-                          if(oif[OCOL_MINVY]) oi[ OCOL_MINVY ] += c[ ndim-2 ]+1;
-                          if(oif[OCOL_MINVZ]) oi[ OCOL_MINVZ ] += c[ ndim-3 ]+1;
-                        }
+                      oi[ OCOL_MINVNUM ]++;
+                      if(oif[OCOL_MINVX]) oi[ OCOL_MINVX ] += c[ ndim-1 ]+1;
+                      if(oif[OCOL_MINVY]) oi[ OCOL_MINVY ] += c[ ndim-2 ]+1;
+                      if(oif[OCOL_MINVZ]) oi[ OCOL_MINVZ ] += c[ ndim-3 ]+1;
                     }
-                  if( oif[ OCOL_MAXVNUM ] && *V>=maxima_v )
+                }
+              if( oif[ OCOL_MAXVNUM ] && *V>=maxima_v )
+                {
+                  if( *V>maxima_v )
                     {
-                      if( *V>maxima_v )
-                        {
-                          maxima_v = *V;
-                          oi[ OCOL_MAXVNUM ]=1;
-                          if(oif[OCOL_MAXVX]) oi[ OCOL_MAXVX ] = c[ ndim-1 ]+1;
-                          if(oif[OCOL_MAXVY]) oi[ OCOL_MAXVY ] = c[ ndim-2 ]+1;
-                          if(oif[OCOL_MAXVZ]) oi[ OCOL_MAXVZ ] = c[ ndim-3 ]+1;
-                        }
-                      else
-                        {
-                          oi[ OCOL_MAXVNUM ]++;
-                          if(oif[OCOL_MAXVX]) oi[ OCOL_MAXVX ] += c[ ndim-1 ]+1;
-                          if(oif[OCOL_MAXVY]) oi[ OCOL_MAXVY ] += c[ ndim-2 ]+1;
-                          if(oif[OCOL_MAXVZ]) oi[ OCOL_MAXVZ ] += c[ ndim-3 ]+1;
-                        }
+                      maxima_v = *V;
+                      oi[ OCOL_MAXVNUM ]=1;
+                      if(oif[OCOL_MAXVX]) oi[ OCOL_MAXVX ] = c[ ndim-1 ]+1;
+                      if(oif[OCOL_MAXVY]) oi[ OCOL_MAXVY ] = c[ ndim-2 ]+1;
+                      if(oif[OCOL_MAXVZ]) oi[ OCOL_MAXVZ ] = c[ ndim-3 ]+1;
                     }
-
-                  /* For flux weighted centers, we can only use positive
-                     values, so do those measurements here. */
-                  if( *V > 0.0f )
+                  else
                     {
-                      if(oif[ OCOL_NUMWHT ]) oi[ OCOL_NUMWHT ]++;
-                      if(oif[ OCOL_SUMWHT ]) oi[ OCOL_SUMWHT ] += *V;
-                      if(oif[ OCOL_VX ]) oi[ OCOL_VX ] += *V*(c[ ndim-1 ]+1);
-                      if(oif[ OCOL_VY ]) oi[ OCOL_VY ] += *V*(c[ ndim-2 ]+1);
-                      if(oif[ OCOL_VZ ]) oi[ OCOL_VZ ] += *V*(c[ ndim-3 ]+1);
-                      if(pp->shift)
-                        {
-                          oi[ OCOL_VXX    ] += *V * sc[1] * sc[1];
-                          oi[ OCOL_VYY    ] += *V * sc[0] * sc[0];
-                          oi[ OCOL_VXY    ] += *V * sc[1] * sc[0];
-                        }
-                      if(p->clumps && *C>0)
-                        {
-                          if(oif[ OCOL_C_NUMWHT ]) oi[ OCOL_C_NUMWHT ]++;
-                          if(oif[ OCOL_C_SUMWHT ]) oi[ OCOL_C_SUMWHT ] += *V;
-                          if(oif[ OCOL_C_VX ])
-                            oi[   OCOL_C_VX ] += *V * (c[ ndim-1 ]+1);
-                          if(oif[ OCOL_C_VY ])
-                            oi[   OCOL_C_VY ] += *V * (c[ ndim-2 ]+1);
-                          if(oif[ OCOL_C_VZ ])
-                            oi[   OCOL_C_VZ ] += *V * (c[ ndim-3 ]+1);
-                        }
+                      oi[ OCOL_MAXVNUM ]++;
+                      if(oif[OCOL_MAXVX]) oi[ OCOL_MAXVX ] += c[ ndim-1 ]+1;
+                      if(oif[OCOL_MAXVY]) oi[ OCOL_MAXVY ] += c[ ndim-2 ]+1;
+                      if(oif[OCOL_MAXVZ]) oi[ OCOL_MAXVZ ] += c[ ndim-3 ]+1;
                     }
                 }
 
-
-              /* Sky value based measurements. */
-              if(p->sky && oif[ OCOL_SUMSKY ])
+              /* For flux weighted centers, we can only use positive
+                 values, so do those measurements here. */
+              if( (og & PARSE_GROUP_WHT) && *V > 0.0f )
                 {
-                  skyval = ( pp->st_sky
-                             ? (isnan(*SK)?0:*SK)               /* Full array  */
-                             : ( p->sky->size>1
-                                 ? (isnan(sky[tid])?0:sky[tid]) /* Tile        */
-                                 : sky[0] ) );                  /* Single value*/
-                  if(!isnan(skyval))
+                  if(oif[ OCOL_NUMWHT ]) oi[ OCOL_NUMWHT ]++;
+                  if(oif[ OCOL_SUMWHT ]) oi[ OCOL_SUMWHT ] += *V;
+                  if(oif[ OCOL_VX ]) oi[ OCOL_VX ] += *V*(c[ ndim-1 ]+1);
+                  if(oif[ OCOL_VY ]) oi[ OCOL_VY ] += *V*(c[ ndim-2 ]+1);
+                  if(oif[ OCOL_VZ ]) oi[ OCOL_VZ ] += *V*(c[ ndim-3 ]+1);
+                  if(pp->shift)
                     {
-                      oi[ OCOL_NUMSKY  ]++;
-                      oi[ OCOL_SUMSKY  ] += skyval;
+                      oi[ OCOL_VXX    ] += *V * sc[1] * sc[1];
+                      oi[ OCOL_VYY    ] += *V * sc[0] * sc[0];
+                      oi[ OCOL_VXY    ] += *V * sc[1] * sc[0];
+                    }
+                  if( (og & PARSE_GROUP_CWHT) && p->clumps && *C>0 )
+                    {
+                      if(oif[ OCOL_C_NUMWHT ]) oi[ OCOL_C_NUMWHT ]++;
+                      if(oif[ OCOL_C_SUMWHT ]) oi[ OCOL_C_SUMWHT ] += *V;
+                      if(oif[ OCOL_C_VX ])
+                        oi[   OCOL_C_VX ] += *V * (c[ ndim-1 ]+1);
+                      if(oif[ OCOL_C_VY ])
+                        oi[   OCOL_C_VY ] += *V * (c[ ndim-2 ]+1);
+                      if(oif[ OCOL_C_VZ ])
+                        oi[   OCOL_C_VZ ] += *V * (c[ ndim-3 ]+1);
                     }
                 }
+            }
 
 
-              /* Sky standard deviation based measurements.*/
-              if(p->std)
+          /* Sky value based measurements. */
+          if(p->sky && oif[ OCOL_SUMSKY ])
+            {
+              skyval = ( pp->st_sky
+                         ? (isnan(*SK)?0:*SK)               /* Full array  */
+                         : ( p->sky->size>1
+                             ? (isnan(sky[tid])?0:sky[tid]) /* Tile        */
+                             : sky[0] ) );                  /* Single value*/
+              if(!isnan(skyval))
                 {
-                  /* Calculate the variance and save it in the output if necessary. */
-                  sval = pp->st_std ? *ST : (p->std->size>1?std[tid]:std[0]);
-                  var = p->variance ? sval : sval*sval;
-                  if(oif[ OCOL_SUMVAR ] && (!isnan(var)))
-                    {
-                      oi[ OCOL_NUMVAR  ]++;
-                      oi[ OCOL_SUMVAR  ] += var;
-                    }
+                  oi[ OCOL_NUMSKY  ]++;
+                  oi[ OCOL_SUMSKY  ] += skyval;
+                }
+            }
+
+
+          /* Sky standard deviation based measurements.*/
+          if( (og & PARSE_GROUP_VAR) && p->std )
+            {
+              /* Calculate the variance and save it in the output if necessary. */
+              sval = pp->st_std ? *ST : (p->std->size>1?std[tid]:std[0]);
+              var = p->variance ? sval : sval*sval;
+              if(oif[ OCOL_SUMVAR ] && (!isnan(var)))
+                {
+                  oi[ OCOL_NUMVAR  ]++;
+                  oi[ OCOL_SUMVAR  ] += var;
+                }
 
-                  /* For each pixel, we have a sky contribution to the
-                     counts and the signal's contribution. The standard
-                     deviation in the sky is simply 'sval', but the
-                     standard deviation of the signal (independent of the
-                     sky) is 'sqrt(*V)'. Therefore the total variance of
-                     this pixel is the variance of the sky added with the
-                     absolute value of its sky-subtracted flux. We use the
-                     absolute value, because especially as the signal gets
-                     noisy there will be negative values, and we don't want
-                     them to decrease the variance. */
-                  if(oif[ OCOL_SUM_VAR ] && goodvalue)
+              /* For each pixel, we have a sky contribution to the
+                 counts and the signal's contribution. The standard
+                 deviation in the sky is simply 'sval', but the
+                 standard deviation of the signal (independent of the
+                 sky) is 'sqrt(*V)'. Therefore the total variance of
+                 this pixel is the variance of the sky added with the
+                 absolute value of its sky-subtracted flux. We use the
+                 absolute value, because especially as the signal gets
+                 noisy there will be negative values, and we don't want
+                 them to decrease the variance. */
+              if(oif[ OCOL_SUM_VAR ] && goodvalue)
+                {
+                  varval=p->variance ? var : sval;
+                  if(!isnan(varval))
                     {
-                      varval=p->variance ? var : sval;
-                      if(!isnan(varval))
-                        {
-                          oi[ OCOL_SUM_VAR_NUM  ]++;
-                          oi[ OCOL_SUM_VAR      ] += varval + fabs(*V);
-                        }
+                      oi[ OCOL_SUM_VAR_NUM  ]++;
+                      oi[ OCOL_SUM_VAR      ] += varval + fabs(*V);
                     }
                 }
             }
@@ -721,15 +824,6 @@ parse_objects(struct mkcatalog_passparams *pp)
           if( p->std && pp->st_std ) ++ST;
         }
       while(++O<OO);
-
-      /* Increment to the next contiguous region of this tile. */
-      increment += ( gal_tile_block_increment(p->objects, tsize,
-                                              num_increment++, NULL) );
-
-      /* If a 2D projection is requested, see if we should initialize (set
-         to zero) the projection-index ('pind') not. */
-      if(xybin && (num_increment-1)%tsize[1]==0 )
-        pind=0;
     }
 
   /* Write the projected area columns. */
@@ -748,7 +842,7 @@ parse_objects(struct mkcatalog_passparams *pp)
       /* For a check on the projected 2D areas.
       if(xybin && pp->object==2)
         {
-          gal_fits_img_write(xybin, "xybin.fits", NULL, NULL);
+          gal_fits_img_write(xybin, "xybin.fits", NULL, NULL, 0);
           exit(0);
         }
       */
@@ -826,10 +920,13 @@ parse_clumps(struct mkcatalog_passparams *pp)
   gal_data_t *xybin=NULL;
   int32_t *O, *OO, *C=NULL, nlab;
   size_t cind, *tsize=pp->tile->dsize;
+  uint32_t cg=parse_groups_clumps(pp);
   double *minima_v=NULL, *maxima_v=NULL;
   uint8_t *u, *uf, goodvalue, *cif=p->ciflag;
   size_t nngb=gal_dimension_num_neighbors(ndim);
-  size_t i, ii, d, pind=0, increment=0, num_increment=1;
+  size_t i, ii, d, r, pind=0, increment;
+  size_t *runs=p->objruns[pp->object].array;
+  size_t numruns=p->objruns[pp->object].size/2;
   float var, sval, varval, skyval, *V=NULL, *SK=NULL, *ST=NULL;
   int32_t *objects=p->objects->array, *clumps=p->clumps->array;
   float *std=p->std?p->std->array:NULL, *sky=p->sky?p->sky->array:NULL;
@@ -901,48 +998,47 @@ parse_clumps(struct mkcatalog_passparams *pp)
       || cif[ CCOL_MAXVY   ] || cif[ CCOL_MAXVZ ] )
     maxima_v=parse_init_extrema(cif, GAL_TYPE_FLOAT64, pp->clumpsinobj, 1);
 
-  /* Parse each contiguous patch of memory covered by this object. */
-  while( pp->start_end_inc[0] + increment <= pp->start_end_inc[1] )
+  /* Parse each run of pixels in this object (see 'gal_label_runs'). */
+  for(r=0;r<numruns;++r)
     {
-      /* Set the contiguous range to parse. The pixel-to-pixel counting
-         along the fastest dimension will be done over the 'O' pointer. */
+      /* Set the contiguous range to parse: 'increment' is the offset of
+         this run's first pixel from the tile's first pixel. The
+         pixel-to-pixel counting will be done over the 'O' pointer. */
+      increment = runs[2*r] - pp->start_end_inc[0];
       C = pp->st_c + increment;
       if( p->values            ) V  = pp->st_v   + increment;
       if( p->sky && pp->st_sky ) SK = pp->st_sky + increment;
       if( p->std && pp->st_std ) ST = pp->st_std + increment;
-      OO = ( O = pp->st_o + increment ) + tsize[ndim-1];
+      OO = ( O = pp->st_o + increment ) + runs[2*r+1];
+
+      /* Index of the run's first pixel in the 2D projection. */
+      if(xybin) pind=parse_projection_index(p, tsize, increment);
 
-      /* Parse the tile */
+      /* Parse the run (all its pixels are in this object). */
       do
         {
-          /* If this pixel belongs to the requested object then do the
-             processing. */
-          if( *O==pp->object )
+          /* We are on a clump. */
+          if(p->clumps && *C>0)
             {
-              /* We are on a clump. */
-              if(p->clumps && *C>0)
+              /* Pointer to make things easier. Note that the clump
+                 labels start from 1, but the array indexs from 0.*/
+              cind = *C-1;
+              ci=&pp->ci[ cind * CCOL_NUMCOLS ];
+
+              /* Add to the area of this object. */
+              if(cg & PARSE_GROUP_NUMALL) ci[ CCOL_NUMALL ]++;
+              if(cif[ CCOL_NUMALLXY ])
+                ((uint8_t *)(xybin[cind].array))[ pind ] = 1;
+
+              /* Raw-position related measurements. */
+              if(c)
                 {
-                  /* Pointer to make things easier. Note that the clump
-                     labels start from 1, but the array indexs from 0.*/
-                  cind = *C-1;
-                  ci=&pp->ci[ cind * CCOL_NUMCOLS ];
-
-                  /* Add to the area of this object. */
-                  if( cif[ CCOL_NUMALL ]
-                      || cif[ CCOL_MINX ] || cif[ CCOL_MAXX ]
-                      || cif[ CCOL_MINY ] || cif[ CCOL_MAXY ]
-                      || cif[ CCOL_MINZ ] || cif[ CCOL_MAXZ ] )
-                    ci[ CCOL_NUMALL ]++;
-                  if(cif[ CCOL_NUMALLXY ])
-                    ((uint8_t *)(xybin[cind].array))[ pind ] = 1;
-
-                  /* Raw-position related measurements. */
-                  if(c)
-                    {
-                      /* Get "C" the coordinates of this point. */
-                      gal_dimension_index_to_coord(O-objects, ndim, dsize, c);
+                  /* Get "C" the coordinates of this point. */
+                  gal_dimension_index_to_coord(O-objects, ndim, dsize, c);
 
-                      /* Position extrema measurements. */
+                  /* Position extrema measurements. */
+                  if(cg & PARSE_GROUP_POSEXT)
+                    {
                       if(cif[ CCOL_MINX ])
                         ci[CCOL_MINX]=CMIN(CCOL_MINX, ndim-1);
                       if(cif[ CCOL_MAXX ])
@@ -955,207 +1051,213 @@ parse_clumps(struct mkcatalog_passparams *pp)
                         ci[CCOL_MINZ]=CMIN(CCOL_MINZ, ndim-3);
                       if(cif[ CCOL_MAXZ ])
                         ci[CCOL_MAXZ]=CMAX(CCOL_MAXZ, ndim-3);
+                    }
 
-                      /* If we need tile-ID, get the tile ID now. */
-                      if(tid!=GAL_BLANK_SIZE_T)
-                        tid=gal_tile_full_id_from_coord(&p->cp.tl, c);
+                  /* If we need tile-ID, get the tile ID now. */
+                  if(tid!=GAL_BLANK_SIZE_T)
+                    tid=gal_tile_full_id_from_coord(&p->cp.tl, c);
 
-                      /* General geometric (independent of pixel value)
-                         calculations. */
+                  /* General geometric (independent of pixel value)
+                     calculations. */
+                  if(cg & PARSE_GROUP_GEO)
+                    {
                       if(cif[ CCOL_GX ]) ci[ CCOL_GX ] += c[ ndim-1 ]+1;
                       if(cif[ CCOL_GY ]) ci[ CCOL_GY ] += c[ ndim-2 ]+1;
                       if(cif[ CCOL_GZ ]) ci[ CCOL_GZ ] += c[ ndim-3 ]+1;
-                      if(pp->shift)
-                        {
-                          /* Shifted coordinates for second order moments,
-                             see explanations in the first pass.*/
-                          for(d=0;d<ndim;++d) sc[d] = c[d] + 1 - pp->shift[d];
-
-                          /* Raw second-order measurements. */
-                          ci[ CCOL_GXX ] += sc[1] * sc[1];
-                          ci[ CCOL_GYY ] += sc[0] * sc[0];
-                          ci[ CCOL_GXY ] += sc[1] * sc[0];
-                        }
                     }
-
-                  /* Value related measurements, see 'parse_objects' for
-                     comments. */
-                  goodvalue=0;
-                  if( p->values && !( p->hasblank && isnan(*V) ) )
+                  if(pp->shift)
                     {
-                      /* For the standard-deviation measurement. */
-                      goodvalue=1;
+                      /* Shifted coordinates for second order moments,
+                         see explanations in the first pass.*/
+                      for(d=0;d<ndim;++d) sc[d] = c[d] + 1 - pp->shift[d];
+
+                      /* Raw second-order measurements. */
+                      ci[ CCOL_GXX ] += sc[1] * sc[1];
+                      ci[ CCOL_GYY ] += sc[0] * sc[0];
+                      ci[ CCOL_GXY ] += sc[1] * sc[0];
+                    }
+                }
+
+              /* Value related measurements, see 'parse_objects' for
+                 comments. */
+              goodvalue=0;
+              if( p->values && !( p->hasblank && isnan(*V) ) )
+                {
+                  /* For the standard-deviation measurement. */
+                  goodvalue=1;
 
-                      /* Fill in the necessary information. */
+                  /* Fill in the necessary information. */
+                  if(cg & PARSE_GROUP_VSUM)
+                    {
                       if(cif[ CCOL_NUM   ]) ci[ CCOL_NUM   ]++;
                       if(cif[ CCOL_SUM   ]) ci[ CCOL_SUM   ] += *V;
                       if(cif[ CCOL_SUMP2 ]) ci[ CCOL_SUMP2 ] += *V * *V;
-                      if(cif[ CCOL_NUMXY ])
-                        ((uint8_t *)(xybin[cind].array))[ pind ] = 2;
+                    }
+                  if(cif[ CCOL_NUMXY ])
+                    ((uint8_t *)(xybin[cind].array))[ pind ] = 2;
 
-                      /* Minimum/maximum pixel positions. */
-                      if( cif[ CCOL_MINVNUM ] && *V<=minima_v[cind] )
+                  /* Minimum/maximum pixel positions. */
+                  if( cif[ CCOL_MINVNUM ] && *V<=minima_v[cind] )
+                    {
+                      if( *V<minima_v[cind] )
                         {
-                          if( *V<minima_v[cind] )
-                            {
-                              minima_v[cind] = *V;
-                              ci[ CCOL_MINVNUM ]=1;
-                              if(cif[CCOL_MINVX]) ci[ CCOL_MINVX ] = c[ ndim-1 ]+1;
-                              if(cif[CCOL_MINVY]) ci[ CCOL_MINVY ] = c[ ndim-2 ]+1;
-                              if(cif[CCOL_MINVZ]) ci[ CCOL_MINVZ ] = c[ ndim-3 ]+1;
-                            }
-                          else
-                            {
-                              ci[ CCOL_MINVNUM ]++;
-                              if(cif[CCOL_MINVX]) ci[ CCOL_MINVX ] += c[ ndim-1 ]+1;
-                              if(cif[CCOL_MINVY]) ci[ CCOL_MINVY ] += c[ ndim-2 ]+1;
-                              if(cif[CCOL_MINVZ]) ci[ CCOL_MINVZ ] += c[ ndim-3 ]+1;
-                            }
+                          minima_v[cind] = *V;
+                          ci[ CCOL_MINVNUM ]=1;
+                          if(cif[CCOL_MINVX]) ci[ CCOL_MINVX ] = c[ ndim-1 ]+1;
+                          if(cif[CCOL_MINVY]) ci[ CCOL_MINVY ] = c[ ndim-2 ]+1;
+                          if(cif[CCOL_MINVZ]) ci[ CCOL_MINVZ ] = c[ ndim-3 ]+1;
                         }
-                      if( cif[ CCOL_MAXVNUM ] && *V>=maxima_v[cind] )
+                      else
                         {
-                          if( *V>maxima_v[cind] )
-                            {
-                              maxima_v[cind] = *V;
-                              ci[ CCOL_MAXVNUM ]=1;
-                              if(cif[CCOL_MAXVX]) ci[ CCOL_MAXVX ] = c[ ndim-1 ]+1;
-                              if(cif[CCOL_MAXVY]) ci[ CCOL_MAXVY ] = c[ ndim-2 ]+1;
-                              if(cif[CCOL_MAXVZ]) ci[ CCOL_MAXVZ ] = c[ ndim-3 ]+1;
-                            }
-                          else
-                            {
-                              ci[ CCOL_MAXVNUM ]++;
-                              if(cif[CCOL_MAXVX]) ci[ CCOL_MAXVX ] += c[ ndim-1 ]+1;
-                              if(cif[CCOL_MAXVY]) ci[ CCOL_MAXVY ] += c[ ndim-2 ]+1;
-                              if(cif[CCOL_MAXVZ]) ci[ CCOL_MAXVZ ] += c[ ndim-3 ]+1;
-                            }
+                          ci[ CCOL_MINVNUM ]++;
+                          if(cif[CCOL_MINVX]) ci[ CCOL_MINVX ] += c[ ndim-1 ]+1;
+                          if(cif[CCOL_MINVY]) ci[ CCOL_MINVY ] += c[ ndim-2 ]+1;
+                          if(cif[CCOL_MINVZ]) ci[ CCOL_MINVZ ] += c[ ndim-3 ]+1;
                         }
-
-                      /* Columns that need positive values. */
-                      if( *V > 0.0f )
+                    }
+                  if( cif[ CCOL_MAXVNUM ] && *V>=maxima_v[cind] )
+                    {
+                      if( *V>maxima_v[cind] )
+                        {
+                          maxima_v[cind] = *V;
+                          ci[ CCOL_MAXVNUM ]=1;
+                          if(cif[CCOL_MAXVX]) ci[ CCOL_MAXVX ] = c[ ndim-1 ]+1;
+                          if(cif[CCOL_MAXVY]) ci[ CCOL_MAXVY ] = c[ ndim-2 ]+1;
+                          if(cif[CCOL_MAXVZ]) ci[ CCOL_MAXVZ ] = c[ ndim-3 ]+1;
+                        }
+                      else
                         {
-                          if(cif[ CCOL_NUMWHT ]) ci[ CCOL_NUMWHT ]++;
-                          if(cif[ CCOL_SUMWHT ]) ci[ CCOL_SUMWHT ] += *V;
-                          if(cif[ CCOL_VX ])
-                            ci[   CCOL_VX ] += *V * (c[ ndim-1 ]+1);
-                          if(cif[ CCOL_VY ])
-                            ci[   CCOL_VY ] += *V * (c[ ndim-2 ]+1);
-                          if(cif[ CCOL_VZ ])
-                            ci[   CCOL_VZ ] += *V * (c[ ndim-3 ]+1);
-                          if(pp->shift)
-                            {
-                              ci[ CCOL_VXX ] += *V * sc[1] * sc[1];
-                              ci[ CCOL_VYY ] += *V * sc[0] * sc[0];
-                              ci[ CCOL_VXY ] += *V * sc[1] * sc[0];
-                            }
+                          ci[ CCOL_MAXVNUM ]++;
+                          if(cif[CCOL_MAXVX]) ci[ CCOL_MAXVX ] += c[ ndim-1 ]+1;
+                          if(cif[CCOL_MAXVY]) ci[ CCOL_MAXVY ] += c[ ndim-2 ]+1;
+                          if(cif[CCOL_MAXVZ]) ci[ CCOL_MAXVZ ] += c[ ndim-3 ]+1;
                         }
                     }
 
-                  /* Sky based measurements. */
-                  if(p->sky && cif[ CCOL_SUMSKY ])
+                  /* Columns that need positive values. */
+                  if( (cg & PARSE_GROUP_WHT) && *V > 0.0f )
                     {
-                      skyval = ( pp->st_sky
-                                 ? *SK             /* Full. */
-                                 : ( p->sky->size>1
-                                     ? sky[tid]    /* Tile. */
-                                     : sky[0] ) ); /* 1 value. */
-                      if(!isnan(skyval))
+                      if(cif[ CCOL_NUMWHT ]) ci[ CCOL_NUMWHT ]++;
+                      if(cif[ CCOL_SUMWHT ]) ci[ CCOL_SUMWHT ] += *V;
+                      if(cif[ CCOL_VX ])
+                        ci[   CCOL_VX ] += *V * (c[ ndim-1 ]+1);
+                      if(cif[ CCOL_VY ])
+                        ci[   CCOL_VY ] += *V * (c[ ndim-2 ]+1);
+                      if(cif[ CCOL_VZ ])
+                        ci[   CCOL_VZ ] += *V * (c[ ndim-3 ]+1);
+                      if(pp->shift)
                         {
-                          ci[ CCOL_NUMSKY  ]++;
-                          ci[ CCOL_SUMSKY  ] += skyval;
+                          ci[ CCOL_VXX ] += *V * sc[1] * sc[1];
+                          ci[ CCOL_VYY ] += *V * sc[0] * sc[0];
+                          ci[ CCOL_VXY ] += *V * sc[1] * sc[0];
                         }
                     }
+                }
 
-                  /* Sky Standard deviation based measurements, see
-                     'parse_objects' for comments. */
-                  if(p->std)
+              /* Sky based measurements. */
+              if(p->sky && cif[ CCOL_SUMSKY ])
+                {
+                  skyval = ( pp->st_sky
+                             ? *SK             /* Full. */
+                             : ( p->sky->size>1
+                                 ? sky[tid]    /* Tile. */
+                                 : sky[0] ) ); /* 1 value. */
+                  if(!isnan(skyval))
                     {
-                      sval = ( pp->st_std
-                               ? *ST
-                               : (p->std->size>1 ? std[tid] : std[0]) );
-                      var = p->variance ? sval : sval*sval;
-                      if(cif[ CCOL_SUMVAR  ] && (!isnan(var)))
-                        {
-                          ci[ CCOL_NUMVAR ]++;
-                          ci[ CCOL_SUMVAR ] += var;
-                        }
-                      if(cif[ CCOL_SUM_VAR ] && goodvalue)
+                      ci[ CCOL_NUMSKY  ]++;
+                      ci[ CCOL_SUMSKY  ] += skyval;
+                    }
+                }
+
+              /* Sky Standard deviation based measurements, see
+                 'parse_objects' for comments. */
+              if( (cg & PARSE_GROUP_VAR) && p->std )
+                {
+                  sval = ( pp->st_std
+                           ? *ST
+                           : (p->std->size>1 ? std[tid] : std[0]) );
+                  var = p->variance ? sval : sval*sval;
+                  if(cif[ CCOL_SUMVAR  ] && (!isnan(var)))
+                    {
+                      ci[ CCOL_NUMVAR ]++;
+                      ci[ CCOL_SUMVAR ] += var;
+                    }
+                  if(cif[ CCOL_SUM_VAR ] && goodvalue)
+                    {
+                      varval=p->variance ? var : sval;
+                      if(!isnan(varval))
                         {
-                          varval=p->variance ? var : sval;
-                          if(!isnan(varval))
-                            {
-                              ci[ CCOL_SUM_VAR_NUM ]++;
-                              ci[ CCOL_SUM_VAR     ] += varval + fabs(*V);
-                            }
+                          ci[ CCOL_SUM_VAR_NUM ]++;
+                          ci[ CCOL_SUM_VAR     ] += varval + fabs(*V);
                         }
                     }
                 }
+            }
 
-              /* This pixel is on the diffuse region (and the object
-                 actually has clumps). If any river-based measurements are
-                 necessary check to see if it is touching a clump or not,
-                 but only if this object actually has any clumps. */
-              else if(ngblabs && pp->clumpsinobj)
-                {
-                  /* We are on a diffuse (possibly a river) pixel. So the
-                     value of this pixel has to be added to any of the
-                     clumps in touches. But since it might touch a labeled
-                     region more than once, we use 'ngblabs' to keep track
-                     of which label we have already added its value
-                     to. 'ii' is the number of different labels this river
-                     pixel has already been considered for. 'ngblabs' will
-                     keep the list labels. */
-                  ii=0;
-                  memset(ngblabs, 0, nngb*sizeof *ngblabs);
-
-                  /* Go over the neighbors and see if this pixel is
-                     touching a clump or not. */
-                  GAL_DIMENSION_NEIGHBOR_OP(O-objects, ndim, dsize, ndim,
-                                            dinc,
+          /* This pixel is on the diffuse region (and the object
+             actually has clumps). If any river-based measurements are
+             necessary check to see if it is touching a clump or not,
+             but only if this object actually has any clumps. */
+          else if(ngblabs && pp->clumpsinobj)
+            {
+              /* We are on a diffuse (possibly a river) pixel. So the
+                 value of this pixel has to be added to any of the
+                 clumps in touches. But since it might touch a labeled
+                 region more than once, we use 'ngblabs' to keep track
+                 of which label we have already added its value
+                 to. 'ii' is the number of different labels this river
+                 pixel has already been considered for. 'ngblabs' will
+                 keep the list labels. */
+              ii=0;
+              memset(ngblabs, 0, nngb*sizeof *ngblabs);
+
+              /* Go over the neighbors and see if this pixel is
+                 touching a clump or not. */
+              GAL_DIMENSION_NEIGHBOR_OP(O-objects, ndim, dsize, ndim,
+                                        dinc,
+                 {
+                   /* Neighbor's label (mainly for easy reading). */
+                   nlab=clumps[nind];
+
+                   /* We only want neighbors that are a clump and part
+                      of this object and part of the same object. */
+                   if( nlab>0 && objects[nind]==pp->object)
                      {
-                       /* Neighbor's label (mainly for easy reading). */
-                       nlab=clumps[nind];
+                       /* Go over all already checked labels and make
+                          sure this clump hasn't already been
+                          considered. */
+                       for(i=0;i<ii;++i) if(ngblabs[i]==nlab) break;
 
-                       /* We only want neighbors that are a clump and part
-                          of this object and part of the same object. */
-                       if( nlab>0 && objects[nind]==pp->object)
+                       /* It hasn't been considered yet: */
+                       if(i==ii)
                          {
-                           /* Go over all already checked labels and make
-                              sure this clump hasn't already been
-                              considered. */
-                           for(i=0;i<ii;++i) if(ngblabs[i]==nlab) break;
+                           /* Make sure it won't be considered any
+                              more. */
+                           ngblabs[ii++] = nlab;
+
+                           /* To help in reading. */
+                           cir=&pp->ci[ (nlab-1) * CCOL_NUMCOLS ];
 
-                           /* It hasn't been considered yet: */
-                           if(i==ii)
+                           /* Write in the necessary values. */
+                           if(cif[ CCOL_RIV_NUM  ])
+                             cir[ CCOL_RIV_NUM ]++;
+
+                           if(cif[ CCOL_RIV_SUM  ])
+                             cir[ CCOL_RIV_SUM ] += *V;
+
+                           if(cif[ CCOL_RIV_SUM_VAR  ])
                              {
-                               /* Make sure it won't be considered any
-                                  more. */
-                               ngblabs[ii++] = nlab;
-
-                               /* To help in reading. */
-                               cir=&pp->ci[ (nlab-1) * CCOL_NUMCOLS ];
-
-                               /* Write in the necessary values. */
-                               if(cif[ CCOL_RIV_NUM  ])
-                                 cir[ CCOL_RIV_NUM ]++;
-
-                               if(cif[ CCOL_RIV_SUM  ])
-                                 cir[ CCOL_RIV_SUM ] += *V;
-
-                               if(cif[ CCOL_RIV_SUM_VAR  ])
-                                 {
-                                   sval = ( pp->st_std
-                                            ? *ST
-                                            : ( p->std->size>1
-                                                ? std[tid]
-                                                : std[0] )     );
-                                   cir[ CCOL_RIV_SUM_VAR ] += fabs(*V)
-                                     + (p->variance ? sval : sval*sval);
-                                 }
+                               sval = ( pp->st_std
+                                        ? *ST
+                                        : ( p->std->size>1
+                                            ? std[tid]
+                                            : std[0] )     );
+                               cir[ CCOL_RIV_SUM_VAR ] += fabs(*V)
+                                 + (p->variance ? sval : sval*sval);
                              }
                          }
-                     });
-                }
+                     }
+                 });
             }
 
           /* Increment the other pointers. */
@@ -1166,15 +1268,6 @@ parse_clumps(struct mkcatalog_passparams *pp)
           if( p->std && pp->st_std ) ++ST;
         }
       while(++O<OO);
-
-      /* Increment to the next contiguous region of this tile. */
-      increment += ( gal_tile_block_increment(p->objects, tsize,
-                                              num_increment++, NULL) );
-
-      /* If a 2D projection is requested, see if we should initialize (set
-         to zero) the projection-index ('pind') not. */
-      if(xybin && (num_increment-1) % tsize[1]==0 )
-        pind=0;
     }
 
 
@@ -1199,7 +1292,7 @@ parse_clumps(struct mkcatalog_passparams *pp)
 
           /* For a check on the projected 2D areas. */
           if(xybin && pp->object==2)
-            gal_fits_img_write(&xybin[i], "xybin.fits", NULL, NULL);
+            gal_fits_img_write(&xybin[i], "xybin.fits", NULL, NULL, 0);
 
         }
     }
@@ -1351,9 +1444,10 @@ parse_order_based(struct mkcatalog_passparams *pp)
   float *sigcliparr;
   gal_data_t *result;
   int32_t *O, *OO, *C=NULL;
-  size_t i, increment=0, num_increment=1;
+  size_t i, r, increment;
   gal_data_t *objvals=NULL, **clumpsvals=NULL;
-  size_t *tsize=pp->tile->dsize, ndim=p->objects->ndim;
+  size_t *runs=p->objruns[pp->object].array;
+  size_t numruns=p->objruns[pp->object].size/2;
   size_t counter=0, *ccounter=NULL, tmpsize=pp->oi[OCOL_NUM];
 
   /* It may happen that there are no usable pixels for this object (and
@@ -1424,22 +1518,22 @@ parse_order_based(struct mkcatalog_passparams *pp)
     }
 
 
-  /* Parse each contiguous patch of memory covered by this object. */
-  while( pp->start_end_inc[0] + increment <= pp->start_end_inc[1] )
+  /* Parse each run of pixels in this object (see 'parse_objects'). */
+  for(r=0;r<numruns;++r)
     {
-      /* Set the contiguous range to parse. The pixel-to-pixel counting
-         along the fastest dimension will be done over the 'O' pointer. */
+      /* Set the contiguous range to parse. */
+      increment = runs[2*r] - pp->start_end_inc[0];
       V = pp->st_v + increment;
       if(p->clumps) C = pp->st_c + increment;
-      OO = ( O = pp->st_o + increment ) + tsize[ndim-1];
+      OO = ( O = pp->st_o + increment ) + runs[2*r+1];
 
-      /* Parse the next contiguous region of this tile. */
+      /* Parse the run (all its pixels are in this object). */
       do
         {
-          /* If this pixel belongs to the requested object, then do the
-             processing. 'hasblank' is constant, so when the values doesn't
-             have any blank values, the 'isnan' will never be checked. */
-          if( *O==pp->object && !( p->hasblank && isnan(*V) ) )
+          /* Only use non-blank values. 'hasblank' is constant, so when
+             the values doesn't have any blank values, the 'isnan' will
+             never be checked. */
+          if( !( p->hasblank && isnan(*V) ) )
             {
               /* Copy the value for the whole object. */
               memcpy( gal_pointer_increment(objvals->array, counter++,
@@ -1459,10 +1553,6 @@ parse_order_based(struct mkcatalog_passparams *pp)
           if(p->clumps) ++C;
         }
       while(++O<OO);
-
-      /* Increment to the next contiguous region of this tile. */
-      increment += ( gal_tile_block_increment(p->objects, tsize,
-                                              num_increment++, NULL) );
     }
 
 
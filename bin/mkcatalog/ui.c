@@ -32,6 +32,7 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 #include <gnuastro/wcs.h>
 #include <gnuastro/fits.h>
 #include <gnuastro/blank.h>
+#include <gnuastro/label.h>
 #include <gnuastro/array.h>
 #include <gnuastro/threads.h>
 #include <gnuastro/pointer.h>
@@ -360,6 +361,32 @@ ui_check_upperlimit(struct argp_option *option, char *arg,
 /**************************************************************/
 /***************       Sanity Check         *******************/
 /**************************************************************/
+/* The options of the extra bands (other than '--bandhdu') are optional,
+   but when given, they must be given once for each '--bandhdu' (in the
+   same order). The options are added to the start of the list, so it is
+   also reversed here. */
+static void
+ui_check_band_option(struct mkcatalogparams *p, gal_list_str_t **list,
+                     char *name)
+{
+  size_t num;
+
+  if(*list)
+    {
+      gal_list_str_reverse(list);
+      num=gal_list_str_number(*list);
+      if(num!=p->numbands)
+        error(EXIT_FAILURE, 0, "'--%s' has been given %zu times, but "
+              "'--bandhdu' has been given %zu times. When '--%s' is "
+              "given, it should be given once for each '--bandhdu'",
+              name, num, p->numbands, name);
+    }
+}
+
+
+
+
+
 /* Read and check ONLY the options. When arguments are involved, do the
    check in 'ui_check_options_and_arguments'. */
 static void
@@ -415,6 +442,31 @@ ui_read_check_only_options(struct mkcatalogparams *p)
         }
     }
 
+  /* The extra bands: the options are added to the start of the lists, so
+     reverse them to have them in the same order as the command-line. If
+     '--bandfile' (or the options of each band's Sky and Sky standard
+     deviation) are given, they must be given once for each '--bandhdu'
+     (when '--bandfile' isn't given, all bands are in the values file). */
+  if( p->bandfile || p->bandhdu || p->bandsky || p->bandskyhdu
+      || p->bandstd || p->bandstdhdu )
+    {
+      gal_list_str_reverse(&p->bandhdu);
+      p->numbands=gal_list_str_number(p->bandhdu);
+      if(p->numbands==0)
+        error(EXIT_FAILURE, 0, "no '--bandhdu' given! Each extra band "
+              "is identified by its HDU, '--bandfile' is only necessary "
+              "when the band isn't in the values file");
+      ui_check_band_option(p, &p->bandfile,   "bandfile");
+      ui_check_band_option(p, &p->bandsky,    "bandsky");
+      ui_check_band_option(p, &p->bandskyhdu, "bandskyhdu");
+      ui_check_band_option(p, &p->bandstd,    "bandstd");
+      ui_check_band_option(p, &p->bandstdhdu, "bandstdhdu");
+      if(p->spectrum)
+        error(EXIT_FAILURE, 0, "'--spectrum' can't be used with extra "
+              "bands ('--bandhdu'): the spectra are written as separate "
+              "extensions of the output, which are not band-specific");
+    }
+
   /* Make sure that '--fracmax' is given if necessary and that the fracsum
      values are less than one. */
   for(colcode=p->columnids; colcode!=NULL; colcode=colcode->next)
@@ -641,7 +693,8 @@ ui_num_clumps(struct mkcatalogparams *p)
   basename = p->cp.output ? p->cp.output : p->objectsfile;
   p->relabclumps=gal_checkset_automatic_output(&p->cp, basename,
                                                "-clumps-relab.fits");
-  gal_fits_img_write(p->clumps, p->relabclumps, NULL, PROGRAM_STRING);
+  gal_fits_img_write(p->clumps, p->relabclumps, NULL, PROGRAM_STRING,
+                     p->cp.compress);
   p->cp.keepinputdir=keepinputdir;
 
   /* Clean up. */
@@ -674,6 +727,13 @@ ui_one_tile_per_object_correct_numobjects(struct mkcatalogparams *p)
   size_t *coord=gal_pointer_allocate(GAL_TYPE_SIZE_T, ndim, 0, __func__,
                                       "coord");
 
+  /* Find the runs of pixels in each label. The measurements on each object
+     will only parse these pixels (not all the pixels in its tile). At
+     this point, 'numobjects' is the largest label in the image. */
+  p->numobjruns=p->numobjects+1;
+  p->objruns=gal_label_runs(p->objects, p->numobjects, p->cp.minmapsize,
+                            p->cp.quietmmap);
+
   /* Initialize the minimum and maximum position for each tile/object. So,
      we'll initialize the minimum coordinates to the maximum possible
      'size_t' value (in 'GAL_BLANK_SIZE_T') and the maximums to zero. */
@@ -830,6 +890,33 @@ ui_one_tile_per_object_correct_numobjects(struct mkcatalogparams *p)
 
 
 
+/* Read the single-channel dataset in the given file and HDU (converted to
+   'type' when it isn't 'GAL_TYPE_INVALID'). When possible, FITS images
+   are directly mapped from the file (see 'gal_fits_img_read_map'). */
+static gal_data_t *
+ui_read_one_ch(struct mkcatalogparams *p, char *filename, char *hdu,
+               uint8_t type)
+{
+  gal_data_t *out;
+
+  /* Read the dataset. */
+  if( gal_fits_file_recognized(filename) )
+    out=gal_fits_img_read_map(filename, hdu, p->cp.numthreads,
+                              p->cp.minmapsize, p->cp.quietmmap);
+  else
+    out=gal_array_read_one_ch(filename, hdu, NULL, p->cp.numthreads,
+                              p->cp.minmapsize, p->cp.quietmmap);
+
+  /* Convert it to the requested type (if necessary). */
+  return ( type==GAL_TYPE_INVALID
+           ? out
+           : gal_data_copy_to_new_type_free(out, type) );
+}
+
+
+
+
+
 /* The only mandatory input is the objects image, so first read that and
    make sure its type is correct. */
 static void
@@ -838,8 +925,8 @@ ui_read_labels(struct mkcatalogparams *p)
   gal_data_t *tmp, *keys=gal_data_array_calloc(2);
 
   /* Read it into memory. */
-  p->objects = gal_array_read_one_ch(p->objectsfile, p->cp.hdu, NULL,
-                                     p->cp.minmapsize, p->cp.quietmmap);
+  p->objects = ui_read_one_ch(p, p->objectsfile, p->cp.hdu,
+                              GAL_TYPE_INVALID);
   p->objects->ndim=gal_dimension_remove_extra(p->objects->ndim,
                                               p->objects->dsize, NULL);
 
@@ -916,9 +1003,8 @@ ui_read_labels(struct mkcatalogparams *p)
               "configuration file", p->usedclumpsfile);
 
       /* Read the clumps image. */
-      p->clumps = gal_array_read_one_ch(p->usedclumpsfile, p->clumpshdu,
-                                        NULL, p->cp.minmapsize,
-                                        p->cp.quietmmap);
+      p->clumps = ui_read_one_ch(p, p->usedclumpsfile, p->clumpshdu,
+                                 GAL_TYPE_INVALID);
       p->clumps->ndim=gal_dimension_remove_extra(p->clumps->ndim,
                                                  p->clumps->dsize, NULL);
 
@@ -1199,7 +1285,7 @@ ui_preparation_check_size_read_tiles(struct mkcatalogparams *p,
 /* Subtract 'sky' from the input dataset depending on its size (it may be
    the whole array or a tile-values array).. */
 static void
-ui_subtract_sky(struct mkcatalogparams *p)
+ui_subtract_sky(struct mkcatalogparams *p, gal_data_t *values)
 {
   size_t tid;
   gal_data_t *tile;
@@ -1207,10 +1293,10 @@ ui_subtract_sky(struct mkcatalogparams *p)
   struct gal_tile_two_layer_params *tl=&p->cp.tl;
 
   /* It is the same size as the input or a single value. */
-  if( gal_dimension_is_different(p->values, p->sky)==0 || p->sky->size==1)
+  if( gal_dimension_is_different(values, p->sky)==0 || p->sky->size==1)
     {
       s=p->sky->array;
-      ff = (f=p->values->array) + p->values->size;
+      ff = (f=values->array) + values->size;
       if(p->sky->size==1) { if(*s!=0.0) do *f-=*s;   while(++f<ff); }
       else                              do *f-=*s++; while(++f<ff);
     }
@@ -1225,7 +1311,7 @@ ui_subtract_sky(struct mkcatalogparams *p)
           tile=&tl->tiles[tid];
 
           /* Subtract the Sky value from the input image. */
-          GAL_TILE_PARSE_OPERATE(tile, p->values, 1, 0, {*o-=skyarr[tid];});
+          GAL_TILE_PARSE_OPERATE(tile, values, 1, 0, {*o-=skyarr[tid];});
         }
     }
 
@@ -1241,11 +1327,109 @@ ui_subtract_sky(struct mkcatalogparams *p)
 
 
 
+/* Return element 'ind' (counting from zero) of 'list', or NULL when the
+   list isn't given. */
+static char *
+ui_band_str(gal_list_str_t *list, size_t ind)
+{
+  for(; list!=NULL && ind>0; list=list->next) --ind;
+  return list ? list->v : NULL;
+}
+
+
+
+
+
+/* The file containing band 'ind' (counting from zero). */
+static char *
+ui_band_file(struct mkcatalogparams *p, size_t ind)
+{
+  char *file=ui_band_str(p->bandfile, ind);
+  return ( file
+           ? file
+           : ( p->valuesfile ? p->valuesfile : p->objectsfile ) );
+}
+
+
+
+
+
+/* Find the Sky ('issky==1') or Sky standard deviation ('issky==0') of
+   band 'ind' (counting from zero). Similar to '--insky' and '--instd',
+   it may be a single number: in this case it is written in 'value' and
+   1 is returned. Otherwise, the file and HDU of the dataset are set (by
+   default, it is in the band's file) and 0 is returned. */
+static int
+ui_band_sky_std_name(struct mkcatalogparams *p, size_t ind, int issky,
+                     char **file, char **hdu, float *value)
+{
+  char *str, *tailptr;
+  char *opt = issky ? "bandsky" : "bandstd";
+
+  /* See if it is a number (when the string is only a number, 'tailptr'
+     will point to the end of the string). */
+  str=ui_band_str(issky ? p->bandsky : p->bandstd, ind);
+  if(str)
+    {
+      *value=strtod(str, &tailptr);
+      if(*tailptr=='\0') return 1;
+    }
+
+  /* It is a dataset, so its HDU is necessary. */
+  *file = str ? str : ui_band_file(p, ind);
+  *hdu = ui_band_str(issky ? p->bandskyhdu : p->bandstdhdu, ind);
+  if(*hdu==NULL)
+    error(EXIT_FAILURE, 0, "no %s given for band %zu ('%s', hdu: %s).\n\n"
+          "Each band has its own %s, so it can't be taken from the values "
+          "dataset. Please use '--%s' (a single value or file name) or "
+          "'--%shdu' (HDU of the dataset) once for each '--bandhdu'",
+          issky ? "Sky" : "Sky standard deviation", ind+1,
+          ui_band_file(p, ind), ui_band_str(p->bandhdu, ind),
+          issky ? "Sky" : "Sky standard deviation", opt, opt);
+  return 0;
+}
+
+
+
+
+
+/* Read the Sky or Sky standard deviation of band 'ind' (see
+   'ui_band_sky_std_name'). */
+static gal_data_t *
+ui_read_band_sky_std(struct mkcatalogparams *p, size_t ind, int issky,
+                     char **file, char **hdu)
+{
+  float value;
+  size_t one=1;
+  gal_data_t *out;
+
+  if( ui_band_sky_std_name(p, ind, issky, file, hdu, &value) )
+    {
+      out=gal_data_alloc(NULL, GAL_TYPE_FLOAT32, 1, &one, NULL, 0, -1, 1,
+                         NULL, NULL, NULL);
+      *((float *)(out->array))=value;
+      *file=*hdu=NULL;
+    }
+  else
+    {
+      out=ui_read_one_ch(p, *file, *hdu, GAL_TYPE_FLOAT32);
+      out->ndim=gal_dimension_remove_extra(out->ndim, out->dsize, NULL);
+      ui_preparation_check_size_read_tiles(p, out, *file, *hdu);
+    }
+  return out;
+}
+
+
+
+
+
 static void
 ui_preparations_read_inputs(struct mkcatalogparams *p)
 {
-  size_t one=1;
+  float value;
+  size_t i, one=1;
   gal_data_t *zero;
+  char *fname, *hdu;
   gal_data_t *column;
   int need_values=0, need_sky=0, need_std=0;
 
@@ -1267,10 +1451,8 @@ ui_preparations_read_inputs(struct mkcatalogparams *p)
               "give the filename", p->usedvaluesfile);
 
       /* Read the values dataset. */
-      p->values=gal_array_read_one_ch_to_type(p->usedvaluesfile, p->valueshdu,
-                                              NULL, GAL_TYPE_FLOAT32,
-                                              p->cp.minmapsize,
-                                              p->cp.quietmmap);
+      p->values=ui_read_one_ch(p, p->usedvaluesfile, p->valueshdu,
+                               GAL_TYPE_FLOAT32);
       p->values->ndim=gal_dimension_remove_extra(p->values->ndim,
                                                  p->values->dsize, NULL);
 
@@ -1319,10 +1501,8 @@ ui_preparations_read_inputs(struct mkcatalogparams *p)
                   "give the filename", p->usedskyfile);
 
           /* Read the Sky dataset. */
-          p->sky=gal_array_read_one_ch_to_type(p->usedskyfile, p->skyhdu,
-                                               NULL, GAL_TYPE_FLOAT32,
-                                               p->cp.minmapsize,
-                                               p->cp.quietmmap);
+          p->sky=ui_read_one_ch(p, p->usedskyfile, p->skyhdu,
+                                GAL_TYPE_FLOAT32);
           p->sky->ndim=gal_dimension_remove_extra(p->sky->ndim,
                                                   p->sky->dsize, NULL);
 
@@ -1332,7 +1512,7 @@ ui_preparations_read_inputs(struct mkcatalogparams *p)
         }
 
       /* Subtract the Sky value. */
-      if(p->subtractsky) ui_subtract_sky(p);
+      if(p->subtractsky) ui_subtract_sky(p, p->values);
     }
 
 
@@ -1351,9 +1531,7 @@ ui_preparations_read_inputs(struct mkcatalogparams *p)
               p->usedstdfile);
 
       /* Read the Sky standard deviation image into memory. */
-      p->std=gal_array_read_one_ch_to_type(p->usedstdfile, p->stdhdu,
-                                           NULL, GAL_TYPE_FLOAT32,
-                                           p->cp.minmapsize, p->cp.quietmmap);
+      p->std=ui_read_one_ch(p, p->usedstdfile, p->stdhdu, GAL_TYPE_FLOAT32);
       p->std->ndim=gal_dimension_remove_extra(p->std->ndim,
                                               p->std->dsize, NULL);
 
@@ -1364,6 +1542,28 @@ ui_preparations_read_inputs(struct mkcatalogparams *p)
 
 
 
+  /* The extra bands (if any) are only read when they are measured (see
+     'ui_read_band'). But the Sky and Sky standard deviation of each band
+     are checked here, so a missing option is reported immediately. */
+  if(p->numbands)
+    {
+      /* Bands are only meaningful with the values. */
+      if(need_values==0)
+        error(EXIT_FAILURE, 0, "extra bands are given (with '--bandhdu'), "
+              "but none of the requested columns need the values image");
+
+      /* Check the names of each band's Sky and Sky standard deviation. */
+      for(i=0;i<p->numbands;++i)
+        {
+          if(p->subtractsky || need_sky)
+            ui_band_sky_std_name(p, i, 1, &fname, &hdu, &value);
+          if(need_std)
+            ui_band_sky_std_name(p, i, 0, &fname, &hdu, &value);
+        }
+    }
+
+
+
   /* Sanity checks on upper-limit measurements. */
   if(p->upperlimit)
     {
@@ -1387,9 +1587,8 @@ ui_preparations_read_inputs(struct mkcatalogparams *p)
                   p->upmaskfile);
 
           /* Read the mask image. */
-          p->upmask = gal_array_read_one_ch(p->upmaskfile, p->upmaskhdu,
-                                            NULL, p->cp.minmapsize,
-                                            p->cp.quietmmap);
+          p->upmask = ui_read_one_ch(p, p->upmaskfile, p->upmaskhdu,
+                                     GAL_TYPE_INVALID);
           p->upmask->ndim=gal_dimension_remove_extra(p->upmask->ndim,
                                                      p->upmask->dsize,
                                                      NULL);
@@ -1492,6 +1691,57 @@ ui_preparations_read_keywords(struct mkcatalogparams *p)
 
 
 
+/* Read band 'band' (counting from 1) and (when necessary) its Sky and Sky
+   standard deviation as the values, Sky and Sky standard deviation of
+   'p' (so the next measurements are done on it). The Sky is also
+   subtracted if requested. The caller must keep (and later restore) the
+   previous pointers, and free the band's datasets after measuring them:
+   so only one band is in memory at any time. */
+void
+ui_read_band(struct mkcatalogparams *p, size_t band)
+{
+  size_t ind=band-1;
+  int need_values=0, need_sky=0, need_std=0;
+
+  /* See which inputs are necessary. */
+  ui_necessary_inputs(p, &need_values, &need_sky, &need_std);
+
+  /* Read the band. */
+  p->usedvaluesfile=ui_band_file(p, ind);
+  p->valueshdu=ui_band_str(p->bandhdu, ind);
+  p->values=ui_read_one_ch(p, p->usedvaluesfile, p->valueshdu,
+                           GAL_TYPE_FLOAT32);
+  p->values->ndim=gal_dimension_remove_extra(p->values->ndim,
+                                             p->values->dsize, NULL);
+  if( gal_dimension_is_different(p->objects, p->values) )
+    error(EXIT_FAILURE, 0, "'%s' (hdu: %s) and '%s' (hdu: %s) have a "
+          "different dimension/size", p->usedvaluesfile, p->valueshdu,
+          p->objectsfile, p->cp.hdu);
+  p->hasblank=gal_blank_present(p->values, 1);
+
+  /* The band's Sky (subtracted from it if requested). */
+  p->sky=NULL;
+  if(p->subtractsky || need_sky)
+    {
+      p->sky=ui_read_band_sky_std(p, ind, 1, &p->usedskyfile, &p->skyhdu);
+      if(p->subtractsky) ui_subtract_sky(p, p->values);
+    }
+
+  /* The band's Sky standard deviation and the values that depend on it
+     (for example the counts-per-second correction). */
+  p->std=NULL;
+  p->medstd=NAN;
+  if(need_std)
+    {
+      p->std=ui_read_band_sky_std(p, ind, 0, &p->usedstdfile, &p->stdhdu);
+      ui_preparations_read_keywords(p);
+    }
+}
+
+
+
+
+
 /* When both catalogs need to be made, we need a separator, the output
    names will either be built based on the input name or output name (if
    given). In both cases, the operations are the same, just the base name
@@ -1715,7 +1965,7 @@ ui_preparations_spectrum_wcs(struct mkcatalogparams *p)
 
   /* For a final check.
   gal_table_write(p->specsliceinfo, NULL, NULL, GAL_TABLE_FORMAT_BFITS,
-                  "specsliceinfo.fits", "test-debug", 0);
+                  "specsliceinfo.fits", "test-debug", 0, 1);
   */
 
   /* Clean up. */
@@ -1878,6 +2128,7 @@ void
 ui_read_check_inputs_setup(int argc, char *argv[], struct mkcatalogparams *p)
 {
   char *tmp;
+  gal_list_str_t *hdu, *file;
   struct gal_options_common_params *cp=&p->cp;
 
 
@@ -1951,6 +2202,16 @@ ui_read_check_inputs_setup(int argc, char *argv[], struct mkcatalogparams *p)
       if(p->values)
         printf("  - Values:  %s (hdu: %s)\n", p->usedvaluesfile,
                p->valueshdu);
+      if(p->numbands)
+        {
+          file=p->bandfile;
+          for(hdu=p->bandhdu; hdu!=NULL; hdu=hdu->next)
+            {
+              printf("    - Band:  %s (hdu: %s)\n",
+                     file ? file->v : p->usedvaluesfile, hdu->v);
+              if(file) file=file->next;
+            }
+        }
 
       if(p->subtractsky || p->sky)
         {
@@ -2053,6 +2314,12 @@ ui_free_report(struct mkcatalogparams *p, struct timeval *t1)
   gal_data_free(p->sky);
   gal_data_free(p->std);
   gal_data_free(p->values);
+  gal_list_str_free(p->bandhdu, 1);
+  gal_list_str_free(p->bandfile, 1);
+  gal_list_str_free(p->bandsky, 1);
+  gal_list_str_free(p->bandskyhdu, 1);
+  gal_list_str_free(p->bandstd, 1);
+  gal_list_str_free(p->bandstdhdu, 1);
   gal_data_free(p->upmask);
   gal_data_free(p->clumps);
   gal_data_free(p->objects);
@@ -2063,6 +2330,7 @@ ui_free_report(struct mkcatalogparams *p, struct timeval *t1)
   if(p->outlabsinv) free(p->outlabsinv);
   if(p->upcheckout) free(p->upcheckout);
   gal_data_array_free(p->tiles, p->numobjects, 0);
+  gal_data_array_free(p->objruns, p->numobjruns, 1);
 
   /* Clean up the spectra. */
   if(p->spectra)
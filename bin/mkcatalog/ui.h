@@ -84,6 +84,12 @@ enum option_keys_enum
   /* Only with long version (start with a value 1000, the rest will be set
      automatically). */
   UI_KEY_VALUESHDU       = 1000,        /* General settings. */
+  UI_KEY_BANDFILE,
+  UI_KEY_BANDHDU,
+  UI_KEY_BANDSKY,
+  UI_KEY_BANDSKYHDU,
+  UI_KEY_BANDSTD,
+  UI_KEY_BANDSTDHDU,
   UI_KEY_CLUMPSHDU,
   UI_KEY_SKYHDU,
   UI_KEY_STDHDU,
@@ -205,6 +211,9 @@ enum option_keys_enum
 void
 ui_read_check_inputs_setup(int argc, char *argv[], struct mkcatalogparams *p);
 
+void
+ui_read_band(struct mkcatalogparams *p, size_t band);
+
 void
 ui_free_report(struct mkcatalogparams *p, struct timeval *t1);
 
@@ -243,6 +243,98 @@ upperlimit_random_range(struct mkcatalog_passparams *pp, gal_data_t *tile,
 
 
 
+/* The footprint of the object/clump is the same for all the random
+   positions. So instead of parsing the full tile (and checking the labels
+   of every pixel) for each random position, the footprint is found once
+   as contiguous runs of pixels. Each run is kept as two numbers: its
+   offset from the tile's first pixel (in the block) and its length. */
+static size_t *
+upperlimit_footprint_runs(struct mkcatalog_passparams *pp, gal_data_t *tile,
+                          int32_t clumplab, size_t *numruns)
+{
+  struct mkcatalogparams *p=pp->p;
+  size_t ndim=p->objects->ndim;
+
+  int32_t *O, *OO, *C, *st_o, *st_c;
+  size_t i, n, ind, last, pass, se_inc[2], *oruns, *runs=NULL;
+  size_t increment, num_increment;
+
+  /* The runs of each object have already been found over the full image
+     (see 'gal_label_runs'), we just need to make them relative to the
+     tile's first pixel. */
+  if(clumplab==0)
+    {
+      n=p->objruns[pp->object].size/2;
+      oruns=p->objruns[pp->object].array;
+      runs=gal_pointer_allocate(GAL_TYPE_SIZE_T, 2*(n?n:1), 0, __func__,
+                                "runs");
+      for(i=0;i<n;++i)
+        {
+          runs[2*i]   = oruns[2*i] - pp->start_end_inc[0];
+          runs[2*i+1] = oruns[2*i+1];
+        }
+      *numruns=n;
+      return runs;
+    }
+
+  /* Starting pointers of the clump's tile. */
+  st_o=gal_tile_start_end_ind_inclusive(tile, p->objects, se_inc);
+  st_c=(int32_t *)(p->clumps->array) + se_inc[0];
+
+  /* In the first pass, we'll just count the number of runs, and in the
+     second, we'll fill them in. */
+  for(pass=0;pass<2;++pass)
+    {
+      n=0;
+      increment=0;
+      num_increment=1;
+      last=GAL_BLANK_SIZE_T;
+      while( se_inc[0] + increment <= se_inc[1] )
+        {
+          /* Set the pointers. */
+          OO = ( O = st_o + increment ) + tile->dsize[ndim-1];
+          C = st_c + increment;
+
+          /* Parse the contiguous region. */
+          do
+            {
+              if( *O==pp->object && *C==clumplab )
+                {
+                  /* Start a new run if this pixel isn't immediately after
+                     the last footprint pixel. */
+                  ind=O-st_o;
+                  if(last==GAL_BLANK_SIZE_T || ind!=last+1)
+                    {
+                      if(runs) { runs[2*n]=ind; runs[2*n+1]=1; }
+                      ++n;
+                    }
+                  else if(runs) ++runs[2*(n-1)+1];
+                  last=ind;
+                }
+              ++C;
+            }
+          while(++O<OO);
+
+          /* Go to the next contiguous region of this tile. */
+          increment += ( gal_tile_block_increment(p->objects, tile->dsize,
+                                                  num_increment++, NULL) );
+        }
+
+      /* Allocate the runs after the first pass. */
+      if(pass==0)
+        runs=gal_pointer_allocate(GAL_TYPE_SIZE_T, 2*(n?n:1), 0, __func__,
+                                  "runs");
+    }
+
+  /* Return the runs. */
+  *numruns=n;
+  return runs;
+}
+
+
+
+
+
 /* Return a random position in the requested dimension. */
 static size_t
 upperlimit_random_position(struct mkcatalog_passparams *pp, gal_data_t *tile,
@@ -425,7 +517,7 @@ upperlimit_write_check(struct mkcatalogparams *p, gal_list_sizet_t *check_x,
   if(check_z) { y->next=z; z->next=s; }
   else        { y->next=s;            }
   gal_table_write(x, &keylist, NULL, p->cp.tableformat, p->upcheckout,
-                  "UPPERLIMIT_CHECK", 0);
+                  "UPPERLIMIT_CHECK", 0, p->cp.numthreads);
 
   /* Inform the user. */
   if(!p->cp.quiet)
@@ -546,15 +638,14 @@ upperlimit_one_tile(struct mkcatalog_passparams *pp, gal_data_t *tile,
   struct mkcatalogparams *p=pp->p;
   size_t ndim=p->objects->ndim, *dsize=p->objects->dsize;
 
+  int32_t *O;
   double sum;
-  void *tarray;
-  uint8_t *M=NULL, *st_m=NULL;
+  uint8_t *M=NULL;
   int continueparse, writecheck=0;
+  float *V, *uparr=pp->up_vals->array;
   struct gal_list_f32_t *check_s=NULL;
-  size_t d, counter=0, se_inc[2], nfailed=0;
-  float *V, *st_v, *uparr=pp->up_vals->array;
-  size_t min[3], max[3], increment, num_increment;
-  int32_t *O, *OO, *oO, *st_o, *st_oo, *st_oc, *oC=NULL;
+  size_t d, r, f, ff, start, counter=0, nfailed=0;
+  size_t min[3], max[3], numruns, *runs;
   size_t maxfails = p->upnum * MKCATALOG_UPPERLIMIT_MAXFAILS_MULTIP;
   struct gal_list_sizet_t *check_x=NULL, *check_y=NULL, *check_z=NULL;
   size_t *rcoord=gal_pointer_allocate(GAL_TYPE_SIZE_T, ndim, 0, __func__,
@@ -576,7 +667,6 @@ upperlimit_one_tile(struct mkcatalog_passparams *pp, gal_data_t *tile,
 
 
   /* Initializations. */
-  tarray=tile->array;
   gsl_rng_set(pp->rng, seed);
   pp->up_vals->flag &= ~GAL_DATA_FLAG_SORT_CH;
 
@@ -585,12 +675,8 @@ upperlimit_one_tile(struct mkcatalog_passparams *pp, gal_data_t *tile,
   upperlimit_random_range(pp, tile, min, max, clumplab);
 
 
-  /* 'se_inc' is just used temporarily, the important thing here is
-     'st_oo'. */
-  st_oo = ( clumplab
-            ? gal_tile_start_end_ind_inclusive(tile, p->objects, se_inc)
-            : pp->st_o );
-  st_oc = clumplab ? (int32_t *)(p->clumps->array) + se_inc[0] : NULL;
+  /* Find the runs of pixels in the footprint of this object/clump. */
+  runs=upperlimit_footprint_runs(pp, tile, clumplab, &numruns);
 
 
   /* Continue measuring randomly until we get the desired total number. */
@@ -600,65 +686,25 @@ upperlimit_one_tile(struct mkcatalog_passparams *pp, gal_data_t *tile,
       for(d=0;d<ndim;++d)
         rcoord[d] = upperlimit_random_position(pp, tile, d, min, max);
 
-      /* Set the tile's new starting pointer. */
-      tile->array = gal_pointer_increment(p->objects->array,
-                          gal_dimension_coord_to_index(ndim, dsize, rcoord),
-                                           p->objects->type);
-
-      /* Starting and ending coordinates for this random position, note
-         that in 'pp' we have the starting and ending coordinates of the
-         actual tile. */
-      increment     = 0;
-      num_increment = 1;
-      continueparse = 1;
-      sum           = 0.0f;
-
-      /* Starting pointers for the random tile. */
-      st_v   = gal_tile_start_end_ind_inclusive(tile, p->values, se_inc);
-      st_o               = (int32_t *)(p->objects->array) + se_inc[0];
-      if(p->upmask) st_m = (uint8_t *)(p->upmask->array)  + se_inc[0];
-
-      /* Parse over this object/clump. */
-      while( se_inc[0] + increment <= se_inc[1] )
+      /* Pointers to the random tile's first pixel on all the arrays. */
+      start = gal_dimension_coord_to_index(ndim, dsize, rcoord);
+      V = (float *)(p->values->array) + start;
+      O = (int32_t *)(p->objects->array) + start;
+      if(p->upmask) M = (uint8_t *)(p->upmask->array) + start;
+
+      /* Parse over the footprint's runs. If a pixel has a non-zero object
+         code, or is masked, or has a blank value, then stop parsing. */
+      sum=0.0f;
+      continueparse=1;
+      for(r=0;r<numruns;++r)
         {
-          /* Set the pointers. */
-          V               = st_v  + increment;    /* Random tile.   */
-          O               = st_o  + increment;    /* Random tile.   */
-          if(st_m) M      = st_m  + increment;    /* Random tile.   */
-          oO              = st_oo + increment;    /* Original tile. */
-          if(clumplab) oC = st_oc + increment;    /* Original tile. */
-
-
-          /* Parse over this contiguous region, similar to the first and
-             second pass functions. */
-          OO = O + tile->dsize[ndim-1];
+          ff = ( f=runs[2*r] ) + runs[2*r+1];
           do
-            {
-              /* Only use pixels over this object/clump. */
-              if( *oO==pp->object && ( oC==NULL || *oC==clumplab ) )
-                {
-                  /* If this pixel is a non-zero object code, or is masked,
-                     or has a blank value, then stop parsing. */
-                  if( *O || (M && *M) || ( p->hasblank && isnan(*V) ) )
-                    continueparse=0;
-                  else
-                    sum += *V;
-                }
-
-              /* Increment the other pointers. */
-              ++V;
-              ++oO;
-              if(M) ++M;
-              if(oC) ++oC;
-            }
-          while(continueparse && ++O<OO);
-
-
-          /* Increment to the next contiguous region of this tile. */
-          if(continueparse)
-            increment += ( gal_tile_block_increment(p->objects, dsize,
-                                                    num_increment++, NULL) );
-          else break;
+            if( O[f] || (M && M[f]) || ( p->hasblank && isnan(V[f]) ) )
+              { continueparse=0; break; }
+            else sum += V[f];
+          while(++f<ff);
+          if(continueparse==0) break;
         }
 
 
@@ -705,9 +751,9 @@ upperlimit_one_tile(struct mkcatalog_passparams *pp, gal_data_t *tile,
   /* Do the measurement on the random distribution. */
   upperlimit_measure(pp, clumplab, counter==p->upnum);
 
-  /* Reset the tile's array pointer, clean up and return. */
+  /* Clean up and return. */
+  free(runs);
   free(rcoord);
-  tile->array=tarray;
   gal_list_f32_free(check_s);
   gal_list_sizet_free(check_x);
   gal_list_sizet_free(check_y);
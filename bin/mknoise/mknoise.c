@@ -115,7 +115,8 @@ convertsaveoutput(struct mknoiseparams *p)
   if(p->input->name) { free(p->input->name); p->input->name=NULL; }
   p->input=gal_data_copy_to_new_type_free(p->input, p->cp.type);
   p->input->name="NOISED";
-  gal_fits_img_write(p->input, p->cp.output, headers, PROGRAM_NAME);
+  gal_fits_img_write(p->input, p->cp.output, headers, PROGRAM_NAME,
+                     p->cp.compress);
   p->input->name=NULL; /* because we didn't allocate it. */
 
   /* Write the configuration keywords. */
@@ -206,6 +206,19 @@ struct argp_option program_options[] =
       GAL_OPTIONS_NOT_MANDATORY,
       GAL_OPTIONS_NOT_SET
     },
+    {
+      "parallelmerge",
+      UI_KEY_PARALLELMERGE,
+      0,
+      0,
+      "Merge built profiles in parallel (after all built).",
+      GAL_OPTIONS_GROUP_OUTPUT,
+      &p->parallelmerge,
+      GAL_OPTIONS_NO_ARG_TYPE,
+      GAL_OPTIONS_RANGE_0_OR_1,
+      GAL_OPTIONS_NOT_MANDATORY,
+      GAL_OPTIONS_NOT_SET
+    },
 
 
 
@@ -269,6 +282,32 @@ struct argp_option program_options[] =
       GAL_OPTIONS_MANDATORY,
       GAL_OPTIONS_NOT_SET
     },
+    {
+      "tabulate",
+      UI_KEY_TABULATE,
+      "INT",
+      0,
+      "Tabulate pixel-center profiles (table size).",
+      UI_GROUP_PROFILES,
+      &p->tabulate,
+      GAL_TYPE_SIZE_T,
+      GAL_OPTIONS_RANGE_GE_0,
+      GAL_OPTIONS_NOT_MANDATORY,
+      GAL_OPTIONS_NOT_SET
+    },
+    {
+      "qrng",
+      UI_KEY_QRNG,
+      "STR",
+      0,
+      "Quasi-random sequence for central pixels.",
+      UI_GROUP_PROFILES,
+      &p->qrngname,
+      GAL_TYPE_STRING,
+      GAL_OPTIONS_RANGE_ANY,
+      GAL_OPTIONS_NOT_MANDATORY,
+      GAL_OPTIONS_NOT_SET
+    },
     {
       "tunitinp",
       UI_KEY_TUNITINP,
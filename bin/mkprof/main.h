@@ -25,6 +25,7 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 
 #include <pthread.h>
 #include <gsl/gsl_rng.h>
+#include <gsl/gsl_qrng.h>
 
 #include <gnuastro/fits.h>
 
@@ -104,6 +105,7 @@ struct builtqueue
   int        indivcreated;    /* ==1: an individual file is created. */
   size_t          numaccu;    /* Number of accurate pixels.          */
   double         accufrac;    /* Difference of accurate values.      */
+  double              sum;    /* Sum of pixels in merged image.      */
 
   struct builtqueue *next;    /* Pointer to next element.            */
 };
@@ -130,9 +132,12 @@ struct mkprofparams
   uint8_t          psfinimg;  /* ==1: Build PSF profiles in image.        */
   uint8_t        individual;  /* ==1: Build all catalog separately.       */
   uint8_t          nomerged;  /* ==1: Don't make a merged image of all.   */
+  uint8_t     parallelmerge;  /* ==1: Merge profiles in parallel.         */
   char             *typestr;  /* Type of finally merged output image.     */
   size_t          numrandom;  /* Number of radom points for integration.  */
   float           tolerance;  /* Accuracy to stop integration.            */
+  size_t           tabulate;  /* Size of table for pixel-center profiles. */
+  char            *qrngname;  /* Name of quasi-random sequence to use.    */
   uint8_t          tunitinp;  /* ==1: Truncation is in pixels, not radial.*/
   size_t             *shift;  /* Shift along axeses position of profiles. */
   uint8_t       prepforconv;  /* Shift and expand by size of first psf.   */
@@ -189,6 +194,7 @@ struct mkprofparams
   gsl_rng              *rng;  /* Main instance of random number generator.*/
   const char      *rng_name;  /* Name of random number generator.         */
   unsigned long    rng_seed;  /* Fixed seed of random number generator.   */
+  const gsl_qrng_type  *qrng;  /* Type of quasi-random sequence (or NULL). */
   time_t            rawtime;  /* Starting time of the program.            */
   double               *cat;  /* Input catalog.                           */
   gal_data_t           *log;  /* Log data to be printed.                  */
@@ -93,6 +93,7 @@ builtqueue_addempty(struct builtqueue **bq)
   tbq->indivcreated = 0;
   tbq->numaccu      = 0;
   tbq->accufrac     = 0.0f;
+  tbq->sum          = 0.0f;
 
   /* Set its next element to the input bq and re-set the input bq. */
   tbq->next=*bq;
@@ -151,7 +152,8 @@ saveindividual(struct mkonthread *mkp)
   /* Write the array to the file (a separately built PSF doesn't need WCS
      coordinates). */
   if(ibq->ispsf && p->psfinimg==0)
-    gal_fits_img_write(ibq->image, filename, NULL, PROGRAM_NAME);
+    gal_fits_img_write(ibq->image, filename, NULL, PROGRAM_NAME,
+                       p->cp.compress);
   else
     {
       /* Allocate space for the corrected crpix and fill it in. Both
@@ -164,7 +166,7 @@ saveindividual(struct mkonthread *mkp)
       /* Write the image. */
       gal_fits_img_write_corr_wcs_str(ibq->image, filename, p->wcsstr,
                                       p->wcsnkeyrec, crpix, NULL,
-                                      PROGRAM_NAME);
+                                      PROGRAM_NAME, p->cp.compress);
     }
   ibq->indivcreated=1;
 
@@ -237,6 +239,11 @@ saveindividual(struct mkonthread *mkp)
                         &p->tolerance, 0,
                         "Tolerance level to stop random integration",
                         0, NULL, 0);
+  if(p->qrng)
+    gal_fits_key_list_add(&keys, GAL_TYPE_STRING, "QRNGNAME", 0,
+                          p->qrngname, 0,
+                          "Quasi-random sequence in central pixels", 0,
+                          NULL, 0);
   gal_fits_key_list_add(&keys, GAL_TYPE_STRING, "MODE", 0,
                         p->mode==MKPROF_MODE_IMG?"img":"wcs", 0,
                         "Coordinates in image or WCS units", 0, NULL, 0);
@@ -385,6 +392,13 @@ mkprof_build_single(struct mkonthread *mkp, long *fpixel_i, long *lpixel_i,
       ibq->overlap_m=gal_data_alloc(ptr, p->out->type, ndim, dsize, NULL,
                                     0, -1, 1, NULL, NULL, NULL);
       ibq->overlap_m->block=p->out;
+
+
+      /* Sum of the pixels that will be added to the merged image (for the
+         log). It is calculated here so it is done in parallel. */
+      if(ibq->overlaps)
+        GAL_TILE_PO_OISET(float, float, ibq->overlap_i, NULL, 0, 0,
+                          {ibq->sum += *i;});
     }
 }
 
@@ -491,6 +505,19 @@ mkprof_build(void *inparam)
   long fpixel_i[3], lpixel_i[3], fpixel_o[3], lpixel_o[3];
 
 
+  /* Allocate the queue of pixels (it will grow when necessary and is
+     re-used for all the profiles built on this thread). */
+  mkp->pq=gal_pqueue_alloc(1024);
+
+  /* Allocate the table of profile values (when requested). */
+  mkp->table = ( p->tabulate
+                 ? gal_pointer_allocate(GAL_TYPE_FLOAT64, p->tabulate+2, 0,
+                                        __func__, "mkp->table")
+                 : NULL );
+
+  /* Allocate the quasi-random sequence generator (when requested). */
+  mkp->qrng = p->qrng ? gsl_qrng_alloc(p->qrng, ndim) : NULL;
+
   /* Make each profile that was specified for this thread. */
   for(i=0; mkp->indexs[i]!=GAL_BLANK_SIZE_T; ++i)
     {
@@ -564,14 +591,19 @@ mkprof_build(void *inparam)
 
 
       /* Add this profile to the list of profiles that must be written onto
-         the final merged image with another thread. */
-      if(p->cp.numthreads>1)
+         the final merged image with another thread. When the profiles are
+         to be merged in parallel, they are kept in this thread's queue
+         until all profiles are built. */
+      if(p->cp.numthreads>1 && p->parallelmerge==0)
         mkprof_add_built_to_write_queue(mkp, ibq, &fbq, i);
     }
 
   /* Free the allocated space for this thread and wait until all other
      threads finish. */
   gsl_rng_free(mkp->rng);
+  gal_pqueue_free(mkp->pq);
+  if(mkp->table) free(mkp->table);
+  if(mkp->qrng) gsl_qrng_free(mkp->qrng);
   if(p->cp.numthreads==1)
     p->bq=mkp->ibq;
   else
@@ -602,15 +634,108 @@ mkprof_build(void *inparam)
 /**************************************************************/
 /************              The writer             *************/
 /**************************************************************/
+/* Fill the log array for this profile. */
 static void
-mkprof_write(struct mkprofparams *p)
+mkprof_write_log(struct mkprofparams *p, struct builtqueue *ibq)
+{
+  size_t clog=0;
+  gal_data_t *log;
+
+  for(log=p->log; log!=NULL; log=log->next)
+    switch(++clog)
+      {
+      case 5:
+        ((unsigned char *)(log->array))[ibq->id] = ibq->indivcreated;
+        break;
+      case 4:
+        ((float *)(log->array))[ibq->id] = ibq->accufrac;
+        break;
+      case 3:
+        ((unsigned long *)(log->array))[ibq->id]=ibq->numaccu;
+        break;
+      case 2:
+        ((float *)(log->array))[ibq->id] =
+          gal_units_counts_to_mag(ibq->sum, p->zeropoint);
+        break;
+      case 1:
+        ((unsigned long *)(log->array))[ibq->id]=ibq->id+1;
+        break;
+      }
+}
+
+
+
+
+
+/* Free the arrays of a built profile and the queue element itself. Note
+   that there is no problem to free a NULL pointer (when the built array
+   didn't overlap). */
+static void
+mkprof_write_free_built(struct builtqueue *ibq)
+{
+  gal_data_free(ibq->overlap_i);
+  gal_data_free(ibq->overlap_m);
+  gal_data_free(ibq->image);
+  free(ibq);
+}
+
+
+
+
+
+/* Write the final array to the output FITS image if a merged image is to
+   be created. */
+static void
+mkprof_write_merged(struct mkprofparams *p)
 {
-  double sum;
   char *jobname;
   struct timeval t1;
-  gal_data_t *out=p->out, *log;
+  gal_data_t *out=p->out;
+
+  if(out)
+    {
+      /* Get the current time for verbose output. */
+      if(!p->cp.quiet) gettimeofday(&t1, NULL);
+
+      /* Write the final image into a FITS file with the requested
+         type. Until now, we were using 'p->wcs' for the WCS, but from now
+         on, will put it in 'out' to also free it while freeing 'out'. */
+      out->wcs=p->wcs;
+      gal_fits_img_write_to_type(out, p->mergedimgname, NULL,
+                                 PROGRAM_NAME, p->cp.type, p->cp.compress);
+      p->wcs=NULL;
+
+      /* Clean up */
+      gal_data_free(out);
+
+      /* Write the configuration keywords. */
+      gal_fits_key_write_filename("input", p->catname, &p->cp.okeys, 1,
+                                  p->cp.quiet);
+      gal_fits_key_write_config(&p->cp.okeys, "MakeProfiles configuration",
+                                "MKPROF-CONFIG", p->mergedimgname, "0");
+
+      /* In verbose mode, print the information. */
+      if(!p->cp.quiet)
+        {
+          if( asprintf(&jobname, "%s created.", p->mergedimgname)<0 )
+            error(EXIT_FAILURE, 0, "%s: asprintf allocation", __func__);
+          gal_timing_report(&t1, jobname, 1);
+          free(jobname);
+        }
+    }
+}
+
+
+
+
+
+static void
+mkprof_write(struct mkprofparams *p)
+{
+  char *jobname;
+  gal_data_t *out=p->out;
   struct builtqueue *ibq=NULL, *tbq;
-  size_t complete=0, num=p->num, clog;
+  size_t complete=0, num=p->num;
 
   /* Write each image into the output array. */
   while(complete<p->num)
@@ -630,7 +755,6 @@ mkprof_write(struct mkprofparams *p)
               pthread_mutex_unlock(&p->qlock);
             }
         }
-      sum=0.0f;
 
 
       /* During the build process, we also defined the overlap tiles of
@@ -640,35 +764,11 @@ mkprof_write(struct mkprofparams *p)
       if(ibq->overlaps && out)
         GAL_TILE_PO_OISET(float,float,ibq->overlap_i,ibq->overlap_m,1,0, {
             *o  = p->replace ? ( *i>*o ? *i : *o ) :  (*i + *o);
-            sum += *i;
           });
 
 
       /* Fill the log array. */
-      if(p->cp.log)
-        {
-          clog=0;
-          for(log=p->log; log!=NULL; log=log->next)
-            switch(++clog)
-              {
-              case 5:
-                ((unsigned char *)(log->array))[ibq->id] = ibq->indivcreated;
-                break;
-              case 4:
-                ((float *)(log->array))[ibq->id] = ibq->accufrac;
-                break;
-              case 3:
-                ((unsigned long *)(log->array))[ibq->id]=ibq->numaccu;
-                break;
-              case 2:
-                ((float *)(log->array))[ibq->id] =
-                  gal_units_counts_to_mag(sum, p->zeropoint);
-                break;
-              case 1:
-                ((unsigned long *)(log->array))[ibq->id]=ibq->id+1;
-                break;
-              }
-        }
+      if(p->cp.log) mkprof_write_log(p, ibq);
 
 
       /* Report if in verbose mode. */
@@ -683,51 +783,172 @@ mkprof_write(struct mkprofparams *p)
         }
 
 
-      /* Free the array and the queue element and change it to the next one
-         and increment complete. Note that there is no problem to free a
-         NULL pointer (when the built array didn't overlap). */
-      gal_data_free(ibq->overlap_i);
-      gal_data_free(ibq->overlap_m);
-      gal_data_free(ibq->image);
+      /* Free the queue element and change it to the next one. */
       tbq=ibq->next;
-      free(ibq);
+      mkprof_write_free_built(ibq);
       ibq=tbq;
     }
 
 
-  /* Write the final array to the output FITS image if a merged image is to
-     be created. */
-  if(out)
+  /* Write the merged image. */
+  mkprof_write_merged(p);
+}
+
+
+
+
+
+/* Parameters for merging the profiles in parallel. */
+struct mkprof_merge_params
+{
+  struct mkprofparams     *p;  /* Main program parameters.            */
+  struct builtqueue    **bqs;  /* All built profiles (sorted by ID).   */
+  size_t         stripewidth;  /* Width of each stripe along dim 0.    */
+};
+
+
+
+
+
+/* Add the pixels of all the built profiles that overlap with the stripes
+   given to this thread. Each stripe is a contiguous range along the
+   slowest dimension of the merged image: no other thread will write into
+   it, so no locking is necessary. The profiles are added in the order of
+   their IDs, so the output doesn't depend on the number of threads (or
+   which thread finished first), with or without '--replace'. */
+static void *
+mkprof_write_merge_on_thread(void *in_prm)
+{
+  struct gal_threads_params *tprm=(struct gal_threads_params *)in_prm;
+  struct mkprof_merge_params *mprm=tprm->params;
+  struct mkprofparams *p=mprm->p;
+
+  struct builtqueue *ibq;
+  float *i, *f, *o, *iarr, *oarr=p->out->array;
+  size_t ndim=p->out->ndim, *odsize=p->out->dsize;
+  size_t a, b, j, k, lo, hi, s0, s1, nrows, start[3], *dsize, *idsize;
+
+  /* Go over all the stripes given to this thread. */
+  for(a=0; tprm->indexs[a]!=GAL_BLANK_SIZE_T; ++a)
     {
-      /* Get the current time for verbose output. */
-      if(!p->cp.quiet) gettimeofday(&t1, NULL);
+      /* Range of this stripe along the slowest dimension. */
+      s0 = tprm->indexs[a] * mprm->stripewidth;
+      s1 = s0 + mprm->stripewidth < odsize[0] ? s0 + mprm->stripewidth
+                                              : odsize[0];
 
-      /* Write the final image into a FITS file with the requested
-         type. Until now, we were using 'p->wcs' for the WCS, but from now
-         on, will put it in 'out' to also free it while freeing 'out'. */
-      out->wcs=p->wcs;
-      gal_fits_img_write_to_type(out, p->mergedimgname, NULL,
-                                 PROGRAM_NAME, p->cp.type);
-      p->wcs=NULL;
+      /* Go over all the profiles. */
+      for(b=0; b<p->num; ++b)
+        {
+          /* Ignore profiles that don't overlap with the merged image. */
+          ibq=mprm->bqs[b];
+          if(ibq->overlaps==0) continue;
+
+          /* Starting coordinate of this profile's overlap in the merged
+             image and its size. */
+          dsize=ibq->overlap_m->dsize;
+          gal_dimension_index_to_coord((float *)(ibq->overlap_m->array)
+                                       - oarr, ndim, odsize, start);
+
+          /* Only continue if it overlaps with this stripe. */
+          lo = start[0] > s0 ? start[0] : s0;
+          hi = start[0]+dsize[0] < s1 ? start[0]+dsize[0] : s1;
+          if(lo>=hi) continue;
+
+          /* Parse the overlapping rows (the last dimension is contiguous
+             in both the individual and merged images). */
+          iarr=ibq->overlap_i->array;
+          idsize=ibq->image->dsize;
+          nrows = ndim==3 ? dsize[1] : 1;
+          for(k=lo; k<hi; ++k)
+            for(j=0; j<nrows; ++j)
+              {
+                /* Set the starting pointers of this row. */
+                if(ndim==3)
+                  {
+                    o = oarr + ( k*odsize[1] + start[1] + j )*odsize[2]
+                        + start[2];
+                    i = iarr + ( (k-start[0])*idsize[1] + j )*idsize[2];
+                  }
+                else
+                  {
+                    o = oarr + k*odsize[1] + start[1];
+                    i = iarr + (k-start[0])*idsize[1];
+                  }
+
+                /* Add the pixels of this row. */
+                for(f=i+dsize[ndim-1]; i<f; ++i, ++o)
+                  *o = p->replace ? ( *i>*o ? *i : *o ) :  (*i + *o);
+              }
+        }
+    }
 
-      /* Clean up */
-      gal_data_free(out);
+  /* Wait for all the other threads to finish and return. */
+  if(tprm->b) pthread_barrier_wait(tprm->b);
+  return NULL;
+}
 
-      /* Write the configuration keywords. */
-      gal_fits_key_write_filename("input", p->catname, &p->cp.okeys, 1,
-                                  p->cp.quiet);
-      gal_fits_key_write_config(&p->cp.okeys, "MakeProfiles configuration",
-                                "MKPROF-CONFIG", p->mergedimgname, "0");
 
-      /* In verbose mode, print the information. */
-      if(!p->cp.quiet)
+
+
+
+/* When '--parallelmerge' is called, the builder threads keep their built
+   profiles and the merging is done after all the profiles are built. The
+   merged image is then divided into stripes along its slowest dimension
+   and each thread adds the profiles over its own stripes. This removes
+   the bottleneck of a single writer thread (when there are many small
+   profiles), but all the built profiles have to be kept in memory. */
+static void
+mkprof_write_parallel(struct mkprofparams *p, struct mkonthread *mkp)
+{
+  size_t i, numstripes;
+  struct builtqueue **bqs, *ibq, *tbq;
+  struct mkprof_merge_params mprm={0};
+  size_t nt=p->cp.numthreads, numforbalance=4;
+
+  /* Put all the built profiles into an array, sorted by their ID. */
+  errno=0;
+  bqs=malloc(p->num * sizeof *bqs);
+  if(bqs==NULL)
+    error(EXIT_FAILURE, errno, "%s: allocating %zu bytes for 'bqs'",
+          __func__, p->num * sizeof *bqs);
+  for(i=0;i<nt;++i)
+    for(ibq=mkp[i].ibq; ibq!=NULL; ibq=ibq->next)
+      bqs[ibq->id]=ibq;
+
+  /* Merge the profiles into the output in parallel. To balance the load
+     (profiles are usually not uniformly distributed over the image),
+     there are more stripes than threads. */
+  if(p->out)
+    {
+      numstripes = nt*numforbalance;
+      if(numstripes>p->out->dsize[0]) numstripes=p->out->dsize[0];
+      mprm.p=p;
+      mprm.bqs=bqs;
+      mprm.stripewidth = p->out->dsize[0]/numstripes
+                         + (p->out->dsize[0]%numstripes ? 1 : 0);
+      numstripes = p->out->dsize[0]/mprm.stripewidth
+                   + (p->out->dsize[0]%mprm.stripewidth ? 1 : 0);
+      gal_threads_spin_off(mkprof_write_merge_on_thread, &mprm, numstripes,
+                           nt, p->cp.minmapsize, p->cp.quietmmap);
+    }
+
+  /* Fill the log and free the built profiles. */
+  for(i=0;i<nt;++i)
+    {
+      ibq=mkp[i].ibq;
+      while(ibq!=NULL)
         {
-          if( asprintf(&jobname, "%s created.", p->mergedimgname)<0 )
-            error(EXIT_FAILURE, 0, "%s: asprintf allocation", __func__);
-          gal_timing_report(&t1, jobname, 1);
-          free(jobname);
+          if(p->cp.log) mkprof_write_log(p, ibq);
+          tbq=ibq->next;
+          mkprof_write_free_built(ibq);
+          ibq=tbq;
         }
+      mkp[i].ibq=NULL;
     }
+  free(bqs);
+
+  /* Write the merged image. */
+  mkprof_write_merged(p);
 }
 
 
@@ -857,8 +1078,16 @@ mkprof(struct mkprofparams *p)
 
 
   /* Write the created arrays into the image. Set the original quiet flag
-     and let the user know that its done. */
-  mkprof_write(p);
+     and let the user know that its done. When the profiles are to be
+     merged in parallel, we should first wait for all the builder threads
+     to finish. */
+  if(nt>1 && p->parallelmerge)
+    {
+      pthread_barrier_wait(&b);
+      mkprof_write_parallel(p, mkp);
+    }
+  else
+    mkprof_write(p);
   if(p->num>numforprint)
     {
       p->cp.quiet=origquiet;
@@ -883,7 +1112,7 @@ mkprof(struct mkprofparams *p)
      the attribute and barrier. */
   if(nt>1)
     {
-      pthread_barrier_wait(&b);
+      if(p->parallelmerge==0) pthread_barrier_wait(&b);
       pthread_attr_destroy(&attr);
       pthread_barrier_destroy(&b);
       pthread_cond_destroy(&p->qready);
@@ -23,6 +23,7 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 #ifndef MOCKGALS_H
 #define MOCKGALS_H
 
+#include <gnuastro/pqueue.h>
 #include <gnuastro/threads.h>
 
 #include "main.h"
@@ -53,6 +54,14 @@ struct mkonthread
 
   /* Random number generator: */
   gsl_rng            *rng;   /* Copy of main random number generator. */
+  gsl_qrng          *qrng;   /* Quasi-random sequence (when requested).*/
+
+  /* Queue of pixels to build (re-used for all profiles of a thread). */
+  gal_pqueue_t        *pq;   /* Pixels ordered by distance to center. */
+
+  /* Table of profile values (when '--tabulate' is given). */
+  double           *table;   /* Profile on regular radii (+2 elements).*/
+  double       tableinvdr;   /* Inverse of the radius interval.       */
 
   /* Profile specific parameters: */
   double        sersic_re;   /* r/re in Sersic profile.               */
@@ -30,6 +30,7 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 
 #include <sys/time.h>            /* generate random seed */
 #include <gsl/gsl_rng.h>         /* used in setrandoms   */
+#include <gsl/gsl_qrng.h>        /* Quasi-random points. */
 #include <gsl/gsl_randist.h>     /* To make noise.       */
 #include <gsl/gsl_integration.h> /* gsl_integration_qng  */
 
@@ -196,7 +197,7 @@ float
 oneprofile_randompoints(struct mkonthread *mkp)
 {
   double r_before=mkp->r;
-  double range[3], sum=0.0f;
+  double range[3], point[3], sum=0.0f;
   size_t i, j, numrandom=mkp->p->numrandom, ndim=mkp->p->ndim;
   double coord_before[3]={mkp->coord[0], mkp->coord[1], mkp->coord[2]};
 
@@ -204,14 +205,33 @@ oneprofile_randompoints(struct mkonthread *mkp)
   for(i=0;i<ndim;++i)
     range[i] = mkp->higher[i] - mkp->lower[i];
 
-  /* Find the sum of the profile on the random positions. */
-  for(i=0;i<numrandom;++i)
+  /* Find the sum of the profile on the random positions. When a
+     quasi-random (low-discrepancy) sequence is requested, the points are
+     more evenly spread over the pixel, so the average converges much
+     faster than with pseudo-random points. The sequence is re-initialized
+     for each pixel, so the result doesn't depend on the order the pixels
+     (or profiles) are built (or the number of threads). */
+  if(mkp->qrng)
     {
-      for(j=0;j<ndim;++j)
-        mkp->coord[j] = mkp->lower[j] + gsl_rng_uniform(mkp->rng) * range[j];
-      oneprofile_r_el(mkp);
-      sum+=mkp->profile(mkp);
+      gsl_qrng_init(mkp->qrng);
+      for(i=0;i<numrandom;++i)
+        {
+          gsl_qrng_get(mkp->qrng, point);
+          for(j=0;j<ndim;++j)
+            mkp->coord[j] = mkp->lower[j] + point[j] * range[j];
+          oneprofile_r_el(mkp);
+          sum+=mkp->profile(mkp);
+        }
     }
+  else
+    for(i=0;i<numrandom;++i)
+      {
+        for(j=0;j<ndim;++j)
+          mkp->coord[j] = ( mkp->lower[j]
+                            + gsl_rng_uniform(mkp->rng) * range[j] );
+        oneprofile_r_el(mkp);
+        sum+=mkp->profile(mkp);
+      }
 
   /* Reset the original distance and coordinate of the pixel and return the
      average random value. The resetting is mostly redundant (only useful
@@ -245,6 +265,78 @@ oneprofile_randompoints(struct mkonthread *mkp)
 
 
 
+/****************************************************************
+ **************        Tabulated profile       ******************
+ ****************************************************************/
+/* Tabulate the profile over 'p->tabulate' equally spaced radii from zero
+   to the truncation radius. One extra element is kept on each side of the
+   table so the cubic interpolation below doesn't need any special
+   treatment at the two ends: the profile is symmetric around zero and it
+   is linearly extrapolated after the truncation radius. */
+static void
+oneprofile_tabulate(struct mkonthread *mkp)
+{
+  size_t i, n=mkp->p->tabulate;
+  double r_before=mkp->r, *t=mkp->table, dr=mkp->truncr/(n-1);
+
+  /* Fill the table. */
+  for(i=0;i<n;++i)
+    {
+      mkp->r = i*dr;
+      t[i+1] = mkp->profile(mkp);
+    }
+  t[0]   = t[2];
+  t[n+1] = 2*t[n] - t[n-1];
+
+  /* Keep the inverse of the radial interval for the interpolation and
+     reset the radius. */
+  mkp->tableinvdr = 1/dr;
+  mkp->r=r_before;
+}
+
+
+
+
+
+/* Find the profile's value at 'mkp->r' with cubic (Catmull-Rom)
+   interpolation over the four nearest elements of the table. */
+static double
+oneprofile_tabulated(struct mkonthread *mkp)
+{
+  double x=mkp->r*mkp->tableinvdr, f, *t;
+  size_t i=x, n=mkp->p->tabulate;
+
+  /* The last interval is closed (for the truncation radius itself). */
+  if(i>=n-1) i=n-2;
+  f=x-i;
+  t=mkp->table+i;      /* 't[1]' is the value at radius 'i'. */
+
+  /* Do the interpolation. */
+  return t[1] + 0.5 * f * ( t[2] - t[0]
+                            + f * ( 2*t[0] - 5*t[1] + 4*t[2] - t[3]
+                                    + f * ( 3*(t[1]-t[2]) + t[3]
+                                            - t[0] ) ) );
+}
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
 /****************************************************************
  *****************      2D integration       ********************
  ****************************************************************/
@@ -325,6 +417,29 @@ integ2d(struct mkonthread *mkp)
 /************       Pixel by pixel building       *************/
 /*********        Positions are in C not FITS         *********/
 /**************************************************************/
+/* Estimate the number of pixels that are left to be filled after the
+   random points: the number of pixels within the truncation radius
+   (within the image) minus those that have already been done. */
+static size_t
+oneprofile_num_remaining(struct mkonthread *mkp)
+{
+  double r=mkp->truncr, num;
+  struct builtqueue *ibq=mkp->ibq;
+
+  /* Volume (in pixels) of the truncated ellipse or ellipsoid. */
+  num = ( mkp->p->ndim==2
+          ? M_PI * mkp->q[0] * r * r
+          : 4.0/3.0 * M_PI * mkp->q[0] * mkp->q[1] * r * r * r );
+  if(num > ibq->image->size) num=ibq->image->size;
+
+  /* Return the remaining number. */
+  return num > ibq->numaccu ? num - ibq->numaccu : 0;
+}
+
+
+
+
+
 /* 'oneprofile_center_oversampled' stored the center of the profile in
    floating point coordinates. This function will convert that into a
    pixel index. */
@@ -365,10 +480,9 @@ oneprofile_pix_by_pix(struct mkonthread *mkp)
   float circ_r, *array=mkp->ibq->image->array;
   double (*profile)(struct mkonthread *)=mkp->profile;
   double truncr=mkp->truncr, approx, hp=0.5f/mkp->p->oversample;
+  double (*centerprofile)(struct mkonthread *)=mkp->profile;
   size_t i, p, *dinc=gal_dimension_increment(ndim, dsize);
-
-  /* lQ: Largest. sQ: Smallest in queue */
-  gal_list_dosizet_t *lQ=NULL, *sQ;
+  gal_pqueue_t *pq=mkp->pq;
 
   /* Find the nearest pixel to the profile center and add it to the
      queue. */
@@ -385,9 +499,10 @@ oneprofile_pix_by_pix(struct mkonthread *mkp)
                              gal_dimension_total_size(ndim, dsize), 1,
                              __func__, "byt");
 
-  /* Start the queue: */
+  /* Start the queue (it is empty: 'gal_pqueue_to_sizet' below empties it
+     after each profile). */
   byt[p]=1;
-  gal_list_dosizet_add( &lQ, &sQ, p, oneprofile_r_circle(p, mkp) );
+  gal_pqueue_add(pq, p, oneprofile_r_circle(p, mkp));
 
   /* If random points are necessary, then do it: */
   switch(mkp->func)
@@ -395,18 +510,13 @@ oneprofile_pix_by_pix(struct mkonthread *mkp)
     case PROFILE_SERSIC:
     case PROFILE_MOFFAT:
     case PROFILE_GAUSSIAN:
-      while(sQ)
+      while(pq->size)
         {
-          /* In case you want to see the status of the twosided ordered
-             queue, increasing and decreasing side by side, uncomment this
-             line. Note that there will be a lot of lines printed! */
-          /*print_tossll(lQ, sQ);*/
-
           /* Pop a pixel from the queue, convert its index into coordinates
              and use them to estimate the elliptical radius of the
              pixel. If the pixel is outside the truncation radius, ignore
              it. */
-          p=gal_list_dosizet_pop_smallest(&lQ, &sQ, &circ_r);
+          p=gal_pqueue_pop_smallest(pq, &circ_r);
           oneprofile_set_coord(mkp, p);
           oneprofile_r_el(mkp);
           if(mkp->r > truncr) continue;
@@ -444,8 +554,7 @@ oneprofile_pix_by_pix(struct mkonthread *mkp)
               if(byt[nind]==0)
                 {
                   byt[nind]=1;
-                  gal_list_dosizet_add( &lQ, &sQ, nind,
-                                        oneprofile_r_circle(nind, mkp) );
+                  gal_pqueue_add(pq, nind, oneprofile_r_circle(nind, mkp));
                 }
             } );
 
@@ -456,7 +565,23 @@ oneprofile_pix_by_pix(struct mkonthread *mkp)
 
   /* All the pixels that required integration or random points are now
      done, so we don't need an ordered array any more. */
-  gal_list_dosizet_to_sizet(lQ, &Q);
+  gal_pqueue_to_sizet(pq, &Q);
+
+
+  /* If requested, the remaining pixels (that only need the profile's
+     value at their center) of the profiles that are costly to evaluate
+     are found by interpolating over a table of the profile. Building the
+     table needs 'p->tabulate' evaluations of the profile, so it is only
+     done when more pixels than that are left. */
+  if( mkp->p->tabulate && Q
+      && oneprofile_num_remaining(mkp) > mkp->p->tabulate
+      && ( mkp->func==PROFILE_SERSIC
+           || mkp->func==PROFILE_MOFFAT
+           || mkp->func==PROFILE_GAUSSIAN ) )
+    {
+      oneprofile_tabulate(mkp);
+      centerprofile=oneprofile_tabulated;
+    }
 
 
   /* Order doesn't matter any more, add all the pixels you find. */
@@ -479,7 +604,7 @@ oneprofile_pix_by_pix(struct mkonthread *mkp)
         }
 
       /* Find the value for this pixel: */
-      array[p]=profile(mkp);
+      array[p]=centerprofile(mkp);
 
       /* For a check:
       printf("r_center: %g\n", mkp->r);
@@ -552,12 +677,13 @@ oneprofile_custom_img(struct mkprofparams *p, size_t id)
   /* Load the image. In 'ui.c', we have already checked that the number of
      images given to '--customimg' is atleast equal to the largest
      requested profile. Also, note that if only one HDU is given, we'll
-     assume that for all HDUs. */
+     assume that for all HDUs. This is done within one of the building
+     threads, so only one thread is used for reading. */
   thdu=p->customimghdu;
   timg=p->customimgname; for(i=1;i<imgcounter;++i) timg=timg->next;
   if(p->customimghdu->next)
     for(i=1;i<imgcounter;++i) thdu=thdu->next;
-  out=gal_fits_img_read_to_type(timg->v, thdu->v, GAL_TYPE_FLOAT32,
+  out=gal_fits_img_read_to_type(timg->v, thdu->v, GAL_TYPE_FLOAT32, 1,
                                 p->cp.minmapsize, p->cp.quietmmap);
 
   /* Make sure the image has an odd number of pixels on each side. */
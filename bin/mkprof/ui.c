@@ -547,6 +547,30 @@ ui_read_check_only_options(struct mkprofparams *p)
               "coordinate columns");
     }
 
+  /* The table of profile values needs atleast two elements (for the
+     center and the truncation radius). */
+  if(p->tabulate==1)
+    error(EXIT_FAILURE, 0, "the value to '--tabulate' must be larger than "
+          "1 (or 0 to disable tabulation)");
+
+  /* The quasi-random sequence for the central pixels. */
+  if(p->qrngname)
+    {
+      if(      !strcmp(p->qrngname, "sobol") )
+        p->qrng=gsl_qrng_sobol;
+      else if( !strcmp(p->qrngname, "niederreiter") )
+        p->qrng=gsl_qrng_niederreiter_2;
+      else if( !strcmp(p->qrngname, "halton") )
+        p->qrng=gsl_qrng_halton;
+      else if( !strcmp(p->qrngname, "reversehalton") )
+        p->qrng=gsl_qrng_reversehalton;
+      else
+        error(EXIT_FAILURE, 0, "'%s' not recognized as a value to "
+              "'--qrng'. The acceptable values are 'sobol', "
+              "'niederreiter', 'halton' and 'reversehalton'",
+              p->qrngname);
+    }
+
   /* The zeropoint magnitude is only necessary when 'mcolissum' is
      not called.  */
   if( p->mcolissum==0 && isnan(p->zeropoint) )
@@ -1953,6 +1977,7 @@ ui_read_ndim(struct mkprofparams *p)
               /* Read the image. */
               p->out=gal_array_read_one_ch_to_type(p->backname, p->backhdu,
                                                    NULL, GAL_TYPE_FLOAT32,
+                                                   p->cp.numthreads,
                                                    p->cp.minmapsize,
                                                    p->cp.quietmmap);
               p->out->ndim=gal_dimension_remove_extra(p->out->ndim,
@@ -2117,6 +2142,15 @@ ui_print_intro(struct mkprofparams *p)
   gal_timing_report(NULL, jobname, 1);
   free(jobname);
 
+  if(p->qrng)
+    {
+      if( asprintf(&jobname, "Central pixels with quasi-random sequence: "
+                   "%s", p->qrngname)<0 )
+        error(EXIT_FAILURE, 0, "%s: asprintf allocation", __func__);
+      gal_timing_report(NULL, jobname, 1);
+      free(jobname);
+    }
+
   if(p->kernel==NULL)
     {
       if( asprintf(&jobname, "Using %zu threads.", p->cp.numthreads)<0 )
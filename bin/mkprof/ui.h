@@ -73,6 +73,9 @@ enum option_keys_enum
 
   /* Only with long version. */
   UI_KEY_PSFINIMG        = 1000,
+  UI_KEY_PARALLELMERGE,
+  UI_KEY_TABULATE,
+  UI_KEY_QRNG,
   UI_KEY_MAGATPEAK,
   UI_KEY_MCOLISSUM,
   UI_KEY_MCOLNOCUSTPROF,
@@ -85,6 +85,19 @@ struct argp_option program_options[] =
       GAL_OPTIONS_NOT_MANDATORY,
       GAL_OPTIONS_NOT_SET
     },
+    {
+      "convcache",
+      UI_KEY_CONVCACHE,
+      "DIR",
+      0,
+      "Directory to keep/reuse convolved images.",
+      GAL_OPTIONS_GROUP_INPUT,
+      &p->convcache,
+      GAL_TYPE_STRING,
+      GAL_OPTIONS_RANGE_ANY,
+      GAL_OPTIONS_NOT_MANDATORY,
+      GAL_OPTIONS_NOT_SET
+    },
     {
       "widekernel",
       UI_KEY_WIDEKERNEL,
@@ -80,6 +80,120 @@ detection_ngb_to_connectivity(size_t ndim, size_t ngb)
 
 
 
+/* Erosion and opening are local operations: after 'erode' erosions and an
+   opening of depth 'opening', the value of a pixel only depends on the
+   pixels within 'erode+2*opening' pixels of it. So instead of doing them
+   over the full image (on one thread), we can do them independently on
+   each large tile, as long as the tile is padded by a "halo" of that width
+   (or the edge of the image). Only the tile's own pixels (not its halo)
+   are then written into the output, so the result is identical to the
+   full-image operation. */
+struct eo_params
+{
+  size_t                    halo;  /* Width of halo around each tile.    */
+  gal_data_t                *out;  /* Output (eroded and opened) image.  */
+  struct noisechiselparams    *p;  /* Pointer to NoiseChisel parameters. */
+};
+
+static void *
+detection_erode_open_on_tile(void *in_prm)
+{
+  struct gal_threads_params *tprm=(struct gal_threads_params *)in_prm;
+  struct eo_params *eo_prm=(struct eo_params *)(tprm->params);
+  struct noisechiselparams *p=eo_prm->p;
+
+  uint8_t *b, *bf;
+  size_t i, d, ndim=p->binary->ndim, *dsize=p->binary->dsize;
+  gal_data_t *tile, *halotile, *copy, *inner, *otile;
+  size_t start_end[20], halominmax[20], innerminmax[20], tileminmax[20];
+
+  /* Go over all the tiles given to this thread. */
+  for(i=0; tprm->indexs[i] != GAL_BLANK_SIZE_T; ++i)
+    {
+      /* Coordinates of the tile in the full image (the end coordinates
+         are not inclusive). */
+      tile=&p->ltl.tiles[tprm->indexs[i]];
+      gal_tile_start_end_coord(tile, start_end, 1);
+
+      /* Set the inclusive minimum and maximum coordinates of the tile,
+         its halo (limited by the image edges) and the tile within the
+         halo. */
+      for(d=0;d<ndim;++d)
+        {
+          tileminmax[d]      = start_end[d];
+          tileminmax[d+ndim] = start_end[d+ndim]-1;
+          halominmax[d]      = ( start_end[d] > eo_prm->halo
+                                 ? start_end[d]-eo_prm->halo : 0 );
+          halominmax[d+ndim] = ( start_end[d+ndim]-1+eo_prm->halo < dsize[d]
+                                 ? start_end[d+ndim]-1+eo_prm->halo
+                                 : dsize[d]-1 );
+          innerminmax[d]      = tileminmax[d]      - halominmax[d];
+          innerminmax[d+ndim] = tileminmax[d+ndim] - halominmax[d];
+        }
+
+      /* Copy the tile and its halo into a separate array to work on. */
+      halotile=gal_tile_series_from_minmax(p->binary, halominmax, 1);
+      copy=gal_data_copy(halotile);
+
+      /* Erode, correct the no-erode values and open. */
+      gal_binary_erode(copy, p->erode,
+                       detection_ngb_to_connectivity(ndim, p->erodengb), 1);
+      bf=(b=copy->array)+copy->size;
+      do *b = *b==THRESHOLD_NO_ERODE_VALUE ? 1 : *b; while(++b<bf);
+      gal_binary_open(copy, p->opening,
+                      detection_ngb_to_connectivity(ndim, p->openingngb), 1);
+
+      /* Write the tile's own pixels (without the halo) into the output. */
+      inner=gal_tile_series_from_minmax(copy, innerminmax, 1);
+      otile=gal_tile_series_from_minmax(eo_prm->out, tileminmax, 1);
+      GAL_TILE_PARSE_OPERATE(otile, inner, 1, 0, {*i=*o;});
+
+      /* Clean up. */
+      gal_data_free(copy);
+      gal_data_array_free(inner, 1, 0);
+      gal_data_array_free(otile, 1, 0);
+      gal_data_array_free(halotile, 1, 0);
+    }
+
+  /* Wait until all the threads finish and return. */
+  if(tprm->b) pthread_barrier_wait(tprm->b);
+  return NULL;
+}
+
+
+
+
+
+/* Do the erosion and opening over the large tiles and replace the binary
+   image with the result. */
+static void
+detection_erode_open_tiled(struct noisechiselparams *p)
+{
+  struct eo_params eo_prm;
+
+  /* Allocate the output and set the halo width. */
+  eo_prm.p=p;
+  eo_prm.halo=p->erode + 2*p->opening;
+  eo_prm.out=gal_data_alloc(NULL, GAL_TYPE_UINT8, p->binary->ndim,
+                            p->binary->dsize, p->binary->wcs, 0,
+                            p->cp.minmapsize, p->cp.quietmmap, NULL,
+                            "binary", NULL);
+  eo_prm.out->flag=p->binary->flag;
+
+  /* Do the operations on each large tile. */
+  gal_threads_spin_off(detection_erode_open_on_tile, &eo_prm,
+                       p->ltl.tottiles, p->cp.numthreads,
+                       p->cp.minmapsize, p->cp.quietmmap);
+
+  /* Replace the binary image with the output. */
+  gal_data_free(p->binary);
+  p->binary=eo_prm.out;
+}
+
+
+
+
+
 void
 detection_initial(struct noisechiselparams *p)
 {
@@ -103,7 +217,8 @@ detection_initial(struct noisechiselparams *p)
   if(p->detectionname)
     {
       p->binary->name="THRESHOLDED";
-      gal_fits_img_write(p->binary, p->detectionname, NULL, PROGRAM_NAME);
+      gal_fits_img_write(p->binary, p->detectionname, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       p->binary->name=NULL;
     }
 
@@ -117,44 +232,68 @@ detection_initial(struct noisechiselparams *p)
     }
 
 
-  /* Erode the image. */
-  if(!p->cp.quiet) gettimeofday(&t1, NULL);
-  gal_binary_erode(p->binary, p->erode,
-                   detection_ngb_to_connectivity(p->input->ndim,
-                                                 p->erodengb), 1);
-  if(!p->cp.quiet)
+  /* When no check image is requested and there is more than one large
+     tile and thread, do the erosion and opening independently on each
+     large tile (with a halo). Otherwise, do them over the full image (the
+     check image needs the eroded image before the opening). */
+  if( p->detectionname==NULL && p->cp.numthreads>1 && p->ltl.tottiles>1
+      && p->input->ndim>1 )
     {
-      if( asprintf(&msg, "Eroded %zu time%s (%zu-connected).", p->erode,
-                   p->erode!=1?"s":"", p->erodengb)<0 )
-        error(EXIT_FAILURE, 0, "%s: asprintf allocation", __func__);
-      gal_timing_report(&t1, msg, 2);
-      free(msg);
+      if(!p->cp.quiet) gettimeofday(&t1, NULL);
+      detection_erode_open_tiled(p);
+      if(!p->cp.quiet)
+        {
+          if( asprintf(&msg, "Eroded %zu time%s (%zu-connected) and opened "
+                       "(depth: %zu, %zu-connected) on large tiles.",
+                       p->erode, p->erode!=1?"s":"", p->erodengb,
+                       p->opening, p->openingngb)<0 )
+            error(EXIT_FAILURE, 0, "%s: asprintf allocation", __func__);
+          gal_timing_report(&t1, msg, 2);
+          free(msg);
+        }
     }
-  if(p->detectionname)
+  else
     {
-      p->binary->name="ERODED";
-      gal_fits_img_write(p->binary, p->detectionname, NULL, PROGRAM_NAME);
-      p->binary->name=NULL;
-    }
+      /* Erode the image. */
+      if(!p->cp.quiet) gettimeofday(&t1, NULL);
+      gal_binary_erode(p->binary, p->erode,
+                       detection_ngb_to_connectivity(p->input->ndim,
+                                                     p->erodengb), 1);
+      if(!p->cp.quiet)
+        {
+          if( asprintf(&msg, "Eroded %zu time%s (%zu-connected).", p->erode,
+                       p->erode!=1?"s":"", p->erodengb)<0 )
+            error(EXIT_FAILURE, 0, "%s: asprintf allocation", __func__);
+          gal_timing_report(&t1, msg, 2);
+          free(msg);
+        }
+      if(p->detectionname)
+        {
+          p->binary->name="ERODED";
+          gal_fits_img_write(p->binary, p->detectionname, NULL, PROGRAM_NAME,
+                             p->cp.compress);
+          p->binary->name=NULL;
+        }
 
 
-  /* Correct the no-erode values. */
-  bf=(b=p->binary->array)+p->binary->size;
-  do *b = *b==THRESHOLD_NO_ERODE_VALUE ? 1 : *b; while(++b<bf);
+      /* Correct the no-erode values. */
+      bf=(b=p->binary->array)+p->binary->size;
+      do *b = *b==THRESHOLD_NO_ERODE_VALUE ? 1 : *b; while(++b<bf);
 
 
-  /* Do the opening. */
-  if(!p->cp.quiet) gettimeofday(&t1, NULL);
-  gal_binary_open(p->binary, p->opening,
-                  detection_ngb_to_connectivity(p->input->ndim,
-                                                p->openingngb), 1);
-  if(!p->cp.quiet)
-    {
-      if( asprintf(&msg, "Opened (depth: %zu, %zu-connected).",
-                   p->opening, p->openingngb)<0 )
-        error(EXIT_FAILURE, 0, "%s: asprintf allocation", __func__);
-      gal_timing_report(&t1, msg, 2);
-      free(msg);
+      /* Do the opening. */
+      if(!p->cp.quiet) gettimeofday(&t1, NULL);
+      gal_binary_open(p->binary, p->opening,
+                      detection_ngb_to_connectivity(p->input->ndim,
+                                                    p->openingngb), 1);
+      if(!p->cp.quiet)
+        {
+          if( asprintf(&msg, "Opened (depth: %zu, %zu-connected).",
+                       p->opening, p->openingngb)<0 )
+            error(EXIT_FAILURE, 0, "%s: asprintf allocation", __func__);
+          gal_timing_report(&t1, msg, 2);
+          free(msg);
+        }
     }
 
 
@@ -173,7 +312,8 @@ detection_initial(struct noisechiselparams *p)
   if(p->detectionname)
     {
       p->olabel->name="OPENED-AND-LABELED";
-      gal_fits_img_write(p->olabel, p->detectionname, NULL, PROGRAM_NAME);
+      gal_fits_img_write(p->olabel, p->detectionname, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       p->olabel->name=NULL;
     }
 
@@ -371,7 +511,8 @@ detection_pseudo_find(struct noisechiselparams *p, gal_data_t *workbin,
   if(p->detectionname)
     {
       workbin->name = s0d1 ? "DTHRESH-ON-DET" : "DTHRESH-ON-SKY";
-      gal_fits_img_write(workbin, p->detectionname, NULL, PROGRAM_NAME);
+      gal_fits_img_write(workbin, p->detectionname, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       workbin->name=NULL;
     }
 
@@ -435,7 +576,8 @@ detection_pseudo_find(struct noisechiselparams *p, gal_data_t *workbin,
             }
 
           /* Write the temporary array into the check image. */
-          gal_fits_img_write(bin, p->detectionname, NULL, PROGRAM_NAME);
+          gal_fits_img_write(bin, p->detectionname, NULL, PROGRAM_NAME,
+                             p->cp.compress);
 
           /* Increment the step counter. */
           ++fho_prm.step;
@@ -652,7 +794,8 @@ detection_sn(struct noisechiselparams *p, gal_data_t *worklab, size_t num,
           while(++plab<plabend);
         }
       worklab->name=extname;
-      gal_fits_img_write(worklab, p->detectionname, NULL, PROGRAM_NAME);
+      gal_fits_img_write(worklab, p->detectionname, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       worklab->name=NULL;
     }
 
@@ -765,7 +908,7 @@ detection_pseudo_remove_low_sn(struct noisechiselparams *p,
     {
       workbin->name="TRUE-PSEUDOS";
       gal_fits_img_write(workbin, p->detectionname, NULL,
-                         PROGRAM_NAME);
+                         PROGRAM_NAME, p->cp.compress);
       workbin->name=NULL;
     }
 
@@ -1171,7 +1314,7 @@ detection(struct noisechiselparams *p)
     {
       workbin->name="DETECTIONS-INIT-TRUE";
       gal_fits_img_write(workbin, p->detectionname, NULL,
-                         PROGRAM_NAME);
+                         PROGRAM_NAME, p->cp.compress);
       workbin->name=NULL;
     }
   if(!p->cp.quiet)
@@ -1255,7 +1398,7 @@ detection(struct noisechiselparams *p)
     {
       p->olabel->name="DETECTION-FINAL";
       gal_fits_img_write(p->olabel, p->detectionname, NULL,
-                         PROGRAM_NAME);
+                         PROGRAM_NAME, p->cp.compress);
       p->olabel->name=NULL;
     }
 
@@ -60,7 +60,7 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
        size_t i;
        float *arr;
        gal_data_t *img=gal_fits_img_read_to_type("kernel.fits", "1",
-                                                 GAL_TYPE_FLOAT32, -1);
+                                                 GAL_TYPE_FLOAT32, 1, -1, 1);
 
        arr=img->array;
 
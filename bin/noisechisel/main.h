@@ -48,6 +48,7 @@ struct noisechiselparams
   char                  *khdu;  /* Kernel HDU.                            */
   char         *convolvedname;  /* Convolved image (to avoid convolution).*/
   char                  *chdu;  /* HDU of convolved image.                */
+  char             *convcache;  /* Directory to cache convolved images. */
   char        *widekernelname;  /* Name of wider kernel to be used.       */
   char                  *whdu;  /* Wide kernel HDU.                       */
 
@@ -97,6 +98,8 @@ struct noisechiselparams
   char          *detsn_D_name;  /* Final detection S/N name.              */
   char         *detectionname;  /* Name of detection steps file.          */
   char               *skyname;  /* Name of Sky estimation steps file.     */
+  char         *convcachename;  /* Name of convolved image in cache.     */
+  uint8_t          convcached;  /* Convolved image was read from cache.  */
 
   gal_data_t           *input;  /* Input image.                           */
   gal_data_t          *kernel;  /* Sharper kernel.                        */
@@ -33,6 +33,7 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 
 #include <gnuastro-internal/timing.h>
 #include <gnuastro-internal/checkset.h>
+#include <gnuastro-internal/convolve-internal.h>
 
 #include "main.h"
 
@@ -78,6 +79,11 @@ noisechisel_convolve(struct noisechiselparams *p)
               else
                 gal_timing_report(&t1, "Convolved with given kernel.", 1);
             }
+
+          /* Keep the convolved image in the cache (if requested). */
+          if(p->convcachename)
+            gal_convolveinternal_cache_write(p->conv, p->convcachename,
+                                             PROGRAM_NAME);
         }
       else
         p->conv=p->input;
@@ -96,9 +102,11 @@ noisechisel_convolve(struct noisechiselparams *p)
   /* Save the convolution step if necessary. */
   if(p->detectionname)
     {
-      gal_fits_img_write(p->input, p->detectionname, NULL, PROGRAM_NAME);
+      gal_fits_img_write(p->input, p->detectionname, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       if(p->input!=p->conv)
-        gal_fits_img_write(p->conv, p->detectionname, NULL, PROGRAM_NAME);
+        gal_fits_img_write(p->conv, p->detectionname, NULL, PROGRAM_NAME,
+                           p->cp.compress);
     }
 
   /* Convolve with wider kernel (if requested). */
@@ -152,7 +160,8 @@ noisechisel_output(struct noisechiselparams *p)
       /* Correct the name of the input and write it out. */
       if(p->input->name) free(p->input->name);
       p->input->name="INPUT-NO-SKY";
-      gal_fits_img_write(p->input, p->cp.output, NULL, PROGRAM_NAME);
+      gal_fits_img_write(p->input, p->cp.output, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       p->input->name=NULL;
     }
 
@@ -169,13 +178,15 @@ noisechisel_output(struct noisechiselparams *p)
   if(p->label)
     {
       p->olabel->name = "DETECTIONS";
-      gal_fits_img_write(p->olabel, p->cp.output, keys, PROGRAM_NAME);
+      gal_fits_img_write(p->olabel, p->cp.output, keys, PROGRAM_NAME,
+                         p->cp.compress);
       p->olabel->name=NULL;
     }
   else
     {
       p->binary->name = "DETECTIONS";
-      gal_fits_img_write(p->binary, p->cp.output, keys, PROGRAM_NAME);
+      gal_fits_img_write(p->binary, p->cp.output, keys, PROGRAM_NAME,
+                         p->cp.compress);
       p->binary->name=NULL;
     }
   keys=NULL;
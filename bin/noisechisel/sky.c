@@ -201,7 +201,8 @@ sky_and_std(struct noisechiselparams *p, char *checkname)
   if(checkname && !tl->oneelempertile)
     {
       p->binary->name="DETECTED";
-      gal_fits_img_write(p->binary, checkname, NULL, PROGRAM_NAME);
+      gal_fits_img_write(p->binary, checkname, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       p->binary->name=NULL;
     }
 
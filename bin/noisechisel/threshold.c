@@ -226,7 +226,7 @@ threshold_write_sn_table(struct noisechiselparams *p, gal_data_t *insn,
      FITS file. We have already deleted any existing file with the same
      name in 'ui_set_output_names'.*/
   gal_table_write(cols, NULL, comments, p->cp.tableformat, filename,
-                  extname, 0);
+                  extname, 0, p->cp.numthreads);
 
 
   /* Clean up (if necessary). */
@@ -399,7 +399,7 @@ qthresh_on_tile(void *in_prm)
   int type=qprm->erode_th->type;
   gal_data_t *meanconv = p->wconv ? p->wconv : p->conv;
   size_t i, tind, twidth=gal_type_sizeof(type), ndim=p->input->ndim;
-  gal_data_t *tile, *mean, *num, *meanquant, *qvalue, *usage, *tblock=NULL;
+  gal_data_t *tile, *mean, *meanquant, *qvalue, *usage, *tblock=NULL;
 
   /* Put the temporary usage space for this thread into a data set for easy
      processing. */
@@ -434,15 +434,17 @@ qthresh_on_tile(void *in_prm)
       tile->block=tblock;
 
 
-      /* Find the mean's quantile on this tile, note that we have already
-         copied the tile's dataset to a newly allocated place. So we have
-         set the 'inplace' flag to '1' to avoid extra allocation. */
+      /* Find the mean's quantile on this tile. The 'inplace' flag is
+         '0' so 'usage' isn't sorted here: the mean's quantile can be
+         found without sorting and most tiles (that have signal) will be
+         rejected after this step. So sorting is only done (once, in the
+         first 'gal_statistics_quantile' call below) for the tiles that
+         pass. The mean is blank when there are no usable elements. */
       mean=gal_statistics_mean(usage);
-      num=gal_statistics_number(usage);
       mean=gal_data_copy_to_new_type_free(mean, usage->type);
-      meanquant = ( *(size_t *)(num->array)
-                    ? gal_statistics_quantile_function(usage, mean, 1)
-                    : NULL );
+      meanquant = ( gal_blank_is(mean->array, mean->type)
+                    ? NULL
+                    : gal_statistics_quantile_function(usage, mean, 0) );
 
       /* Only continue if the mean's quantile is close enough to the
          median.  */
@@ -502,7 +504,6 @@ qthresh_on_tile(void *in_prm)
         }
 
       /* Clean up and fix the tile's pointers. */
-      gal_data_free(num);
       gal_data_free(mean);
       gal_data_free(meanquant);
     }
@@ -602,10 +603,10 @@ threshold_quantile_find_apply(struct noisechiselparams *p)
   if(p->qthreshname && !tl->oneelempertile)
     {
       gal_fits_img_write(p->conv ? p->conv : p->input, p->qthreshname, NULL,
-                         PROGRAM_NAME);
+                         PROGRAM_NAME, p->cp.compress);
       if(p->wconv)
         gal_fits_img_write(p->wconv ? p->wconv : p->input, p->qthreshname,
-                           NULL, PROGRAM_NAME);
+                           NULL, PROGRAM_NAME, p->cp.compress);
     }
 
 
@@ -716,7 +717,8 @@ threshold_quantile_find_apply(struct noisechiselparams *p)
   if(p->qthreshname && !tl->oneelempertile)
     {
       p->binary->name="QTHRESH-APPLIED";
-      gal_fits_img_write(p->binary, p->qthreshname, NULL, PROGRAM_NAME);
+      gal_fits_img_write(p->binary, p->qthreshname, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       p->binary->name=NULL;
     }
 
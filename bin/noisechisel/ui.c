@@ -39,6 +39,7 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 #include <gnuastro-internal/timing.h>
 #include <gnuastro-internal/options.h>
 #include <gnuastro-internal/checkset.h>
+#include <gnuastro-internal/convolve-internal.h>
 #include <gnuastro-internal/fixedstringmacros.h>
 
 #include "main.h"
@@ -545,12 +546,14 @@ ui_prepare_tiles(struct noisechiselparams *p)
     {
       /* Large tiles. */
       check=gal_tile_block_check_tiles(ltl->tiles);
-      gal_fits_img_write(check, tl->tilecheckname, NULL, PROGRAM_NAME);
+      gal_fits_img_write(check, tl->tilecheckname, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       gal_data_free(check);
 
       /* Small tiles. */
       check=gal_tile_block_check_tiles(tl->tiles);
-      gal_fits_img_write(check, tl->tilecheckname, NULL, PROGRAM_NAME);
+      gal_fits_img_write(check, tl->tilecheckname, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       gal_data_free(check);
 
       /* If 'continueaftercheck' hasn't been called, abort NoiseChisel. */
@@ -608,6 +611,7 @@ ui_preparations_read_input(struct noisechiselparams *p)
      (with a length of 1). */
   p->input = gal_array_read_one_ch_to_type(p->inputname, p->cp.hdu,
                                            NULL, GAL_TYPE_FLOAT32,
+                                           p->cp.numthreads,
                                            p->cp.minmapsize,
                                            p->cp.quietmmap);
   p->input->wcs = gal_wcs_read(p->inputname, p->cp.hdu,
@@ -681,6 +685,7 @@ ui_preparations(struct noisechiselparams *p)
       /* Read the input convolved image. */
       p->conv = gal_array_read_one_ch_to_type(p->convolvedname, p->chdu,
                                               NULL, GAL_TYPE_FLOAT32,
+                                              p->cp.numthreads,
                                               p->cp.minmapsize,
                                               p->cp.quietmmap);
 
@@ -700,6 +705,24 @@ ui_preparations(struct noisechiselparams *p)
   /* Prepare the tessellation. */
   ui_prepare_tiles(p);
 
+  /* If a directory is given for the cache of convolved images (and no
+     convolved image was given explicitly), see if this input has already
+     been convolved with this kernel and tessellation. */
+  if(p->convcache && p->conv==NULL && p->kernel)
+    {
+      p->convcachename=gal_convolveinternal_cache_name(p->convcache,
+                                                       p->input, p->kernel,
+                                                       &p->cp.tl);
+      p->conv=gal_convolveinternal_cache_read(p->convcachename, p->input,
+                                              p->cp.minmapsize,
+                                              p->cp.quietmmap);
+      if(p->conv)
+        {
+          p->convcached=1;
+          p->conv->wcs=gal_wcs_copy(p->input->wcs);
+        }
+    }
+
   /* Allocate space for the over-all necessary arrays. */
   p->binary=gal_data_alloc(NULL, GAL_TYPE_UINT8, p->input->ndim,
                            p->input->dsize, p->input->wcs, 0,
@@ -801,6 +824,8 @@ ui_read_check_inputs_setup(int argc, char *argv[],
       if(p->convolvedname)
         printf("  - Convolved input: %s (hdu: %s)\n",
                p->convolvedname, p->chdu);
+      else if(p->convcached)
+        printf("  - Convolved input (from cache): %s\n", p->convcachename);
       else
         {
           if(p->kernelname)
@@ -899,12 +924,14 @@ ui_free_report(struct noisechiselparams *p, struct timeval *t1)
   if(p->khdu) free(p->khdu);
   if(p->whdu) free(p->whdu);
   if(p->chdu) free(p->chdu);
+  if(p->convcache) free(p->convcache);
   if(p->skyname) free(p->skyname);
   if(p->detskyname) free(p->detskyname);
   if(p->qthreshname) free(p->qthreshname);
   if(p->detsn_s_name) free(p->detsn_s_name);
   if(p->detsn_d_name) free(p->detsn_d_name);
   if(p->detectionname) free(p->detectionname);
+  if(p->convcachename) free(p->convcachename);
 
   /* Free the allocated datasets. */
   gal_data_free(p->sky);
@@ -78,6 +78,7 @@ enum option_keys_enum
   UI_KEY_KHDU               = 1000,
   UI_KEY_CONVOLVED,
   UI_KEY_CHDU,
+  UI_KEY_CONVCACHE,
   UI_KEY_WHDU,
   UI_KEY_MINNUMFALSE,
   UI_KEY_SMOOTHWIDTH,
@@ -556,7 +556,7 @@ clumps_write_sn_table(struct segmentparams *p, gal_data_t *insn,
 
   /* write the table. */
   gal_table_write(cols, NULL, comments, p->cp.tableformat, filename,
-                  "SKY_CLUMP_SN", 0);
+                  "SKY_CLUMP_SN", 0, p->cp.numthreads);
 
   /* Clean up (if necessary). */
   if(sn!=insn) gal_data_free(sn);
@@ -661,7 +661,7 @@ clumps_true_find_sn_thresh(struct segmentparams *p)
              demo, set all Sky regions to blank and all clump macro values
              to zero. */
           gal_fits_img_write(p->clabel, p->segmentationname, NULL,
-                             PROGRAM_NAME);
+                             PROGRAM_NAME, p->cp.compress);
 
           /* Increment the step counter. */
           ++clprm.step;
@@ -53,6 +53,7 @@ struct segmentparams
   char                  *khdu;  /* Kernel HDU.                            */
   char         *convolvedname;  /* Convolved image (to avoid convolution).*/
   char                  *chdu;  /* HDU of convolved image.                */
+  char             *convcache;  /* Directory to cache convolved images. */
   char         *detectionname;  /* Detection image file name.             */
   char                  *dhdu;  /* Detection image file name.             */
   char               *skyname;  /* Filename of Sky image.                 */
@@ -82,6 +83,8 @@ struct segmentparams
   char        *clumpsn_s_name;  /* Sky clump S/N name.                    */
   char        *clumpsn_d_name;  /* Detection clumps S/N name.             */
   char      *segmentationname;  /* Name of segmentation steps file.       */
+  char         *convcachename;  /* Name of convolved image in cache.     */
+  uint8_t          convcached;  /* Convolved image was read from cache.  */
 
   gal_data_t           *input;  /* Input dataset.                         */
   gal_data_t          *kernel;  /* Given kernel for convolution.          */
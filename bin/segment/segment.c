@@ -41,6 +41,7 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 
 #include <gnuastro-internal/timing.h>
 #include <gnuastro-internal/checkset.h>
+#include <gnuastro-internal/convolve-internal.h>
 
 #include "main.h"
 
@@ -80,6 +81,14 @@ segment_convolve(struct segmentparams *p)
           /* Report and write check images if necessary. */
           if(!p->cp.quiet)
             gal_timing_report(&t1, "Convolved with given kernel.", 1);
+
+          /* Keep the convolved image in the cache (if requested). Since
+             the key of the cached image is derived from the input file,
+             it is only written when no Sky has been subtracted from the
+             input. */
+          if(p->convcachename && p->skyname==NULL)
+            gal_convolveinternal_cache_write(p->conv, p->convcachename,
+                                             PROGRAM_NAME);
         }
       else
         p->conv=p->input;
@@ -1065,7 +1074,7 @@ segment_save_sn_table(struct clumps_params *clprm)
   clumpinobj->next=sn;
   objind->next=clumpinobj;
   gal_table_write(objind, NULL, comments, p->cp.tableformat, p->clumpsn_d_name,
-                  "DET_CLUMP_SN", 0);
+                  "DET_CLUMP_SN", 0, p->cp.numthreads);
 
 
   /* Clean up. */
@@ -1311,7 +1320,8 @@ segment_detections(struct segmentparams *p)
             }
 
           /* Write the demonstration array into the check image.  */
-          gal_fits_img_write(demo, p->segmentationname, NULL, PROGRAM_NAME);
+          gal_fits_img_write(demo, p->segmentationname, NULL, PROGRAM_NAME,
+                             p->cp.compress);
 
           /* Increment the step counter. */
           ++clprm.step;
@@ -1384,7 +1394,8 @@ segment_output(struct segmentparams *p)
 
   /* The Sky-subtracted input (if requested). */
   if(!p->rawoutput)
-    gal_fits_img_write(p->input, p->cp.output, NULL, PROGRAM_NAME);
+    gal_fits_img_write(p->input, p->cp.output, NULL, PROGRAM_NAME,
+                       p->cp.compress);
 
 
   /* The clump labels. */
@@ -1395,7 +1406,8 @@ segment_output(struct segmentparams *p)
                         &p->numclumps, 0, "Total number of clumps", 0,
                         "counter", 0);
   p->clabel->name="CLUMPS";
-  gal_fits_img_write(p->clabel, p->cp.output, keys, PROGRAM_NAME);
+  gal_fits_img_write(p->clabel, p->cp.output, keys, PROGRAM_NAME,
+                     p->cp.compress);
   p->clabel->name=NULL;
   keys=NULL;
 
@@ -1407,7 +1419,8 @@ segment_output(struct segmentparams *p)
                             &p->numobjects, 0, "Total number of objects", 0,
                             "counter", 0);
       p->olabel->name="OBJECTS";
-      gal_fits_img_write(p->olabel, p->cp.output, keys, PROGRAM_NAME);
+      gal_fits_img_write(p->olabel, p->cp.output, keys, PROGRAM_NAME,
+                         p->cp.compress);
       p->olabel->name=NULL;
       keys=NULL;
     }
@@ -1442,7 +1455,8 @@ segment_output(struct segmentparams *p)
       /* Write the STD dataset into the output file. */
       p->std->name="SKY_STD";
       if(p->std->size == p->input->size)
-        gal_fits_img_write(p->std, p->cp.output, keys, PROGRAM_NAME);
+        gal_fits_img_write(p->std, p->cp.output, keys, PROGRAM_NAME,
+                           p->cp.compress);
       else
         gal_tile_full_values_write(p->std, &p->cp.tl, 1, p->cp.output, keys,
                                    PROGRAM_NAME);
@@ -1502,12 +1516,14 @@ segment(struct segmentparams *p)
      in. */
   if(p->segmentationname)
     {
-      gal_fits_img_write(p->input, p->segmentationname, NULL, PROGRAM_NAME);
+      gal_fits_img_write(p->input, p->segmentationname, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       if(p->input!=p->conv)
-        gal_fits_img_write(p->conv, p->segmentationname, NULL, PROGRAM_NAME);
+        gal_fits_img_write(p->conv, p->segmentationname, NULL, PROGRAM_NAME,
+                           p->cp.compress);
       p->olabel->name="DETECTION_LABELS";
       gal_fits_img_write(p->olabel, p->segmentationname, NULL,
-                         PROGRAM_NAME);
+                         PROGRAM_NAME, p->cp.compress);
       p->olabel->name=NULL;
     }
   if(!p->cp.quiet)
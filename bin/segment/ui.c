@@ -39,6 +39,7 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 #include <gnuastro-internal/timing.h>
 #include <gnuastro-internal/options.h>
 #include <gnuastro-internal/checkset.h>
+#include <gnuastro-internal/convolve-internal.h>
 #include <gnuastro-internal/fixedstringmacros.h>
 
 #include "main.h"
@@ -413,6 +414,7 @@ ui_prepare_inputs(struct segmentparams *p)
   /* Read the input as a single precision floating point dataset. */
   p->input = gal_array_read_one_ch_to_type(p->inputname, p->cp.hdu,
                                            NULL, GAL_TYPE_FLOAT32,
+                                           p->cp.numthreads,
                                            p->cp.minmapsize,
                                            p->cp.quietmmap);
   p->input->wcs = gal_wcs_read(p->inputname, p->cp.hdu,
@@ -444,6 +446,7 @@ ui_prepare_inputs(struct segmentparams *p)
       /* Read the input convolved image. */
       p->conv = gal_array_read_one_ch_to_type(p->convolvedname, p->chdu,
                                               NULL, GAL_TYPE_FLOAT32,
+                                              p->cp.numthreads,
                                               p->cp.minmapsize,
                                               p->cp.quietmmap);
       p->conv->ndim=gal_dimension_remove_extra(p->conv->ndim,
@@ -466,7 +469,8 @@ ui_prepare_inputs(struct segmentparams *p)
     {
       /* Read the dataset into memory. */
       p->olabel = gal_array_read_one_ch(p->useddetectionname, p->dhdu,
-                                        NULL, p->cp.minmapsize,
+                                        NULL, p->cp.numthreads,
+                                        p->cp.minmapsize,
                                         p->cp.quietmmap);
       p->olabel->ndim=gal_dimension_remove_extra(p->olabel->ndim,
                                                  p->olabel->dsize, NULL);
@@ -639,12 +643,14 @@ ui_prepare_tiles(struct segmentparams *p)
     {
       /* Large tiles. */
       check=gal_tile_block_check_tiles(ltl->tiles);
-      gal_fits_img_write(check, tl->tilecheckname, NULL, PROGRAM_NAME);
+      gal_fits_img_write(check, tl->tilecheckname, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       gal_data_free(check);
 
       /* Small tiles. */
       check=gal_tile_block_check_tiles(tl->tiles);
-      gal_fits_img_write(check, tl->tilecheckname, NULL, PROGRAM_NAME);
+      gal_fits_img_write(check, tl->tilecheckname, NULL, PROGRAM_NAME,
+                         p->cp.compress);
       gal_data_free(check);
 
       /* If 'continueaftercheck' hasn't been called, abort NoiseChisel. */
@@ -775,6 +781,7 @@ ui_read_std_and_sky(struct segmentparams *p)
       /* Read the STD image. */
       p->std=gal_array_read_one_ch_to_type(p->usedstdname, p->stdhdu,
                                            NULL, GAL_TYPE_FLOAT32,
+                                           p->cp.numthreads,
                                            p->cp.minmapsize, p->cp.quietmmap);
       p->std->ndim=gal_dimension_remove_extra(p->std->ndim,
                                               p->std->dsize, NULL);
@@ -835,6 +842,7 @@ ui_read_std_and_sky(struct segmentparams *p)
           /* Read the Sky dataset. */
           sky=gal_array_read_one_ch_to_type(p->skyname, p->skyhdu,
                                             NULL, GAL_TYPE_FLOAT32,
+                                            p->cp.numthreads,
                                             p->cp.minmapsize, p->cp.quietmmap);
           sky->ndim=gal_dimension_remove_extra(sky->ndim, sky->dsize,
                                                NULL);
@@ -883,6 +891,27 @@ ui_preparations(struct segmentparams *p)
   /* Prepare the tessellation. */
   ui_prepare_tiles(p);
 
+  /* If a directory is given for the cache of convolved images (and no
+     convolved image was given explicitly), see if this input has already
+     been convolved with this kernel and tessellation (for example by
+     NoiseChisel). When found, it is treated like an image given to
+     '--convolved' (the Sky will also be subtracted from it if
+     necessary). */
+  if(p->convcache && p->conv==NULL && p->kernel)
+    {
+      p->convcachename=gal_convolveinternal_cache_name(p->convcache,
+                                                       p->input, p->kernel,
+                                                       &p->cp.tl);
+      p->conv=gal_convolveinternal_cache_read(p->convcachename, p->input,
+                                              p->cp.minmapsize,
+                                              p->cp.quietmmap);
+      if(p->conv)
+        {
+          p->convcached=1;
+          p->conv->wcs=gal_wcs_copy(p->input->wcs);
+        }
+    }
+
   /* Prepare the (optional Sky, and) Sky Standard deviation image. */
   return ui_read_std_and_sky(p);
 }
@@ -997,6 +1026,8 @@ ui_read_check_inputs_setup(int argc, char *argv[], struct segmentparams *p)
       if(p->convolvedname)
         printf("  - Convolved input: %s (hdu: %s)\n", p->convolvedname,
                p->chdu);
+      else if(p->convcached)
+        printf("  - Convolved input (from cache): %s\n", p->convcachename);
       else
         {
           if(p->kernelname)
@@ -1096,7 +1127,9 @@ ui_free_report(struct segmentparams *p, struct timeval *t1)
   if(p->stdname) free(p->stdname);
   if(p->kernelname) free(p->kernelname);
   if(p->detectionname) free(p->detectionname);
+  if(p->convcache) free(p->convcache);
   if(p->convolvedname) free(p->convolvedname);
+  if(p->convcachename) free(p->convcachename);
   if(p->conv!=p->input) gal_data_free(p->conv);
   if(p->clumpsn_s_name) free(p->clumpsn_s_name);
   if(p->clumpsn_d_name) free(p->clumpsn_d_name);
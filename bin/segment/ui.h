@@ -73,6 +73,7 @@ enum option_keys_enum
   UI_KEY_KHDU               = 1000,
   UI_KEY_CONVOLVED,
   UI_KEY_CHDU,
+  UI_KEY_CONVCACHE,
   UI_KEY_DHDU,
   UI_KEY_SKY,
   UI_KEY_SKYHDU,
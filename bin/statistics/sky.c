@@ -162,7 +162,8 @@ sky(struct statisticsparams *p)
 
   /* When checking steps, the input image is the first extension. */
   if(p->checksky)
-    gal_fits_img_write(p->input, p->checkskyname, NULL, PROGRAM_NAME);
+    gal_fits_img_write(p->input, p->checkskyname, NULL, PROGRAM_NAME,
+                       p->cp.compress);
 
 
   /* Convolve the image (if desired). */
@@ -173,7 +174,7 @@ sky(struct statisticsparams *p)
                                         cp->numthreads, 1, tl->workoverch);
       if(p->checksky)
         gal_fits_img_write(p->convolved, p->checkskyname, NULL,
-                           PROGRAM_NAME);
+                           PROGRAM_NAME, p->cp.compress);
       if(!cp->quiet)
         gal_timing_report(&t1, "Input convolved with kernel.", 1);
     }
@@ -1131,11 +1131,12 @@ ui_preparations(struct statisticsparams *p)
   /* Change 'keepinputdir' based on if an output name was given. */
   p->cp.keepinputdir = p->cp.output ? 1 : 0;
 
-  /* Read the input. */
+  /* Read the input (when possible, the image is directly mapped from
+     the file: it is read only once, see 'gal_fits_img_read_map'). */
   if(p->isfits && p->hdu_type==IMAGE_HDU)
     {
       p->inputformat=INPUT_FORMAT_IMAGE;
-      p->input=gal_array_read_one_ch(p->inputname, cp->hdu, NULL,
+      p->input=gal_fits_img_read_map(p->inputname, cp->hdu, cp->numthreads,
                                      cp->minmapsize, p->cp.quietmmap);
       p->input->wcs=gal_wcs_read(p->inputname, cp->hdu,
                                  p->cp.wcslinearmatrix, 0, 0,
@@ -1182,13 +1183,13 @@ ui_preparations(struct statisticsparams *p)
           check=gal_tile_block_check_tiles(tl->tiles);
           if(p->inputformat==INPUT_FORMAT_IMAGE)
             gal_fits_img_write(check, tl->tilecheckname, NULL,
-                               PROGRAM_NAME);
+                               PROGRAM_NAME, cp->compress);
           else
             {
               gal_checkset_writable_remove(tl->tilecheckname, p->inputname,
                                            0, cp->dontdelete);
               gal_table_write(check, NULL, NULL, cp->tableformat,
-                              tl->tilecheckname, "TABLE", 0);
+                              tl->tilecheckname, "TABLE", 0, cp->numthreads);
             }
           gal_data_free(check);
         }
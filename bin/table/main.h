@@ -35,6 +35,9 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 #define PROGRAM_EXEC   "asttable"      /* Program executable name. */
 #define PROGRAM_STRING PROGRAM_NAME" (" PACKAGE_NAME ") " PACKAGE_VERSION
 
+/* Number of rows in each chunk when reading the selection columns. */
+#define SELECT_CHUNK_ROWS 1000000
+
 /* Row selection types. */
 enum select_types
 {
@@ -141,6 +144,7 @@ struct tableparams
   gal_data_t         *sortcol;  /* Column to define a sorting.          */
   int               selection;  /* Any row-selection is requested.      */
   gal_data_t          *select;  /* Select rows for output.              */
+  uint8_t            pushdown;  /* Rows were selected while reading.    */
   struct list_select *selectcol; /* Column to define a range.           */
   uint8_t            freesort;  /* If the sort column should be freed.  */
   uint8_t         *freeselect;  /* If selection columns should be freed.*/
@@ -165,16 +165,16 @@ table_bring_to_top(gal_data_t *table, gal_data_t *rowids)
 
 
 static gal_data_t *
-table_selection_range(struct tableparams *p, gal_data_t *col)
+table_selection_range(gal_data_t *range, gal_data_t *col)
 {
   size_t one=1;
   double *darr;
   int numok=GAL_ARITHMETIC_FLAG_NUMOK;
   int inplace=GAL_ARITHMETIC_FLAG_INPLACE;
-  gal_data_t *min=NULL, *max=NULL, *tmp, *ltmin, *gemax=NULL;
+  gal_data_t *min=NULL, *max=NULL, *ltmin, *gemax=NULL;
 
   /* First, make sure everything is OK. */
-  if(p->range==NULL)
+  if(range==NULL)
     error(EXIT_FAILURE, 0, "%s: a bug! Please contact us to fix the "
           "problem at %s. 'p->range' should not be NULL at this point",
           __func__, PACKAGE_BUGREPORT);
@@ -186,16 +186,10 @@ table_selection_range(struct tableparams *p, gal_data_t *col)
                      NULL, NULL, NULL);
 
   /* Read the range of values for this column. */
-  darr=p->range->array;
+  darr=range->array;
   ((double *)(min->array))[0] = darr[0];
   ((double *)(max->array))[0] = darr[1];
 
-  /* Move 'p->range' to the next element in the list and free the current
-     one (we have already read its values and don't need it any more). */
-  tmp=p->range;
-  p->range=p->range->next;
-  gal_data_free(tmp);
-
   /* Find all the elements outside this range (smaller than the minimum,
      larger than the maximum or blank) as separate binary flags.. */
   ltmin=gal_arithmetic(GAL_ARITHMETIC_OP_LT, 1, numok, col, min);
@@ -334,7 +328,7 @@ table_selection_string_eq_ne(gal_data_t *column, char *reference, int e0n1)
 
 
 static gal_data_t *
-table_selection_equal_or_notequal(struct tableparams *p, gal_data_t *col,
+table_selection_equal_or_notequal(gal_data_t *arg, gal_data_t *col,
                                   int e0n1)
 {
   void *varr;
@@ -343,7 +337,6 @@ table_selection_equal_or_notequal(struct tableparams *p, gal_data_t *col,
   int numok=GAL_ARITHMETIC_FLAG_NUMOK;
   int inplace=GAL_ARITHMETIC_FLAG_INPLACE;
   gal_data_t *eq, *out=NULL, *value=NULL;
-  gal_data_t *arg = e0n1 ? p->notequal : p->equal;
 
   /* Note that this operator is used to make the "masked" array, so when
      'e0n1==0' the operator should be 'GAL_ARITHMETIC_OP_NE' and
@@ -357,7 +350,7 @@ table_selection_equal_or_notequal(struct tableparams *p, gal_data_t *col,
   /* First, make sure everything is OK. */
   if(arg==NULL)
     error(EXIT_FAILURE, 0, "%s: a bug! Please contact us to fix the "
-          "problem at %s. 'p->range' should not be NULL at this point",
+          "problem at %s. 'arg' should not be NULL at this point",
           __func__, PACKAGE_BUGREPORT);
 
   /* To easily parse the given values. */
@@ -373,6 +366,7 @@ table_selection_equal_or_notequal(struct tableparams *p, gal_data_t *col,
       else
         {
           /* Allocate the value dataset. */
+          gal_data_free(value);
           value=gal_data_alloc(NULL, GAL_TYPE_FLOAT64, 1, &one, NULL, 0,
                                -1, 1, NULL, NULL, NULL);
           varr=value->array;
@@ -408,15 +402,8 @@ table_selection_equal_or_notequal(struct tableparams *p, gal_data_t *col,
   */
 
 
-  /* Move the main pointer to the next possible call of the given
-     option. Note that 'arg' already points to 'p->equal' or 'p->notequal',
-     so it will automatically be freed with the next step.*/
-  if(e0n1) p->notequal=p->notequal->next;
-  else     p->equal=p->equal->next;
-
   /* Clean up and return. */
   gal_data_free(value);
-  gal_data_free(arg);
   return out;
 }
 
@@ -424,27 +411,26 @@ table_selection_equal_or_notequal(struct tableparams *p, gal_data_t *col,
 
 
 
-static void
-table_select_by_value(struct tableparams *p)
+/* Build the mask of the rows that must be removed (with a value of 1)
+   from the given selection columns. The values given to the selection
+   options are not changed, so this function can be called on successive
+   chunks of rows (see 'table_read_pushdown'). */
+static gal_data_t *
+table_select_mask(struct tableparams *p, struct list_select *selectcol)
 {
-  gal_data_t *rowids;
   struct list_select *tmp;
-  uint8_t *u, *uf, *ustart;
-  size_t i, *s, ngood=0;
   int inplace=GAL_ARITHMETIC_FLAG_INPLACE;
   gal_data_t *mask, *blmask, *addmask=NULL;
+  gal_data_t *range=p->range, *equal=p->equal, *notequal=p->notequal;
 
-  /* It may happen that the input table is empty! In such cases, just
-     return and don't bother with this step. */
-  if(p->table->size==0 || p->table->array==NULL || p->table->dsize==NULL)
-    return;
-
-  /* Allocate datasets for the necessary numbers and write them in. */
-  mask=gal_data_alloc(NULL, GAL_TYPE_UINT8, 1, p->table->dsize, NULL, 1,
-                      p->cp.minmapsize, p->cp.quietmmap, NULL, NULL, NULL);
+  /* Allocate the mask (with the number of rows in the selection
+     columns). */
+  mask=gal_data_alloc(NULL, GAL_TYPE_UINT8, 1, selectcol->col->dsize,
+                      NULL, 1, p->cp.minmapsize, p->cp.quietmmap, NULL,
+                      NULL, NULL);
 
   /* Go over each selection criteria and remove the necessary elements. */
-  for(tmp=p->selectcol;tmp!=NULL;tmp=tmp->next)
+  for(tmp=selectcol;tmp!=NULL;tmp=tmp->next)
     {
       /* Make sure the input isn't a vector column. */
       if(tmp->col->ndim!=1)
@@ -454,11 +440,14 @@ table_select_by_value(struct tableparams *p)
               "this feature, please get in touch with us at '%s' to add "
               "it", PACKAGE_BUGREPORT);
 
-      /* Do the specific type of selection. */
+      /* Do the specific type of selection. Each call to '--range',
+         '--equal' or '--notequal' corresponds to one selection column (in
+         the same order), so after using each, we'll go to the next. */
       switch(tmp->type)
         {
         case SELECT_TYPE_RANGE:
-          addmask=table_selection_range(p, tmp->col);
+          addmask=table_selection_range(range, tmp->col);
+          range=range->next;
           break;
 
         /* '--inpolygon' and '--outpolygon' need two columns. */
@@ -470,11 +459,13 @@ table_select_by_value(struct tableparams *p)
           break;
 
         case SELECT_TYPE_EQUAL:
-          addmask=table_selection_equal_or_notequal(p, tmp->col, 0);
+          addmask=table_selection_equal_or_notequal(equal, tmp->col, 0);
+          equal=equal->next;
           break;
 
         case SELECT_TYPE_NOTEQUAL:
-          addmask=table_selection_equal_or_notequal(p, tmp->col, 1);
+          addmask=table_selection_equal_or_notequal(notequal, tmp->col, 1);
+          notequal=notequal->next;
           break;
 
         case SELECT_TYPE_NOBLANK:
@@ -503,24 +494,29 @@ table_select_by_value(struct tableparams *p)
          selections). */
       mask=gal_arithmetic(GAL_ARITHMETIC_OP_OR, 1, inplace, mask, addmask);
 
-      /* For a check.
-         {
-           float *f=ref->array;
-           uint8_t *m=mask->array;
-           uint8_t *u=addmask->array, *uf=u+addmask->size;
-           printf("\n\nInput column: %s\n", ref->name?ref->name:"No Name");
-           printf("Range: %g, %g\n", rarr[0], rarr[1]);
-           printf("%-20s%-20s%-20s\n", "Value", "This mask",
-           "Including previous");
-           do printf("%-20f%-20u%-20u\n", *f++, *u++, *m++); while(u<uf);
-           exit(0);
-           }
-        */
-
       /* Final clean up. */
       gal_data_free(addmask);
     }
 
+  /* Return the mask. */
+  return mask;
+}
+
+
+
+
+
+/* Remove the rows that don't pass the selection criteria. */
+static void
+table_select_by_mask(struct tableparams *p)
+{
+  size_t *s, ngood=0;
+  uint8_t *u, *uf, *ustart;
+  gal_data_t *mask, *rowids;
+
+  /* Build the mask of the rows that should be removed. */
+  mask=table_select_mask(p, p->selectcol);
+
   /* Find the final number of elements to print and allocate the array to
      keep them. */
   uf=(u=mask->array)+mask->size;
@@ -544,14 +540,203 @@ table_select_by_value(struct tableparams *p)
      column. */
   if(p->sortcol && p->sortin==0) table_bring_to_top(p->sortcol, rowids);
 
+  /* Clean up. */
+  gal_data_free(mask);
+  gal_data_free(rowids);
+}
+
+
+
+
+
+static void
+table_select_by_value(struct tableparams *p)
+{
+  size_t i;
+  struct list_select *tmp;
+
+  /* It may happen that the input table is empty! In such cases, just
+     return and don't bother with this step. */
+  if(p->table->size==0 || p->table->array==NULL || p->table->dsize==NULL)
+    return;
+
+  /* Select the rows, unless it was already done while reading the table
+     (see 'table_read_pushdown'). */
+  if(p->pushdown==0) table_select_by_mask(p);
+
   /* Clean up. */
   i=0;
   for(tmp=p->selectcol;tmp!=NULL;tmp=tmp->next)
     { if(p->freeselect[i]) {gal_data_free(tmp->col); tmp->col=NULL;} ++i; }
   ui_list_select_free(p->selectcol, 0);
+  gal_list_data_free(p->notequal);
+  gal_list_data_free(p->equal);
+  gal_list_data_free(p->range);
+  p->range=p->equal=p->notequal=NULL;
   free(p->freeselect);
-  gal_data_free(mask);
-  gal_data_free(rowids);
+}
+
+
+
+
+
+/* Read the input table, only keeping the rows that pass the selection
+   criteria. The selection columns are first read in chunks of rows and
+   only the rows that pass are then read from all the requested
+   columns. When the output is limited by position ('--head', '--tail' or
+   '--rowrange' without '--sort'), reading stops as soon as enough rows
+   have been found. This is only called (instead of 'gal_table_read') for
+   FITS tables. 'selectindout' and 'selecttypeout' are the position (in
+   the requested columns) and type of each selection column (see
+   'ui_check_select_sort_before'). */
+gal_data_t *
+table_read_pushdown(struct tableparams *p, size_t nselect,
+                    size_t *selectindout, size_t *selecttypeout)
+{
+  uint8_t *u;
+  double *darr;
+  int tableformat, backward;
+  struct list_select *selectcol;
+  gal_list_sizet_t *tmp, *indexll, *selll=NULL;
+  struct gal_options_common_params *cp=&p->cp;
+  size_t i, j, c, num, first, numcols, numrows, nsel=0;
+  gal_data_t *allcols, *chunk, *col, *mask, *out, **chunkcols=NULL;
+  size_t *sind=NULL, *spos=NULL, *rowids=NULL, *rtmp, nfound=0, numalloc=0;
+  size_t need=GAL_BLANK_SIZE_T;   /* Largest possible 'size_t' value. */
+
+  /* Get the information of all the columns and the input indexs of the
+     requested columns. */
+  allcols=gal_table_info(p->filename, cp->hdu, NULL, &numcols, &numrows,
+                         &tableformat);
+  if(allcols==NULL) return NULL;
+  indexll=gal_table_list_of_indexs(p->columns, allcols, numcols,
+                                   cp->searchin, cp->ignorecase,
+                                   p->filename, cp->hdu, p->colmatch);
+
+  /* When the output rows are limited by their position (and they aren't
+     sorted afterwards), there is no need to find more rows. For '--tail',
+     the table is parsed from the end. */
+  if(p->sort==NULL)
+    {
+      if(p->head!=GAL_BLANK_SIZE_T)      need=p->head;
+      else if(p->tail!=GAL_BLANK_SIZE_T) need=p->tail;
+      else if(p->rowrange)
+        { darr=p->rowrange->array; need=darr[1]+1; }
+    }
+  backward = need!=GAL_BLANK_SIZE_T && p->tail!=GAL_BLANK_SIZE_T;
+
+  /* Without any selection column, the rows are at the top or bottom of
+     the table. */
+  if(nselect==0)
+    {
+      num = need<numrows ? need : numrows;
+      first = backward ? numrows-num : 0;
+      out=gal_fits_tab_read_rows(p->filename, cp->hdu, allcols, indexll,
+                                 NULL, first, num, cp->numthreads,
+                                 cp->minmapsize, cp->quietmmap);
+    }
+  else
+    {
+      /* Find the input index of each selection column. A column may be
+         used in more than one selection, but it only needs to be read
+         once: 'sind' keeps the input index of the columns to read and
+         'spos' keeps the position of each selection column in it. */
+      sind=gal_pointer_allocate(GAL_TYPE_SIZE_T, nselect, 0, __func__,
+                                "sind");
+      spos=gal_pointer_allocate(GAL_TYPE_SIZE_T, nselect, 0, __func__,
+                                "spos");
+      for(i=0;i<nselect;++i)
+        {
+          c=0;
+          for(tmp=indexll;tmp!=NULL;tmp=tmp->next)
+            if(c++==selectindout[i]) break;
+          if(tmp==NULL)
+            error(EXIT_FAILURE, 0, "%s: a bug! Please contact us at %s to "
+                  "fix the problem. Selection column %zu is not in the "
+                  "requested columns", __func__, PACKAGE_BUGREPORT, i);
+          for(j=0;j<nsel;++j) if(sind[j]==tmp->v) break;
+          if(j==nsel) sind[nsel++]=tmp->v;
+          spos[i]=j;
+        }
+      for(j=nsel;j>0;--j) gal_list_sizet_add(&selll, sind[j-1]);
+      errno=0;
+      chunkcols=malloc(nsel*sizeof *chunkcols);
+      if(chunkcols==NULL)
+        error(EXIT_FAILURE, errno, "%s: %zu bytes for 'chunkcols'",
+              __func__, nsel*sizeof *chunkcols);
+
+      /* Parse the table in chunks of rows. */
+      for(c=0; c<numrows && nfound<need; c+=num)
+        {
+          /* Read this chunk of the selection columns. */
+          num = ( numrows-c < SELECT_CHUNK_ROWS
+                  ? numrows-c : SELECT_CHUNK_ROWS );
+          first = backward ? numrows-c-num : c;
+          chunk=gal_fits_tab_read_rows(p->filename, cp->hdu, allcols,
+                                       selll, NULL, first, num,
+                                       cp->numthreads, cp->minmapsize,
+                                       cp->quietmmap);
+
+          /* Build the list of selection columns over this chunk (in the
+             same order as 'p->selectcol', see
+             'ui_check_select_sort_after'). */
+          j=0;
+          selectcol=NULL;
+          for(col=chunk;col!=NULL;col=col->next) chunkcols[j++]=col;
+          for(i=nselect;i>0;--i)
+            ui_list_select_add(&selectcol, chunkcols[spos[i-1]],
+                               selecttypeout[i-1]);
+
+          /* Keep the rows that pass the selection (have a mask value of
+             0). When parsing backwards, the rows are kept in decreasing
+             order. */
+          mask=table_select_mask(p, selectcol);
+          u=mask->array;
+          for(i=0; i<num && nfound<need; ++i)
+            {
+              j = backward ? num-1-i : i;
+              if(u[j]) continue;
+              if(nfound==numalloc)
+                {
+                  numalloc = numalloc ? 2*numalloc : num;
+                  errno=0;
+                  rowids=realloc(rowids, numalloc*sizeof *rowids);
+                  if(rowids==NULL)
+                    error(EXIT_FAILURE, errno, "%s: %zu bytes for "
+                          "'rowids'", __func__, numalloc*sizeof *rowids);
+                }
+              rowids[nfound++]=first+j;
+            }
+
+          /* Clean up. */
+          gal_data_free(mask);
+          gal_list_data_free(chunk);
+          ui_list_select_free(selectcol, 0);
+        }
+
+      /* The rows have to be read in increasing order. */
+      if(backward)
+        for(i=0;i<nfound/2;++i)
+          {
+            rtmp=rowids+nfound-1-i;
+            j=rowids[i]; rowids[i]=*rtmp; *rtmp=j;
+          }
+
+      /* Read the selected rows of all the requested columns. */
+      out=gal_fits_tab_read_rows(p->filename, cp->hdu, allcols, indexll,
+                                 rowids, 0, nfound, cp->numthreads,
+                                 cp->minmapsize, cp->quietmmap);
+    }
+
+  /* Clean up and return. */
+  if(sind) free(sind);
+  if(spos) free(spos);
+  if(rowids) free(rowids);
+  if(chunkcols) free(chunkcols);
+  gal_list_sizet_free(selll);
+  gal_list_sizet_free(indexll);
+  gal_data_array_free(allcols, numcols, 0);
+  return out;
 }
 
 
@@ -1531,7 +1716,7 @@ table(struct tableparams *p)
     {
       table_txt_formats(p);
       gal_table_write(p->table, NULL, NULL, p->cp.tableformat, p->cp.output,
-                      "TABLE", p->colinfoinstdout);
+                      "TABLE", p->colinfoinstdout, p->cp.numthreads);
     }
   else
     error(EXIT_FAILURE, 0, "no output columns");
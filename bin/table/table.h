@@ -23,6 +23,10 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 #ifndef TABLE_H
 #define TABLE_H
 
+gal_data_t *
+table_read_pushdown(struct tableparams *p, size_t nselect,
+                    size_t *selectindout, size_t *selecttypeout);
+
 void
 table(struct tableparams *p);
 
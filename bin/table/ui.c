@@ -43,6 +43,7 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 #include "main.h"
 
 #include "ui.h"
+#include "table.h"
 #include "arithmetic.h"
 #include "authors-cite.h"
 
@@ -140,6 +141,7 @@ ui_initialize_options(struct tableparams *p,
 
         /* Options to ignore. */
         case GAL_OPTIONS_KEY_TYPE:
+        case GAL_OPTIONS_KEY_COMPRESS:
           cp->coptions[i].flags=OPTION_HIDDEN;
           break;
         }
@@ -414,7 +416,7 @@ ui_check_options_and_arguments(struct tableparams *p)
 /**************************************************************/
 /************   List of row-selection requests   **************/
 /**************************************************************/
-static void
+void
 ui_list_select_add(struct list_select **list, gal_data_t *col, int type)
 {
   struct list_select *newnode;
@@ -1274,10 +1276,30 @@ ui_preparations(struct tableparams *p)
                   : NULL);
 
 
+  /* When the input is a FITS table, the rows can be selected while
+     reading it (only reading the necessary rows, see
+     'table_read_pushdown'). This isn't possible when the columns or rows
+     of other tables should be added to it before the selection. */
+  p->pushdown = ( lines==NULL
+                  && p->catrowfile==NULL
+                  && p->catcolumnfile==NULL
+                  && ( p->selection
+                       || ( p->sort==NULL
+                            && ( p->rowrange
+                                 || p->head!=GAL_BLANK_SIZE_T
+                                 || p->tail!=GAL_BLANK_SIZE_T ) ) )
+                  && p->filename
+                  && gal_fits_file_recognized(p->filename) );
+
+
   /* Read the necessary columns. */
-  p->table=gal_table_read(p->filename, cp->hdu, lines, p->columns,
-                          cp->searchin, cp->ignorecase, cp->numthreads,
-                          cp->minmapsize, p->cp.quietmmap, p->colmatch);
+  p->table = ( p->pushdown
+               ? table_read_pushdown(p, nselect, selectindout,
+                                     selecttypeout)
+               : gal_table_read(p->filename, cp->hdu, lines, p->columns,
+                                cp->searchin, cp->ignorecase,
+                                cp->numthreads, cp->minmapsize,
+                                p->cp.quietmmap, p->colmatch) );
   if(p->filename==NULL) p->filename="stdin";
   gal_list_str_free(lines, 1);
 
@@ -95,6 +95,9 @@ enum option_keys_enum
 void
 ui_read_check_inputs_setup(int argc, char *argv[], struct tableparams *p);
 
+void
+ui_list_select_add(struct list_select **list, gal_data_t *col, int type);
+
 void
 ui_list_select_free(struct list_select *list, int freevalue);
 
@@ -184,6 +184,19 @@ struct argp_option program_options[] =
       GAL_OPTIONS_MANDATORY,
       GAL_OPTIONS_NOT_SET,
     },
+    {
+      "wcsinterp",
+      UI_KEY_WCSINTERP,
+      "FLT",
+      0,
+      "Max. error (in pix) of interpolating WCS.",
+      UI_GROUP_ALIGN,
+      &p->wa.wcsinterp,
+      GAL_TYPE_FLOAT64,
+      GAL_OPTIONS_RANGE_GE_0,
+      GAL_OPTIONS_NOT_MANDATORY,
+      GAL_OPTIONS_NOT_SET
+    },
     {
       "gridfile",
       UI_KEY_GRIDFILE,
@@ -68,6 +68,7 @@ struct warpparams
   size_t       extinds[4];  /* Indexs of the minimum and maximum values. */
   double    outfpixval[2];  /* Pixel value of first output pixel.        */
   double         opixarea;  /* Area of output pix in units of input pix. */
+  size_t      stripheight;  /* No. of output rows in each thread job.    */
   uint8_t        wcsalign;  /* If warp must work in WCS-align mode.      */
   uint8_t  distortiontype;  /* Store distortion type in nonlinear mode.  */
 };
@@ -671,10 +671,15 @@ ui_check_options_and_arguments(struct warpparams *p)
       if(p->wa.edgesampling==GAL_BLANK_SIZE_T)
         error(EXIT_FAILURE, 0, "no '--edgesampling' provided");
     }
+  else if(p->wa.wcsinterp!=0.0f)
+    error(EXIT_FAILURE, 0, "'--wcsinterp' is only relevant when aligning "
+          "the input to a WCS (when no linear warp like '--rotate' or "
+          "'--matrix' is given)");
 
   /* Read the input image as double type and its WCS structure. */
   p->input=gal_array_read_one_ch_to_type(p->inputname, p->cp.hdu,
                                          NULL, GAL_TYPE_FLOAT64,
+                                         p->cp.numthreads,
                                          p->cp.minmapsize,
                                          p->cp.quietmmap);
 
@@ -28,6 +28,7 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 #include <stdio.h>
 #include <float.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <gnuastro/wcs.h>
 #include <gnuastro/fits.h>
@@ -60,6 +61,11 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
   }                                                             \
 
 
+/* Number of input pixels along a row to find the overlap area with an
+   output pixel in one call. */
+#define WARP_ROW_CHUNK 64
+
+
 
 
 
@@ -82,151 +88,174 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 /***************************************************************/
 /**************      Processing function      ******************/
 /***************************************************************/
+/* Fill the output pixel 'ind' from the positions of its four corners on
+   the input image (in the order: bottom-left, bottom-right, top-left and
+   top-right in 'icrn_base'). */
+static void
+warp_linear_onpix(struct warpparams *p, size_t ind, double *icrn_base)
+{
+  size_t *extinds=p->extinds, *ordinds=p->ordinds;
+  long is0=p->input->dsize[0], is1=p->input->dsize[1];
+  double filledarea, *input=p->input->array, v=NAN;
+  long k, nx, x, y, xstart, xend, ystart, yend; /* Might be negative */
+  double icrn[8], areas[WARP_ROW_CHUNK], *output=p->output->array;
+  size_t numinput;
+
+  /* Initialize the output pixel value: */
+  numinput=0;
+  output[ind]=filledarea=0.0f;
+
+  /* Using the known relationships between the vertice locations,
+     put everything in the right place: */
+  xstart =
+    GAL_DIMENSION_NEARESTINT_HALFHIGHER( icrn_base[extinds[0]] );
+  xend   =
+    GAL_DIMENSION_NEARESTINT_HALFLOWER(  icrn_base[extinds[1]] ) + 1;
+  ystart =
+    GAL_DIMENSION_NEARESTINT_HALFHIGHER( icrn_base[extinds[2]] );
+  yend   =
+    GAL_DIMENSION_NEARESTINT_HALFLOWER(  icrn_base[extinds[3]] ) + 1;
+  icrn[0]=icrn_base[ordinds[0]*2]; icrn[1]=icrn_base[ordinds[0]*2+1];
+  icrn[2]=icrn_base[ordinds[1]*2]; icrn[3]=icrn_base[ordinds[1]*2+1];
+  icrn[4]=icrn_base[ordinds[2]*2]; icrn[5]=icrn_base[ordinds[2]*2+1];
+  icrn[6]=icrn_base[ordinds[3]*2]; icrn[7]=icrn_base[ordinds[3]*2+1];
+
+  /* For a check:
+  if(ind==9999)
+    {
+      printf("\n\n\nind: %zu: (%zu, %zu):\n", ind,
+             ind%p->output->dsize[1]+1, ind/p->output->dsize[1]+1);
+      for(k=0;k<4;++k)
+        printf("(%.3f, %.3f)\n", icrn_base[k*2], icrn_base[k*2+1]);
+      printf("------- Ordered -------\n");
+      for(k=0;k<4;++k) printf("(%.3f, %.3f)\n", icrn[k*2], icrn[k*2+1]);
+      printf("------- Start and ending pixels -------\n");
+      printf("X: %ld -- %ld\n", xstart, xend);
+      printf("Y: %ld -- %ld\n", ystart, yend);
+    }
+  */
+
+  /* Keep the range within the input image (note that the pixel
+     coordinates start from 1). */
+  if(xstart<1) xstart=1;
+  if(ystart<1) ystart=1;
+  if(xend>is1+1) xend=is1+1;
+  if(yend>is0+1) yend=is0+1;
+
+  /* Go over all the input pixels that are covered. Note that x and y are
+     the centers of the pixel. The areas of the overlap with the pixels
+     along each row are found together (in groups of 'WARP_ROW_CHUNK'). */
+  for(y=ystart;y<yend;++y)
+    for(x=xstart;x<xend;x+=nx)
+      {
+        nx = xend-x < WARP_ROW_CHUNK ? xend-x : WARP_ROW_CHUNK;
+        gal_polygon_clip_area_row(icrn, 4, x-0.5f, y-0.5f, nx, areas);
+        for(k=0;k<nx;++k)
+          {
+            /* Read the value of the input pixel. */
+            v=input[(y-1)*is1+x+k-1];
+
+            /* Add the fractional value of this pixel. If this output
+               pixel covers a NaN pixel in the input grid, then
+               calculate the area of this NaN pixel to account for it
+               later. */
+            if( !isnan(v) )
+              {
+                ++numinput;
+                filledarea+=areas[k];
+                output[ind]+=v*areas[k];
+              }
+
+            /* For a simple pixel value check:
+            if(ind==97387)
+              printf("%f --> (%zu) %f\n", v*areas[k], numinput,
+                     output[ind]);
+            */
+          }
+      }
+
+  /* See if the pixel value should be set to NaN or not (because of not
+     enough coverage). */
+  if(numinput && filledarea/p->opixarea < p->coveredfrac-1e-5)
+    numinput=0;
+
+  /* Write the final value to disk: */
+  if(numinput==0) output[ind]=NAN;
+}
+
+
+
+
+
+/* Transform the corners along the bottom of the given output row (which
+   are also the top corners of the row before it) to the input image
+   coordinates. Note that the outfpixval already contains the correction
+   for the fact that the FITS standard considers the center of first
+   pixel to be at (1.0f, 1.0f).*/
+static void
+warp_linear_corner_row(struct warpparams *p, size_t row, double *out)
+{
+  double ocrn[2];
+  size_t c, os1=p->output->dsize[1];
+
+  ocrn[1]=(double)row-0.5f+p->outfpixval[1];
+  for(c=0;c<=os1;++c)
+    {
+      ocrn[0]=(double)c-0.5f+p->outfpixval[0];
+      WARP_MAPPOINT(ocrn, p->inverse, &out[c*2]);
+    }
+}
+
+
+
+
+
+/* Each job is a strip of 'p->stripheight' output rows. Every corner is
+   shared between four output pixels, so instead of transforming the four
+   corners of each pixel separately, the corners of each row are only
+   transformed once and kept for the next row. */
 static void *
 warp_onthread_linear(void *inparam)
 {
   struct gal_threads_params *tprm=(struct gal_threads_params *)inparam;
   struct warpparams *p=(struct warpparams *)tprm->params;
 
-  size_t *extinds=p->extinds, *ordinds=p->ordinds;
-  long is0=p->input->dsize[0], is1=p->input->dsize[1];
-  double area, filledarea, *input=p->input->array, v=NAN;
-  size_t i, j, ind, os1=p->output->dsize[1], numcrn, numinput;
-  long x, y, xstart, xend, ystart, yend; /* Might be negative */
-  double ocrn[8], icrn_base[8], icrn[8], *output=p->output->array;
-  double pcrn[8], *outfpixval=p->outfpixval, ccrn[GAL_POLYGON_MAX_CORNERS];
+  double icrn_base[8], *lower, *upper, *tmp;
+  size_t i, r, rf, c, os0=p->output->dsize[0], os1=p->output->dsize[1];
+
+  /* Allocate the two rows of transformed corners. */
+  lower=gal_pointer_allocate(GAL_TYPE_FLOAT64, 2*(os1+1), 0, __func__,
+                             "lower");
+  upper=gal_pointer_allocate(GAL_TYPE_FLOAT64, 2*(os1+1), 0, __func__,
+                             "upper");
 
+  /* Go over all the strips of this thread. */
   for(i=0; tprm->indexs[i] != GAL_BLANK_SIZE_T; ++i)
     {
-      ind=tprm->indexs[i];
-
-      /* Initialize the output pixel value: */
-      numinput=0;
-      output[ind]=filledarea=0.0f;
-
-      /* Set the corners of this output pixel. The ind/os1 and ind%os1
-         start from 0. Note that the outfpixval already contains the
-         correction for the fact that the FITS standard considers the
-         center of first pixel to be at (1.0f, 1.0f).*/
-      ocrn[0]=(double)(ind%os1)-0.5f+outfpixval[0];
-      ocrn[1]=(double)(ind/os1)-0.5f+outfpixval[1];
-      ocrn[2]=(double)(ind%os1)+0.5f+outfpixval[0];
-      ocrn[3]=(double)(ind/os1)-0.5f+outfpixval[1];
-      ocrn[4]=(double)(ind%os1)-0.5f+outfpixval[0];
-      ocrn[5]=(double)(ind/os1)+0.5f+outfpixval[1];
-      ocrn[6]=(double)(ind%os1)+0.5f+outfpixval[0];
-      ocrn[7]=(double)(ind/os1)+0.5f+outfpixval[1];
-
-
-      /* Transform the four corners of the output pixel to the input
-         image coordinates. */
-      for(j=0;j<4;++j) WARP_MAPPOINT(&ocrn[j*2], p->inverse,
-                                     &icrn_base[j*2]);
-
-      /* Using the known relationships between the vertice locations,
-         put everything in the right place: */
-      xstart =
-        GAL_DIMENSION_NEARESTINT_HALFHIGHER( icrn_base[extinds[0]] );
-      xend   =
-        GAL_DIMENSION_NEARESTINT_HALFLOWER(  icrn_base[extinds[1]] ) + 1;
-      ystart =
-        GAL_DIMENSION_NEARESTINT_HALFHIGHER( icrn_base[extinds[2]] );
-      yend   =
-        GAL_DIMENSION_NEARESTINT_HALFLOWER(  icrn_base[extinds[3]] ) + 1;
-      icrn[0]=icrn_base[ordinds[0]*2]; icrn[1]=icrn_base[ordinds[0]*2+1];
-      icrn[2]=icrn_base[ordinds[1]*2]; icrn[3]=icrn_base[ordinds[1]*2+1];
-      icrn[4]=icrn_base[ordinds[2]*2]; icrn[5]=icrn_base[ordinds[2]*2+1];
-      icrn[6]=icrn_base[ordinds[3]*2]; icrn[7]=icrn_base[ordinds[3]*2+1];
-
-      /* For a check:
-      if(ind==9999)
-        {
-          printf("\n\n\nind: %zu: (%zu, %zu):\n",
-                 ind, ind%os1+1, ind/os1+1);
-          for(j=0;j<4;++j)
-            printf("(%.3f, %.3f) --> (%.3f, %.3f)\n",
-                   ocrn[j*2], ocrn[j*2+1], icrn_base[j*2],
-                   icrn_base[j*2+1]);
-          printf("------- Ordered -------\n");
-          for(j=0;j<4;++j) printf("(%.3f, %.3f)\n", icrn[j*2], icrn[j*2+1]);
-          printf("------- Start and ending pixels -------\n");
-          printf("X: %ld -- %ld\n", xstart, xend);
-          printf("Y: %ld -- %ld\n", ystart, yend);
-        }
-      */
-
-      /* Go over all the input pixels that are covered. Note that x
-         and y are the centers of the pixel. */
-      for(y=ystart;y<yend;++y)
+      /* First and last (not inclusive) rows of this strip. */
+      r=tprm->indexs[i]*p->stripheight;
+      rf = r+p->stripheight < os0 ? r+p->stripheight : os0;
+
+      /* Go over the rows, the bottom corners of each row are the top
+         corners of the previous row. */
+      warp_linear_corner_row(p, r, lower);
+      for(;r<rf;++r)
         {
-          /* If the pixel isn't in the image (note that the pixel
-             coordinates start from 1), skip this pixel. Note that the
-             pixel polygon should be counter clockwise. */
-          if( y<1 || y>is0 ) continue;
-          pcrn[1]=y-0.5f;      pcrn[3]=y-0.5f;
-          pcrn[5]=y+0.5f;      pcrn[7]=y+0.5f;
-          for(x=xstart;x<xend;++x)
+          warp_linear_corner_row(p, r+1, upper);
+          for(c=0;c<os1;++c)
             {
-              if( x<1 || x>is1 ) continue;
-
-              /* Read the value of the input pixel. */
-              v=input[(y-1)*is1+x-1];
-
-              pcrn[0]=x-0.5f;          pcrn[2]=x+0.5f;
-              pcrn[4]=x+0.5f;          pcrn[6]=x-0.5f;
-
-              /* Find the overlapping (clipped) polygon: */
-              gal_polygon_clip(icrn, 4, pcrn, 4, ccrn, &numcrn);
-              area=gal_polygon_area(ccrn, numcrn);
-
-              /* Add the fractional value of this pixel. If this
-                 output pixel covers a NaN pixel in the input grid,
-                 then calculate the area of this NaN pixel to account
-                 for it later. */
-              if( !isnan(v) )
-                {
-                  ++numinput;
-                  filledarea+=area;
-                  output[ind]+=v*area;
-                }
-
-              /* For a polygon check:
-              if(ind==9999)
-                {
-                  printf("%zu -- (%zd, %zd):\n", ind, x, y);
-                  printf("icrn:\n");
-                  for(j=0;j<4;++j)
-                    printf("\t%.3f, %.3f\n", icrn[j*2], icrn[j*2+1]);
-                  printf("pcrn:\n");
-                  for(j=0;j<4;++j)
-                    printf("\t%.3f, %.3f\n", pcrn[j*2], pcrn[j*2+1]);
-                  printf("ccrn:\n");
-                  for(j=0;j<numcrn;++j)
-                    printf("\t%.3f, %.3f\n", ccrn[j*2], ccrn[j*2+1]);
-                  printf("[%zu]: %.3f of [%ld, %ld]: %f\n", ind,
-                         gal_polygon_area(ccrn, numcrn), x, y,
-                         input[(y-1)*is1+x-1]);
-                }
-              */
-
-              /* For a simple pixel value check:
-              if(ind==97387)
-                printf("%f --> (%zu) %f\n",
-                       v*gal_polygon_area(ccrn, numcrn),
-                       numinput, output[ind]);
-              */
+              memcpy(icrn_base,   lower+c*2, 4*sizeof *icrn_base);
+              memcpy(icrn_base+4, upper+c*2, 4*sizeof *icrn_base);
+              warp_linear_onpix(p, r*os1+c, icrn_base);
             }
+          tmp=lower; lower=upper; upper=tmp;
         }
-
-      /* See if the pixel value should be set to NaN or not (because of not
-         enough coverage). */
-      if(numinput && filledarea/p->opixarea < p->coveredfrac-1e-5)
-        numinput=0;
-
-      /* Write the final value to disk: */
-      if(numinput==0) output[ind]=NAN;
     }
 
+  /* Clean up. */
+  free(lower);
+  free(upper);
+
   /* Wait for all the other threads to finish, then return. */
   if(tprm->b) { pthread_barrier_wait(tprm->b); }
   return NULL;
@@ -424,7 +453,7 @@ warp_write_to_file(struct warpparams *p, int hasmatrix)
 
   /* Save the output and 'MAX-FRAC' if available. */
   for(tmp=p->output;tmp!=NULL;tmp=tmp->next)
-    gal_fits_img_write(tmp, p->cp.output, NULL, PROGRAM_NAME);
+    gal_fits_img_write(tmp, p->cp.output, NULL, PROGRAM_NAME, p->cp.compress);
 
   /* Write the configuration keywords on HDU/extension '0'. */
   gal_fits_key_write_filename("input", p->inputname, &p->cp.okeys,
@@ -530,6 +559,7 @@ warp_write_wcs_linear(struct warpparams *p)
 void
 warp(struct warpparams *p)
 {
+  size_t numstrips;
   struct timeval t0;
   gal_warp_wcsalign_t *wa=&p->wa;
 
@@ -566,8 +596,14 @@ warp(struct warpparams *p)
     {
       warp_linear_init(p);
 
-      /* Fill the output image */
-      gal_threads_spin_off(warp_onthread_linear, p, p->output->size,
+      /* Fill the output image in strips of rows (four strips for every
+         thread, to balance the load). */
+      numstrips=4*p->cp.numthreads;
+      p->stripheight=p->output->dsize[0]/numstrips;
+      if(p->stripheight==0) p->stripheight=1;
+      numstrips = ( p->output->dsize[0]/p->stripheight
+                    + (p->output->dsize[0]%p->stripheight ? 1 : 0) );
+      gal_threads_spin_off(warp_onthread_linear, p, numstrips,
                            p->cp.numthreads, p->cp.minmapsize,
                            p->cp.quietmmap);
 
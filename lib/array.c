@@ -115,16 +115,18 @@ gal_array_file_recognized(char *name)
 
 
 /* Read (all the possibly existing) color channels within each
-   extension/dir of the given file. */
+   extension/dir of the given file. 'numthreads' is only used for
+   tile-compressed FITS images. */
 gal_data_t *
 gal_array_read(char *filename, char *extension, gal_list_str_t *lines,
-               size_t minmapsize, int quietmmap)
+               size_t numthreads, size_t minmapsize, int quietmmap)
 {
   size_t ext;
 
   /* FITS  */
   if( gal_fits_file_recognized(filename) )
-    return gal_fits_img_read(filename, extension, minmapsize, quietmmap);
+    return gal_fits_img_read(filename, extension, numthreads, minmapsize,
+                             quietmmap);
 
   /* TIFF */
   else if ( gal_tiff_name_is_tiff(filename) )
@@ -157,11 +159,11 @@ gal_array_read(char *filename, char *extension, gal_list_str_t *lines,
 gal_data_t *
 gal_array_read_to_type(char *filename, char *extension,
                        gal_list_str_t *lines, uint8_t type,
-                       size_t minmapsize, int quietmmap)
+                       size_t numthreads, size_t minmapsize, int quietmmap)
 {
   gal_data_t *out=NULL;
   gal_data_t *next, *in=gal_array_read(filename, extension, lines,
-                                       minmapsize, quietmmap);
+                                       numthreads, minmapsize, quietmmap);
 
   /* Go over all the channels. */
   while(in)
@@ -184,11 +186,12 @@ gal_array_read_to_type(char *filename, char *extension,
 /* Read the input array and make sure it is only one channel. */
 gal_data_t *
 gal_array_read_one_ch(char *filename, char *extension, gal_list_str_t *lines,
-                      size_t minmapsize, int quietmmap)
+                      size_t numthreads, size_t minmapsize, int quietmmap)
 {
   char *fname;
   gal_data_t *out;
-  out=gal_array_read(filename, extension, lines, minmapsize, quietmmap);
+  out=gal_array_read(filename, extension, lines, numthreads, minmapsize,
+                     quietmmap);
 
   if(out->next)
     {
@@ -220,10 +223,11 @@ gal_array_read_one_ch(char *filename, char *extension, gal_list_str_t *lines,
 gal_data_t *
 gal_array_read_one_ch_to_type(char *filename, char *extension,
                               gal_list_str_t *lines, uint8_t type,
-                              size_t minmapsize, int quietmmap)
+                              size_t numthreads, size_t minmapsize,
+                              int quietmmap)
 {
   gal_data_t *out=gal_array_read_one_ch(filename, extension, lines,
-                                        minmapsize, quietmmap);
+                                        numthreads, minmapsize, quietmmap);
 
   return gal_data_copy_to_new_type_free(out, type);
 }
@@ -0,0 +1,1783 @@
+/*********************************************************************
+arrow -- functions to read and write Apache Arrow IPC (Feather) files.
+This is part of GNU Astronomy Utilities (Gnuastro) package.
+
+Original author:
+     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+Contributing author(s):
+Copyright (C) 2022 Free Software Foundation, Inc.
+
+Gnuastro is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+Gnuastro is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
+**********************************************************************/
+#include <config.h>
+
+#include <stdio.h>
+#include <errno.h>
+#include <error.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#include <gnuastro/list.h>
+#include <gnuastro/blank.h>
+#include <gnuastro/arrow.h>
+#include <gnuastro/threads.h>
+#include <gnuastro/pointer.h>
+
+#include <gnuastro-internal/checkset.h>
+
+
+
+
+
+/*************************************************************
+ **************      Arrow format constants       ************
+ *************************************************************/
+/* The Arrow IPC file format (also known as Feather version 2) is
+   described in https://arrow.apache.org/docs/format/Columnar.html. It
+   starts and finishes with the magic string below. In between, there is
+   a stream of "messages" (the schema, then the record batches that
+   contain the actual data of the columns). Each message has a metadata
+   and a body. The metadata of the messages (and the footer of the file,
+   that points to all the record batches) are in the FlatBuffers
+   serialization format that is defined in the '.fbs' files of the Arrow
+   format. Since we only need a few of the tables defined there, they are
+   directly read and written here (so there is no need for any external
+   library). */
+#define ARROW_MAGIC             "ARROW1"
+#define ARROW_MAGIC_LEN         6
+#define ARROW_CONTINUATION      0xFFFFFFFF
+#define ARROW_METADATA_V5       4
+
+/* 'MessageHeader' union in 'Message.fbs'. */
+#define ARROW_HEADER_SCHEMA     1
+#define ARROW_HEADER_RECORDBATCH 3
+
+/* 'Type' union in 'Schema.fbs' (only the ones that are used here). */
+enum arrow_types
+{
+  ARROW_TYPE_NONE,
+  ARROW_TYPE_NULL,
+  ARROW_TYPE_INT,
+  ARROW_TYPE_FLOATINGPOINT,
+  ARROW_TYPE_BINARY,
+  ARROW_TYPE_UTF8,
+  ARROW_TYPE_BOOL,
+  ARROW_TYPE_DECIMAL,
+  ARROW_TYPE_DATE,
+  ARROW_TYPE_TIME,
+  ARROW_TYPE_TIMESTAMP,
+  ARROW_TYPE_INTERVAL,
+  ARROW_TYPE_LIST,
+  ARROW_TYPE_STRUCT,
+  ARROW_TYPE_UNION,
+  ARROW_TYPE_FIXEDSIZEBINARY,
+  ARROW_TYPE_FIXEDSIZELIST,
+  ARROW_TYPE_MAP,
+  ARROW_TYPE_DURATION,
+  ARROW_TYPE_LARGEBINARY,
+  ARROW_TYPE_LARGEUTF8,
+  ARROW_TYPE_LARGELIST,
+};
+
+/* 'Precision' enum of 'FloatingPoint' in 'Schema.fbs'. */
+#define ARROW_PRECISION_SINGLE  1
+#define ARROW_PRECISION_DOUBLE  2
+
+/* Keys of the custom metadata that keep Gnuastro's column metadata. */
+#define ARROW_KEY_UNIT          "unit"
+#define ARROW_KEY_COMMENT       "comment"
+#define ARROW_KEY_TABCOMMENT    "COMMENT"
+
+/* Name of the child field of vector columns. */
+#define ARROW_VECTOR_CHILD      "item"
+
+
+
+
+
+/*************************************************************
+ **************        Name identification        ************
+ *************************************************************/
+int
+gal_arrow_name_is_arrow(char *name)
+{
+  size_t len;
+
+  if(name)
+    {
+      len=strlen(name);
+      if (    ( len>=6 && strcmp(&name[len-6], ".arrow")   == 0 )
+           || ( len>=8 && strcmp(&name[len-8], ".feather") == 0 ) )
+        return 1;
+      else
+        return 0;
+    }
+  else return 0;
+}
+
+
+
+
+
+int
+gal_arrow_suffix_is_arrow(char *name)
+{
+  if(name)
+    {
+      if (strcmp(name, "arrow") == 0   || strcmp(name, ".arrow") == 0
+          || strcmp(name, "feather") == 0 || strcmp(name, ".feather") == 0)
+        return 1;
+      else
+        return 0;
+    }
+  else return 0;
+}
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+/*************************************************************
+ **************        FlatBuffers (reading)      ************
+ *************************************************************/
+/* In FlatBuffers, all values are little-endian. A "table" starts with a
+   signed 32-bit offset to its "vtable" (the vtable is at the table's
+   position minus this offset). The vtable contains 16-bit numbers: its
+   own size, the size of the table and the offset of each field within
+   the table (zero if the field isn't present). Strings, vectors and
+   sub-tables are kept as unsigned 32-bit offsets (relative to the
+   position of the offset itself). */
+struct arrow_file
+{
+  char          *filename;  /* Name of the file.                       */
+  unsigned char      *buf;  /* Contents of the file (memory-mapped).   */
+  size_t             size;  /* Size of the file (in bytes).            */
+  size_t           fields;  /* Position of the vector of fields.       */
+  size_t          numcols;  /* Number of columns (fields).             */
+  size_t       numbatches;  /* Number of record batches.               */
+  size_t         *batches;  /* Position of each record batch's table.  */
+  size_t          *bodies;  /* Position of each record batch's body.   */
+  size_t          numrows;  /* Total number of rows.                   */
+  int                swap;  /* File's endianness isn't the host's.     */
+};
+
+
+
+
+
+/* Abort with an error if 'n' bytes from 'pos' are not in the file. */
+static void
+arrow_fb_check(struct arrow_file *af, size_t pos, size_t n)
+{
+  if(pos>af->size || n>af->size-pos)
+    error(EXIT_FAILURE, 0, "%s: not a valid Arrow IPC file (the "
+          "metadata point to byte %zu, which is beyond the end of the "
+          "file)", af->filename, pos+n);
+}
+
+
+
+
+
+/* Read an 'n'-byte little-endian unsigned integer from 'pos'. */
+static uint64_t
+arrow_fb_uint(struct arrow_file *af, size_t pos, size_t n)
+{
+  size_t i;
+  uint64_t out=0;
+  arrow_fb_check(af, pos, n);
+  for(i=0;i<n;++i) out |= (uint64_t)(af->buf[pos+i]) << (8*i);
+  return out;
+}
+
+
+
+
+
+/* Return the position of the object that the offset in 'pos' points
+   to. */
+static size_t
+arrow_fb_deref(struct arrow_file *af, size_t pos)
+{
+  return pos + arrow_fb_uint(af, pos, 4);
+}
+
+
+
+
+
+/* Return the position of field 'id' in the table at 'table' (or 0 if the
+   field isn't present). */
+static size_t
+arrow_fb_field(struct arrow_file *af, size_t table, size_t id)
+{
+  size_t vtable, vtsize, offset;
+
+  vtable = table - (int32_t)arrow_fb_uint(af, table, 4);
+  vtsize = arrow_fb_uint(af, vtable, 2);
+  if( 4+2*id >= vtsize ) return 0;
+  offset = arrow_fb_uint(af, vtable+4+2*id, 2);
+  return offset ? table+offset : 0;
+}
+
+
+
+
+
+/* Return the scalar field 'id' (with 'n' bytes) of a table, or 'def' if
+   it isn't present. */
+static uint64_t
+arrow_fb_scalar(struct arrow_file *af, size_t table, size_t id, size_t n,
+                uint64_t def)
+{
+  size_t pos=arrow_fb_field(af, table, id);
+  return pos ? arrow_fb_uint(af, pos, n) : def;
+}
+
+
+
+
+
+/* Return the position of the object (table, vector or string) that is
+   field 'id' of a table, or 0 if it isn't present. */
+static size_t
+arrow_fb_object(struct arrow_file *af, size_t table, size_t id)
+{
+  size_t pos=arrow_fb_field(af, table, id);
+  return pos ? arrow_fb_deref(af, pos) : 0;
+}
+
+
+
+
+
+/* Number of elements in the vector at 'vec' (that can be 0 for an absent
+   vector). */
+static size_t
+arrow_fb_vec_num(struct arrow_file *af, size_t vec)
+{
+  return vec ? arrow_fb_uint(af, vec, 4) : 0;
+}
+
+
+
+
+
+/* Position of table number 'i' in a vector of tables. */
+static size_t
+arrow_fb_vec_table(struct arrow_file *af, size_t vec, size_t i)
+{
+  return arrow_fb_deref(af, vec+4+4*i);
+}
+
+
+
+
+
+/* Allocate a copy of the string at 'str' (that may be 0 for an absent
+   string). */
+static char *
+arrow_fb_string(struct arrow_file *af, size_t str)
+{
+  char *out;
+  size_t len;
+
+  if(str==0) return NULL;
+  len=arrow_fb_uint(af, str, 4);
+  arrow_fb_check(af, str+4, len);
+  errno=0;
+  out=malloc(len+1);
+  if(out==NULL)
+    error(EXIT_FAILURE, errno, "%s: %zu bytes for 'out'", __func__, len+1);
+  memcpy(out, af->buf+str+4, len);
+  out[len]='\0';
+  return out;
+}
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+/*************************************************************
+ **************        FlatBuffers (writing)      ************
+ *************************************************************/
+/* FlatBuffers are usually built from the end to the start. But since the
+   offsets to the sub-objects only need to point forward, here they are
+   built from the start: the parent is written first (with its offsets
+   left empty), and the offsets are filled when the children are written
+   after it. The vtable of each table is put immediately before it. */
+struct arrow_fbb
+{
+  unsigned char      *buf;  /* The FlatBuffer.                         */
+  size_t             size;  /* Number of used bytes.                   */
+  size_t            alloc;  /* Number of allocated bytes.              */
+};
+
+
+
+
+
+/* Add 'n' (zero-valued) bytes to the end of the buffer, such that the
+   first one is aligned to 'align' bytes. The position of the first byte
+   is returned. */
+static size_t
+arrow_fbb_space(struct arrow_fbb *b, size_t n, size_t align)
+{
+  size_t start = (b->size+align-1)/align*align;
+
+  /* Allocate the necessary space. */
+  if(start+n > b->alloc)
+    {
+      b->alloc = 2*(start+n);
+      errno=0;
+      b->buf=realloc(b->buf, b->alloc);
+      if(b->buf==NULL)
+        error(EXIT_FAILURE, errno, "%s: %zu bytes for 'b->buf'",
+              __func__, b->alloc);
+    }
+
+  /* Clear the padding and the new space, then return the start. */
+  memset(b->buf+b->size, 0, start+n-b->size);
+  b->size=start+n;
+  return start;
+}
+
+
+
+
+
+/* Write 'value' as an 'n'-byte little-endian integer at 'pos'. */
+static void
+arrow_fbb_put(struct arrow_fbb *b, size_t pos, uint64_t value, size_t n)
+{
+  size_t i;
+  for(i=0;i<n;++i) b->buf[pos+i] = (value >> (8*i)) & 0xFF;
+}
+
+
+
+
+
+/* Make the offset at 'pos' point to 'target'. */
+static void
+arrow_fbb_ref(struct arrow_fbb *b, size_t pos, size_t target)
+{
+  arrow_fbb_put(b, pos, target-pos, 4);
+}
+
+
+
+
+
+/* Add a table with 'nfields' fields, the size of each field (in bytes) is
+   given in 'sizes' (zero for fields that aren't present). The position of
+   each field is written into 'fpos' and the position of the table is
+   returned. */
+static size_t
+arrow_fbb_table(struct arrow_fbb *b, size_t nfields, const size_t *sizes,
+                size_t *fpos)
+{
+  size_t i, start, table, vtable, tsize=4, vtsize=4+2*nfields;
+
+  /* Set the offset of each field in the table (each field is aligned to
+     its own size). */
+  for(i=0;i<nfields;++i)
+    if(sizes[i])
+      {
+        tsize = (tsize+sizes[i]-1)/sizes[i]*sizes[i];
+        fpos[i] = tsize;
+        tsize += sizes[i];
+      }
+    else fpos[i]=0;
+
+  /* Put the vtable immediately before the table (which is aligned to 8
+     bytes). */
+  start=b->size;
+  table=(start+vtsize+7)/8*8;
+  vtable=table-vtsize;
+  arrow_fbb_space(b, table+tsize-start, 1);
+
+  /* Fill the vtable and the table's offset to it. */
+  arrow_fbb_put(b, vtable,   vtsize, 2);
+  arrow_fbb_put(b, vtable+2, tsize,  2);
+  for(i=0;i<nfields;++i)
+    arrow_fbb_put(b, vtable+4+2*i, fpos[i], 2);
+  arrow_fbb_put(b, table, table-vtable, 4);
+
+  /* Return the position of the table and its fields. */
+  for(i=0;i<nfields;++i) if(fpos[i]) fpos[i]+=table;
+  return table;
+}
+
+
+
+
+
+/* Add a string and return its position. */
+static size_t
+arrow_fbb_string(struct arrow_fbb *b, char *str)
+{
+  size_t len=strlen(str), pos=arrow_fbb_space(b, 4+len+1, 4);
+  arrow_fbb_put(b, pos, len, 4);
+  memcpy(b->buf+pos+4, str, len);
+  return pos;
+}
+
+
+
+
+
+/* Add a vector of 'n' elements (each with 'elsize' bytes) and return its
+   position (the elements start 4 bytes after it). The elements are
+   aligned to 'align' bytes. */
+static size_t
+arrow_fbb_vector(struct arrow_fbb *b, size_t n, size_t elsize,
+                 size_t align)
+{
+  /* The length is immediately before the first element. */
+  size_t pos=(b->size+3)/4*4;
+  while( (pos+4)%align ) pos+=4;
+  arrow_fbb_space(b, pos+4+n*elsize-b->size, 1);
+  arrow_fbb_put(b, pos, n, 4);
+  return pos;
+}
+
+
+
+
+
+/* Add a table of a key and value (custom metadata). */
+static size_t
+arrow_fbb_keyvalue(struct arrow_fbb *b, char *key, char *value)
+{
+  size_t table, fpos[2];
+  const size_t sizes[2]={4, 4};
+
+  table=arrow_fbb_table(b, 2, sizes, fpos);
+  arrow_fbb_ref(b, fpos[0], arrow_fbb_string(b, key));
+  arrow_fbb_ref(b, fpos[1], arrow_fbb_string(b, value));
+  return table;
+}
+
+
+
+
+
+/* Add a vector of key-value tables. */
+static size_t
+arrow_fbb_metadata(struct arrow_fbb *b, gal_list_str_t *keys,
+                   gal_list_str_t *values)
+{
+  size_t i, vec;
+  gal_list_str_t *k, *v;
+
+  vec=arrow_fbb_vector(b, gal_list_str_number(keys), 4, 4);
+  for(i=0, k=keys, v=values; k!=NULL; k=k->next, v=v->next, ++i)
+    arrow_fbb_ref(b, vec+4+4*i, arrow_fbb_keyvalue(b, k->v, v->v));
+  return vec;
+}
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+/*************************************************************
+ **************        Information of table       ************
+ *************************************************************/
+/* Return the starting position of the message at 'pos' and its
+   FlatBuffer. Older files don't have the continuation marker. */
+static size_t
+arrow_file_message(struct arrow_file *af, size_t pos)
+{
+  size_t fb = ( arrow_fb_uint(af, pos, 4)==ARROW_CONTINUATION
+                ? pos+8 : pos+4 );
+  return arrow_fb_deref(af, fb);
+}
+
+
+
+
+
+/* Map the file into memory and find the schema and the record
+   batches. */
+static void
+arrow_file_open(char *filename, struct arrow_file *af)
+{
+  struct stat st;
+  uint16_t one=1;
+  size_t i, footer, schema, batches, block, message;
+
+  /* Map the file into memory (only the used pages are actually read). */
+  af->filename=filename;
+  if( stat(filename, &st) )
+    error(EXIT_FAILURE, errno, "%s", filename);
+  af->size=st.st_size;
+  if( af->size < 2*ARROW_MAGIC_LEN+2+4
+      || (af->buf=gal_pointer_mmap_file(filename, 0, af->size, 1))==NULL )
+    error(EXIT_FAILURE, 0, "%s: couldn't be read as an Arrow IPC file",
+          filename);
+
+  /* Check the magic strings at the start and end of the file. */
+  if( memcmp(af->buf, ARROW_MAGIC, ARROW_MAGIC_LEN)
+      || memcmp(af->buf+af->size-ARROW_MAGIC_LEN, ARROW_MAGIC,
+                ARROW_MAGIC_LEN) )
+    error(EXIT_FAILURE, 0, "%s: not an Arrow IPC file (it doesn't start "
+          "and finish with '%s'). Note that Arrow IPC streams (that "
+          "don't have a footer) are not currently supported", filename,
+          ARROW_MAGIC);
+
+  /* The footer is immediately before its size (a 32-bit integer) and the
+     final magic string. */
+  footer = af->size - ARROW_MAGIC_LEN - 4;
+  footer = arrow_fb_deref(af, footer - arrow_fb_uint(af, footer, 4));
+
+  /* Read the schema. */
+  schema=arrow_fb_object(af, footer, 1);
+  if(schema==0)
+    error(EXIT_FAILURE, 0, "%s: the footer doesn't have a schema",
+          filename);
+  af->fields=arrow_fb_object(af, schema, 1);
+  af->numcols=arrow_fb_vec_num(af, af->fields);
+  af->swap = arrow_fb_scalar(af, schema, 0, 2, 0) != (*(uint8_t *)&one!=1);
+
+  /* Find all the record batches. Each 'Block' (a structure in the vector)
+     has 24 bytes: the position of the message (8 bytes), the size of its
+     metadata (4 bytes, followed by 4 bytes of padding) and the size of its
+     body (8 bytes). */
+  af->numrows=0;
+  batches=arrow_fb_object(af, footer, 3);
+  af->numbatches=arrow_fb_vec_num(af, batches);
+  af->batches=gal_pointer_allocate(GAL_TYPE_SIZE_T, af->numbatches+1, 0,
+                                   __func__, "af->batches");
+  af->bodies=gal_pointer_allocate(GAL_TYPE_SIZE_T, af->numbatches+1, 0,
+                                  __func__, "af->bodies");
+  for(i=0;i<af->numbatches;++i)
+    {
+      block=batches+4+24*i;
+      message=arrow_file_message(af, arrow_fb_uint(af, block, 8));
+      if( arrow_fb_scalar(af, message, 1, 1, 0)!=ARROW_HEADER_RECORDBATCH )
+        error(EXIT_FAILURE, 0, "%s: block %zu of the footer is not a "
+              "record batch", filename, i+1);
+      af->batches[i]=arrow_fb_object(af, message, 2);
+      af->bodies[i] = ( arrow_fb_uint(af, block, 8)
+                        + arrow_fb_uint(af, block+8, 4) );
+      if( arrow_fb_field(af, af->batches[i], 3) )
+        error(EXIT_FAILURE, 0, "%s: compressed record batches are not "
+              "currently supported", filename);
+      af->numrows += arrow_fb_scalar(af, af->batches[i], 0, 8, 0);
+    }
+}
+
+
+
+
+
+static void
+arrow_file_close(struct arrow_file *af)
+{
+  gal_pointer_mmap_file_free(af->buf);
+  free(af->batches);
+  free(af->bodies);
+}
+
+
+
+
+
+/* Set Gnuastro's type (and the number of values in each row) from the
+   type of an Arrow field. If the type isn't supported, the type will be
+   zero (GAL_TYPE_INVALID). */
+static uint8_t
+arrow_field_type(struct arrow_file *af, size_t field, size_t *repeat)
+{
+  size_t type, children;
+  uint8_t out=GAL_TYPE_INVALID;
+  int bits, issigned, typetype=arrow_fb_scalar(af, field, 2, 1, 0);
+
+  *repeat=1;
+  type=arrow_fb_object(af, field, 3);
+  switch(typetype)
+    {
+    case ARROW_TYPE_INT:
+      bits=arrow_fb_scalar(af, type, 0, 4, 0);
+      issigned=arrow_fb_scalar(af, type, 1, 1, 0);
+      switch(bits)
+        {
+        case 8:  out = issigned ? GAL_TYPE_INT8  : GAL_TYPE_UINT8;  break;
+        case 16: out = issigned ? GAL_TYPE_INT16 : GAL_TYPE_UINT16; break;
+        case 32: out = issigned ? GAL_TYPE_INT32 : GAL_TYPE_UINT32; break;
+        case 64: out = issigned ? GAL_TYPE_INT64 : GAL_TYPE_UINT64; break;
+        }
+      break;
+
+    case ARROW_TYPE_FLOATINGPOINT:
+      switch( arrow_fb_scalar(af, type, 0, 2, 0) )
+        {
+        case ARROW_PRECISION_SINGLE: out=GAL_TYPE_FLOAT32; break;
+        case ARROW_PRECISION_DOUBLE: out=GAL_TYPE_FLOAT64; break;
+        }
+      break;
+
+    case ARROW_TYPE_BOOL:      out=GAL_TYPE_UINT8;  break;
+    case ARROW_TYPE_UTF8:
+    case ARROW_TYPE_LARGEUTF8: out=GAL_TYPE_STRING; break;
+
+    /* Vector columns: the child should be a fixed-width numeric type. */
+    case ARROW_TYPE_FIXEDSIZELIST:
+      children=arrow_fb_object(af, field, 5);
+      if( arrow_fb_vec_num(af, children)==1 )
+        {
+          out=arrow_field_type(af, arrow_fb_vec_table(af, children, 0),
+                               repeat);
+          if(out==GAL_TYPE_STRING || *repeat!=1
+             || arrow_fb_scalar(af, arrow_fb_vec_table(af, children, 0),
+                                2, 1, 0)==ARROW_TYPE_BOOL )
+            out=GAL_TYPE_INVALID;
+          *repeat=arrow_fb_scalar(af, type, 0, 4, 0);
+        }
+      break;
+    }
+
+  return out;
+}
+
+
+
+
+
+/* Count the number of nodes and buffers of a field (and its children) in
+   a record batch. */
+static void
+arrow_field_count(struct arrow_file *af, size_t field, size_t *nodes,
+                  size_t *buffers)
+{
+  size_t i, children=arrow_fb_object(af, field, 5);
+  int typetype=arrow_fb_scalar(af, field, 2, 1, 0);
+
+  /* This field's node and buffers. */
+  *nodes+=1;
+  switch(typetype)
+    {
+    case ARROW_TYPE_NULL:                                    break;
+    case ARROW_TYPE_STRUCT:
+    case ARROW_TYPE_FIXEDSIZELIST: *buffers+=1;              break;
+    case ARROW_TYPE_BINARY:
+    case ARROW_TYPE_UTF8:
+    case ARROW_TYPE_LARGEBINARY:
+    case ARROW_TYPE_LARGEUTF8:     *buffers+=3;              break;
+    case ARROW_TYPE_UNION:
+      error(EXIT_FAILURE, 0, "%s: union columns are not currently "
+            "supported", af->filename);
+      break;
+    default:                       *buffers+=2;              break;
+    }
+
+  /* The children. */
+  for(i=0;i<arrow_fb_vec_num(af, children);++i)
+    arrow_field_count(af, arrow_fb_vec_table(af, children, i), nodes,
+                      buffers);
+}
+
+
+
+
+
+/* Read the custom metadata value of 'key' in a field (or NULL if it isn't
+   present). */
+static char *
+arrow_field_metadata(struct arrow_file *af, size_t field, char *key)
+{
+  char *k, *out=NULL;
+  size_t i, kv, meta=arrow_fb_object(af, field, 6);
+
+  for(i=0; out==NULL && i<arrow_fb_vec_num(af, meta); ++i)
+    {
+      kv=arrow_fb_vec_table(af, meta, i);
+      k=arrow_fb_string(af, arrow_fb_object(af, kv, 0));
+      if( k && !strcmp(k, key) )
+        out=arrow_fb_string(af, arrow_fb_object(af, kv, 1));
+      free(k);
+    }
+  return out;
+}
+
+
+
+
+
+/* See the descriptions of 'gal_table_info'. */
+gal_data_t *
+gal_arrow_tab_info(char *filename, size_t *numcols, size_t *numrows)
+{
+  size_t i, field;
+  gal_data_t *allcols;
+  struct arrow_file af;
+
+  /* Open the file. */
+  arrow_file_open(filename, &af);
+  *numcols=af.numcols;
+  *numrows=af.numrows;
+
+  /* Read the information of each column. Similar to FITS tables, the
+     number of values in each row of vector columns is kept in
+     'minmapsize' (see 'gal_table_print_info'). */
+  allcols=gal_data_array_calloc(af.numcols);
+  for(i=0;i<af.numcols;++i)
+    {
+      field=arrow_fb_vec_table(&af, af.fields, i);
+      allcols[i].name=arrow_fb_string(&af, arrow_fb_object(&af, field, 0));
+      allcols[i].unit=arrow_field_metadata(&af, field, ARROW_KEY_UNIT);
+      allcols[i].comment=arrow_field_metadata(&af, field,
+                                              ARROW_KEY_COMMENT);
+      allcols[i].type=arrow_field_type(&af, field,
+                                       &allcols[i].minmapsize);
+    }
+
+  /* Clean up and return. */
+  arrow_file_close(&af);
+  return allcols;
+}
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+/*************************************************************
+ **************           Read a table            ************
+ *************************************************************/
+/* Return the position (in the file) and size of buffer 'b' of a record
+   batch. Each 'Buffer' (a structure in the vector) has two 64-bit
+   integers: its offset (from the start of the body) and its length. */
+static size_t
+arrow_read_buffer(struct arrow_file *af, size_t batch, size_t b,
+                  size_t *len)
+{
+  size_t buffers=arrow_fb_object(af, af->batches[batch], 2);
+
+  if( b>=arrow_fb_vec_num(af, buffers) )
+    error(EXIT_FAILURE, 0, "%s: not enough buffers in record batch %zu",
+          af->filename, batch+1);
+  *len=arrow_fb_uint(af, buffers+4+16*b+8, 8);
+  return af->bodies[batch]+arrow_fb_uint(af, buffers+4+16*b, 8);
+}
+
+
+
+
+
+/* Return the null count of node 'n' in a record batch. Each 'FieldNode'
+   (a structure in the vector) has two 64-bit integers: its length and
+   the number of nulls. */
+static size_t
+arrow_read_nullcount(struct arrow_file *af, size_t batch, size_t n)
+{
+  size_t nodes=arrow_fb_object(af, af->batches[batch], 1);
+
+  if( n>=arrow_fb_vec_num(af, nodes) )
+    error(EXIT_FAILURE, 0, "%s: not enough field nodes in record batch "
+          "%zu", af->filename, batch+1);
+  return arrow_fb_uint(af, nodes+4+16*n+8, 8);
+}
+
+
+
+
+
+/* Put blank values in the elements of 'out' (from 'start') that aren't
+   valid in the validity bitmap (that starts from 'valid'). When 'repeat'
+   is larger than one, each bit corresponds to 'repeat' elements. */
+static void
+arrow_read_blank(gal_data_t *out, size_t start, size_t num, size_t repeat,
+                 unsigned char *valid)
+{
+  size_t i, j;
+  char **strarr=out->array;
+  size_t width=gal_type_sizeof(out->type);
+
+  for(i=0;i<num;++i)
+    if( (valid[i/8] & (1<<(i%8)))==0 )
+      for(j=0;j<repeat;++j)
+        {
+          if(out->type==GAL_TYPE_STRING)
+            {
+              free(strarr[(start+i)*repeat+j]);
+              gal_checkset_allocate_copy(GAL_BLANK_STRING,
+                                         &strarr[(start+i)*repeat+j]);
+            }
+          else
+            gal_blank_write((char *)(out->array)
+                            + ((start+i)*repeat+j)*width, out->type);
+        }
+}
+
+
+
+
+
+/* Copy the values of fixed-width types (in 'in') into the output. */
+static void
+arrow_read_copy(gal_data_t *out, size_t start, size_t num,
+                unsigned char *in, int swap, int isbool)
+{
+  size_t i, j, width=gal_type_sizeof(out->type);
+  unsigned char *o=(unsigned char *)(out->array)+start*width;
+
+  if(isbool)
+    for(i=0;i<num;++i) o[i] = (in[i/8] >> (i%8)) & 1;
+  else if(swap && width>1)
+    for(i=0;i<num;++i)
+      for(j=0;j<width;++j)
+        o[i*width+j]=in[i*width+width-1-j];
+  else
+    memcpy(o, in, num*width);
+}
+
+
+
+
+
+/* Copy the strings of a record batch into the output. */
+static void
+arrow_read_strings(struct arrow_file *af, gal_data_t *out, size_t start,
+                   size_t num, size_t offpos, size_t datapos, size_t offw)
+{
+  char **strarr=out->array;
+  size_t i, j, len, s, e=0;
+
+  for(i=0;i<num;++i)
+    {
+      /* Read the start and end of the string (offsets are kept in the
+         file's endianness). */
+      s=e;
+      e=0;
+      if(i==0)
+        for(j=0;j<offw;++j)
+          s |= (size_t)(af->buf[offpos+j])
+               << 8*(af->swap ? offw-1-j : j);
+      for(j=0;j<offw;++j)
+        e |= (size_t)(af->buf[offpos+(i+1)*offw+j])
+             << 8*(af->swap ? offw-1-j : j);
+
+      /* Copy the string. */
+      len=e-s;
+      arrow_fb_check(af, datapos+s, len);
+      errno=0;
+      strarr[start+i]=malloc(len+1);
+      if(strarr[start+i]==NULL)
+        error(EXIT_FAILURE, errno, "%s: %zu bytes for string %zu",
+              __func__, len+1, start+i);
+      memcpy(strarr[start+i], af->buf+datapos+s, len);
+      strarr[start+i][len]='\0';
+    }
+}
+
+
+
+
+
+/* Read one column. The values of fixed-width types are directly
+   memory-mapped from the file (without any copying) when there is only
+   one record batch, the column has no nulls, the file has the same
+   endianness as this host and the values are aligned to their width in
+   the file (the Arrow format only recommends alignment, so files from
+   other writers may not have it). */
+static gal_data_t *
+arrow_read_column(struct arrow_file *af, size_t col, gal_data_t *info,
+                  size_t minmapsize, int quietmmap)
+{
+  gal_data_t *out;
+  void *array=NULL;
+  int offw=0, isbool, typetype;
+  size_t field, child=0, node=0, buffer=0;
+  size_t i, b, dsize[2], nrows, start, repeat, width, len, valid, data;
+
+  /* Make sure the type is supported. */
+  field=arrow_fb_vec_table(af, af->fields, col);
+  typetype=arrow_fb_scalar(af, field, 2, 1, 0);
+  if(info->type==GAL_TYPE_INVALID)
+    error(EXIT_FAILURE, 0, "%s: the type of column %zu is not currently "
+          "supported", af->filename, col+1);
+
+  /* Find the first node and buffer of this column. */
+  for(i=0;i<col;++i)
+    arrow_field_count(af, arrow_fb_vec_table(af, af->fields, i), &node,
+                      &buffer);
+
+  /* Basic settings. */
+  repeat=info->minmapsize;
+  width=gal_type_sizeof(info->type);
+  isbool = typetype==ARROW_TYPE_BOOL;
+  if(typetype==ARROW_TYPE_FIXEDSIZELIST) child=1;
+  if(info->type==GAL_TYPE_STRING)
+    offw = typetype==ARROW_TYPE_LARGEUTF8 ? 8 : 4;
+
+  /* If possible, map the values directly from the file. */
+  dsize[0]=af->numrows;
+  dsize[1]=repeat;
+  if( af->numbatches==1 && af->numrows && !af->swap && !isbool
+      && info->type!=GAL_TYPE_STRING
+      && arrow_read_nullcount(af, 0, node)==0
+      && arrow_read_nullcount(af, 0, node+child)==0 )
+    {
+      data=arrow_read_buffer(af, 0, buffer+1+child, &len);
+      if( len>=af->numrows*repeat*width && data%width==0 )
+        array=gal_pointer_mmap_file(af->filename, data,
+                                    af->numrows*repeat*width, quietmmap);
+    }
+
+  /* Allocate the output (only when it wasn't mapped). When there are no
+     rows, a 1-row array is allocated to avoid allocation errors and the
+     sizes are corrected after it. */
+  if(af->numrows==0) dsize[0]=1;
+  out=gal_data_alloc(array, info->type, repeat>1 ? 2 : 1, dsize, NULL, 0,
+                     minmapsize, quietmmap, info->name, info->unit,
+                     info->comment);
+  if(af->numrows==0)
+    {
+      free(out->array);
+      out->size=out->dsize[0]=0;
+      out->array=NULL;
+    }
+  if(array || af->numrows==0) return out;
+
+  /* Copy the values of each record batch. */
+  start=0;
+  for(b=0;b<af->numbatches;++b)
+    {
+      /* Number of rows in this batch. */
+      nrows=arrow_fb_scalar(af, af->batches[b], 0, 8, 0);
+      if(start+nrows>af->numrows)
+        error(EXIT_FAILURE, 0, "%s: inconsistent number of rows in record "
+              "batch %zu", af->filename, b+1);
+
+      /* Copy the values. */
+      if(info->type==GAL_TYPE_STRING)
+        {
+          i=arrow_read_buffer(af, b, buffer+1, &len);
+          arrow_fb_check(af, i, (nrows+1)*offw);
+          data=arrow_read_buffer(af, b, buffer+2, &len);
+          arrow_read_strings(af, out, start, nrows, i, data, offw);
+        }
+      else
+        {
+          data=arrow_read_buffer(af, b, buffer+1+child, &len);
+          arrow_fb_check(af, data, isbool ? (nrows+7)/8 : nrows*repeat*width);
+          arrow_read_copy(out, start*repeat, nrows*repeat, af->buf+data,
+                          af->swap, isbool);
+        }
+
+      /* Put blank values in the null elements (for vector columns, both
+         the full row and each element may be null). */
+      if( arrow_read_nullcount(af, b, node) )
+        {
+          valid=arrow_read_buffer(af, b, buffer, &len);
+          arrow_fb_check(af, valid, (nrows+7)/8);
+          arrow_read_blank(out, start, nrows, repeat, af->buf+valid);
+        }
+      if( child && arrow_read_nullcount(af, b, node+1) )
+        {
+          valid=arrow_read_buffer(af, b, buffer+1, &len);
+          arrow_fb_check(af, valid, (nrows*repeat+7)/8);
+          arrow_read_blank(out, start*repeat, nrows*repeat, 1,
+                           af->buf+valid);
+        }
+
+      /* Go onto the next batch. */
+      start+=nrows;
+    }
+
+  /* Return the output. */
+  return out;
+}
+
+
+
+
+
+/* Parameters for reading the columns in parallel. */
+struct arrow_tab_read_params
+{
+  struct arrow_file    *af;  /* The opened file.                       */
+  gal_data_t      *allcols;  /* Information of all the columns.        */
+  size_t          *indexs;   /* Index of each output column in file.   */
+  gal_data_t    **colarray;  /* Array of the read columns.             */
+  size_t        minmapsize;  /* Minimum size to memory-map.            */
+  int            quietmmap;  /* Don't print memory-mapping info.       */
+};
+
+
+
+
+
+/* Read the columns that are assigned to this thread. Each thread only
+   reads from the (already opened and memory-mapped) file, so they don't
+   interfere with each other. */
+static void *
+arrow_tab_read_onecol(void *in_prm)
+{
+  struct gal_threads_params *tprm=(struct gal_threads_params *)in_prm;
+  struct arrow_tab_read_params *p=(struct arrow_tab_read_params *)tprm->params;
+  size_t i, c;
+
+  for(i=0; tprm->indexs[i] != GAL_BLANK_SIZE_T; ++i)
+    {
+      c=p->indexs[ tprm->indexs[i] ];
+      p->colarray[ tprm->indexs[i] ] =
+        arrow_read_column(p->af, c, &p->allcols[c], p->minmapsize,
+                          p->quietmmap);
+    }
+
+  /* Wait for all the other threads to finish, then return. */
+  if(tprm->b) pthread_barrier_wait(tprm->b);
+  return NULL;
+}
+
+
+
+
+
+/* Read the columns given in the list 'indexll' (counting from zero) from
+   the Arrow IPC file. 'allcols' is the output of 'gal_arrow_tab_info'.
+   The columns are read in parallel on 'numthreads' threads. */
+gal_data_t *
+gal_arrow_tab_read(char *filename, size_t numrows, gal_data_t *allcols,
+                   gal_list_sizet_t *indexll, size_t numthreads,
+                   size_t minmapsize, int quietmmap)
+{
+  size_t i, numcols;
+  struct arrow_file af;
+  gal_data_t *out=NULL;
+  gal_list_sizet_t *ind;
+  struct arrow_tab_read_params p;
+
+  /* Open the file and make sure it hasn't changed. */
+  arrow_file_open(filename, &af);
+  if(af.numrows!=numrows)
+    error(EXIT_FAILURE, 0, "%s: the number of rows (%zu) is different "
+          "from the expected number (%zu)", filename, af.numrows, numrows);
+
+  /* Put the requested column indexs in an array (to easily find the
+     file's column of each output column in the threads). */
+  numcols=gal_list_sizet_number(indexll);
+  if(numcols)
+    {
+      p.indexs=gal_pointer_allocate(GAL_TYPE_SIZE_T, numcols, 0, __func__,
+                                    "p.indexs");
+      errno=0;
+      p.colarray=calloc(numcols, sizeof *p.colarray);
+      if(p.colarray==NULL)
+        error(EXIT_FAILURE, errno, "%s: %zu bytes for 'p.colarray'",
+              __func__, numcols*sizeof *p.colarray);
+      i=0; for(ind=indexll; ind!=NULL; ind=ind->next) p.indexs[i++]=ind->v;
+
+      /* Read the columns in parallel. */
+      p.af=&af;
+      p.allcols=allcols;
+      p.quietmmap=quietmmap;
+      p.minmapsize=minmapsize;
+      gal_threads_spin_off(arrow_tab_read_onecol, &p, numcols, numthreads,
+                           minmapsize, quietmmap);
+
+      /* Put the columns into a single list. */
+      out=p.colarray[0];
+      for(i=0;i<numcols-1;++i) p.colarray[i]->next=p.colarray[i+1];
+      free(p.colarray);
+      free(p.indexs);
+    }
+
+  /* Clean up and return. */
+  arrow_file_close(&af);
+  return out;
+}
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+/*************************************************************
+ **************          Write a table            ************
+ *************************************************************/
+/* Information about each column for writing. */
+struct arrow_write_col
+{
+  gal_data_t          *col;  /* The column.                            */
+  gal_data_t         *flag;  /* Flag of blank values (or NULL).        */
+  size_t         nullcount;  /* Number of blank values.                */
+  size_t          strbytes;  /* Total length of strings.               */
+  int                 offw;  /* Width of string offsets (4 or 8).      */
+};
+
+
+
+
+
+/* Body buffers are aligned to 8 bytes. */
+static size_t
+arrow_write_pad(size_t size)
+{
+  return (size+7)/8*8;
+}
+
+
+
+
+
+/* Write 'n' zero-valued bytes (for padding). */
+static void
+arrow_write_zeros(FILE *fp, size_t n)
+{
+  while(n--) fputc(0, fp);
+}
+
+
+
+
+
+/* Write 'value' as an 'n'-byte little-endian integer in the file. */
+static void
+arrow_write_uint(FILE *fp, uint64_t value, size_t n)
+{
+  size_t i;
+  for(i=0;i<n;++i) fputc( (value >> (8*i)) & 0xFF, fp );
+}
+
+
+
+
+
+/* Prepare the information of each column for writing. */
+static struct arrow_write_col *
+arrow_write_prepare(gal_data_t *cols, size_t numcols, size_t *numrows)
+{
+  size_t i, j;
+  char **strarr;
+  uint8_t *flag;
+  gal_data_t *col;
+  struct arrow_write_col *wc;
+
+  /* Allocate the array. */
+  errno=0;
+  wc=calloc(numcols, sizeof *wc);
+  if(wc==NULL)
+    error(EXIT_FAILURE, errno, "%s: %zu bytes for 'wc'", __func__,
+          numcols*sizeof *wc);
+
+  /* Fill the information of each column. */
+  i=0;
+  *numrows=GAL_BLANK_SIZE_T;
+  for(col=cols; col!=NULL; col=col->next)
+    {
+      /* Check the type, dimensions and number of rows. */
+      switch(col->type)
+        {
+        case GAL_TYPE_BIT:
+        case GAL_TYPE_COMPLEX32:
+        case GAL_TYPE_COMPLEX64:
+          error(EXIT_FAILURE, 0, "%s: %s columns are not supported in "
+                "Arrow tables", __func__, gal_type_name(col->type, 1));
+        }
+      if( col->ndim>2 || (col->ndim==2 && col->type==GAL_TYPE_STRING) )
+        error(EXIT_FAILURE, 0, "%s: only 1D columns or 2D numeric "
+              "(vector) columns can be written in Arrow tables",
+              __func__);
+      if(*numrows==GAL_BLANK_SIZE_T) *numrows=col->dsize[0];
+      else if(col->dsize[0]!=*numrows)
+        error(EXIT_FAILURE, 0, "%s: the number of rows in the input "
+              "columns are not equal! The first column has %zu rows, "
+              "while column %zu has %zu rows", __func__, *numrows, i+1,
+              col->dsize[0]);
+
+      /* Flag the blank elements. */
+      wc[i].col=col;
+      if( col->size && gal_blank_present(col, 1) )
+        {
+          wc[i].flag=gal_blank_flag(col);
+          flag=wc[i].flag->array;
+          for(j=0;j<col->size;++j) wc[i].nullcount+=flag[j];
+        }
+
+      /* Total length of the strings (the offsets have to be 64-bit when
+         it is larger than the largest 32-bit signed integer). */
+      if(col->type==GAL_TYPE_STRING)
+        {
+          strarr=col->array;
+          for(j=0;j<col->size;++j) wc[i].strbytes+=strlen(strarr[j]);
+          wc[i].offw = wc[i].strbytes>INT32_MAX ? 8 : 4;
+        }
+      ++i;
+    }
+
+  /* Return the array. */
+  return wc;
+}
+
+
+
+
+
+/* Add the 'Type' table of a column (that is the 'type' field of its
+   'Field' table) and return its position. */
+static size_t
+arrow_write_type(struct arrow_fbb *b, uint8_t type, int offw,
+                 size_t repeat, uint8_t *typetype)
+{
+  size_t table, fpos[2];
+  const size_t intsizes[2]={4, 1}, fltsizes[1]={2}, lstsizes[1]={4};
+
+  /* Vector columns. */
+  if(repeat)
+    {
+      *typetype=ARROW_TYPE_FIXEDSIZELIST;
+      table=arrow_fbb_table(b, 1, lstsizes, fpos);
+      arrow_fbb_put(b, fpos[0], repeat, 4);
+      return table;
+    }
+
+  /* Single-valued columns. */
+  switch(type)
+    {
+    case GAL_TYPE_UINT8:  case GAL_TYPE_INT8:
+    case GAL_TYPE_UINT16: case GAL_TYPE_INT16:
+    case GAL_TYPE_UINT32: case GAL_TYPE_INT32:
+    case GAL_TYPE_UINT64: case GAL_TYPE_INT64:
+      *typetype=ARROW_TYPE_INT;
+      table=arrow_fbb_table(b, 2, intsizes, fpos);
+      arrow_fbb_put(b, fpos[0], 8*gal_type_sizeof(type), 4);
+      arrow_fbb_put(b, fpos[1], type==GAL_TYPE_INT8
+                                || type==GAL_TYPE_INT16
+                                || type==GAL_TYPE_INT32
+                                || type==GAL_TYPE_INT64, 1);
+      return table;
+
+    case GAL_TYPE_FLOAT32:
+    case GAL_TYPE_FLOAT64:
+      *typetype=ARROW_TYPE_FLOATINGPOINT;
+      table=arrow_fbb_table(b, 1, fltsizes, fpos);
+      arrow_fbb_put(b, fpos[0], ( type==GAL_TYPE_FLOAT32
+                                  ? ARROW_PRECISION_SINGLE
+                                  : ARROW_PRECISION_DOUBLE ), 2);
+      return table;
+
+    case GAL_TYPE_STRING:
+      *typetype = offw==8 ? ARROW_TYPE_LARGEUTF8 : ARROW_TYPE_UTF8;
+      return arrow_fbb_table(b, 0, NULL, fpos);
+
+    default:
+      error(EXIT_FAILURE, 0, "%s: type code %d not recognized", __func__,
+            type);
+    }
+
+  /* Control should not reach here. */
+  return 0;
+}
+
+
+
+
+
+/* Add a 'Field' table: name (string), nullable (bool), type_type (uint8),
+   type (table), dictionary (not used), children (vector of fields) and
+   custom_metadata (vector of key-values). */
+static size_t
+arrow_write_field(struct arrow_fbb *b, gal_data_t *col, int offw,
+                  int ischild)
+{
+  uint8_t typetype;
+  size_t table, fpos[7], children;
+  gal_list_str_t *keys=NULL, *values=NULL;
+  const size_t sizes[7]={4, 1, 1, 4, 0, 4, 4};
+  size_t repeat = ischild==0 && col->ndim==2 ? col->dsize[1] : 0;
+
+  /* Write the table and its scalar fields (all columns can have nulls:
+     Gnuastro's blank values). */
+  table=arrow_fbb_table(b, 7, sizes, fpos);
+  arrow_fbb_put(b, fpos[1], 1, 1);
+
+  /* Name of the field. */
+  arrow_fbb_ref(b, fpos[0],
+                arrow_fbb_string(b, ( ischild
+                                      ? ARROW_VECTOR_CHILD
+                                      : (col->name ? col->name : "") )));
+
+  /* Type of the field. */
+  arrow_fbb_ref(b, fpos[3], arrow_write_type(b, col->type, offw, repeat,
+                                             &typetype));
+  arrow_fbb_put(b, fpos[2], typetype, 1);
+
+  /* Children (only for vector columns). */
+  children=arrow_fbb_vector(b, repeat ? 1 : 0, 4, 4);
+  arrow_fbb_ref(b, fpos[5], children);
+  if(repeat)
+    arrow_fbb_ref(b, children+4, arrow_write_field(b, col, offw, 1));
+
+  /* The unit and comment are written as custom metadata. */
+  if(ischild==0)
+    {
+      if(col->comment)
+        {
+          gal_list_str_add(&keys, ARROW_KEY_COMMENT, 0);
+          gal_list_str_add(&values, col->comment, 0);
+        }
+      if(col->unit)
+        {
+          gal_list_str_add(&keys, ARROW_KEY_UNIT, 0);
+          gal_list_str_add(&values, col->unit, 0);
+        }
+    }
+  arrow_fbb_ref(b, fpos[6], arrow_fbb_metadata(b, keys, values));
+  gal_list_str_free(keys, 0);
+  gal_list_str_free(values, 0);
+
+  /* Return the position of the table. */
+  return table;
+}
+
+
+
+
+
+/* Add the 'Schema' table: endianness (short), fields (vector of fields),
+   custom_metadata (vector of key-values). */
+static size_t
+arrow_write_schema(struct arrow_fbb *b, struct arrow_write_col *wc,
+                   size_t numcols, gal_list_str_t *keys,
+                   gal_list_str_t *values)
+{
+  size_t i, table, fields, fpos[3];
+  const size_t sizes[3]={2, 4, 4};
+  uint16_t one=1;
+
+  /* The table and its endianness (0: little-endian, 1: big-endian). */
+  table=arrow_fbb_table(b, 3, sizes, fpos);
+  arrow_fbb_put(b, fpos[0], *(uint8_t *)&one!=1, 2);
+
+  /* The fields. */
+  fields=arrow_fbb_vector(b, numcols, 4, 4);
+  arrow_fbb_ref(b, fpos[1], fields);
+  for(i=0;i<numcols;++i)
+    arrow_fbb_ref(b, fields+4+4*i,
+                  arrow_write_field(b, wc[i].col, wc[i].offw, 0));
+
+  /* Metadata of the table. */
+  arrow_fbb_ref(b, fpos[2], arrow_fbb_metadata(b, keys, values));
+  return table;
+}
+
+
+
+
+
+/* Add the 'RecordBatch' table: length (long), nodes (vector of
+   'FieldNode' structures) and buffers (vector of 'Buffer' structures). The
+   body's buffers are in the same order as the columns (and for each
+   column: validity, offsets (only strings) and values). The size of the
+   body is returned in 'bodylen'. */
+static size_t
+arrow_write_recordbatch(struct arrow_fbb *b, struct arrow_write_col *wc,
+                        size_t numcols, size_t numrows, size_t *bodylen)
+{
+  gal_data_t *col;
+  const size_t sizes[3]={8, 4, 4};
+  size_t i, n, table, nodes, buffers, fpos[3];
+  size_t nn=0, nb=0, numnodes=0, numbuffers=0;
+
+  /* Count the nodes and buffers. */
+  for(i=0;i<numcols;++i)
+    if(wc[i].col->ndim==2) { numnodes+=2; numbuffers+=3; }
+    else
+      { numnodes+=1; numbuffers += wc[i].col->type==GAL_TYPE_STRING ? 3:2; }
+
+  /* The table and its vectors (the structures are aligned to 8
+     bytes). */
+  table=arrow_fbb_table(b, 3, sizes, fpos);
+  arrow_fbb_put(b, fpos[0], numrows, 8);
+  nodes=arrow_fbb_vector(b, numnodes, 16, 8);
+  arrow_fbb_ref(b, fpos[1], nodes);
+  buffers=arrow_fbb_vector(b, numbuffers, 16, 8);
+  arrow_fbb_ref(b, fpos[2], buffers);
+
+  /* Fill the nodes and buffers. */
+#define ARROW_NODE(L, N) {                                              \
+    arrow_fbb_put(b, nodes+4+16*nn,   (L), 8);                          \
+    arrow_fbb_put(b, nodes+4+16*nn+8, (N), 8); ++nn; }
+#define ARROW_BUFFER(L) {                                               \
+    arrow_fbb_put(b, buffers+4+16*nb,   *bodylen, 8);                   \
+    arrow_fbb_put(b, buffers+4+16*nb+8, (L), 8); ++nb;                  \
+    *bodylen+=arrow_write_pad(L); }
+  *bodylen=0;
+  for(i=0;i<numcols;++i)
+    {
+      col=wc[i].col;
+      if(col->ndim==2)         /* Vector column: a fixed-size list. */
+        {
+          ARROW_NODE(numrows, 0);
+          ARROW_BUFFER(0);
+          n=numrows*col->dsize[1];
+          ARROW_NODE(n, wc[i].nullcount);
+          ARROW_BUFFER(wc[i].nullcount ? (n+7)/8 : 0);
+          ARROW_BUFFER(n*gal_type_sizeof(col->type));
+        }
+      else
+        {
+          ARROW_NODE(numrows, wc[i].nullcount);
+          ARROW_BUFFER(wc[i].nullcount ? (numrows+7)/8 : 0);
+          if(col->type==GAL_TYPE_STRING)
+            {
+              ARROW_BUFFER( (numrows+1)*wc[i].offw );
+              ARROW_BUFFER( wc[i].strbytes );
+            }
+          else
+            ARROW_BUFFER(numrows*gal_type_sizeof(col->type));
+        }
+    }
+#undef ARROW_NODE
+#undef ARROW_BUFFER
+
+  /* Return the position of the table. */
+  return table;
+}
+
+
+
+
+
+/* Write a message (with the given header and body length) into the file
+   and return the size of its metadata. The message is preceded by the
+   continuation marker and the size of the metadata (that is padded to 8
+   bytes). */
+static size_t
+arrow_write_message(FILE *fp, struct arrow_fbb *header, uint8_t htype,
+                    size_t bodylen, size_t hroot)
+{
+  size_t table, fpos[4];
+  struct arrow_fbb b={NULL, 0, 0};
+  const size_t sizes[4]={2, 1, 4, 8};
+
+  /* The root offset, then the 'Message' table: version (short),
+     header_type (uint8), header (table) and bodyLength (long). */
+  arrow_fbb_space(&b, 4, 4);
+  table=arrow_fbb_table(&b, 4, sizes, fpos);
+  arrow_fbb_ref(&b, 0, table);
+  arrow_fbb_put(&b, fpos[0], ARROW_METADATA_V5, 2);
+  arrow_fbb_put(&b, fpos[1], htype, 1);
+  arrow_fbb_put(&b, fpos[3], bodylen, 8);
+
+  /* Append the header's FlatBuffer (that was built independently from
+     position 0, so its offsets are still valid when its start is aligned
+     to 8 bytes). */
+  arrow_fbb_ref(&b, fpos[2], arrow_fbb_space(&b, header->size, 8)+hroot);
+  memcpy(b.buf+b.size-header->size, header->buf, header->size);
+  arrow_fbb_space(&b, 0, 8);
+
+  /* Write the message's metadata. */
+  arrow_write_uint(fp, ARROW_CONTINUATION, 4);
+  arrow_write_uint(fp, b.size, 4);
+  fwrite(b.buf, 1, b.size, fp);
+  free(b.buf);
+  return 8+b.size;
+}
+
+
+
+
+
+/* Write a validity bitmap from the flag of blank elements. */
+static void
+arrow_write_validity(FILE *fp, uint8_t *flag, size_t num)
+{
+  size_t i;
+  unsigned char byte=0;
+
+  for(i=0;i<num;++i)
+    {
+      if(flag[i]==0) byte |= 1<<(i%8);
+      if(i%8==7 || i==num-1) { fputc(byte, fp); byte=0; }
+    }
+  arrow_write_zeros(fp, arrow_write_pad((num+7)/8)-(num+7)/8);
+}
+
+
+
+
+
+/* Write the body of the record batch (in the same order as
+   'arrow_write_recordbatch'). */
+static void
+arrow_write_body(FILE *fp, struct arrow_write_col *wc, size_t numcols,
+                 size_t numrows)
+{
+  gal_data_t *col;
+  size_t i, j, n, offset;
+  char **strarr;
+
+  for(i=0;i<numcols;++i)
+    {
+      col=wc[i].col;
+      n=col->size;
+
+      /* Validity bitmap. */
+      if(wc[i].nullcount)
+        arrow_write_validity(fp, wc[i].flag->array, n);
+
+      /* Values. */
+      if(col->type==GAL_TYPE_STRING)
+        {
+          /* Offsets (in the host's endianness). */
+          strarr=col->array;
+          offset=0;
+          for(j=0;j<=n;++j)
+            {
+              if(wc[i].offw==8)
+                { int64_t o=offset; fwrite(&o, 8, 1, fp); }
+              else
+                { int32_t o=offset; fwrite(&o, 4, 1, fp); }
+              if(j<n) offset+=strlen(strarr[j]);
+            }
+          arrow_write_zeros(fp, arrow_write_pad((n+1)*wc[i].offw)
+                                - (n+1)*wc[i].offw);
+
+          /* Characters. */
+          for(j=0;j<n;++j) fputs(strarr[j], fp);
+          arrow_write_zeros(fp, arrow_write_pad(offset)-offset);
+        }
+      else
+        {
+          offset=n*gal_type_sizeof(col->type);
+          if(n) fwrite(col->array, 1, offset, fp);
+          arrow_write_zeros(fp, arrow_write_pad(offset)-offset);
+        }
+    }
+}
+
+
+
+
+
+/* Convert the keywords and comments into lists of keys and values (to be
+   written as the table's metadata), the keywords are freed. */
+static void
+arrow_write_keys(struct gal_fits_list_key_t **keylist,
+                 gal_list_str_t *comments, gal_list_str_t **keys,
+                 gal_list_str_t **values)
+{
+  char *valuestr;
+  gal_list_str_t *c;
+  gal_fits_list_key_t *tmp, *ttmp;
+
+  /* The keywords (titles and full comments are ignored). */
+  tmp = keylist ? *keylist : NULL;
+  while(tmp!=NULL)
+    {
+      if(tmp->title==NULL && tmp->fullcomment==NULL)
+        {
+          valuestr = ( tmp->type==GAL_TYPE_STRING
+                       ? tmp->value
+                       : gal_type_to_string(tmp->value, tmp->type, 1) );
+          gal_list_str_add(keys, tmp->keyname, 1);
+          gal_list_str_add(values, valuestr, 1);
+          if(tmp->type!=GAL_TYPE_STRING) free(valuestr);
+          if(tmp->kfree) free(tmp->keyname);
+          if(tmp->vfree) free(tmp->value);
+          if(tmp->cfree) free(tmp->comment);
+          if(tmp->ufree) free(tmp->unit);
+        }
+      else
+        {
+          if(tmp->title && tmp->tfree) free(tmp->title);
+          if(tmp->fullcomment && tmp->fcfree) free(tmp->fullcomment);
+        }
+      ttmp=tmp->next;
+      free(tmp);
+      tmp=ttmp;
+    }
+  if(keylist) *keylist=NULL;
+
+  /* The comments. */
+  for(c=comments; c!=NULL; c=c->next)
+    {
+      gal_list_str_add(keys, ARROW_KEY_TABCOMMENT, 1);
+      gal_list_str_add(values, c->v, 1);
+    }
+
+  /* The lists were filled as last-in-first-out. */
+  gal_list_str_reverse(keys);
+  gal_list_str_reverse(values);
+}
+
+
+
+
+
+/* Write the columns into an Arrow IPC file. The column values are written
+   without any change (in the host's endianness), so they can be read
+   directly (without any copying) later. Gnuastro's blank values are
+   marked as nulls in the validity bitmaps. */
+void
+gal_arrow_tab_write(gal_data_t *cols, struct gal_fits_list_key_t **keylist,
+                    gal_list_str_t *comments, char *filename)
+{
+  FILE *fp;
+  struct arrow_write_col *wc;
+  const size_t footsizes[4]={2, 4, 4, 4};
+  gal_list_str_t *keys=NULL, *values=NULL;
+  size_t i, numcols, numrows, bodylen, fpos[4];
+  struct arrow_fbb schema={NULL, 0, 0}, batch={NULL, 0, 0};
+  struct arrow_fbb footer={NULL, 0, 0};
+  size_t root, blocks, schemaroot, batchroot, batchoffset, batchmeta;
+
+  /* Make sure the file doesn't exist and prepare the columns. */
+  if( gal_checkset_writable_notexist(filename)==0 )
+    error(EXIT_FAILURE, 0, "%s: already exists", filename);
+  numcols=gal_list_data_number(cols);
+  if(numcols==0)
+    error(EXIT_FAILURE, 0, "%s: no columns to write", __func__);
+  wc=arrow_write_prepare(cols, numcols, &numrows);
+  arrow_write_keys(keylist, comments, &keys, &values);
+
+  /* Build the FlatBuffers of the schema and the record batch. */
+  schemaroot=arrow_write_schema(&schema, wc, numcols, keys, values);
+  batchroot=arrow_write_recordbatch(&batch, wc, numcols, numrows,
+                                    &bodylen);
+
+  /* Open the file and write the magic string (padded to 8 bytes). */
+  errno=0;
+  fp=fopen(filename, "wb");
+  if(fp==NULL)
+    error(EXIT_FAILURE, errno, "%s: couldn't be opened for writing",
+          filename);
+  fwrite(ARROW_MAGIC, 1, ARROW_MAGIC_LEN, fp);
+  arrow_write_zeros(fp, 8-ARROW_MAGIC_LEN);
+
+  /* The schema and record batch messages. */
+  batchoffset = 8 + arrow_write_message(fp, &schema, ARROW_HEADER_SCHEMA,
+                                        0, schemaroot);
+  batchmeta=arrow_write_message(fp, &batch, ARROW_HEADER_RECORDBATCH,
+                                bodylen, batchroot);
+  arrow_write_body(fp, wc, numcols, numrows);
+
+  /* End-of-stream marker. */
+  arrow_write_uint(fp, ARROW_CONTINUATION, 4);
+  arrow_write_uint(fp, 0, 4);
+
+  /* The footer: version (short), schema (table), dictionaries (vector of
+     blocks) and recordBatches (vector of blocks). */
+  arrow_fbb_space(&footer, 4, 4);
+  root=arrow_fbb_table(&footer, 4, footsizes, fpos);
+  arrow_fbb_ref(&footer, 0, root);
+  arrow_fbb_put(&footer, fpos[0], ARROW_METADATA_V5, 2);
+  arrow_fbb_ref(&footer, fpos[2], arrow_fbb_vector(&footer, 0, 24, 8));
+  blocks=arrow_fbb_vector(&footer, 1, 24, 8);
+  arrow_fbb_ref(&footer, fpos[3], blocks);
+  arrow_fbb_put(&footer, blocks+4,    batchoffset, 8);
+  arrow_fbb_put(&footer, blocks+4+8,  batchmeta,   4);
+  arrow_fbb_put(&footer, blocks+4+16, bodylen,     8);
+  arrow_fbb_ref(&footer, fpos[1],
+                arrow_write_schema(&footer, wc, numcols, keys, values));
+
+  /* Write the footer, its size and the final magic string. */
+  fwrite(footer.buf, 1, footer.size, fp);
+  arrow_write_uint(fp, footer.size, 4);
+  fwrite(ARROW_MAGIC, 1, ARROW_MAGIC_LEN, fp);
+
+  /* Close the file. */
+  errno=0;
+  if( ferror(fp) || fclose(fp) )
+    error(EXIT_FAILURE, errno, "%s: couldn't be written", filename);
+
+  /* Clean up. */
+  for(i=0;i<numcols;++i) gal_data_free(wc[i].flag);
+  free(wc);
+  free(batch.buf);
+  free(footer.buf);
+  free(schema.buf);
+  gal_list_str_free(keys, 1);
+  gal_list_str_free(values, 1);
+}
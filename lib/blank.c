@@ -941,7 +941,9 @@ gal_blank_remove_realloc(gal_data_t *input)
   /* Remove the blanks and fix the size of the dataset. */
   gal_blank_remove(input);
 
-  /* Run realloc to shrink the allocated space. */
+  /* Run realloc to shrink the allocated space (memory-mapped arrays
+     can't be re-allocated, they will be freed later). */
+  if( input->mmapname || gal_pointer_mmap_file_is(input->array) ) return;
   input->array=realloc(input->array,
                        input->size*gal_type_sizeof(input->type));
   if(input->array==NULL)
@@ -0,0 +1,209 @@
+/*********************************************************************
+Convolution operations used by some Gnuastro programs, but too specific
+to be in the general library.
+This is part of GNU Astronomy Utilities (Gnuastro) package.
+
+Original author:
+     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+Contributing author(s):
+Copyright (C) 2022 Free Software Foundation, Inc.
+
+Gnuastro is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+Gnuastro is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
+**********************************************************************/
+#include <config.h>
+
+#include <stdio.h>
+#include <errno.h>
+#include <error.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <gnuastro/fits.h>
+#include <gnuastro/type.h>
+#include <gnuastro/array.h>
+#include <gnuastro/pointer.h>
+#include <gnuastro/dimension.h>
+
+#include <gnuastro-internal/checkset.h>
+#include <gnuastro-internal/convolve-internal.h>
+
+
+
+
+/***********************************************************************/
+/**************          Cache of convolved images        **************/
+/***********************************************************************/
+/* The convolved image only depends on the input pixels, the kernel and
+   the tessellation (convolution doesn't cross channel borders when
+   '--workoverch' isn't given). So we use a hash of all of these as the key
+   (and name) of a convolved image in the cache directory. We don't need a
+   cryptographic hash here, so we use the 64-bit FNV-1a hash, but to be
+   fast on large images, the bulk of the bytes are added eight at a
+   time. Each step (an XOR and a multiplication by an odd number) can be
+   inverted, so the hash depends on the position of every byte: a
+   flipped, transposed or shifted input (with the same pixel values) will
+   have a different hash. */
+#define CONVOLVEINTERNAL_FNV_OFFSET 14695981039346656037ULL
+#define CONVOLVEINTERNAL_FNV_PRIME  1099511628211ULL
+
+static uint64_t
+convolveinternal_hash(uint64_t hash, void *in, size_t size)
+{
+  uint64_t word;
+  unsigned char *c=in, *cf=c+size;
+
+  /* Add the bytes in groups of eight ('memcpy' is used because the
+     pointer may not be aligned). */
+  for(; cf-c>=8; c+=8)
+    {
+      memcpy(&word, c, 8);
+      hash^=word;
+      hash*=CONVOLVEINTERNAL_FNV_PRIME;
+    }
+
+  /* Add the remaining bytes one by one. */
+  for(; c<cf; ++c) { hash^=*c; hash*=CONVOLVEINTERNAL_FNV_PRIME; }
+  return hash;
+}
+
+
+
+
+
+/* Add the type, size and values of a dataset to the hash. */
+static uint64_t
+convolveinternal_hash_data(uint64_t hash, gal_data_t *data)
+{
+  hash=convolveinternal_hash(hash, &data->type, sizeof data->type);
+  hash=convolveinternal_hash(hash, &data->ndim, sizeof data->ndim);
+  hash=convolveinternal_hash(hash, data->dsize,
+                             data->ndim * sizeof *data->dsize);
+  return convolveinternal_hash(hash, data->array,
+                               data->size * gal_type_sizeof(data->type));
+}
+
+
+
+
+
+/* Return the name of the convolved image in the cache directory. The
+   input's pixels are used (rather than the file name or its modification
+   time) so the same data in different files (or a copy of the file) will
+   point to the same convolved image. The output is allocated and must be
+   freed by the caller. */
+char *
+gal_convolveinternal_cache_name(char *cachedir, gal_data_t *input,
+                                gal_data_t *kernel,
+                                struct gal_tile_two_layer_params *tl)
+{
+  char *out;
+  int errnum;
+  uint64_t hash=CONVOLVEINTERNAL_FNV_OFFSET;
+
+  /* Make sure the directory exists (or can be built). */
+  errnum=gal_checkset_mkdir(cachedir);
+  if(errnum)
+    error(EXIT_FAILURE, errnum, "%s: can't be used as a cache directory "
+          "for the convolved image", cachedir);
+
+  /* The input and the kernel (their types, sizes and values). */
+  hash=convolveinternal_hash_data(hash, input);
+  hash=convolveinternal_hash_data(hash, kernel);
+
+  /* The tessellation. */
+  hash=convolveinternal_hash(hash, tl->tilesize,
+                             tl->ndim*sizeof *tl->tilesize);
+  hash=convolveinternal_hash(hash, tl->numchannels,
+                             tl->ndim*sizeof *tl->numchannels);
+  hash=convolveinternal_hash(hash, &tl->remainderfrac,
+                             sizeof tl->remainderfrac);
+  hash=convolveinternal_hash(hash, &tl->workoverch, sizeof tl->workoverch);
+
+  /* Build the file name and return it. */
+  if( asprintf(&out, "%s%sconvolved-%016"PRIx64".fits", cachedir,
+               cachedir[strlen(cachedir)-1]=='/' ? "" : "/", hash)<0 )
+    error(EXIT_FAILURE, 0, "%s: asprintf allocation", __func__);
+  return out;
+}
+
+
+
+
+
+/* If the convolved image exists in the cache, read it and return
+   it. Otherwise, return NULL. */
+gal_data_t *
+gal_convolveinternal_cache_read(char *cachename, gal_data_t *input,
+                                size_t minmapsize, int quietmmap)
+{
+  gal_data_t *out;
+
+  /* If the file doesn't exist, return NULL. */
+  if( gal_checkset_check_file_return(cachename)==0 ) return NULL;
+
+  /* Read the cached image (it isn't compressed, so one thread is
+     enough). */
+  out=gal_array_read_one_ch_to_type(cachename, "1", NULL, GAL_TYPE_FLOAT32,
+                                    1, minmapsize, quietmmap);
+  out->ndim=gal_dimension_remove_extra(out->ndim, out->dsize, NULL);
+
+  /* The name is derived from a hash of the input's pixels, so it should
+     have the same size. But to be safe in case of a hash collision, we
+     will ignore it if it doesn't. */
+  if( gal_dimension_is_different(input, out) )
+    {
+      error(0, 0, "%s: [*** WARNING ***] not the same size as the input, "
+            "it will be ignored and the input will be convolved", cachename);
+      gal_data_free(out);
+      return NULL;
+    }
+
+  /* Return the cached image. */
+  return out;
+}
+
+
+
+
+
+/* Write the convolved image into the cache. Several programs (possibly
+   running in parallel) may write the same convolved image in the cache,
+   so it is first written in a temporary file and then renamed (which is
+   atomic). */
+void
+gal_convolveinternal_cache_write(gal_data_t *conv, char *cachename,
+                                 char *program_string)
+{
+  char *tmpname, *key;
+  gal_fits_list_key_t *keys=NULL;
+
+  /* Put the key (the base name of the file) as a keyword. */
+  key=gal_checkset_not_dir_part(cachename);
+  gal_fits_key_list_add(&keys, GAL_TYPE_STRING,
+                        GAL_CONVOLVEINTERNAL_CACHE_KEYNAME, 0, key, 1,
+                        "Key of convolved image in cache.", 0, NULL, 0);
+
+  /* Write the image into a temporary file and rename it. */
+  tmpname=gal_checkset_make_unique_suffix(cachename, ".fits");
+  gal_fits_img_write(conv, tmpname, keys, program_string, 0);
+  errno=0;
+  if( rename(tmpname, cachename) )
+    error(EXIT_FAILURE, errno, "%s: couldn't be renamed to %s", tmpname,
+          cachename);
+
+  /* Clean up. */
+  free(tmpname);
+}
@@ -292,7 +292,8 @@ gal_data_free_contents(gal_data_t *data)
     {
       if(data->mmapname)
         gal_pointer_mmap_free(&data->mmapname, data->quietmmap);
-      else free(data->array);
+      else if( gal_pointer_mmap_file_free(data->array)==0 )
+        free(data->array);
     }
   data->array=NULL;
 }
@@ -2533,18 +2533,275 @@ gal_fits_img_info_dim(char *filename, char *hdu, size_t *ndim)
 
 
 
-/* Read a FITS image HDU into a Gnuastro data structure. */
-gal_data_t *
-gal_fits_img_read(char *filename, char *hdu, size_t minmapsize,
-                  int quietmmap)
+/* Parameters to swap the bytes of a mapped image in parallel. */
+struct fits_img_read_map_params
+{
+  unsigned char  *array;  /* Start of the mapped array.              */
+  size_t          width;  /* Number of bytes in each value.          */
+  size_t           size;  /* Number of values in the array.          */
+  size_t      chunksize;  /* Number of values in each chunk.         */
+};
+
+
+
+
+
+/* Swap the bytes of the values in the chunks that are assigned to this
+   thread (FITS data are big-endian). */
+static void *
+fits_img_read_map_swap(void *in_prm)
+{
+  struct gal_threads_params *tprm=(struct gal_threads_params *)in_prm;
+  struct fits_img_read_map_params *p=tprm->params;
+
+  unsigned char *v, *vf, tmp;
+  size_t b, i, w=p->width, first, last;
+
+  /* Go over all the chunks that are assigned to this thread. */
+  for(i=0; tprm->indexs[i] != GAL_BLANK_SIZE_T; ++i)
+    {
+      first=tprm->indexs[i]*p->chunksize;
+      last = first+p->chunksize > p->size ? p->size : first+p->chunksize;
+      vf=p->array+last*w;
+      for(v=p->array+first*w; v<vf; v+=w)
+        for(b=0;b<w/2;++b)
+          { tmp=v[b]; v[b]=v[w-1-b]; v[w-1-b]=tmp; }
+    }
+
+  /* Wait for all the other threads to finish, then return. */
+  if(tprm->b) pthread_barrier_wait(tprm->b);
+  return NULL;
+}
+
+
+
+
+
+/* When the data unit of the image can be used in memory without any
+   change of its values, map it directly from the file and return the
+   mapped pointer. Otherwise return NULL. FITS data are big-endian, so on
+   little-endian hosts the bytes of multi-byte types are swapped in place
+   (on 'numthreads' threads). The mapping is private, so the file isn't
+   changed, but the swapped pages are copied into RAM: only 8-bit images
+   (or big-endian hosts) keep the pixels in the file until they are
+   used. */
+static void *
+fits_img_read_map(fitsfile *fptr, uint8_t type, size_t size,
+                  size_t numthreads, int quietmmap)
+{
+  void *out;
+  uint16_t one=1;
+  long long blank;
+  LONGLONG headstart, datastart, dataend;
+  double bscale=1.0f, bzero=0.0f;
+  struct fits_img_read_map_params p;
+  int bitpix, blankok=1, status=0, keystatus;
+  size_t width=gal_type_sizeof(type);
+  char urltype[FLEN_FILENAME], filename[FLEN_FILENAME];
+
+  /* The HDU must be an uncompressed image in a normal file (not in
+     memory, or through a network protocol for example). */
+  if( fits_is_compressed_image(fptr, &status) ) return NULL;
+  fits_url_type(fptr, urltype, &status);
+  fits_file_name(fptr, filename, &status);
+  if( status || strcmp(urltype, "file://") ) return NULL;
+
+  /* The values must be used without any scaling. */
+  fits_get_img_type(fptr, &bitpix, &status);
+  if( status || type!=gal_fits_bitpix_to_type(bitpix) ) return NULL;
+  keystatus=0;
+  fits_read_key(fptr, TDOUBLE, "BSCALE", &bscale, NULL, &keystatus);
+  keystatus=0;
+  fits_read_key(fptr, TDOUBLE, "BZERO", &bzero, NULL, &keystatus);
+  if( bscale!=1.0f || bzero!=0.0f ) return NULL;
+
+  /* In integer types, the blank value of the file (if any) must be the
+     same as Gnuastro's blank value. */
+  keystatus=0;
+  if( bitpix>0
+      && fits_read_key(fptr, TLONGLONG, "BLANK", &blank, NULL,
+                       &keystatus)==0 )
+    switch(type)
+      {
+      case GAL_TYPE_UINT8: blankok = blank==GAL_BLANK_UINT8; break;
+      case GAL_TYPE_INT16: blankok = blank==GAL_BLANK_INT16; break;
+      case GAL_TYPE_INT32: blankok = blank==GAL_BLANK_INT32; break;
+      case GAL_TYPE_INT64: blankok = blank==GAL_BLANK_INT64; break;
+      default:             blankok = 0;
+      }
+  if(blankok==0) return NULL;
+
+  /* Find the start of the data unit and map it. */
+  if( fits_get_hduaddrll(fptr, &headstart, &datastart, &dataend, &status) )
+    return NULL;
+  out=gal_pointer_mmap_file(filename, datastart, size*width, quietmmap);
+
+  /* On little-endian hosts, swap the bytes of multi-byte values. */
+  if( out && width>1 && *(uint8_t *)(&one)==1 )
+    {
+      if(numthreads==0) numthreads=1;
+      p.array=out;
+      p.size=size;
+      p.width=width;
+      p.chunksize=size/numthreads + (size%numthreads!=0);
+      gal_threads_spin_off(fits_img_read_map_swap, &p,
+                           size/p.chunksize + (size%p.chunksize!=0),
+                           numthreads, -1, 1);
+    }
+  return out;
+}
+
+
+
+
+
+/* Parameters to read a tile-compressed image in parallel. */
+struct fits_img_read_params
+{
+  char        *filename;  /* Name of the input file.                 */
+  char             *hdu;  /* HDU of the image.                       */
+  gal_data_t       *img;  /* Allocated output image.                 */
+  void           *blank;  /* Value to put in blank pixels.           */
+  size_t       bandrows;  /* Number of rows (slowest dim.) per band. */
+};
+
+
+
+
+
+/* Read the bands of the image that are assigned to this thread. Each
+   thread needs its own FITS pointer, and the bands are multiples of the
+   tile size along the slowest dimension so no tile is decompressed by
+   more than one thread. */
+static void *
+fits_img_read_band(void *in_prm)
+{
+  struct gal_threads_params *tprm=(struct gal_threads_params *)in_prm;
+  struct fits_img_read_params *p=tprm->params;
+
+  fitsfile *fptr;
+  gal_data_t *img=p->img;
+  int anyblank, status=0;
+  long *fpixel, *lpixel, *inc;
+  size_t i, j, first, last, ndim=img->ndim;
+  size_t rowbytes=img->size/img->dsize[0]*gal_type_sizeof(img->type);
+
+  /* Allocate the pixel coordinates (see 'gal_fits_img_read' on the
+     'long' type). */
+  fpixel=gal_pointer_allocate(GAL_TYPE_INT64, 3*ndim, 0, __func__,
+                              "fpixel");
+  lpixel=fpixel+ndim;
+  inc=fpixel+2*ndim;
+
+  /* Open the file and read each band. */
+  fptr=gal_fits_hdu_open_format(p->filename, p->hdu, 0);
+  for(i=0; tprm->indexs[i] != GAL_BLANK_SIZE_T; ++i)
+    {
+      /* Rows of this band (counting from 0). */
+      first=tprm->indexs[i]*p->bandrows;
+      last = ( first+p->bandrows > img->dsize[0]
+               ? img->dsize[0] : first+p->bandrows ) - 1;
+
+      /* The FITS pixel range (in FITS order, counting from 1). */
+      for(j=0;j<ndim;++j)
+        {
+          inc[j]=fpixel[j]=1;
+          lpixel[j]=img->dsize[ndim-1-j];
+        }
+      fpixel[ndim-1]=first+1;
+      lpixel[ndim-1]=last+1;
+
+      /* Read the band into its place in the output. */
+      fits_read_subset(fptr, gal_fits_type_to_datatype(img->type), fpixel,
+                       lpixel, inc, p->blank,
+                       (unsigned char *)img->array + first*rowbytes,
+                       &anyblank, &status);
+      gal_fits_io_error(status, NULL);
+    }
+
+  /* Clean up, wait for all the other threads to finish, then return. */
+  fits_close_file(fptr, &status);
+  gal_fits_io_error(status, NULL);
+  free(fpixel);
+  if(tprm->b) pthread_barrier_wait(tprm->b);
+  return NULL;
+}
+
+
+
+
+
+/* Tile-compressed images are decompressed in parallel: the image is
+   divided into bands along the slowest dimension (each band has an equal
+   number of tiles) and each band is read by one of the 'numthreads'
+   threads. If this isn't possible (the image isn't compressed, CFITSIO
+   isn't thread-safe, or there is only one row of tiles for example), this
+   function will return 0 without doing anything. */
+static int
+fits_img_read_compressed(fitsfile *fptr, char *filename, char *hdu,
+                         gal_data_t *img, void *blank, size_t numthreads)
+{
+  long ztile;
+  size_t nbands, ntilerows;
+  char key[FLEN_KEYWORD];
+  struct fits_img_read_params p;
+  int status=0, keystatus=0;
+
+  /* Only use multiple threads when CFITSIO is thread-safe (see
+     'gal_fits_tab_read_rows'). */
+#if GAL_CONFIG_HAVE_FITS_IS_REENTRANT == 1
+  if( fits_is_reentrant()==0 ) numthreads=1;
+#else
+  numthreads=1;
+#endif
+
+  /* The image must be compressed and we need multiple threads. */
+  if( numthreads<2
+      || fits_is_compressed_image(fptr, &status)==0
+      || status )
+    return 0;
+
+  /* Tile size along the slowest dimension. */
+  sprintf(key, "ZTILE%zu", img->ndim);
+  if( fits_read_key(fptr, TLONG, key, &ztile, NULL, &keystatus)
+      || ztile<1 )
+    return 0;
+
+  /* Number of rows of tiles and the number of bands. */
+  ntilerows=(img->dsize[0]+ztile-1)/ztile;
+  if(ntilerows<2) return 0;
+  nbands = ntilerows<numthreads ? ntilerows : numthreads;
+
+  /* Read the bands in parallel. */
+  p.img=img;
+  p.hdu=hdu;
+  p.blank=blank;
+  p.filename=filename;
+  p.bandrows=(ntilerows+nbands-1)/nbands*ztile;
+  gal_threads_spin_off(fits_img_read_band, &p,
+                       (img->dsize[0]+p.bandrows-1)/p.bandrows, numthreads,
+                       -1, 1);
+  return 1;
+}
+
+
+
+
+
+/* Read a FITS image HDU into a Gnuastro data structure. When 'map' is
+   non-zero, the data unit of the file is directly mapped into memory (if
+   it can be used as it is stored, see 'fits_img_read_map'). */
+static gal_data_t *
+fits_img_read(char *filename, char *hdu, size_t numthreads,
+              size_t minmapsize, int quietmmap, int map)
 {
-  void *blank;
   long *fpixel;
   fitsfile *fptr;
   gal_data_t *img;
-  size_t i, ndim, *dsize;
+  void *blank, *array=NULL;
   char *name=NULL, *unit=NULL;
   int status=0, type, anyblank;
+  size_t i, ndim, size=1, *dsize;
 
 
   /* Check HDU for realistic conditions: */
@@ -2577,8 +2834,14 @@ gal_fits_img_read(char *filename, char *hdu, size_t minmapsize,
   for(i=0;i<ndim;++i) fpixel[i]=1;
 
 
+  /* If requested, try to map the data unit of the file directly. */
+  for(i=0;i<ndim;++i) size*=dsize[i];
+  if(map) array=fits_img_read_map(fptr, type, size, numthreads,
+                                   quietmmap);
+
+
   /* Allocate the space for the array and for the blank values. */
-  img=gal_data_alloc(NULL, type, ndim, dsize, NULL, 0, minmapsize,
+  img=gal_data_alloc(array, type, ndim, dsize, NULL, 0, minmapsize,
                      quietmmap, name, unit, NULL);
   blank=gal_blank_alloc_write(type);
   if(name) free(name);
@@ -2586,10 +2849,16 @@ gal_fits_img_read(char *filename, char *hdu, size_t minmapsize,
   free(dsize);
 
 
-  /* Read the image into the allocated array: */
-  fits_read_pix(fptr, gal_fits_type_to_datatype(type), fpixel,
-                img->size, blank, img->array, &anyblank, &status);
-  if(status) gal_fits_io_error(status, NULL);
+  /* Read the image into the allocated array (if it wasn't mapped or
+     decompressed in parallel): */
+  if( array==NULL
+      && fits_img_read_compressed(fptr, filename, hdu, img, blank,
+                                  numthreads)==0 )
+    {
+      fits_read_pix(fptr, gal_fits_type_to_datatype(type), fpixel,
+                    img->size, blank, img->array, &anyblank, &status);
+      if(status) gal_fits_io_error(status, NULL);
+    }
   free(fpixel);
   free(blank);
 
@@ -2607,17 +2876,43 @@ gal_fits_img_read(char *filename, char *hdu, size_t minmapsize,
 
 
 
+gal_data_t *
+gal_fits_img_read(char *filename, char *hdu, size_t numthreads,
+                  size_t minmapsize, int quietmmap)
+{
+  return fits_img_read(filename, hdu, numthreads, minmapsize, quietmmap, 0);
+}
+
+
+
+
+
+/* Similar to 'gal_fits_img_read', but when the data unit of the image can
+   be used without any change, it is directly (privately) mapped into
+   memory: the pixels are only read from the file when they are used. */
+gal_data_t *
+gal_fits_img_read_map(char *filename, char *hdu, size_t numthreads,
+                      size_t minmapsize, int quietmmap)
+{
+  return fits_img_read(filename, hdu, numthreads, minmapsize, quietmmap, 1);
+}
+
+
+
+
+
 /* The user has specified an input file + extension, and your program needs
    this input to be a special type. For such cases, this function can be
    used to convert the input file to the desired type. */
 gal_data_t *
 gal_fits_img_read_to_type(char *inputname, char *hdu, uint8_t type,
-                          size_t minmapsize, int quietmmap)
+                          size_t numthreads, size_t minmapsize,
+                          int quietmmap)
 {
   gal_data_t *in, *converted;
 
   /* Read the specified input image HDU. */
-  in=gal_fits_img_read(inputname, hdu, minmapsize, quietmmap);
+  in=gal_fits_img_read(inputname, hdu, numthreads, minmapsize, quietmmap);
 
   /* If the input had another type, convert it to float. */
   if(in->type!=type)
@@ -2645,8 +2940,9 @@ gal_fits_img_read_kernel(char *filename, char *hdu, size_t minmapsize,
   gal_data_t *kernel;
   float *f, *fp, tmp;
 
-  /* Read the image as a float and if it has a WCS structure, free it. */
-  kernel=gal_fits_img_read_to_type(filename, hdu, GAL_TYPE_FLOAT32,
+  /* Read the image as a float and if it has a WCS structure, free it
+     (kernels are small, so there is no need for multiple threads). */
+  kernel=gal_fits_img_read_to_type(filename, hdu, GAL_TYPE_FLOAT32, 1,
                                    minmapsize, quietmmap);
   if(kernel->wcs) { wcsfree(kernel->wcs); kernel->wcs=NULL; }
 
@@ -2692,11 +2988,61 @@ gal_fits_img_read_kernel(char *filename, char *hdu, size_t minmapsize,
 
 
 
+/* Prepare CFITSIO to tile-compress the image HDU that is created next
+   ('naxes' is in the FITS order). Every row (along the fastest dimension)
+   is one tile, so the tiles can be decompressed in parallel (see
+   'fits_img_read_compressed'). CFITSIO can only Rice-compress integers of
+   32 bits or less, so other types are compressed with GZIP (floating
+   point values are not quantized, so the compression is lossless). */
+static void
+fits_img_write_compress(fitsfile *fptr, uint8_t type, size_t ndim,
+                        long *naxes)
+{
+  size_t i;
+  long *tile;
+  int status=0;
+
+  /* Set the compression algorithm. */
+  switch(type)
+    {
+    case GAL_TYPE_INT64:
+    case GAL_TYPE_UINT64:
+      fits_set_compression_type(fptr, GZIP_2, &status);
+      break;
+
+    case GAL_TYPE_FLOAT32:
+    case GAL_TYPE_FLOAT64:
+      fits_set_compression_type(fptr, GZIP_2, &status);
+      fits_set_quantize_level(fptr, 0.0f, &status);
+      break;
+
+    default:
+      fits_set_compression_type(fptr, RICE_1, &status);
+    }
+
+  /* Set the tile size (one row). */
+  tile=gal_pointer_allocate( ( sizeof(long)==8
+                               ? GAL_TYPE_INT64
+                               : GAL_TYPE_INT32 ), ndim, 0, __func__,
+                             "tile");
+  tile[0]=naxes[0];
+  for(i=1;i<ndim;++i) tile[i]=1;
+  fits_set_tile_dim(fptr, ndim, tile, &status);
+  gal_fits_io_error(status, "preparing the tile compression");
+  free(tile);
+}
+
+
+
+
+
 /* This function will write all the data array information (including its
    WCS information) into a FITS file, but will not close it. Instead it
-   will pass along the FITS pointer for further modification. */
+   will pass along the FITS pointer for further modification. When
+   'compress' is non-zero, the image is tile-compressed (see
+   'fits_img_write_compress'). */
 fitsfile *
-gal_fits_img_write_to_ptr(gal_data_t *input, char *filename)
+gal_fits_img_write_to_ptr(gal_data_t *input, char *filename, int compress)
 {
   void *blank;
   int64_t *i64;
@@ -2761,6 +3107,7 @@ gal_fits_img_write_to_ptr(gal_data_t *input, char *filename)
 
       /* We can now use CFITSIO's signed-int64 type macros. */
       datatype=TLONGLONG;
+      if(compress) fits_img_write_compress(fptr, block->type, ndim, naxes);
       fits_create_img(fptr, LONGLONG_IMG, ndim, naxes, &status);
       gal_fits_io_error(status, NULL);
 
@@ -2786,7 +3133,9 @@ gal_fits_img_write_to_ptr(gal_data_t *input, char *filename)
       /* Set the datatype */
       datatype=gal_fits_type_to_datatype(block->type);
 
-      /* Create the FITS file. */
+      /* Create the FITS file (with tile compression if requested). */
+      if(compress)
+        fits_img_write_compress(fptr, towrite->type, ndim, naxes);
       fits_create_img(fptr, gal_fits_type_to_bitpix(towrite->type),
                       ndim, naxes, &status);
       gal_fits_io_error(status, NULL);
@@ -2860,13 +3209,14 @@ gal_fits_img_write_to_ptr(gal_data_t *input, char *filename)
 
 void
 gal_fits_img_write(gal_data_t *data, char *filename,
-                   gal_fits_list_key_t *headers, char *program_string)
+                   gal_fits_list_key_t *headers, char *program_string,
+                   int compress)
 {
   int status=0;
   fitsfile *fptr;
 
   /* Write the data array into a FITS file and keep it open: */
-  fptr=gal_fits_img_write_to_ptr(data, filename);
+  fptr=gal_fits_img_write_to_ptr(data, filename, compress);
 
   /* Write all the headers and the version information. */
   gal_fits_key_write_version_in_ptr(&headers, program_string, fptr);
@@ -2883,7 +3233,7 @@ gal_fits_img_write(gal_data_t *data, char *filename,
 void
 gal_fits_img_write_to_type(gal_data_t *data, char *filename,
                            gal_fits_list_key_t *headers,
-                           char *program_string, int type)
+                           char *program_string, int type, int compress)
 {
   /* If the input dataset is not the correct type, then convert it,
      otherwise, use the input data structure. */
@@ -2892,7 +3242,7 @@ gal_fits_img_write_to_type(gal_data_t *data, char *filename,
                          : gal_data_copy_to_new_type(data, type));
 
   /* Write the converted dataset into an image. */
-  gal_fits_img_write(towrite, filename, headers, program_string);
+  gal_fits_img_write(towrite, filename, headers, program_string, compress);
 
   /* Free the dataset if it was allocated. */
   if(towrite!=data) gal_data_free(towrite);
@@ -2918,7 +3268,7 @@ void
 gal_fits_img_write_corr_wcs_str(gal_data_t *input, char *filename,
                                 char *wcsstr, int nkeyrec, double *crpix,
                                 gal_fits_list_key_t *headers,
-                                char *program_string)
+                                char *program_string, int compress)
 {
   int status=0;
   fitsfile *fptr;
@@ -2929,7 +3279,7 @@ gal_fits_img_write_corr_wcs_str(gal_data_t *input, char *filename,
           __func__);
 
   /* Write the data array into a FITS file and keep it open. */
-  fptr=gal_fits_img_write_to_ptr(input, filename);
+  fptr=gal_fits_img_write_to_ptr(input, filename, compress);
 
   /* Write the WCS headers into the FITS file. */
   gal_fits_key_write_wcsstr(fptr, NULL, wcsstr, nkeyrec);
@@ -3494,11 +3844,14 @@ gal_fits_tab_info(char *filename, char *hdu, size_t *numcols,
 
 
 /* Read CFITSIO un-readable (INF, -INF or NAN) floating point values in
-   FITS ASCII tables. */
+   FITS ASCII tables. The 'numrows' rows starting from 'firstrow' (counting
+   from 1, like CFITSIO) are read into the output, starting from its
+   'start' element. */
 static void
 fits_tab_read_ascii_float_special(char *filename, char *hdu,
                                   fitsfile *fptr, gal_data_t *out,
-                                  size_t colnum, size_t numrows,
+                                  size_t colnum, size_t firstrow,
+                                  size_t start, size_t numrows,
                                   size_t minmapsize, int quietmmap)
 {
   double tmp;
@@ -3524,7 +3877,7 @@ fits_tab_read_ascii_float_special(char *filename, char *hdu,
     }
 
   /* Read the column as a string. */
-  fits_read_col(fptr, TSTRING, colnum, 1, 1, out->size, NULL,
+  fits_read_col(fptr, TSTRING, colnum, firstrow, 1, numrows, NULL,
                 strrows->array, &anynul, &status);
   gal_fits_io_error(status, NULL);
 
@@ -3538,9 +3891,9 @@ fits_tab_read_ascii_float_special(char *filename, char *hdu,
 
       /* Write it into the output dataset. */
       if(out->type==GAL_TYPE_FLOAT32)
-        ((float *)(out->array))[i]=tmp;
+        ((float *)(out->array))[start+i]=tmp;
       else
-        ((double *)(out->array))[i]=tmp;
+        ((double *)(out->array))[start+i]=tmp;
     }
 
   /* Clean up. */
@@ -3557,6 +3910,8 @@ struct fits_tab_read_onecol_params
   char              *filename;  /* Name of FITS file with table.     */
   char                   *hdu;  /* HDU of input table.               */
   size_t              numrows;  /* Number of rows in table to read.  */
+  size_t             firstrow;  /* First row to read (from 0).       */
+  size_t              *rowids;  /* Rows to read (if not NULL).       */
   size_t              numcols;  /* Number of columns.                */
   size_t           minmapsize;  /* Minimum space to memory-map.      */
   int               quietmmap;  /* Don't print memory-mapping info.  */
@@ -3582,6 +3937,7 @@ fits_tab_read_onecol(void *in_prm)
   void *blank, *blankuse;
   int isfloat, hdutype, anynul=0, status=0;
   size_t i, j, c, ndim, strw, repeat, indout, indin=GAL_BLANK_SIZE_T;
+  size_t row, nrun, nelem;
 
   /* Open the FITS file */
   fptr=gal_fits_hdu_open_format(p->filename, p->hdu, 1);
@@ -3679,27 +4035,47 @@ fits_tab_read_onecol(void *in_prm)
           blankuse = ( col->type==GAL_TYPE_STRING
                        ? *((char **)blank)
                        : blank);
-          fits_read_col(fptr, gal_fits_type_to_datatype(col->type),
-                        indin+1, 1, 1, col->size, blankuse, col->array,
-                        &anynul, &status);
 
-          /* In the ASCII table format some things need to be checked. */
-          if( hdutype==ASCII_TBL )
+          /* Read the rows. When only certain rows are requested
+             ('rowids'), each run of consecutive rows is read with one
+             call to CFITSIO. 'nelem' is the number of elements in each
+             row (larger than 1 for vector columns). */
+          nelem = ndim==2 ? dsize[1] : 1;
+          for(j=0; j<p->numrows; j+=nrun)
             {
-              /* CFITSIO might not be able to read 'INF' or '-INF'. In this
-                case, it will set status to 'BAD_C2D' or 'BAD_C2F'. So,
-                we'll use our own parser for the column values. */
-              if(isfloat && (status==BAD_C2D || status==BAD_C2F) )
+              /* Set the first row of this run and its length. */
+              if(p->rowids)
+                {
+                  row=p->rowids[j];
+                  for(nrun=1; j+nrun<p->numrows; ++nrun)
+                    if(p->rowids[j+nrun]!=row+nrun) break;
+                }
+              else { row=p->firstrow; nrun=p->numrows; }
+
+              /* Read this run into its place in the column. */
+              fits_read_col(fptr, gal_fits_type_to_datatype(col->type),
+                            indin+1, row+1, 1, nrun*nelem, blankuse,
+                            gal_pointer_increment(col->array, j*nelem,
+                                                  col->type),
+                            &anynul, &status);
+
+              /* In the ASCII table format some things need to be
+                 checked: CFITSIO might not be able to read 'INF' or
+                 '-INF'. In this case, it will set status to 'BAD_C2D' or
+                 'BAD_C2F'. So, we'll use our own parser for the column
+                 values. */
+              if( hdutype==ASCII_TBL && isfloat
+                  && (status==BAD_C2D || status==BAD_C2F) )
                 {
                   fits_tab_read_ascii_float_special(p->filename, p->hdu,
                                                     fptr, col, indin+1,
-                                                    p->numrows,
+                                                    row+1, j, nrun,
                                                     p->minmapsize,
                                                     p->quietmmap);
                   status=0;
                 }
+              gal_fits_io_error(status, NULL); /* After correction. */
             }
-          gal_fits_io_error(status, NULL); /* After 'status' correction. */
 
           /* Clean up and sanity check (just note that the blank value for
              strings, is an array of strings, so we need to free the
@@ -3732,6 +4108,24 @@ gal_data_t *
 gal_fits_tab_read(char *filename, char *hdu, size_t numrows,
                   gal_data_t *allcols, gal_list_sizet_t *indexll,
                   size_t numthreads, size_t minmapsize, int quietmmap)
+{
+  return gal_fits_tab_read_rows(filename, hdu, allcols, indexll, NULL, 0,
+                                numrows, numthreads, minmapsize, quietmmap);
+}
+
+
+
+
+
+/* Read only some rows of the given columns. When 'rowids' is NULL,
+   'numrows' consecutive rows starting from 'firstrow' (counting from 0)
+   are read. Otherwise, the 'numrows' rows in 'rowids' are read ('rowids'
+   has to be sorted in increasing order and 'firstrow' is ignored). */
+gal_data_t *
+gal_fits_tab_read_rows(char *filename, char *hdu, gal_data_t *allcols,
+                       gal_list_sizet_t *indexll, size_t *rowids,
+                       size_t firstrow, size_t numrows, size_t numthreads,
+                       size_t minmapsize, int quietmmap)
 {
   size_t i;
   gal_data_t *out=NULL;
@@ -3761,8 +4155,10 @@ gal_fits_tab_read(char *filename, char *hdu, size_t numrows,
 
       /* Prepare for parallelization and spin-off the threads. */
       p.hdu = hdu;
+      p.rowids = rowids;
       p.allcols = allcols;
       p.numrows = numrows;
+      p.firstrow = firstrow;
       p.indexll = indexll;
       p.filename = filename;
       p.quietmmap = quietmmap;
@@ -4199,29 +4595,16 @@ fits_tab_write_colvec_ascii(fitsfile *fptr, gal_data_t *vector,
 
 
 
-/* Write a single column into the FITS table. */
+/* Write the data of a single column (with index 'colind', counting from
+   zero) into the FITS table. */
 static void
-fits_tab_write_col(fitsfile *fptr, gal_data_t *col, int tableformat,
-                   size_t *colind, char *tform, char *filename)
+fits_tab_write_col_data(fitsfile *fptr, gal_data_t *col, int tableformat,
+                        size_t colind)
 {
   int status=0;
   char **strarr;
   void *blank=NULL;
 
-  /* If this is a FITS ASCII table, and the column is vector, we need to
-     write it as separate single-value columns and write those, then we can
-     safely return (no more need to continue). */
-  if(tableformat==GAL_TABLE_FORMAT_AFITS && col->ndim>1)
-    {
-      *colind=fits_tab_write_colvec_ascii(fptr, col, *colind, tform,
-                                          filename);
-      return;
-    }
-
-  /* Write the blank value into the header and return a pointer to
-     it. Otherwise, */
-  fits_write_tnull_tcomm(fptr, col, tableformat, *colind+1, tform);
-
   /* Set the blank pointer if its necessary. Note that strings don't need a
      blank pointer in a FITS ASCII table. */
   blank = ( gal_blank_present(col, 0)
@@ -4249,16 +4632,43 @@ fits_tab_write_col(fitsfile *fptr, gal_data_t *col, int tableformat,
 
   /* Write the full column into the table. */
   fits_write_colnull(fptr, gal_fits_type_to_datatype(col->type),
-                     *colind+1, 1, 1, col->size, col->array, blank,
+                     colind+1, 1, 1, col->size, col->array, blank,
                      &status);
   gal_fits_io_error(status, NULL);
 
-  /* Clean up and Increment the column counter. */
+  /* Clean up. */
   if(blank)
     {
       if(col->type==GAL_TYPE_STRING) {strarr=blank; free(strarr[0]);}
       free(blank);
     }
+}
+
+
+
+
+
+/* Write a single column into the FITS table. */
+static void
+fits_tab_write_col(fitsfile *fptr, gal_data_t *col, int tableformat,
+                   size_t *colind, char *tform, char *filename)
+{
+  /* If this is a FITS ASCII table, and the column is vector, we need to
+     write it as separate single-value columns and write those, then we can
+     safely return (no more need to continue). */
+  if(tableformat==GAL_TABLE_FORMAT_AFITS && col->ndim>1)
+    {
+      *colind=fits_tab_write_colvec_ascii(fptr, col, *colind, tform,
+                                          filename);
+      return;
+    }
+
+  /* Write the blank value into the header and return a pointer to
+     it. Otherwise, */
+  fits_write_tnull_tcomm(fptr, col, tableformat, *colind+1, tform);
+
+  /* Write the column's data. */
+  fits_tab_write_col_data(fptr, col, tableformat, *colind);
 
   /* Increment the 'colind' for the next column. */
   *colind+=1;
@@ -4268,12 +4678,231 @@ fits_tab_write_col(fitsfile *fptr, gal_data_t *col, int tableformat,
 
 
 
+/* In binary tables, the numeric columns can be written directly: the
+   table's rows are built in memory (each column's values are
+   byte-swapped and put in their place in the row, in parallel), and
+   written into the file as one contiguous block of bytes. The rows are
+   built in batches of roughly this many bytes. */
+#define FITS_TAB_WRITE_BATCH_BYTES 67108864
+
+struct fits_tab_write_params
+{
+  gal_data_t       **cols;  /* Columns (NULL: not written here).       */
+  size_t         *offsets;  /* Byte offset of each column in a row.    */
+  uint8_t           *flip;  /* Sign bit of column should be flipped.   */
+  size_t          numcols;  /* Number of columns.                      */
+  size_t         rowbytes;  /* Number of bytes in each row.            */
+  size_t         firstrow;  /* First row of this batch.                */
+  size_t        batchrows;  /* Number of rows in this batch.           */
+  size_t        chunkrows;  /* Number of rows in each thread's chunk.  */
+  int                swap;  /* Host is little-endian.                  */
+  unsigned char      *buf;  /* Buffer to keep the rows of a batch.     */
+};
+
+
+
+
+
+/* The types that are written directly. For the unsigned types that aren't
+   native to FITS, CFITSIO subtracts TZERO (which is equivalent to flipping
+   the sign bit). However, in such columns CFITSIO also considers the
+   values that are equal to TNULL (before subtracting TZERO) as blank. So
+   to produce the same output as CFITSIO, these columns are only written
+   directly when they have no blank values. The returned value is 0 if the
+   column can't be written directly, 1 if it can and 2 if it can but with
+   its sign bit flipped. */
+static int
+fits_tab_write_bin_direct(gal_data_t *col)
+{
+  switch(col->type)
+    {
+    case GAL_TYPE_UINT8:
+    case GAL_TYPE_INT16:
+    case GAL_TYPE_INT32:
+    case GAL_TYPE_INT64:
+    case GAL_TYPE_FLOAT32:
+    case GAL_TYPE_FLOAT64:
+      return 1;
+
+    case GAL_TYPE_INT8:
+    case GAL_TYPE_UINT16:
+    case GAL_TYPE_UINT32:
+      return gal_blank_present(col, 0) ? 0 : 2;
+    }
+  return 0;
+}
+
+
+
+
+
+/* Put the values of the directly-written columns of the rows that are
+   assigned to this thread into the row buffer. */
+static void *
+fits_tab_write_bin_worker(void *in_prm)
+{
+  struct gal_threads_params *tprm=(struct gal_threads_params *)in_prm;
+  struct fits_tab_write_params *p=tprm->params;
+
+  gal_data_t *col;
+  int flip, swap=p->swap;
+  unsigned char *in, *out;
+  size_t b, c, e, i, k, r, rf, n, w;
+
+  /* Go over all the chunks of rows that are assigned to this thread. */
+  for(i=0; tprm->indexs[i] != GAL_BLANK_SIZE_T; ++i)
+    {
+      /* Rows of this chunk (within the batch). */
+      r=tprm->indexs[i]*p->chunkrows;
+      rf = r+p->chunkrows > p->batchrows ? p->batchrows : r+p->chunkrows;
+
+      /* Go over the columns. */
+      for(c=0;c<p->numcols;++c)
+        if( (col=p->cols[c]) )
+          {
+            /* Width of each value and number of values in each row. */
+            w=gal_type_sizeof(col->type);
+            n = col->ndim==1 ? 1 : col->dsize[1];
+            flip=p->flip[c];
+
+            /* Copy the values (big-endian in the FITS file). */
+            in=(unsigned char *)col->array + (p->firstrow+r)*n*w;
+            for(k=r;k<rf;++k)
+              {
+                out=p->buf + k*p->rowbytes + p->offsets[c];
+                for(e=0;e<n;++e)
+                  {
+                    if(swap) for(b=0;b<w;++b) out[b]=in[w-1-b];
+                    else     memcpy(out, in, w);
+                    if(flip) out[0]^=0x80;
+                    in+=w; out+=w;
+                  }
+              }
+          }
+    }
+
+  /* Wait for all the other threads to finish, then return. */
+  if(tprm->b) pthread_barrier_wait(tprm->b);
+  return NULL;
+}
+
+
+
+
+
+/* Write the columns of a binary table by building its rows in memory (the
+   keywords of all columns are also written here). If any column has a
+   type that can't be placed in the rows (like bit or complex columns), this
+   function will return 0 without doing anything. Columns that can't be
+   written directly (strings for example) are written with CFITSIO after
+   the rows. The rows of each batch are built on 'numthreads' threads. */
+static int
+fits_tab_write_bin_rows(fitsfile *fptr, gal_data_t *cols, size_t numcols,
+                        size_t numrows, char **tform, size_t numthreads)
+{
+  uint16_t one=1;
+  size_t i;
+  gal_data_t *col;
+  struct fits_tab_write_params p;
+  int status=0, direct, anydirect=0;
+
+  /* Check the columns: the width of bit and complex columns in the row
+     isn't simply the width of their type. */
+  if(numrows==0) return 0;
+  for(col=cols; col!=NULL; col=col->next)
+    {
+      if( col->type==GAL_TYPE_BIT
+          || col->type==GAL_TYPE_COMPLEX32
+          || col->type==GAL_TYPE_COMPLEX64 )
+        return 0;
+      if( col->type!=GAL_TYPE_STRING ) anydirect=1;
+    }
+  if(anydirect==0) return 0;
+
+  /* Allocate the arrays and set the offset of each column in the row. */
+  p.numcols=numcols;
+  p.swap = *(uint8_t *)(&one)==1;
+  errno=0;
+  p.cols=malloc(numcols*sizeof *p.cols);
+  if(p.cols==NULL)
+    error(EXIT_FAILURE, errno, "%s: %zu bytes for 'p.cols'", __func__,
+          numcols*sizeof *p.cols);
+  p.offsets=gal_pointer_allocate(GAL_TYPE_SIZE_T, numcols, 0, __func__,
+                                 "p.offsets");
+  p.flip=gal_pointer_allocate(GAL_TYPE_UINT8, numcols, 0, __func__,
+                              "p.flip");
+  i=0; p.rowbytes=0;
+  for(col=cols; col!=NULL; col=col->next)
+    {
+      direct=fits_tab_write_bin_direct(col);
+      p.flip[i] = direct==2;
+      p.offsets[i]=p.rowbytes;
+      p.cols[i] = direct ? col : NULL;
+      p.rowbytes += ( col->type==GAL_TYPE_STRING
+                      ? col->disp_width
+                      : ( gal_type_sizeof(col->type)
+                          * (col->ndim==1 ? 1 : col->dsize[1]) ) );
+      ++i;
+    }
+
+  /* Write the keywords of all the columns (in the same order as when the
+     columns are written separately). */
+  i=0;
+  for(col=cols; col!=NULL; col=col->next)
+    {
+      fits_write_tnull_tcomm(fptr, col, GAL_TABLE_FORMAT_BFITS, i+1,
+                             tform[i]);
+      ++i;
+    }
+
+  /* Set the number of rows in each batch and allocate the buffer. */
+  p.batchrows = ( FITS_TAB_WRITE_BATCH_BYTES/p.rowbytes
+                  ? FITS_TAB_WRITE_BATCH_BYTES/p.rowbytes : 1 );
+  if(p.batchrows>numrows) p.batchrows=numrows;
+  p.buf=gal_pointer_allocate(GAL_TYPE_UINT8, p.batchrows*p.rowbytes, 1,
+                             __func__, "p.buf");
+
+  /* Build the rows of each batch in parallel and write them. */
+  if(numthreads==0) numthreads=1;
+  for(p.firstrow=0; p.firstrow<numrows; p.firstrow+=p.batchrows)
+    {
+      if(p.firstrow+p.batchrows>numrows) p.batchrows=numrows-p.firstrow;
+      p.chunkrows=(p.batchrows+numthreads-1)/numthreads;
+      gal_threads_spin_off(fits_tab_write_bin_worker, &p,
+                           (p.batchrows+p.chunkrows-1)/p.chunkrows,
+                           numthreads, -1, 1);
+      fits_write_tblbytes(fptr, p.firstrow+1, 1, p.batchrows*p.rowbytes,
+                          p.buf, &status);
+      gal_fits_io_error(status, NULL);
+    }
+
+  /* Write the other columns with CFITSIO. */
+  i=0;
+  for(col=cols; col!=NULL; col=col->next)
+    {
+      if(p.cols[i]==NULL)
+        fits_tab_write_col_data(fptr, col, GAL_TABLE_FORMAT_BFITS, i);
+      ++i;
+    }
+
+  /* Clean up and return. */
+  free(p.buf);
+  free(p.cols);
+  free(p.flip);
+  free(p.offsets);
+  return 1;
+}
+
+
+
+
+
 /* Write the given columns (a linked list of 'gal_data_t') into a FITS
-   table.*/
+   table. The rows of binary tables are built on 'numthreads' threads. */
 void
 gal_fits_tab_write(gal_data_t *cols, gal_list_str_t *comments,
                    int tableformat, char *filename, char *extname,
-                   struct gal_fits_list_key_t **keylist)
+                   struct gal_fits_list_key_t **keylist, size_t numthreads)
 {
   fitsfile *fptr;
   gal_data_t *col;
@@ -4316,10 +4945,16 @@ gal_fits_tab_write(gal_data_t *cols, gal_list_str_t *comments,
   gal_fits_io_error(status, NULL);
 
   /* Write the columns into the file and also write the blank values into
-     the header when necessary. */
-  i=0;
-  for(col=cols; col!=NULL; col=col->next)/*'i' is increment in the func.*/
-    fits_tab_write_col(fptr, col, tableformat, &i, tform[i], filename);
+     the header when necessary. Binary tables are written row-by-row (when
+     possible), otherwise each column is written separately. */
+  if( tableformat!=GAL_TABLE_FORMAT_BFITS
+      || fits_tab_write_bin_rows(fptr, cols, numcols, numrows, tform,
+                                 numthreads)==0 )
+    {
+      i=0;
+      for(col=cols; col!=NULL; col=col->next)/*'i' is incremented in func.*/
+        fits_tab_write_col(fptr, col, tableformat, &i, tform[i], filename);
+    }
 
   /* Write the requested keywords. */
   if(keylist)
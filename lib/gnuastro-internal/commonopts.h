@@ -289,6 +289,19 @@ struct argp_option gal_commonopts_options[] =
       GAL_OPTIONS_NOT_SET,
       gal_options_read_wcslinearmatrix
     },
+    {
+      "compress",
+      GAL_OPTIONS_KEY_COMPRESS,
+      0,
+      0,
+      "Tile-compress the output FITS images.",
+      GAL_OPTIONS_GROUP_OUTPUT,
+      &cp->compress,
+      GAL_OPTIONS_NO_ARG_TYPE,
+      GAL_OPTIONS_RANGE_0_OR_1,
+      GAL_OPTIONS_NOT_MANDATORY,
+      GAL_OPTIONS_NOT_SET
+    },
     {
       "dontdelete",
       GAL_OPTIONS_KEY_DONTDELETE,
@@ -0,0 +1,82 @@
+/*********************************************************************
+Convolution operations used by some Gnuastro programs, but too specific
+to be in the general library.
+This is part of GNU Astronomy Utilities (Gnuastro) package.
+
+Original author:
+     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+Contributing author(s):
+Copyright (C) 2022 Free Software Foundation, Inc.
+
+Gnuastro is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+Gnuastro is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
+**********************************************************************/
+#ifndef __GAL_CONVOLVE_INTERNAL_H__
+#define __GAL_CONVOLVE_INTERNAL_H__
+
+/* Include other headers if necessary here. Note that other header files
+   must be included before the C++ preparations below */
+#include <gnuastro/tile.h>
+
+
+/* When we are within Gnuastro's building process, 'IN_GNUASTRO_BUILD' is
+   defined. In the build process, installation information (in particular
+   'GAL_CONFIG_ARITH_CHAR' and the rest of the types that we needed in the
+   arithmetic function) is kept in 'config.h'. When building a user's
+   programs, this information is kept in 'gnuastro/config.h'. Note that all
+   '.c' files must start with the inclusion of 'config.h' and that
+   'gnuastro/config.h' is only created at installation time (not present
+   during the building of Gnuastro).*/
+#ifndef IN_GNUASTRO_BUILD
+#include <gnuastro/config.h>
+#endif
+
+
+/* C++ Preparations */
+#undef __BEGIN_C_DECLS
+#undef __END_C_DECLS
+#ifdef __cplusplus
+# define __BEGIN_C_DECLS extern "C" {
+# define __END_C_DECLS }
+#else
+# define __BEGIN_C_DECLS                /* empty */
+# define __END_C_DECLS                  /* empty */
+#endif
+/* End of C++ preparations */
+
+
+
+/* Actual header contants (the above were for the Pre-processor). */
+__BEGIN_C_DECLS  /* From C++ preparations */
+
+
+/* Keyword in the cached convolved image that keeps the key. */
+#define GAL_CONVOLVEINTERNAL_CACHE_KEYNAME "CONVKEY"
+
+
+char *
+gal_convolveinternal_cache_name(char *cachedir, gal_data_t *input,
+                                gal_data_t *kernel,
+                                struct gal_tile_two_layer_params *tl);
+
+gal_data_t *
+gal_convolveinternal_cache_read(char *cachename, gal_data_t *input,
+                                size_t minmapsize, int quietmmap);
+
+void
+gal_convolveinternal_cache_write(gal_data_t *conv, char *cachename,
+                                 char *program_string);
+
+__END_C_DECLS    /* From C++ preparations */
+
+#endif           /* __GAL_CONVOLVE_INTERNAL_H__ */
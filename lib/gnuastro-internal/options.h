@@ -127,6 +127,7 @@ enum options_common_keys
   GAL_OPTIONS_KEY_INTERPMETRIC,
   GAL_OPTIONS_KEY_INTERPNUMNGB,
   GAL_OPTIONS_KEY_WCSLINEARMATRIX,
+  GAL_OPTIONS_KEY_COMPRESS,
 };
 
 
@@ -198,6 +199,7 @@ struct gal_options_common_params
   uint8_t                 type; /* Data type of output.                   */
   uint8_t          tableformat; /* Internal code for output table format. */
   uint8_t      wcslinearmatrix; /* WCS matrix to use (PC or CD).          */
+  uint8_t             compress; /* Tile-compress the output images.       */
   uint8_t           dontdelete; /* ==1: Don't delete existing file.       */
   uint8_t         keepinputdir; /* Keep input directory for auto output.  */
 
@@ -0,0 +1,79 @@
+/*********************************************************************
+arrow -- functions to read and write Apache Arrow IPC (Feather) files.
+This is part of GNU Astronomy Utilities (Gnuastro) package.
+
+Original author:
+     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+Contributing author(s):
+Copyright (C) 2022 Free Software Foundation, Inc.
+
+Gnuastro is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+Gnuastro is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
+**********************************************************************/
+#ifndef __GAL_ARROW_H__
+#define __GAL_ARROW_H__
+
+/* Include other headers if necessary here. Note that other header files
+   must be included before the C++ preparations below */
+#include <gnuastro/list.h>
+#include <gnuastro/fits.h>
+#include <gnuastro/error.h>
+
+
+/* C++ Preparations */
+#undef __BEGIN_C_DECLS
+#undef __END_C_DECLS
+#ifdef __cplusplus
+# define __BEGIN_C_DECLS extern "C" {
+# define __END_C_DECLS }
+#else
+# define __BEGIN_C_DECLS                /* empty */
+# define __END_C_DECLS                  /* empty */
+#endif
+/* End of C++ preparations */
+
+
+
+
+
+/* Actual header contants (the above were for the Pre-processor). */
+__BEGIN_C_DECLS  /* From C++ preparations */
+
+
+
+
+
+/* Functions */
+int
+gal_arrow_name_is_arrow(char *name);
+
+int
+gal_arrow_suffix_is_arrow(char *name);
+
+gal_data_t *
+gal_arrow_tab_info(char *filename, size_t *numcols, size_t *numrows);
+
+gal_data_t *
+gal_arrow_tab_read(char *filename, size_t numrows, gal_data_t *allcols,
+                   gal_list_sizet_t *indexll, size_t numthreads,
+                   size_t minmapsize, int quietmmap);
+
+void
+gal_arrow_tab_write(gal_data_t *cols, struct gal_fits_list_key_t **keylist,
+                    gal_list_str_t *comments, char *filename);
+
+
+
+__END_C_DECLS    /* From C++ preparations */
+
+#endif           /* __GAL_ARROW_H__ */
@@ -291,33 +291,40 @@ size_t *
 gal_fits_img_info_dim(char *filename, char *hdu, size_t *ndim);
 
 gal_data_t *
-gal_fits_img_read(char *filename, char *hdu, size_t minmapsize, int quietmmap);
+gal_fits_img_read(char *filename, char *hdu, size_t numthreads,
+                  size_t minmapsize, int quietmmap);
+
+gal_data_t *
+gal_fits_img_read_map(char *filename, char *hdu, size_t numthreads,
+                      size_t minmapsize, int quietmmap);
 
 gal_data_t *
 gal_fits_img_read_to_type(char *inputname, char *hdu, uint8_t type,
-                          size_t minmapsize, int quietmmap);
+                          size_t numthreads, size_t minmapsize,
+                          int quietmmap);
 
 gal_data_t *
 gal_fits_img_read_kernel(char *filename, char *hdu, size_t minmapsize,
                          int quietmmap);
 
 fitsfile *
-gal_fits_img_write_to_ptr(gal_data_t *data, char *filename);
+gal_fits_img_write_to_ptr(gal_data_t *data, char *filename, int compress);
 
 void
 gal_fits_img_write(gal_data_t *data, char *filename,
-                   gal_fits_list_key_t *headers, char *program_string);
+                   gal_fits_list_key_t *headers, char *program_string,
+                   int compress);
 
 void
 gal_fits_img_write_to_type(gal_data_t *data, char *filename,
                            gal_fits_list_key_t *headers,
-                           char *program_string, int type);
+                           char *program_string, int type, int compress);
 
 void
 gal_fits_img_write_corr_wcs_str(gal_data_t *input, char *filename,
                                 char *wcsheader, int nkeyrec, double *crpix,
                                 gal_fits_list_key_t *headers,
-                                char *program_string);
+                                char *program_string, int compress);
 
 
 
@@ -341,10 +348,17 @@ gal_fits_tab_read(char *filename, char *hdu, size_t numrows,
                   gal_data_t *allcols, gal_list_sizet_t *indexll,
                   size_t numthreads, size_t minmapsize, int quietmmap);
 
+gal_data_t *
+gal_fits_tab_read_rows(char *filename, char *hdu, gal_data_t *allcols,
+                       gal_list_sizet_t *indexll, size_t *rowids,
+                       size_t firstrow, size_t numrows, size_t numthreads,
+                       size_t minmapsize, int quietmmap);
+
 void
 gal_fits_tab_write(gal_data_t *cols, gal_list_str_t *comments,
                    int tableformat, char *filename, char *extname,
-                   struct gal_fits_list_key_t **keywords);
+                   struct gal_fits_list_key_t **keywords,
+                   size_t numthreads);
 
 
 
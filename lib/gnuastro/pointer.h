@@ -65,6 +65,16 @@ gal_pointer_mmap_allocate(uint8_t type, size_t size, int clear,
 void
 gal_pointer_mmap_free(char **mmapname, int quietmmap);
 
+void *
+gal_pointer_mmap_file(char *filename, size_t offset, size_t bsize,
+                      int quietmmap);
+
+int
+gal_pointer_mmap_file_is(void *array);
+
+int
+gal_pointer_mmap_file_free(void *array);
+
 void *
 gal_pointer_allocate_ram_or_mmap(uint8_t type, size_t size, int clear,
                                  size_t minmapsize, char **mmapname,
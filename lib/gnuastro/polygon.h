@@ -86,6 +86,10 @@ void
 gal_polygon_clip(double *s, size_t n, double *c, size_t m,
                  double *o, size_t *numcrn);
 
+void
+gal_polygon_clip_area_row(double *v, size_t n, double x0, double y0,
+                          size_t num, double *areas);
+
 void
 gal_polygon_vertices_sort(double *in, size_t n, size_t *ordinds);
 
@@ -0,0 +1,98 @@
+/*********************************************************************
+Priority queue -- Binary heap of indexs sorted by a floating point value.
+This is part of GNU Astronomy Utilities (Gnuastro) package.
+
+Original author:
+     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+Contributing author(s):
+Copyright (C) 2022 Free Software Foundation, Inc.
+
+Gnuastro is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+Gnuastro is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
+**********************************************************************/
+#ifndef __GAL_PQUEUE_H__
+#define __GAL_PQUEUE_H__
+
+/* Include other headers if necessary here. Note that other header files
+   must be included before the C++ preparations below */
+#include <gnuastro/list.h>
+
+/* C++ Preparations */
+#undef __BEGIN_C_DECLS
+#undef __END_C_DECLS
+#ifdef __cplusplus
+# define __BEGIN_C_DECLS extern "C" {
+# define __END_C_DECLS }
+#else
+# define __BEGIN_C_DECLS                /* empty */
+# define __END_C_DECLS                  /* empty */
+#endif
+/* End of C++ preparations */
+
+/* Actual header contants (the above were for the Pre-processor). */
+__BEGIN_C_DECLS  /* From C++ preparations */
+
+
+
+
+/*********************************************************************/
+/***************            Data structure         *******************/
+/*********************************************************************/
+/* One element of the queue. */
+typedef struct gal_pqueue_node_t
+{
+  size_t v;                     /* The actual value.                   */
+  size_t order;                 /* Order of addition (to break ties).  */
+  float s;                      /* The parameter to sort by.           */
+} gal_pqueue_node_t;
+
+/* The queue (a binary min-heap in a contiguous array). */
+typedef struct gal_pqueue_t
+{
+  gal_pqueue_node_t *nodes;     /* Array of nodes (the heap).          */
+  size_t size;                  /* Number of nodes in the queue.       */
+  size_t allocated;             /* Number of allocated nodes.          */
+  size_t numadded;              /* Number of additions since reset.    */
+} gal_pqueue_t;
+
+
+
+
+
+/*********************************************************************/
+/***************             Functions             *******************/
+/*********************************************************************/
+gal_pqueue_t *
+gal_pqueue_alloc(size_t initsize);
+
+void
+gal_pqueue_reset(gal_pqueue_t *pq);
+
+void
+gal_pqueue_add(gal_pqueue_t *pq, size_t value, float tosort);
+
+size_t
+gal_pqueue_pop_smallest(gal_pqueue_t *pq, float *tosort);
+
+void
+gal_pqueue_to_sizet(gal_pqueue_t *pq, gal_list_sizet_t **out);
+
+void
+gal_pqueue_free(gal_pqueue_t *pq);
+
+
+
+
+__END_C_DECLS    /* From C++ preparations */
+
+#endif
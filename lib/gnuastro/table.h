@@ -101,6 +101,7 @@ enum gal_table_types
   GAL_TABLE_FORMAT_TXT,           /* Plain text table.                 */
   GAL_TABLE_FORMAT_AFITS,         /* FITS ASCII table.                 */
   GAL_TABLE_FORMAT_BFITS,         /* FITS binary table.                */
+  GAL_TABLE_FORMAT_ARROW,         /* Apache Arrow IPC (Feather) file.  */
 };
 
 
@@ -171,7 +172,7 @@ gal_table_comments_add_intro(gal_list_str_t **comments,
 void
 gal_table_write(gal_data_t *cols, struct gal_fits_list_key_t **keylist,
                 gal_list_str_t *comments, int tableformat, char *filename,
-                char *extname, uint8_t colinfoinstdout);
+                char *extname, uint8_t colinfoinstdout, size_t numthreads);
 
 void
 gal_table_write_log(gal_data_t *logll, char *program_string,
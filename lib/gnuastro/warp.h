@@ -84,6 +84,10 @@ typedef struct
   size_t             gcrn;  /* Gap between corners of each row.          */
   int               isccw;  /* Rotation orientation of pixel edges.      */
   gal_data_t    *vertices;  /* Stores all vertice coords of output img.  */
+
+  /* Optional arguments given by the caller (initialized to zero by
+     'gal_warp_wcsalign_template'). */
+  double        wcsinterp;  /* Max. error of interpolated WCS (0: none). */
 } gal_warp_wcsalign_t;
 
 
@@ -31,6 +31,7 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 #include <gnuastro/list.h>
 #include <gnuastro/fits.h>
 #include <gnuastro/blank.h>
+#include <gnuastro/pqueue.h>
 #include <gnuastro/pointer.h>
 #include <gnuastro/threads.h>
 #include <gnuastro/dimension.h>
@@ -64,6 +65,7 @@ struct interpolate_ngb_params
   size_t                           num;
   gal_data_t                      *out;
   gal_data_t                   *blanks;
+  size_t                     *blankind;
   size_t                  numneighbors;
   uint8_t                *thread_flags;
   int                        onlyblank;
@@ -96,11 +98,11 @@ interpolate_neighbors_on_thread(void *in_prm)
   float dist, pdist;
   uint8_t *b, *bf, *bb;
   gal_list_void_t *tvll;
-  size_t ngb_counter, pind;
-  gal_list_dosizet_t *lQ, *sQ;
+  size_t *checked, numchecked, checkedsize;
+  size_t j, ngb_counter, pind;
+  gal_pqueue_t *pq=gal_pqueue_alloc(1024);
   size_t i, index, fullind, chstart=0, ndim=input->ndim;
   gal_data_t *tin, *tout, *tnear, *value=NULL, *nearest=NULL;
-  size_t size = (correct_index ? tl->tottilesinch : input->size);
   size_t *dsize = (correct_index ? tl->numtilesinch : input->dsize);
   size_t *icoord=gal_pointer_allocate(GAL_TYPE_SIZE_T, ndim, 0, __func__,
                                       "icoord");
@@ -112,6 +114,15 @@ interpolate_neighbors_on_thread(void *in_prm)
   size_t *dinc=gal_dimension_increment(ndim, dsize);
 
 
+  /* Indexs of the elements that have been flagged as checked for each
+     interpolated element (so only they need to be reset for the next
+     one, not the whole flag array). It will grow when necessary. */
+  numchecked=0;
+  checkedsize=1024;
+  checked=gal_pointer_allocate(GAL_TYPE_SIZE_T, checkedsize, 0, __func__,
+                               "checked");
+
+
   /* Initialize the flags array. We need two flags during this processing:
      1) to see if there are blanks. 2) to see if a neighbor has been
      checked. These are both binary (0 or 1). So to avoid wasting space, we
@@ -142,26 +153,12 @@ interpolate_neighbors_on_thread(void *in_prm)
   /* Go over all the points given to this thread. */
   for(i=0; tprm->indexs[i] != GAL_BLANK_SIZE_T; ++i)
     {
-      /* For easy reading. */
-      fullind=tprm->indexs[i];
-
-
-      /* If the caller only wanted to interpolate over blank values and
-         this value is not blank (we know from the flags), then just set
-         the output value at this element to the input value and go to the
-         next element. */
-      if(prm->onlyblank && !(fullflag[fullind] & INTERPOLATE_FLAGS_BLANK) )
-        {
-          tin=input;
-          for(tout=prm->out; tout!=NULL; tout=tout->next)
-            {
-              memcpy(gal_pointer_increment(tout->array, fullind, tin->type),
-                     gal_pointer_increment(tin->array,  fullind, tin->type),
-                     gal_type_sizeof(tin->type));
-              tin=tin->next;
-            }
-          continue;
-        }
+      /* For easy reading. When only blank elements should be
+         interpolated, the threads are only given the blank elements
+         (through 'blankind'). */
+      fullind = ( prm->blankind
+                  ? prm->blankind[ tprm->indexs[i] ]
+                  : tprm->indexs[i] );
 
 
       /* Correct the index (if necessary). When the values come from a
@@ -189,25 +186,28 @@ interpolate_neighbors_on_thread(void *in_prm)
         }
 
 
-      /* Reset all checked bits in the flags array to 0. */
+      /* Reset the checked bits of the previous element's search to
+         0. Resetting the full flags array for every element would make
+         this operation O(N) for every blank element: very slow on large
+         datasets with many blank elements. */
       ngb_counter=0;
-      bf=(b=flag)+size;
-      do *b &= ~(INTERPOLATE_FLAGS_NGB_CHECKED); while(++b<bf);
+      for(j=0;j<numchecked;++j)
+        fullflag[ checked[j] ] &= ~(INTERPOLATE_FLAGS_NGB_CHECKED);
+      numchecked=0;
 
 
       /* Get the coordinates of this pixel (to be interpolated). */
       gal_dimension_index_to_coord(index, ndim, dsize, icoord);
 
 
-      /* Start parsing the neighbors. We will use a two-way ordered linked
-         list structure. To start from the nearest and go out to the
-         farthest. */
-      lQ=sQ=NULL;
-      gal_list_dosizet_add(&lQ, &sQ, index, 0.0f);
-      while(sQ)
+      /* Start parsing the neighbors. We will use a priority queue to
+         start from the nearest and go out to the farthest. */
+      gal_pqueue_reset(pq);
+      gal_pqueue_add(pq, index, 0.0f);
+      while(pq->size)
         {
           /* Pop-out (p) an index from the queue: */
-          pind=gal_list_dosizet_pop_smallest(&lQ, &sQ, &pdist);
+          pind=gal_pqueue_pop_smallest(pq, &pdist);
 
           /* If this isn't a blank value then add its values to the list of
              neighbor values. Note that we didn't check whether the values
@@ -225,13 +225,8 @@ interpolate_neighbors_on_thread(void *in_prm)
                   tin=tin->next;
                 }
 
-              /* If we have filled all the elements clean up the linked
-                 list and break out. */
-              if(++ngb_counter>=prm->numneighbors)
-                {
-                  if(lQ) gal_list_dosizet_free(lQ);
-                  break;
-                }
+              /* If we have filled all the elements, break out. */
+              if(++ngb_counter>=prm->numneighbors) break;
             }
 
           /* Go over all the neighbors of this popped pixel and add them to
@@ -251,10 +246,23 @@ interpolate_neighbors_on_thread(void *in_prm)
                  dist=prm->metric(icoord, ncoord, ndim);
 
                  /* Add this neighbor to the list. */
-                 gal_list_dosizet_add(&lQ, &sQ, nind, dist);
+                 gal_pqueue_add(pq, nind, dist);
 
-                 /* Flag this neighbor as checked. */
+                 /* Flag this neighbor as checked (and keep its index
+                    to reset the flag later). */
                  flag[nind] |= INTERPOLATE_FLAGS_NGB_CHECKED;
+                 if(numchecked==checkedsize)
+                   {
+                     checkedsize*=2;
+                     errno=0;
+                     checked=realloc(checked,
+                                     checkedsize*sizeof *checked);
+                     if(checked==NULL)
+                       error(EXIT_FAILURE, errno, "%s: couldn't "
+                             "re-allocate 'checked' with %zu elements",
+                             __func__, checkedsize);
+                   }
+                 checked[numchecked++]=chstart+nind;
                }
            } );
 
@@ -262,7 +270,7 @@ interpolate_neighbors_on_thread(void *in_prm)
              shows, there were not enough points for
              interpolation. Normally, this loop should only be exited
              through the 'currentnum>=numnearest' check above. */
-          if(sQ==NULL)
+          if(pq->size==0)
             error(EXIT_FAILURE, 0, "%s: only %zu neighbors found while "
                   "you had asked to use %zu neighbors for close neighbor "
                   "interpolation", __func__, ngb_counter,
@@ -309,6 +317,8 @@ interpolate_neighbors_on_thread(void *in_prm)
   /* Clean up. */
   for(tnear=nearest; tnear!=NULL; tnear=tnear->next) tnear->array=NULL;
   gal_list_data_free(nearest);
+  gal_pqueue_free(pq);
+  free(checked);
   free(icoord);
   free(ncoord);
   free(dinc);
@@ -367,9 +377,10 @@ gal_interpolate_neighbors(gal_data_t *input,
                           size_t numthreads, int onlyblank,
                           int aslinkedlist, int function)
 {
+  uint8_t *b, *bf;
   gal_data_t *tin, *tout;
   struct interpolate_ngb_params prm;
-  size_t ngbvnum=numthreads*numneighbors;
+  size_t i, numactions, ngbvnum=numthreads*numneighbors;
   int permute=(tl && tl->totchannels>1 && tl->workoverch);
 
 
@@ -471,10 +482,43 @@ gal_interpolate_neighbors(gal_data_t *input,
                                         "prm.thread_flags");
 
 
+  /* When only the blank elements should be interpolated, copy the input
+     values into the output and only give the blank elements to the
+     threads (so the threads don't spend time on non-blank elements and
+     the blank elements are distributed evenly between them). */
+  prm.blankind=NULL;
+  numactions=input->size;
+  if(onlyblank)
+    {
+      /* Copy the input(s) into the output(s). */
+      tin=input;
+      for(tout=prm.out; tout!=NULL; tout=tout->next)
+        {
+          memcpy(tout->array, tin->array,
+                 tin->size*gal_type_sizeof(tin->type));
+          tin=tin->next;
+        }
+
+      /* Find the indexs of the blank elements. */
+      numactions=0;
+      bf=(b=prm.blanks->array)+input->size; do numactions+=*b; while(++b<bf);
+      if(numactions)
+        {
+          i=0;
+          prm.blankind=gal_pointer_allocate(GAL_TYPE_SIZE_T, numactions, 0,
+                                            __func__, "prm.blankind");
+          b=prm.blanks->array;
+          do if(*b) prm.blankind[i++]=b-(uint8_t *)(prm.blanks->array);
+          while(++b<bf);
+        }
+    }
+
+
   /* Spin off the threads. */
-  gal_threads_spin_off(interpolate_neighbors_on_thread, &prm,
-                       input->size, numthreads, input->minmapsize,
-                       input->quietmmap);
+  if(numactions)
+    gal_threads_spin_off(interpolate_neighbors_on_thread, &prm,
+                         numactions, numthreads, input->minmapsize,
+                         input->quietmmap);
 
 
   /* If the values were permuted for the interpolation, then re-order the
@@ -498,6 +542,7 @@ gal_interpolate_neighbors(gal_data_t *input,
 
 
   /* Clean up and return. */
+  free(prm.blankind);
   free(prm.thread_flags);
   gal_data_free(prm.blanks);
   gal_list_void_free(prm.ngb_vals, 1);
@@ -149,6 +149,88 @@ gal_label_indexs(gal_data_t *labels, size_t numlabs, size_t minmapsize,
 
 
 
+/* Similar to 'gal_label_indexs', but instead of the index of every
+   element, the contiguous runs of each label are stored: every run is
+   represented by two numbers: the index of its first element and its
+   length. A run never passes over the end of the fastest dimension (so
+   each run is on one row of a 2D image). For compact labeled regions,
+   this is much smaller than the indexs of all the elements and is
+   convenient for parsing over the labeled elements in order. */
+gal_data_t *
+gal_label_runs(gal_data_t *labels, size_t numlabs, size_t minmapsize,
+               int quietmmap)
+{
+  gal_data_t *max, *labruns;
+  int32_t *a, *l, *lf, prev;
+  size_t i, *runs, *nruns, dsize;
+  size_t width=labels->dsize[labels->ndim-1];
+
+  /* Sanity check. */
+  label_check_type(labels, GAL_TYPE_INT32, "labels", __func__);
+
+  /* If the user hasn't given the number of labels, find it (maximum
+     label). */
+  if(numlabs==0)
+    {
+      max=gal_statistics_maximum(labels);
+      numlabs=*((int32_t *)(max->array));
+      gal_data_free(max);
+    }
+  labruns=gal_data_array_calloc(numlabs+1);
+
+  /* Count the number of runs in each label: a new run starts when the
+     label is different from the previous element or at the start of a
+     new row. */
+  nruns=gal_pointer_allocate(GAL_TYPE_SIZE_T, numlabs+1, 1, __func__,
+                             "nruns");
+  prev=0;
+  lf=(a=l=labels->array)+labels->size;
+  do
+    {
+      if( *l>0 && ( *l!=prev || (l-a)%width==0 ) ) ++nruns[*l];
+      prev=*l;
+    }
+  while(++l<lf);
+
+  /* Allocate the dataset of each label (two elements for each run). */
+  for(i=1;i<numlabs+1;++i)
+    {
+      dsize=2*nruns[i];
+      gal_data_initialize(&labruns[i], NULL, GAL_TYPE_SIZE_T, 1, &dsize,
+                          NULL, 0, minmapsize, quietmmap, NULL, NULL, NULL);
+    }
+
+  /* Fill in the runs. We will use the 'nruns' array again, but this time
+     as a counter. */
+  prev=0;
+  memset(nruns, 0, (numlabs+1)*sizeof *nruns);
+  l=labels->array;
+  do
+    {
+      if(*l>0)
+        {
+          runs=labruns[*l].array;
+          if( *l!=prev || (l-a)%width==0 )
+            {
+              runs[ 2*nruns[*l]   ] = l-a;
+              runs[ 2*nruns[*l]+1 ] = 1;
+              ++nruns[*l];
+            }
+          else ++runs[ 2*nruns[*l]-1 ];
+        }
+      prev=*l;
+    }
+  while(++l<lf);
+
+  /* Clean up and return. */
+  free(nruns);
+  return labruns;
+}
+
+
+
+
+
 
 
 
@@ -224,7 +306,7 @@ gal_label_watershed(gal_data_t *values, gal_data_t *indexs,
   tile->block=values;
   gal_checkset_writable_remove(filename, NULL, 0, 0);
   crop=gal_data_copy(tile);
-  gal_fits_img_write(crop, filename, NULL, PROGRAM_NAME);
+  gal_fits_img_write(crop, filename, NULL, PROGRAM_NAME, 0);
   gal_data_free(crop);
   printf("blank: %u\nriver: %u\ntmpcheck: %u\ninit: %u\n",
          (int32_t)GAL_BLANK_INT32, (int32_t)GAL_LABEL_RIVER,
@@ -486,7 +568,7 @@ gal_label_watershed(gal_data_t *values, gal_data_t *indexs,
             crop=gal_data_copy(tile);
             crf=(cr=crop->array)+crop->size;
             do if(*cr==GAL_LABEL_RIVER) *cr=0; while(++cr<crf);
-            gal_fits_img_write(crop, filename, NULL, PROGRAM_NAME);
+            gal_fits_img_write(crop, filename, NULL, PROGRAM_NAME, 0);
             gal_data_free(crop);
           }
         **********************************************/
@@ -25,10 +25,13 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 #include <stdio.h>
 #include <errno.h>
 #include <error.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 
 #include <gnuastro/type.h>
 #include <gnuastro/pointer.h>
@@ -226,6 +229,149 @@ gal_pointer_mmap_free(char **mmapname, int quietmmap)
 
 
 
+/* Arrays that are a direct (private) memory-map of a part of an existing
+   file (see 'gal_pointer_mmap_file'). They have to be un-mapped (not
+   freed), so they are kept here. The list is shared by all threads, so
+   it is only accessed while the mutex is locked. But 'gal_data_free' (in
+   all programs) checks this list for every array, so the number of
+   mappings is also kept (atomically): when it is zero, the mutex isn't
+   necessary. An array that was mapped has been counted before the caller
+   received it, so its caller can never see a zero count. */
+struct pointer_filemap
+{
+  void                  *array;  /* Pointer given to the caller.      */
+  void                   *base;  /* Start of the mapping (page).      */
+  size_t                  size;  /* Size of the mapping (in bytes).   */
+  struct pointer_filemap *next;  /* Next mapped array.                */
+};
+static struct pointer_filemap *pointer_filemaps=NULL;
+static size_t pointer_filemaps_num=0;
+static pthread_mutex_t pointer_filemaps_mutex=PTHREAD_MUTEX_INITIALIZER;
+
+
+
+
+
+/* Map 'bsize' bytes of the file 'filename' (starting from byte 'offset')
+   into memory and return the pointer to its start. The mapping is
+   private, so the file's pages are shared with all other processes that
+   read the file (in the kernel's page cache) and they are only read from
+   the file when they are used. Writing into the array is possible, but
+   the changes will not be written into the file (the changed pages will
+   be copied in the RAM). If the file can't be mapped, NULL is returned
+   (so the caller can read the file in other ways). The array has to be
+   freed with 'gal_pointer_mmap_file_free' ('gal_data_free' will do this
+   automatically): it must not be given to 'free' or 'realloc'. */
+void *
+gal_pointer_mmap_file(char *filename, size_t offset, size_t bsize,
+                      int quietmmap)
+{
+  void *base;
+  int filedes;
+  struct stat info;
+  struct pointer_filemap *fm;
+  size_t pageoffset=offset % sysconf(_SC_PAGESIZE);
+
+  /* Open the file and make sure it is a regular file that contains the
+     requested range. */
+  if(bsize==0) return NULL;
+  filedes=open(filename, O_RDONLY);
+  if(filedes==-1) return NULL;
+  if( fstat(filedes, &info) || !S_ISREG(info.st_mode)
+      || (size_t)info.st_size < offset+bsize )
+    { close(filedes); return NULL; }
+
+  /* Map the pages containing the requested range (the file can be closed
+     after mapping). */
+  base=mmap(NULL, pageoffset+bsize, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+            filedes, offset-pageoffset);
+  close(filedes);
+  if(base==MAP_FAILED) return NULL;
+
+  /* Keep the mapping's information. */
+  errno=0;
+  fm=malloc(sizeof *fm);
+  if(fm==NULL)
+    error(EXIT_FAILURE, errno, "%s: %zu bytes for 'fm'", __func__,
+          sizeof *fm);
+  fm->base=base;
+  fm->size=pageoffset+bsize;
+  fm->array=(char *)base+pageoffset;
+  pthread_mutex_lock(&pointer_filemaps_mutex);
+  fm->next=pointer_filemaps;
+  pointer_filemaps=fm;
+  __atomic_store_n(&pointer_filemaps_num, pointer_filemaps_num+1,
+                   __ATOMIC_RELEASE);
+  pthread_mutex_unlock(&pointer_filemaps_mutex);
+
+  /* Inform the user. */
+  if(!quietmmap)
+    error(EXIT_SUCCESS, 0, "%s: %zu bytes (from byte %zu) directly "
+          "memory-mapped (not copied into RAM or a temporary file)",
+          filename, bsize, offset);
+
+  /* Return the pointer to the requested range. */
+  return fm->array;
+}
+
+
+
+
+
+/* Return 1 if 'array' was mapped with 'gal_pointer_mmap_file' (and
+   is not yet freed). Otherwise, return 0. */
+int
+gal_pointer_mmap_file_is(void *array)
+{
+  struct pointer_filemap *fm;
+
+  if( array==NULL
+      || __atomic_load_n(&pointer_filemaps_num, __ATOMIC_ACQUIRE)==0 )
+    return 0;
+  pthread_mutex_lock(&pointer_filemaps_mutex);
+  for(fm=pointer_filemaps; fm!=NULL; fm=fm->next)
+    if(fm->array==array) break;
+  pthread_mutex_unlock(&pointer_filemaps_mutex);
+  return fm!=NULL;
+}
+
+
+
+
+
+/* If 'array' was mapped with 'gal_pointer_mmap_file', un-map it and
+   return 1. Otherwise, don't touch it and return 0. */
+int
+gal_pointer_mmap_file_free(void *array)
+{
+  struct pointer_filemap *fm, **prev;
+
+  /* Find (and remove) the array from the list. */
+  if( array==NULL
+      || __atomic_load_n(&pointer_filemaps_num, __ATOMIC_ACQUIRE)==0 )
+    return 0;
+  pthread_mutex_lock(&pointer_filemaps_mutex);
+  for(prev=&pointer_filemaps; (fm=*prev)!=NULL; prev=&fm->next)
+    if(fm->array==array)
+      {
+        *prev=fm->next;
+        __atomic_store_n(&pointer_filemaps_num, pointer_filemaps_num-1,
+                         __ATOMIC_RELEASE);
+        break;
+      }
+  pthread_mutex_unlock(&pointer_filemaps_mutex);
+
+  /* Un-map it. */
+  if(fm==NULL) return 0;
+  munmap(fm->base, fm->size);
+  free(fm);
+  return 1;
+}
+
+
+
+
+
 void *
 gal_pointer_allocate_ram_or_mmap(uint8_t type, size_t size, int clear,
                                  size_t minmapsize, char **mmapname,
@@ -47,6 +47,12 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 /* The cross product of two points from the center. */
 #define GAL_POLYGON_CROSS_PRODUCT(A, B) ( (A)[0]*(B)[1] - (B)[0]*(A)[1] )
 
+/* Maximum number of vertices after clipping a polygon with 'n' vertices
+   by four lines in 'gal_polygon_clip_area_row'. Each clip can increase
+   the number of vertices by at most a half (only for concave polygons),
+   so after four clips there are at most about 5.1 times more. */
+#define POLYGON_CLIP_ROW_MAXCRN(n) ( 6*(n) + 8 )
+
 
 
 
@@ -599,6 +605,134 @@ gal_polygon_clip(double *s, size_t n, double *c, size_t m,
 
 
 
+/* Clip the polygon 'in' (with 'n' vertices) to the half-plane where the
+   coordinate along dimension 'd' is larger (when 'sign' is 1) or smaller
+   (when 'sign' is -1) than 'val' and put the result in 'out'. Since the
+   clipping line is parallel to one of the axes, the intersections are
+   found by a simple linear interpolation along the edge. The number of
+   vertices in the output is returned. */
+static size_t
+polygon_clip_axis(double *in, size_t n, double *out, size_t d, double val,
+                  double sign)
+{
+  double *S, *E, ds, de;
+  size_t j, jj, o=0;
+
+  /* If there are no vertices, there is nothing to clip. */
+  if(n==0) return 0;
+
+  /* Go over all the edges (starting from the last vertex). */
+  jj=n-1;
+  ds=sign*(in[jj*2+d]-val);
+  for(j=0;j<n;++j)
+    {
+      S=&in[jj*2];
+      E=&in[j*2];
+      de=sign*(E[d]-val);
+
+      /* The edge crosses the line: add the intersection. */
+      if( (ds<0) != (de<0) )
+        {
+          out[o*2+d]=val;
+          out[o*2+1-d]=S[1-d]+(E[1-d]-S[1-d])*ds/(ds-de);
+          ++o;
+        }
+
+      /* The end of the edge is inside. */
+      if(de>=0) { out[o*2]=E[0]; out[o*2+1]=E[1]; ++o; }
+
+      /* Prepare for the next edge. */
+      ds=de;
+      jj=j;
+    }
+  return o;
+}
+
+
+
+
+
+/* Find the area of the overlap between the convex polygon 'v' (with 'n'
+   vertices) and each one of 'num' unit squares along a row, put the
+   result in 'areas' (which must already be allocated with 'num'
+   elements). The bottom-left corner of the first square is at (x0, y0)
+   and the bottom-left corner of square 'i' is at (x0+i, y0). For example
+   the pixels of an image along a row.
+
+   This is the most common use of polygon clipping (for example to find
+   the fraction of each input pixel that is covered by an output pixel
+   when warping), so it is much faster than calling 'gal_polygon_clip' on
+   each square: the polygon is only clipped once by the bottom and top of
+   the row, and the clipping by the sides of each square doesn't need the
+   generic line intersections. */
+void
+gal_polygon_clip_area_row(double *v, size_t n, double x0, double y0,
+                          size_t num, double *areas)
+{
+  size_t i, nb, nc, maxcrn=POLYGON_CLIP_ROW_MAXCRN(n);
+  double xmin=DBL_MAX, xmax=-DBL_MAX, barea, left, *buf=NULL;
+  double sband[2*POLYGON_CLIP_ROW_MAXCRN(GAL_POLYGON_MAX_CORNERS)];
+  double stmp[2*POLYGON_CLIP_ROW_MAXCRN(GAL_POLYGON_MAX_CORNERS)];
+  double sout[2*POLYGON_CLIP_ROW_MAXCRN(GAL_POLYGON_MAX_CORNERS)];
+  double *band=sband, *tmp=stmp, *out=sout;
+
+  /* This function is called very frequently, so the clipped polygons are
+     kept on the stack. Only when the polygon has too many vertices for
+     them, the space is allocated here. */
+  if(n>GAL_POLYGON_MAX_CORNERS)
+    {
+      buf=gal_pointer_allocate(GAL_TYPE_FLOAT64, 3*2*maxcrn, 0, __func__,
+                               "buf");
+      band=buf;
+      tmp=buf+2*maxcrn;
+      out=buf+4*maxcrn;
+    }
+
+  /* Clip the polygon to the bottom and top of the row. */
+  nb=polygon_clip_axis(v,   n,  tmp,  1, y0,      1.0f);
+  nb=polygon_clip_axis(tmp, nb, band, 1, y0+1.0f, -1.0f);
+
+  /* If the polygon doesn't overlap with this row, all the areas are
+     zero. */
+  if(nb==0)
+    {
+      for(i=0;i<num;++i) areas[i]=0.0f;
+      if(buf) free(buf);
+      return;
+    }
+
+  /* Find the horizontal range of the clipped polygon and its area. */
+  for(i=0;i<nb;++i)
+    {
+      if(band[i*2]<xmin) xmin=band[i*2];
+      if(band[i*2]>xmax) xmax=band[i*2];
+    }
+  barea=gal_polygon_area(band, nb);
+
+  /* Go over each square. */
+  for(i=0;i<num;++i)
+    {
+      left=x0+i;
+      if(xmax<=left || xmin>=left+1.0f)
+        areas[i]=0.0f;
+      else if(xmin>=left && xmax<=left+1.0f)
+        areas[i]=barea;
+      else
+        {
+          nc=polygon_clip_axis(band, nb, tmp, 0, left,      1.0f);
+          nc=polygon_clip_axis(tmp,  nc, out, 0, left+1.0f, -1.0f);
+          areas[i] = nc ? gal_polygon_area(out, nc) : 0.0f;
+        }
+    }
+
+  /* Clean up. */
+  if(buf) free(buf);
+}
+
+
+
+
+
 
 
 
@@ -0,0 +1,235 @@
+/*********************************************************************
+Priority queue -- Binary heap of indexs sorted by a floating point value.
+This is part of GNU Astronomy Utilities (Gnuastro) package.
+
+Original author:
+     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+Contributing author(s):
+Copyright (C) 2022 Free Software Foundation, Inc.
+
+Gnuastro is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+Gnuastro is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
+**********************************************************************/
+#include <config.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <errno.h>
+#include <error.h>
+#include <stdlib.h>
+
+#include <gnuastro/list.h>
+#include <gnuastro/blank.h>
+#include <gnuastro/pqueue.h>
+
+
+
+
+
+/*********************************************************************/
+/***************        Allocation and freeing     *******************/
+/*********************************************************************/
+/* Allocate an empty queue. 'initsize' is the initial number of allocated
+   nodes: the queue will grow automatically when more are necessary. */
+gal_pqueue_t *
+gal_pqueue_alloc(size_t initsize)
+{
+  gal_pqueue_t *pq;
+
+  /* Allocate the structure. */
+  errno=0;
+  pq=malloc(sizeof *pq);
+  if(pq==NULL)
+    error(EXIT_FAILURE, errno, "%s: couldn't allocate %zu bytes for 'pq'",
+          __func__, sizeof *pq);
+
+  /* Allocate the nodes. */
+  pq->allocated = initsize ? initsize : 1;
+  errno=0;
+  pq->nodes=malloc(pq->allocated * sizeof *pq->nodes);
+  if(pq->nodes==NULL)
+    error(EXIT_FAILURE, errno, "%s: couldn't allocate %zu bytes for "
+          "'pq->nodes'", __func__, pq->allocated * sizeof *pq->nodes);
+
+  /* Initialize the counters and return. */
+  pq->size=pq->numadded=0;
+  return pq;
+}
+
+
+
+
+
+/* Empty the queue, but keep its allocated space (so it can be re-used
+   without any new allocation). */
+void
+gal_pqueue_reset(gal_pqueue_t *pq)
+{
+  pq->size=pq->numadded=0;
+}
+
+
+
+
+
+void
+gal_pqueue_free(gal_pqueue_t *pq)
+{
+  if(pq==NULL) return;
+  free(pq->nodes);
+  free(pq);
+}
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+/*********************************************************************/
+/***************          Adding and popping       *******************/
+/*********************************************************************/
+/* Nodes with an equal sorting value are ordered by the order they were
+   added: the first one to be added is popped first. This is the same
+   behavior as 'gal_list_dosizet_pop_smallest' and is necessary to have
+   reproducible results when the popping order matters. */
+#define PQUEUE_LESS(A,B) ( (A)->s < (B)->s                          \
+                           || ( (A)->s == (B)->s                    \
+                                && (A)->order < (B)->order ) )
+
+
+
+
+
+void
+gal_pqueue_add(gal_pqueue_t *pq, size_t value, float tosort)
+{
+  size_t i, parent;
+  gal_pqueue_node_t node, *nodes;
+
+  /* If the queue is full, double its size. */
+  if(pq->size==pq->allocated)
+    {
+      pq->allocated*=2;
+      errno=0;
+      pq->nodes=realloc(pq->nodes, pq->allocated * sizeof *pq->nodes);
+      if(pq->nodes==NULL)
+        error(EXIT_FAILURE, errno, "%s: couldn't re-allocate %zu bytes "
+              "for 'pq->nodes'", __func__,
+              pq->allocated * sizeof *pq->nodes);
+    }
+
+  /* Prepare the new node. */
+  node.v=value;
+  node.s=tosort;
+  node.order=pq->numadded++;
+
+  /* Move the new node up from the end of the heap until its parent is
+     smaller than it. */
+  nodes=pq->nodes;
+  i=pq->size++;
+  while(i)
+    {
+      parent=(i-1)/2;
+      if( PQUEUE_LESS(&node, &nodes[parent]) )
+        { nodes[i]=nodes[parent]; i=parent; }
+      else break;
+    }
+  nodes[i]=node;
+}
+
+
+
+
+
+/* Pop the node with the smallest sorting value (and put its sorting value
+   in 'tosort'). When the queue is empty, the returned value will be
+   'GAL_BLANK_SIZE_T' and 'tosort' will be NaN. */
+size_t
+gal_pqueue_pop_smallest(gal_pqueue_t *pq, float *tosort)
+{
+  size_t i, c, out;
+  gal_pqueue_node_t last, *nodes=pq->nodes;
+
+  /* If the queue is empty, return a blank value. */
+  if(pq->size==0) { *tosort=NAN; return GAL_BLANK_SIZE_T; }
+
+  /* Keep the output. */
+  out=nodes[0].v;
+  *tosort=nodes[0].s;
+
+  /* Move the last node down from the top until both its children are
+     larger than it. */
+  last=nodes[--pq->size];
+  i=0;
+  while( (c=2*i+1) < pq->size )
+    {
+      /* Select the smaller child. */
+      if( c+1 < pq->size && PQUEUE_LESS(&nodes[c+1], &nodes[c]) ) ++c;
+
+      /* See if it should go up. */
+      if( PQUEUE_LESS(&nodes[c], &last) )
+        { nodes[i]=nodes[c]; i=c; }
+      else break;
+    }
+  nodes[i]=last;
+
+  /* Return the value. */
+  return out;
+}
+
+
+
+
+
+/* Add all the values in the queue to a singly-linked list. The values
+   will be added in decreasing order, so the smallest value will be at the
+   top of the output list (to be popped first). Like
+   'gal_list_dosizet_to_sizet', the queue will be empty afterwards (but
+   its allocated space is kept, so it can be re-used). */
+void
+gal_pqueue_to_sizet(gal_pqueue_t *pq, gal_list_sizet_t **out)
+{
+  float s;
+  size_t i, num=pq->size;
+  gal_pqueue_node_t *nodes=pq->nodes;
+
+  /* Popping the smallest value frees the last element of the array, so
+     the popped values can be kept in the same array (in the end, it will
+     be sorted in decreasing order). */
+  while(pq->size)
+    {
+      i=pq->size-1;
+      nodes[i].v=gal_pqueue_pop_smallest(pq, &s);
+    }
+
+  /* Add the values to the list (from the largest to the smallest). */
+  for(i=0;i<num;++i)
+    gal_list_sizet_add(out, nodes[i].v);
+
+  /* Reset the queue. */
+  gal_pqueue_reset(pq);
+}
@@ -560,6 +560,92 @@ gal_statistics_quantile_function_index(gal_data_t *input,
 
 
 
+/* When the input isn't already sorted (and we aren't allowed to sort it
+   in place), sorting a copy only to find the position of one value is
+   wasteful: it is O(NlogN) and needs a new allocation. The position of the
+   value in the sorted array only depends on the number of elements that
+   are smaller or equal to it and on its two neighbors. So with one parse
+   over the dataset (that can also be a tile), we can find the same index
+   as 'gal_statistics_quantile_function_index' without any sorting.
+
+   The elements of 'aux' (of the same type as the input) are: 0: value,
+   1: largest element smaller or equal to value, 2: smallest element
+   larger than value, 3: the smallest element. The output is the quantile
+   function, or NaN when there aren't enough elements or the value is
+   blank (the caller should then use the sorted array).*/
+#define STATS_QFUNC_NOSORT(IT) {                                        \
+    IT *a=aux->array;                                                   \
+    if(k==0)      d=-INFINITY;                                          \
+    else if(k==n) d = a[3]==a[0] ? -INFINITY : INFINITY;                \
+    else d = (double)( a[0]-a[1] < a[2]-a[0] ? k-1 : k ) / (n-1);       \
+  }
+static double
+statistics_quantile_function_nosort(gal_data_t *input,
+                                    gal_data_t *invalue)
+{
+  double d=NAN;
+  size_t n=0, k=0, asize=4;
+  gal_data_t *aux, *value, *block=gal_tile_block(input);
+  size_t width=gal_type_sizeof(block->type);
+
+  /* Make sure the value has the same type as the input. */
+  value = ( invalue->type==block->type
+            ? invalue
+            : gal_data_copy_to_new_type(invalue, block->type) );
+
+  /* If the value is blank, the sorted array is necessary. */
+  if( gal_blank_is(value->array, value->type) )
+    { if(value!=invalue) gal_data_free(value); return d; }
+
+  /* Initialize the auxiliary values. */
+  aux=gal_data_alloc(NULL, block->type, 1, &asize, NULL, 0, -1, 1,
+                     NULL, NULL, NULL);
+  memcpy(aux->array, value->array, width);
+  gal_type_min(block->type, gal_pointer_increment(aux->array, 1,
+                                                  block->type));
+  gal_type_max(block->type, gal_pointer_increment(aux->array, 2,
+                                                  block->type));
+  gal_type_max(block->type, gal_pointer_increment(aux->array, 3,
+                                                  block->type));
+
+  /* Parse the dataset ('o' is the start of 'aux' in the operator). */
+  GAL_TILE_PARSE_OPERATE(input, aux, 0, 1,
+                         {
+                           ++n;
+                           if(*i<o[3]) o[3]=*i;
+                           if(*i<=o[0]) { ++k; if(*i>o[1]) o[1]=*i; }
+                           else if(*i<o[2]) o[2]=*i;
+                         });
+
+  /* With less than two elements, the sorted array is necessary. */
+  if(n>1)
+    switch(block->type)
+      {
+      case GAL_TYPE_UINT8:     STATS_QFUNC_NOSORT( uint8_t  );     break;
+      case GAL_TYPE_INT8:      STATS_QFUNC_NOSORT( int8_t   );     break;
+      case GAL_TYPE_UINT16:    STATS_QFUNC_NOSORT( uint16_t );     break;
+      case GAL_TYPE_INT16:     STATS_QFUNC_NOSORT( int16_t  );     break;
+      case GAL_TYPE_UINT32:    STATS_QFUNC_NOSORT( uint32_t );     break;
+      case GAL_TYPE_INT32:     STATS_QFUNC_NOSORT( int32_t  );     break;
+      case GAL_TYPE_UINT64:    STATS_QFUNC_NOSORT( uint64_t );     break;
+      case GAL_TYPE_INT64:     STATS_QFUNC_NOSORT( int64_t  );     break;
+      case GAL_TYPE_FLOAT32:   STATS_QFUNC_NOSORT( float    );     break;
+      case GAL_TYPE_FLOAT64:   STATS_QFUNC_NOSORT( double   );     break;
+      default:
+        error(EXIT_FAILURE, 0, "%s: type code %d not recognized",
+              __func__, block->type);
+      }
+
+  /* Clean up and return. */
+  if(value!=invalue) gal_data_free(value);
+  gal_data_free(aux);
+  return d;
+}
+
+
+
+
+
 /* Return the quantile function of the given value as float64. */
 #define STATS_QFUNC(IT) {                                               \
     IT *a=nbs->array, v=*((IT *)(value->array));                        \
@@ -577,8 +663,8 @@ gal_statistics_quantile_function(gal_data_t *input, gal_data_t *value,
                                  int inplace)
 {
   double *d;
+  gal_data_t *nbs;
   size_t ind, dsize=1;
-  gal_data_t *nbs=gal_statistics_no_blank_sorted(input, inplace);
   gal_data_t *out=gal_data_alloc(NULL, GAL_TYPE_FLOAT64, 1, &dsize,
                                  NULL, 1, -1, 1, NULL, NULL, NULL);
 
@@ -587,6 +673,18 @@ gal_statistics_quantile_function(gal_data_t *input, gal_data_t *value,
     error(EXIT_FAILURE, 0, "%s: the 'value' argument must only have "
           "one element", __func__);
 
+  /* When the input can't be sorted in place (or is a tile that would be
+     copied anyway), don't sort it at all. */
+  if(inplace==0 || input->block)
+    {
+      d=out->array;
+      d[0]=statistics_quantile_function_nosort(input, value);
+      if( !isnan(d[0]) ) return out;
+    }
+
+  /* Remove blanks and sort the input. */
+  nbs=gal_statistics_no_blank_sorted(input, inplace);
+
   /* Calculate the index of the value. */
   ind=gal_statistics_quantile_function_index(input, value, inplace);
   //printf("ind: %zu (%zu)\n", ind, input->size);
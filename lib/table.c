@@ -31,6 +31,7 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 
 #include <gnuastro/git.h>
 #include <gnuastro/txt.h>
+#include <gnuastro/arrow.h>
 #include <gnuastro/blank.h>
 #include <gnuastro/table.h>
 #include <gnuastro/pointer.h>
@@ -105,7 +106,12 @@ gal_table_info(char *filename, char *hdu, gal_list_str_t *lines,
                size_t *numcols, size_t *numrows, int *tableformat)
 {
   /* Get the table format and size (number of columns and rows). */
-  if(filename && gal_fits_file_recognized(filename))
+  if(filename && gal_arrow_name_is_arrow(filename))
+    {
+      *tableformat=GAL_TABLE_FORMAT_ARROW;
+      return gal_arrow_tab_info(filename, numcols, numrows);
+    }
+  else if(filename && gal_fits_file_recognized(filename))
     return gal_fits_tab_info(filename, hdu, numcols, numrows, tableformat);
   else
     {
@@ -508,7 +514,7 @@ gal_table_read(char *filename, char *hdu, gal_list_str_t *lines,
     {
     case GAL_TABLE_FORMAT_TXT:
       out=gal_txt_table_read(filename, lines, numrows, allcols, indexll,
-                             minmapsize, quietmmap);
+                             numthreads, minmapsize, quietmmap);
       break;
 
     case GAL_TABLE_FORMAT_AFITS:
@@ -517,6 +523,11 @@ gal_table_read(char *filename, char *hdu, gal_list_str_t *lines,
                             numthreads, minmapsize, quietmmap);
       break;
 
+    case GAL_TABLE_FORMAT_ARROW:
+      out=gal_arrow_tab_read(filename, numrows, allcols, indexll,
+                             numthreads, minmapsize, quietmmap);
+      break;
+
     default:
       error(EXIT_FAILURE, 0, "%s: table format code %d not recognized for "
             "'tableformat'", __func__, tableformat);
@@ -590,11 +601,12 @@ gal_table_comments_add_intro(gal_list_str_t **comments,
 
 /* The input is a linked list of data structures and some comments. The
    table will then be written into 'filename' with a format that is
-   specified by 'tableformat'. */
+   specified by 'tableformat'. Plain text tables are formatted with
+   'numthreads' threads. */
 void
 gal_table_write(gal_data_t *cols, struct gal_fits_list_key_t **keylist,
                 gal_list_str_t *comments, int tableformat, char *filename,
-                char *extname, uint8_t colinfoinstdout)
+                char *extname, uint8_t colinfoinstdout, size_t numthreads)
 {
   /* If a filename was given, then the tableformat is relevant and must be
      used. When the filename is empty, a text table must be printed on the
@@ -603,14 +615,17 @@ gal_table_write(gal_data_t *cols, struct gal_fits_list_key_t **keylist,
     {
       if(gal_fits_name_is_fits(filename))
         gal_fits_tab_write(cols, comments, tableformat, filename, extname,
-                           keylist);
+                           keylist, numthreads);
+      else if(gal_arrow_name_is_arrow(filename))
+        gal_arrow_tab_write(cols, keylist, comments, filename);
       else
         gal_txt_write(cols, keylist, comments, filename,
-                      colinfoinstdout, 0);
+                      colinfoinstdout, 0, numthreads);
     }
   else
     /* Write to standard output. */
-    gal_txt_write(cols, keylist, comments, filename, colinfoinstdout, 0);
+    gal_txt_write(cols, keylist, comments, filename, colinfoinstdout, 0,
+                  numthreads);
 }
 
 
@@ -629,7 +644,7 @@ gal_table_write_log(gal_data_t *logll, char *program_string,
 
   /* Write the log file to disk */
   gal_table_write(logll, NULL, comments, GAL_TABLE_FORMAT_TXT,
-                  filename, "LOG", 0);
+                  filename, "LOG", 0, 1);
 
   /* In verbose mode, print the information. */
   if(!quiet)
@@ -107,6 +107,7 @@ gal_tableintern_string_to_format(char *string)
       if(!strcmp(string, "txt"))              return GAL_TABLE_FORMAT_TXT;
       else if(!strcmp(string,"fits-ascii"))   return GAL_TABLE_FORMAT_AFITS;
       else if(!strcmp(string, "fits-binary")) return GAL_TABLE_FORMAT_BFITS;
+      else if(!strcmp(string, "arrow"))       return GAL_TABLE_FORMAT_ARROW;
       else                                    return GAL_TABLE_FORMAT_INVALID;
     }
   else                                        return GAL_TABLE_FORMAT_INVALID;
@@ -124,6 +125,7 @@ gal_tableintern_format_as_string(uint8_t tableformat)
     case GAL_TABLE_FORMAT_TXT:    return "txt";
     case GAL_TABLE_FORMAT_AFITS:  return "fits-ascii";
     case GAL_TABLE_FORMAT_BFITS:  return "fits-binary";
+    case GAL_TABLE_FORMAT_ARROW:  return "arrow";
     default:
       error(EXIT_FAILURE, 0, "%s: code %d not recognized", __func__,
             tableformat);
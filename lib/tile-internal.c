@@ -30,6 +30,7 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 #include <stdlib.h>
 
 #include <gnuastro/tile.h>
+#include <gnuastro/pqueue.h>
 #include <gnuastro/threads.h>
 #include <gnuastro/pointer.h>
 #include <gnuastro/statistics.h>
@@ -340,7 +341,7 @@ gal_tileinternal_no_outlier_local_on_thread(void *in_prm)
   uint8_t *b, *bf, *bb;
   gal_list_void_t *tvll;
   size_t ngb_counter, pind;
-  gal_list_dosizet_t *lQ, *sQ;
+  gal_pqueue_t *pq=gal_pqueue_alloc(1024);
   gal_data_t *tin, *tnear, *nearest=NULL;
   float dist, pdist, *tnarr, *marr=prm->measure->array;
   size_t i, index, fullind, chstart=0, ndim=input->ndim;
@@ -429,15 +430,14 @@ gal_tileinternal_no_outlier_local_on_thread(void *in_prm)
       gal_dimension_index_to_coord(index, ndim, dsize, icoord);
 
 
-      /* Start parsing the neighbors. We will use a two-way ordered linked
-         list structure. To start from the nearest and go out to the
-         farthest. */
-      lQ=sQ=NULL;
-      gal_list_dosizet_add(&lQ, &sQ, index, 0.0f);
-      while(sQ)
+      /* Start parsing the neighbors. We will use a priority queue to
+         start from the nearest and go out to the farthest. */
+      gal_pqueue_reset(pq);
+      gal_pqueue_add(pq, index, 0.0f);
+      while(pq->size)
         {
           /* Pop-out (p) an index from the queue: */
-          pind=gal_list_dosizet_pop_smallest(&lQ, &sQ, &pdist);
+          pind=gal_pqueue_pop_smallest(pq, &pdist);
 
           /* If this isn't a blank value then add its values to the list of
              neighbor values. Note that we didn't check whether the values
@@ -455,13 +455,8 @@ gal_tileinternal_no_outlier_local_on_thread(void *in_prm)
                   tin=tin->next;
                 }
 
-              /* If we have filled all the elements clean up the linked
-                 list and break out. */
-              if(++ngb_counter>=prm->numneighbors)
-                {
-                  if(lQ) gal_list_dosizet_free(lQ);
-                  break;
-                }
+              /* If we have filled all the elements, break out. */
+              if(++ngb_counter>=prm->numneighbors) break;
             }
 
           /* Go over all the neighbors of this popped pixel and add them to
@@ -481,7 +476,7 @@ gal_tileinternal_no_outlier_local_on_thread(void *in_prm)
                  dist=prm->metric(icoord, ncoord, ndim);
 
                  /* Add this neighbor to the list. */
-                 gal_list_dosizet_add(&lQ, &sQ, nind, dist);
+                 gal_pqueue_add(pq, nind, dist);
 
                  /* Flag this neighbor as checked. */
                  flag[nind] |= TILEINTERNAL_OUTLIER_FLAGS_NGB_CHECKED;
@@ -492,7 +487,7 @@ gal_tileinternal_no_outlier_local_on_thread(void *in_prm)
              shows, there were not enough points for
              interpolation. Normally, this loop should only be exited
              through the 'currentnum>=numnearest' check above. */
-          if(sQ==NULL)
+          if(pq->size==0)
             error(EXIT_FAILURE, 0, "%s: only %zu neighbors found while "
                   "you had asked to use %zu neighbors for outlier "
                   "rejection (value to '%s')", __func__, ngb_counter,
@@ -523,6 +518,7 @@ gal_tileinternal_no_outlier_local_on_thread(void *in_prm)
   /* Clean up. */
   for(tnear=nearest; tnear!=NULL; tnear=tnear->next) tnear->array=NULL;
   gal_list_data_free(nearest);
+  gal_pqueue_free(pq);
   free(icoord);
   free(ncoord);
   free(dinc);
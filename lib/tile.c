@@ -267,7 +267,7 @@ gal_tile_series_from_minmax(gal_data_t *block, size_t *minmax, size_t number)
     for(i=0;i<number;++i)
       {
         copy=gal_data_copy(&tiles[i]);
-        gal_fits_img_write(copy, "tiles.fits", NULL, NULL);
+        gal_fits_img_write(copy, "tiles.fits", NULL, NULL, 0);
       }
   }
   */
@@ -1137,8 +1137,9 @@ gal_tile_full_values_write(gal_data_t *tilevalues,
     disp=gal_tile_block_write_const_value(tilevalues, tl->tiles,
                                           withblank, 0);
 
-  /* Write the array as a file and then clean up (if necessary). */
-  gal_fits_img_write(disp, filename, keys, program_string);
+  /* Write the array as a file and then clean up (if necessary). This is
+     only for checking, so one thread is used. */
+  gal_fits_img_write(disp, filename, keys, program_string, 0);
   if(disp!=tilevalues) gal_data_free(disp);
 }
 
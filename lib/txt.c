@@ -24,18 +24,21 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 
 #include <math.h>
 #include <ctype.h>
+#include <float.h>
 #include <stdio.h>
 #include <errno.h>
 #include <error.h>
 #include <unistd.h>
 #include <string.h>
 #include <stdlib.h>
+#include <sys/stat.h>
 
 #include <gnuastro/txt.h>
 #include <gnuastro/list.h>
 #include <gnuastro/units.h>
 #include <gnuastro/blank.h>
 #include <gnuastro/table.h>
+#include <gnuastro/threads.h>
 #include <gnuastro/pointer.h>
 
 #include <gnuastro-internal/checkset.h>
@@ -853,6 +856,64 @@ txt_blocklist_number(gal_data_t *list)
 
 
 
+/* Convert the token to a double. For the common case of a simple decimal
+   number (like '-12.345' or '6.7e-8'), when the decimal significand and
+   the power of ten can both be exactly represented in a double (not more
+   than 2^53 and 10^22), one multiplication or division gives the
+   correctly rounded result (Clinger's "fast path"). In all other cases
+   (for example more digits, 'inf', 'nan' or the '_h_m_s' format),
+   'strtod' is used. So the result is always identical to 'strtod'. */
+static double
+txt_strtod(char *token, char **tailptr)
+{
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+  double d;
+  char *c=token;
+  uint64_t w=0;
+  long e=0, e10;
+  int neg=0, eneg=0;
+  size_t ndigits=0, fdigits=0;
+  static const double pow10[]={1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,
+                               1e7,  1e8,  1e9,  1e10, 1e11, 1e12, 1e13,
+                               1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+                               1e21, 1e22};
+
+  /* The sign and the significand (at most 19 digits to fit in 64-bits). */
+  if(*c=='-' || *c=='+') neg=*c++=='-';
+  for(; isdigit(*c) && ndigits<20; ++c) { w=w*10+(*c-'0'); ++ndigits; }
+  if(*c=='.')
+    for(++c; isdigit(*c) && ndigits<20; ++c)
+      { w=w*10+(*c-'0'); ++ndigits; ++fdigits; }
+
+  /* The exponent (large exponents will fail the check below anyway). */
+  if( ndigits && (*c=='e' || *c=='E') )
+    {
+      ++c;
+      if(*c=='-' || *c=='+') eneg=*c++=='-';
+      if( isdigit(*c)==0 ) ndigits=0;
+      for(; isdigit(*c); ++c) if(e<1000) e=e*10+(*c-'0');
+    }
+
+  /* If the full token was read and the conditions hold, we have the
+     result. */
+  e10 = (eneg ? -e : e) - (long)fdigits;
+  if( ndigits && ndigits<20 && *c=='\0' && w<=(1ULL<<53)
+      && e10>=-22 && e10<=22 )
+    {
+      d = e10<0 ? w/pow10[-e10] : w*pow10[e10];
+      *tailptr=c;
+      return neg ? -d : d;
+    }
+#endif
+
+  /* Use the C library's more general parser. */
+  return strtod(token, tailptr);
+}
+
+
+
+
+
 static void
 txt_read_token(gal_data_t *data, gal_data_t *info, char *token,
                size_t i, char *filename, size_t lineno, size_t toknum)
@@ -967,7 +1028,7 @@ txt_read_token(gal_data_t *data, gal_data_t *info, char *token,
              condition check (even '=='). If it isn't NaN, then we can
              compare the values. */
         case GAL_TYPE_FLOAT32:
-          f[i]=strtod(token, &tailptr);
+          f[i]=txt_strtod(token, &tailptr);
           if( (*tailptr=='h' || *tailptr=='d') && isdigit(*(tailptr+1)) )
             {
               f[i] = ( *tailptr=='h'
@@ -985,7 +1046,7 @@ txt_read_token(gal_data_t *data, gal_data_t *info, char *token,
            in these cases, they are actually coordinates (RA for first, Dec
            for second). */
         case GAL_TYPE_FLOAT64:
-          d[i]=strtod(token, &tailptr);
+          d[i]=txt_strtod(token, &tailptr);
           if( (*tailptr=='h' || *tailptr=='d') && isdigit(*(tailptr+1)) )
             {
               d[i] = ( *tailptr=='h'
@@ -1411,10 +1472,188 @@ txt_read_prepare(gal_data_t *info, size_t *indsize,
 
 
 
+/* Large files are read in parallel: the file is memory-mapped and
+   divided into chunks that start at the beginning of a line, each chunk is
+   then parsed by one thread. Since each row has to be written in its
+   proper place in the output, the lines and rows of each chunk are first
+   counted (also in parallel). */
+#define TXT_READ_CHUNK_MINSIZE 1000000  /* Minimum size of chunk (bytes). */
+
+struct txt_read_params
+{
+  char             *filename;  /* Name of input file.                    */
+  char                *start;  /* Start of the mapped file.              */
+  size_t               *edge;  /* Byte offset of the start of each chunk.*/
+  size_t            *numrows;  /* Number of data rows in each chunk.     */
+  size_t           *numlines;  /* Number of lines in each chunk.         */
+  int              countonly;  /* Only count the lines and rows.         */
+  int                 format;  /* Format of the input (table or image).  */
+  size_t          ntokforout;  /* Last input token used in the output.   */
+  size_t        *tokenvecind;  /* Position of token in vector column.    */
+  gal_data_t    **tokeninout;  /* Output dataset(s) of each token.       */
+  gal_data_t   **tokenininfo;  /* Input information of each token.       */
+};
+
+static void *
+txt_read_chunk(void *in_prm)
+{
+  struct gal_threads_params *tprm=(struct gal_threads_params *)in_prm;
+  struct txt_read_params *p=(struct txt_read_params *)tprm->params;
+
+  size_t i, j, c, len, rowind, lineno, linelen=0;
+  char *pt, *end, *nl, *line=NULL, *ln;
+
+  /* Go over all the chunks that are assigned to this thread. */
+  for(i=0; tprm->indexs[i] != GAL_BLANK_SIZE_T; ++i)
+    {
+      /* Set the first row and line number of this chunk. */
+      c=tprm->indexs[i];
+      rowind=lineno=0;
+      if(p->countonly==0)
+        for(j=0;j<c;++j) { rowind+=p->numrows[j]; lineno+=p->numlines[j]; }
+
+      /* Go over the lines of this chunk. */
+      pt=p->start+p->edge[c];
+      end=p->start+p->edge[c+1];
+      for(; pt<end; pt=nl+1)
+        {
+          /* Find the end of this line. The last line of the file may not
+             finish with a new-line character. */
+          nl=memchr(pt, '\n', end-pt);
+          len = nl ? nl-pt : end-pt;
+          ++lineno;
+
+          /* Copy the line into a null-terminated string (that finishes
+             with a new-line character like 'getline'). When only counting
+             and the line has a new-line character, this isn't
+             necessary. */
+          if(p->countonly && nl) ln=pt;
+          else
+            {
+              if(len+2>linelen)
+                {
+                  linelen=2*(len+2);
+                  errno=0;
+                  line=realloc(line, linelen*sizeof *line);
+                  if(line==NULL)
+                    error(EXIT_FAILURE, errno, "%s: allocating %zu bytes "
+                          "for 'line'", __func__, linelen*sizeof *line);
+                }
+              memcpy(line, pt, len);
+              line[len]='\n';
+              line[len+1]='\0';
+              ln=line;
+            }
+
+          /* The next line starts after the end of this one. */
+          if(nl==NULL) nl=end-1;
+
+          /* Count or parse the line. */
+          if( gal_txt_line_stat(ln) == GAL_TXT_LINESTAT_DATAROW )
+            {
+              if(p->countonly) ++p->numrows[c];
+              else txt_fill(ln, p->tokeninout, p->ntokforout,
+                            p->tokenininfo, p->tokenvecind, rowind++,
+                            p->filename, lineno, 1, p->format);
+            }
+        }
+
+      /* Keep the number of lines in this chunk. */
+      if(p->countonly) p->numlines[c]=lineno;
+    }
+
+  /* Clean up, wait for all threads to finish and return. */
+  if(line) free(line);
+  if(tprm->b) pthread_barrier_wait(tprm->b);
+  return NULL;
+}
+
+
+
+
+
+/* Read a file in parallel (see the comments above 'txt_read_params'). If
+   this isn't possible (for example the file isn't large enough, or it
+   can't be memory-mapped), return 0 (so the caller reads it line by
+   line). Otherwise, return 1. */
+static int
+txt_read_parallel(char *filename, size_t *indsize, int format,
+                  size_t numthreads, size_t minmapsize, int quietmmap,
+                  gal_data_t **tokeninout, size_t ntokforout,
+                  gal_data_t **tokenininfo, size_t *tokenvecind)
+{
+  char *nl;
+  struct stat info;
+  size_t i, numchunks, numrows=0;
+  struct txt_read_params p={NULL};
+
+  /* See if the file is large enough for more than one chunk. */
+  if( numthreads<2 || stat(filename, &info) ) return 0;
+  numchunks=info.st_size/TXT_READ_CHUNK_MINSIZE;
+  if(numchunks>4*numthreads) numchunks=4*numthreads;
+  if(numchunks<2) return 0;
+
+  /* Map the file into memory. */
+  p.start=gal_pointer_mmap_file(filename, 0, info.st_size, 1);
+  if(p.start==NULL) return 0;
+
+  /* Allocate the arrays and set the edges of the chunks (each chunk
+     starts after a new-line character). */
+  p.edge=gal_pointer_allocate(GAL_TYPE_SIZE_T, numchunks+1, 0, __func__,
+                              "p.edge");
+  p.numrows=gal_pointer_allocate(GAL_TYPE_SIZE_T, numchunks, 1, __func__,
+                                 "p.numrows");
+  p.numlines=gal_pointer_allocate(GAL_TYPE_SIZE_T, numchunks, 1, __func__,
+                                  "p.numlines");
+  p.edge[0]=0;
+  p.edge[numchunks]=info.st_size;
+  for(i=1;i<numchunks;++i)
+    {
+      p.edge[i]=i*(info.st_size/numchunks);
+      if(p.edge[i]<p.edge[i-1]) p.edge[i]=p.edge[i-1];
+      nl=memchr(p.start+p.edge[i]-1, '\n', info.st_size-p.edge[i]+1);
+      p.edge[i] = nl ? nl-p.start+1 : (size_t)(info.st_size);
+    }
+
+  /* Count the lines and rows of each chunk. */
+  p.format=format;
+  p.countonly=1;
+  p.filename=filename;
+  gal_threads_spin_off(txt_read_chunk, &p, numchunks, numthreads,
+                       minmapsize, quietmmap);
+
+  /* The number of rows should be the same as the information. */
+  for(i=0;i<numchunks;++i) numrows+=p.numrows[i];
+  if(numrows!=indsize[0])
+    error(EXIT_FAILURE, 0, "%s: has %zu rows, but %zu rows were expected "
+          "(from its first reading). Was it changed while being read?",
+          filename, numrows, indsize[0]);
+
+  /* Parse the rows of each chunk. */
+  p.countonly=0;
+  p.ntokforout=ntokforout;
+  p.tokeninout=tokeninout;
+  p.tokenininfo=tokenininfo;
+  p.tokenvecind=tokenvecind;
+  gal_threads_spin_off(txt_read_chunk, &p, numchunks, numthreads,
+                       minmapsize, quietmmap);
+
+  /* Clean up and return. */
+  free(p.edge);
+  free(p.numrows);
+  free(p.numlines);
+  gal_pointer_mmap_file_free(p.start);
+  return 1;
+}
+
+
+
+
+
 static gal_data_t *
 txt_read(char *filename, gal_list_str_t *lines, size_t *indsize,
-         gal_data_t *info, gal_list_sizet_t *indexll, size_t minmapsize,
-         int quietmmap, int format)
+         gal_data_t *info, gal_list_sizet_t *indexll, size_t numthreads,
+         size_t minmapsize, int quietmmap, int format)
 {
   FILE *fp;
   int test;
@@ -1439,27 +1678,35 @@ txt_read(char *filename, gal_list_str_t *lines, size_t *indsize,
   /* Read the input line by line. */
   if(filename) /* Input from a file. */
     {
-      /* Open the file. */
-      errno=0;
-      fp=fopen(filename, "r");
-      if(fp==NULL)
-        error(EXIT_FAILURE, errno, "%s: couldn't open to read as a text "
-              "table in %s", filename, __func__);
-
-      /* Read the file, line by line. */
-      while( getline(&line, &linelen, fp) != -1 )
+      /* Large files are read in parallel (when possible). */
+      if( txt_read_parallel(filename, indsize, format, numthreads,
+                            minmapsize, quietmmap, tokeninout, ntokforout,
+                            tokenininfo, tokenvecind)==0 )
         {
-          ++lineno;
-          if( gal_txt_line_stat(line) == GAL_TXT_LINESTAT_DATAROW )
-            txt_fill(line, tokeninout, ntokforout, tokenininfo,
-                     tokenvecind, rowind++, filename, lineno, 1, format);
-        }
+          /* Open the file. */
+          errno=0;
+          fp=fopen(filename, "r");
+          if(fp==NULL)
+            error(EXIT_FAILURE, errno, "%s: couldn't open to read as a "
+                  "text table in %s", filename, __func__);
+
+          /* Read the file, line by line. */
+          while( getline(&line, &linelen, fp) != -1 )
+            {
+              ++lineno;
+              if( gal_txt_line_stat(line) == GAL_TXT_LINESTAT_DATAROW )
+                txt_fill(line, tokeninout, ntokforout, tokenininfo,
+                         tokenvecind, rowind++, filename, lineno, 1,
+                         format);
+            }
 
-      /* Clean up and close the file. */
-      errno=0;
-      if(fclose(fp))
-        error(EXIT_FAILURE, errno, "%s: couldn't close file after reading "
-              "ASCII table information in %s", filename, __func__);
+          /* Clean up and close the file. */
+          errno=0;
+          if(fclose(fp))
+            error(EXIT_FAILURE, errno, "%s: couldn't close file after "
+                  "reading ASCII table information in %s", filename,
+                  __func__);
+        }
     }
 
   else /* Input from standard input */
@@ -1495,10 +1742,10 @@ txt_read(char *filename, gal_list_str_t *lines, size_t *indsize,
 gal_data_t *
 gal_txt_table_read(char *filename, gal_list_str_t *lines, size_t numrows,
                    gal_data_t *colinfo, gal_list_sizet_t *indexll,
-                   size_t minmapsize, int quietmmap)
+                   size_t numthreads, size_t minmapsize, int quietmmap)
 {
-  return txt_read(filename, lines, &numrows, colinfo, indexll, minmapsize,
-                  quietmmap, TXT_FORMAT_TABLE);
+  return txt_read(filename, lines, &numrows, colinfo, indexll, numthreads,
+                  minmapsize, quietmmap, TXT_FORMAT_TABLE);
 }
 
 
@@ -1517,7 +1764,7 @@ gal_txt_image_read(char *filename, gal_list_str_t *lines,
   imginfo=gal_txt_image_info(filename, lines, &numimg, dsize);
 
   /* Read the table. */
-  img=txt_read(filename, lines, dsize, imginfo, indexll, minmapsize,
+  img=txt_read(filename, lines, dsize, imginfo, indexll, 1, minmapsize,
                quietmmap, TXT_FORMAT_IMAGE);
 
   /* Clean up and return. */
@@ -1777,37 +2024,331 @@ txt_fmts_for_printf(gal_data_t *datall, int leftadjust, int tab0_img1)
 
 
 
+/* Rows are formatted into memory buffers (in parallel) and then written
+   into the output in order. Each thread formats chunks of
+   'TXT_WRITE_CHUNK_ROWS' rows into its own buffer. */
+#define TXT_WRITE_CHUNK_ROWS 10000
+
+/* Growing buffer of characters. */
+struct txt_write_buffer
+{
+  char          *str;  /* Allocated space.                         */
+  size_t         len;  /* Number of used characters.               */
+  size_t       alloc;  /* Number of allocated characters.          */
+};
+
+/* Formats that don't need 'printf' (decimal integers and strings with no
+   precision). They are parsed once from the printf format. */
+struct txt_write_fast
+{
+  char          conv;  /* 'd', 'u' or 's' ('\0': use 'printf').    */
+  int           left;  /* Left-adjusted value.                     */
+  int          width;  /* Minimum width of value.                  */
+  int          space;  /* A space should be added after the value. */
+};
+
+struct txt_write_params
+{
+  gal_data_t                *input;  /* Input dataset(s).              */
+  char                      **fmts;  /* printf formats.                */
+  struct txt_write_fast      *fast;  /* Fast formats.                  */
+  int                    tab0_img1;  /* Input is an image.             */
+  size_t                     first;  /* First row of this batch.       */
+  size_t                   numrows;  /* Total number of rows.          */
+  struct txt_write_buffer    *bufs;  /* Buffer of each chunk.          */
+};
+
+
+
+
+
+/* See if the printf format can be written without 'printf'. */
+static void
+txt_write_fast_parse(char *fmt, struct txt_write_fast *f)
+{
+  char conv, *c=fmt;
+
+  /* Initialize and parse the format. */
+  f->conv='\0'; f->left=f->width=f->space=0;
+  if(*c++!='%' || *c++!='+') return;
+  if(*c=='-') { f->left=1; ++c; }
+  while(isdigit(*c)) f->width=f->width*10+(*c++-'0');
+  while(*c=='h' || *c=='l') ++c;
+  if(*c!='d' && *c!='u' && *c!='s') return;
+  conv=*c++;
+  if(*c==' ') { f->space=1; ++c; }
+  if(*c=='\0') f->conv=conv;
+}
+
+
+
+
+
+/* Make sure that the buffer has space for 'n' more characters. */
 static void
-txt_print_value(FILE *fp, gal_data_t *data, size_t ind, char *fmt)
+txt_write_buffer_space(struct txt_write_buffer *b, size_t n)
+{
+  if(b->len+n > b->alloc)
+    {
+      b->alloc = 2*(b->len+n);
+      errno=0;
+      b->str=realloc(b->str, b->alloc*sizeof *b->str);
+      if(b->str==NULL)
+        error(EXIT_FAILURE, errno, "%s: allocating %zu bytes",
+              __func__, b->alloc*sizeof *b->str);
+    }
+}
+
+
+
+
+
+/* Print the value with the given printf format into the string. */
+static int
+txt_write_printf(char *str, size_t size, gal_data_t *data, size_t ind,
+                 char *fmt)
 {
   void *a=data->array;
 
   switch(data->type)
     {
       /* Numerical types. */
-    case GAL_TYPE_UINT8:   fprintf(fp, fmt, ((uint8_t *) a)[ind]); break;
-    case GAL_TYPE_INT8:    fprintf(fp, fmt, ((int8_t *)  a)[ind]); break;
-    case GAL_TYPE_UINT16:  fprintf(fp, fmt, ((uint16_t *)a)[ind]); break;
-    case GAL_TYPE_INT16:   fprintf(fp, fmt, ((int16_t *) a)[ind]); break;
-    case GAL_TYPE_UINT32:  fprintf(fp, fmt, ((uint32_t *)a)[ind]); break;
-    case GAL_TYPE_INT32:   fprintf(fp, fmt, ((int32_t *) a)[ind]); break;
-    case GAL_TYPE_UINT64:  fprintf(fp, fmt, ((uint64_t *)a)[ind]); break;
-    case GAL_TYPE_INT64:   fprintf(fp, fmt, ((int64_t *) a)[ind]); break;
-    case GAL_TYPE_FLOAT32: fprintf(fp, fmt, ((float *)   a)[ind]); break;
-    case GAL_TYPE_FLOAT64: fprintf(fp, fmt, ((double *)  a)[ind]); break;
-
-      /* Special consideration for strings. */
-    case GAL_TYPE_STRING:
-      if( !strcmp( ((char **)a)[ind], GAL_BLANK_STRING ) )
-        fprintf(fp, fmt, GAL_BLANK_STRING);
-      else
-        fprintf(fp, fmt, ((char **)a)[ind]);
-      break;
-
+    case GAL_TYPE_UINT8:   return snprintf(str,size,fmt,((uint8_t *) a)[ind]);
+    case GAL_TYPE_INT8:    return snprintf(str,size,fmt,((int8_t *)  a)[ind]);
+    case GAL_TYPE_UINT16:  return snprintf(str,size,fmt,((uint16_t *)a)[ind]);
+    case GAL_TYPE_INT16:   return snprintf(str,size,fmt,((int16_t *) a)[ind]);
+    case GAL_TYPE_UINT32:  return snprintf(str,size,fmt,((uint32_t *)a)[ind]);
+    case GAL_TYPE_INT32:   return snprintf(str,size,fmt,((int32_t *) a)[ind]);
+    case GAL_TYPE_UINT64:  return snprintf(str,size,fmt,((uint64_t *)a)[ind]);
+    case GAL_TYPE_INT64:   return snprintf(str,size,fmt,((int64_t *) a)[ind]);
+    case GAL_TYPE_FLOAT32: return snprintf(str,size,fmt,((float *)   a)[ind]);
+    case GAL_TYPE_FLOAT64: return snprintf(str,size,fmt,((double *)  a)[ind]);
+    case GAL_TYPE_STRING:  return snprintf(str,size,fmt,((char **)   a)[ind]);
     default:
       error(EXIT_FAILURE, 0, "%s: type code %d not recognized",
             __func__, data->type);
     }
+
+  /* Control should not reach here. */
+  return 0;
+}
+
+
+
+
+
+/* Add the value to the buffer. Decimal integers and strings are written
+   directly (giving the same result as 'printf'), the rest are written
+   with 'snprintf'. */
+static void
+txt_write_value(struct txt_write_buffer *b, gal_data_t *data, size_t ind,
+                char *fmt, struct txt_write_fast *f)
+{
+  int n;
+  char num[24], *val;
+  size_t len, pad, avail;
+  uint64_t u=0, neg=0;
+  void *a=data->array;
+
+  /* Formats that need 'printf'. */
+  if(f->conv=='\0')
+    {
+      do
+        {
+          avail=b->alloc-b->len;
+          n=txt_write_printf(b->str+b->len, avail, data, ind, fmt);
+          if(n<0)
+            error(EXIT_FAILURE, errno, "%s: printing with '%s' format",
+                  __func__, fmt);
+          if((size_t)n>=avail) txt_write_buffer_space(b, n+1);
+        }
+      while((size_t)n>=avail);
+      b->len+=n;
+      return;
+    }
+
+  /* Prepare the string to write. */
+  if(f->conv=='s') val=((char **)a)[ind];
+  else
+    {
+      /* Read the value (with its sign). */
+      switch(data->type)
+        {
+        case GAL_TYPE_UINT8:  u=((uint8_t  *)a)[ind]; break;
+        case GAL_TYPE_UINT16: u=((uint16_t *)a)[ind]; break;
+        case GAL_TYPE_UINT32: u=((uint32_t *)a)[ind]; break;
+        case GAL_TYPE_UINT64: u=((uint64_t *)a)[ind]; break;
+        case GAL_TYPE_INT8:   neg=((int8_t  *)a)[ind]<0;
+                              u=((int8_t  *)a)[ind]; break;
+        case GAL_TYPE_INT16:  neg=((int16_t *)a)[ind]<0;
+                              u=((int16_t *)a)[ind]; break;
+        case GAL_TYPE_INT32:  neg=((int32_t *)a)[ind]<0;
+                              u=((int32_t *)a)[ind]; break;
+        case GAL_TYPE_INT64:  neg=((int64_t *)a)[ind]<0;
+                              u=((int64_t *)a)[ind]; break;
+        default:
+          error(EXIT_FAILURE, 0, "%s: type code %d not recognized",
+                __func__, data->type);
+        }
+      if(neg) u=-u;   /* Unsigned negation is also valid for INT64_MIN. */
+
+      /* Write the digits from the end, then the sign ('%+d' also puts a
+         '+' for positive values, but '%u' has no sign). */
+      val=num+sizeof num-1;
+      *val='\0';
+      do *--val='0'+u%10; while(u/=10);
+      if(f->conv=='d') *--val = neg ? '-' : '+';
+    }
+
+  /* Write the string (with the necessary padding). */
+  len=strlen(val);
+  pad = (size_t)f->width>len ? f->width-len : 0;
+  txt_write_buffer_space(b, len+pad+1);
+  if(f->left==0) { memset(b->str+b->len, ' ', pad); b->len+=pad; }
+  memcpy(b->str+b->len, val, len);
+  b->len+=len;
+  if(f->left) { memset(b->str+b->len, ' ', pad); b->len+=pad; }
+  if(f->space) b->str[b->len++]=' ';
+}
+
+
+
+
+
+/* Write one row of the input into the buffer. */
+static void
+txt_write_row(struct txt_write_buffer *b, struct txt_write_params *p,
+              size_t i)
+{
+  size_t j, k, f, d1;
+  gal_data_t *data, *input=p->input;
+
+  if(p->tab0_img1) /* Image. */
+    {
+      d1=input->dsize[1];
+      for(j=0;j<d1;++j)
+        {
+          f = j==d1-1 ? 3 : 0;
+          txt_write_value(b, input, i*d1+j, p->fmts[f], &p->fast[f]);
+        }
+    }
+  else /* Table. */
+    {
+      k=0; /* Column counter. */
+      for(data=input;data!=NULL;data=data->next)
+        {
+          if(data->ndim>1)  /* Vector column. */
+            {
+              d1=data->dsize[1];
+              for(j=0;j<d1;++j)
+                {
+                  /* Last of vector column has a different format. */
+                  f = ( k * FMTS_COLS
+                        + (j==d1-1 && data->next==NULL ? 3 : 0) );
+                  txt_write_value(b, data, i*d1+j, p->fmts[f],
+                                  &p->fast[f]);
+                }
+            }
+          else /* Non-vector column: simple! */
+            txt_write_value(b, data, i, p->fmts[k*FMTS_COLS],
+                            &p->fast[k*FMTS_COLS]);
+          ++k;
+        }
+    }
+
+  /* Finish the row. */
+  txt_write_buffer_space(b, 1);
+  b->str[b->len++]='\n';
+}
+
+
+
+
+
+/* Format the rows of the chunks that are assigned to this thread. */
+static void *
+txt_write_chunk(void *in_prm)
+{
+  struct gal_threads_params *tprm=(struct gal_threads_params *)in_prm;
+  struct txt_write_params *p=(struct txt_write_params *)tprm->params;
+
+  size_t c, i, r, rf;
+
+  /* Go over all the chunks that are assigned to this thread. */
+  for(i=0; tprm->indexs[i] != GAL_BLANK_SIZE_T; ++i)
+    {
+      c=tprm->indexs[i];
+      p->bufs[c].len=0;
+      r=p->first+c*TXT_WRITE_CHUNK_ROWS;
+      rf=r+TXT_WRITE_CHUNK_ROWS;
+      if(rf>p->numrows) rf=p->numrows;
+      for(; r<rf; ++r) txt_write_row(&p->bufs[c], p, r);
+    }
+
+  /* Wait for all the other threads to finish, then return. */
+  if(tprm->b) pthread_barrier_wait(tprm->b);
+  return NULL;
+}
+
+
+
+
+
+/* Write all the rows of the input into the file. */
+static void
+txt_write_rows(FILE *fp, char *filename, gal_data_t *input, char **fmts,
+               size_t numcols, int tab0_img1, size_t numthreads)
+{
+  size_t i, nc, numchunks, batchrows;
+  struct txt_write_params p;
+
+  /* Prepare the parameters. */
+  p.fmts=fmts;
+  p.input=input;
+  p.tab0_img1=tab0_img1;
+  p.numrows=input->dsize[0];
+  if(p.numrows==0) return;
+  errno=0;
+  p.fast=malloc(FMTS_COLS*numcols*sizeof *p.fast);
+  if(p.fast==NULL)
+    error(EXIT_FAILURE, errno, "%s: %zu bytes for 'p.fast'", __func__,
+          FMTS_COLS*numcols*sizeof *p.fast);
+  for(i=0;i<numcols;++i)
+    {
+      txt_write_fast_parse(fmts[i*FMTS_COLS],   &p.fast[i*FMTS_COLS]);
+      txt_write_fast_parse(fmts[i*FMTS_COLS+3], &p.fast[i*FMTS_COLS+3]);
+    }
+
+  /* Limit the number of threads and allocate one buffer for each chunk
+     of a batch (the buffers are re-used in the next batches). */
+  numchunks=(p.numrows+TXT_WRITE_CHUNK_ROWS-1)/TXT_WRITE_CHUNK_ROWS;
+  if(numthreads==0) numthreads=1;
+  if(numthreads>numchunks) numthreads=numchunks;
+  batchrows=numthreads*TXT_WRITE_CHUNK_ROWS;
+  errno=0;
+  p.bufs=calloc(numthreads, sizeof *p.bufs);
+  if(p.bufs==NULL)
+    error(EXIT_FAILURE, errno, "%s: %zu bytes for 'p.bufs'", __func__,
+          numthreads*sizeof *p.bufs);
+
+  /* Format the rows of each batch in parallel and write them in order. */
+  for(p.first=0; p.first<p.numrows; p.first+=batchrows)
+    {
+      nc = ( p.numrows-p.first >= batchrows
+             ? numthreads
+             : (p.numrows-p.first+TXT_WRITE_CHUNK_ROWS-1)
+               / TXT_WRITE_CHUNK_ROWS );
+      gal_threads_spin_off(txt_write_chunk, &p, nc, nc, -1, 1);
+      for(i=0;i<nc;++i)
+        if( fwrite(p.bufs[i].str, 1, p.bufs[i].len, fp)!=p.bufs[i].len )
+          error(EXIT_FAILURE, errno, "%s: couldn't write the rows",
+                filename ? filename : "standard output");
+    }
+
+  /* Clean up. */
+  for(i=0;i<numthreads;++i) free(p.bufs[i].str);
+  free(p.bufs);
+  free(p.fast);
 }
 
 
@@ -1980,12 +2521,12 @@ txt_write_keys(FILE *fp, struct gal_fits_list_key_t **keylist)
 void
 gal_txt_write(gal_data_t *input, struct gal_fits_list_key_t **keylist,
               gal_list_str_t *comment, char *filename,
-              uint8_t colinfoinstdout, int tab0_img1)
+              uint8_t colinfoinstdout, int tab0_img1, size_t numthreads)
 {
   FILE *fp;
   char **fmts;
   gal_list_str_t *strt;
-  size_t i, j, k, num=0, d1;
+  size_t i, num=0;
   gal_data_t *data, *nextimg=NULL;
 
   /* Make sure input is valid. */
@@ -2070,39 +2611,8 @@ gal_txt_write(gal_data_t *input, struct gal_fits_list_key_t **keylist,
 
   /* Print row-by-row (if we actually have data to print! */
   if(input->array)
-    {
-      if(tab0_img1) /* Image. */
-        for(i=0;i<input->dsize[0];++i)
-          {
-            d1=input->dsize[1];
-            for(j=0;j<d1;++j)
-              txt_print_value(fp, input, i*d1+j, fmts[j==d1-1 ? 3 : 0]);
-            fprintf(fp, "\n");
-          }
-      else /* Table. */
-        {
-          for(i=0;i<input->dsize[0];++i)                  /* Row.    */
-            {
-              k=0; /* Column counter. */
-              for(data=input;data!=NULL;data=data->next)  /* Column. */
-                {
-                  if(data->ndim>1)  /* Vector column. */
-                    {
-                      d1=data->dsize[1];
-                      for(j=0;j<d1;++j)
-                        txt_print_value(fp, data, i*d1+j,
-                          fmts[ k * FMTS_COLS
-                      /* Last of vector column has a different format. */
-                                + (j==d1-1 && data->next==NULL ? 3 : 0) ]);
-                    }
-                  else /* Non-vector column: simple! */
-                    txt_print_value(fp, data, i, fmts[k * FMTS_COLS]);
-                  ++k;
-                }
-              fprintf(fp, "\n");
-            }
-        }
-    }
+    txt_write_rows(fp, filename, input, fmts, num, tab0_img1,
+                   numthreads);
 
 
   /* Clean up. */
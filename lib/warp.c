@@ -23,9 +23,11 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
 **********************************************************************/
 #include <config.h>
 
+#include <math.h>
 #include <errno.h>
 #include <error.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include <gnuastro/wcs.h>
 #include <gnuastro/type.h>
@@ -58,6 +60,17 @@ along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
   (size_t)( (V0)+(ES)*( (IND)+(IND)/(IS1) ) )
 
 
+/* Width (in output pixels) of the cells in the top level of the WCS
+   interpolation grid and the smallest width they can be divided into. */
+#define WARP_WCSGRID_STEP    64
+#define WARP_WCSGRID_MINSTEP 2
+
+
+/* Number of input pixels along a row to find the overlap area with an
+   output pixel in one call. */
+#define WARP_WCSALIGN_ROW_CHUNK 64
+
+
 
 
 
@@ -722,6 +735,40 @@ warp_wcsalign_init_params(gal_warp_wcsalign_t *wa, const char *func)
 
 
 
+/* Convert the 'size' output pixel coordinates in 'x' and 'y' to input
+   pixel coordinates (in place). */
+static void
+warp_wcsalign_convert(double *x, double *y, size_t size,
+                      struct wcsprm *owcs, struct wcsprm *iwcs,
+                      size_t minmapsize, int quietmmap)
+{
+  gal_data_t *vertices=NULL;
+
+  /* If there is nothing to convert, return. */
+  if(size==0) return;
+
+  /* Allocate the non-allocated vertices table. */
+  gal_list_data_add_alloc(&vertices, x, GAL_TYPE_FLOAT64, 1, &size, NULL,
+                          0, minmapsize, quietmmap, NULL, NULL, NULL);
+  gal_list_data_add_alloc(&vertices, y, GAL_TYPE_FLOAT64, 1, &size, NULL,
+                          0, minmapsize, quietmmap, NULL, NULL, NULL);
+  gal_list_data_reverse(&vertices); /* '_add' is last-in-first-out. */
+
+  /* Convert the coordinates. */
+  gal_wcs_img_to_world(vertices, owcs, 1);
+  gal_wcs_world_to_img(vertices, iwcs,  1);
+
+  /* Clean up: since the 'array' pointer is within a larger allocated
+     array, we shouldn't free it when freeing the table, so we'll set it to
+     NULL. */
+  vertices->array=vertices->next->array=NULL;
+  gal_list_data_free(vertices);
+}
+
+
+
+
+
 /* Convert the necessary vertice coordinates. */
 static void *
 warp_wcsalign_init_convert(void *in_prm)
@@ -731,11 +778,8 @@ warp_wcsalign_init_convert(void *in_prm)
   gal_warp_wcsalign_t *wa = (gal_warp_wcsalign_t *)tprm->params;
 
   /* Higher-level variables. */
-  gal_data_t *vertices=NULL;
   double *xarr=wa->vertices->array;
-  int quietmmap=wa->vertices->quietmmap;
   double *yarr=wa->vertices->next->array;
-  size_t minmapsize=wa->vertices->minmapsize;
   size_t first, size, nt=wa->numthreads, vsize=wa->vertices->size;
 
   /* WCSLIB's conversion functions write intermediate processing steps in
@@ -754,24 +798,12 @@ warp_wcsalign_init_convert(void *in_prm)
          tprm->id, first, size);
   */
 
-  /* Allocate the non-allocated vertices table for this thread. */
-  gal_list_data_add_alloc(&vertices, xarr+first, GAL_TYPE_FLOAT64,
-                          1, &size, NULL, 0, minmapsize, quietmmap,
-                          NULL, NULL, NULL);
-  gal_list_data_add_alloc(&vertices, yarr+first, GAL_TYPE_FLOAT64,
-                          1, &size, NULL, 0, minmapsize, quietmmap,
-                          NULL, NULL, NULL);
-  gal_list_data_reverse(&vertices); /* '_add' is last-in-first-out. */
-
   /* Convert the coordinates. */
-  gal_wcs_img_to_world(vertices, owcs, 1);
-  gal_wcs_world_to_img(vertices, iwcs,  1);
+  warp_wcsalign_convert(xarr+first, yarr+first, size, owcs, iwcs,
+                        wa->vertices->minmapsize,
+                        wa->vertices->quietmmap);
 
-  /* Clean up: since the 'array' pointer is within a larger allocated
-     array, we shouldn't free it when freeing the table, so we'll set it to
-     NULL. */
-  vertices->array=vertices->next->array=NULL;
-  gal_list_data_free(vertices);
+  /* Clean up. */
   gal_wcs_free(iwcs);
   gal_wcs_free(owcs);
 
@@ -784,6 +816,362 @@ warp_wcsalign_init_convert(void *in_prm)
 
 
 
+/* The WCS interpolation grid (used when 'wa->wcsinterp' is positive).
+
+   The output vertices are on a regular grid and their positions on the
+   input image change very smoothly (for the usual projections and
+   distortions). So instead of converting every vertex through the two
+   WCSs, we can do the full conversion on a coarse grid of points and
+   interpolate the positions of the vertices in between.
+
+   The grid starts with cells of 'WARP_WCSGRID_STEP' output pixels on a
+   side. On every cell, the full conversion is also done on the middle of
+   each side and its center, and these are compared with the bi-linear
+   interpolation of its four corners. When the largest difference (in
+   input pixels) is larger than 'wa->wcsinterp', the cell is divided into
+   four (where the five new points are the corners of the children), until
+   the cells become smaller than 'WARP_WCSGRID_MINSTEP'; the vertices of
+   such cells are then converted with the full WCS.
+
+   Note that 'wa->wcsinterp' is therefore an approximate bound: it is only
+   checked on these five points of each cell. The bi-linear interpolation
+   is exact at the corners, so these are the points where the error of a
+   smoothly varying conversion is largest; but a distortion that changes
+   on scales smaller than the cell can have a larger error elsewhere. */
+struct warp_wcsgrid_cell
+{
+  double          x0, y0;  /* Bottom-left corner (output pixel coords). */
+  double            size;  /* Width of the cell in output pixels.       */
+  double    ix[4], iy[4];  /* Input coords of BL, BR, TL, TR corners.   */
+  size_t           child;  /* First of four children (or blank).        */
+  uint8_t          exact;  /* ==1: Vertices need the full conversion.   */
+};
+
+struct warp_wcsgrid
+{
+  gal_warp_wcsalign_t *wa;  /* Main Warp structure.                     */
+  struct warp_wcsgrid_cell *cells; /* All cells (top level first).      */
+  size_t ncells;            /* Number of cells (in all levels).         */
+  size_t ncx, ncy;          /* Number of top-level cells on each axis.  */
+};
+
+
+
+
+
+/* Add four children to cell 'ind' of the grid. 'px' and 'py' are the
+   input coordinates of the middle of the bottom, top, left and right
+   sides and the center of the cell (in this order). */
+static void
+warp_wcsgrid_divide(struct warp_wcsgrid *grid, size_t ind, size_t *alloc,
+                    double *px, double *py)
+{
+  size_t i, c;
+  struct warp_wcsgrid_cell *cell, *child;
+  double h, gx[9], gy[9];    /* The 3x3 points over the cell. */
+  size_t corners[4][4]={ {0,1,3,4}, {1,2,4,5}, {3,4,6,7}, {4,5,7,8} };
+
+  /* Make sure there is space for the children. */
+  if(grid->ncells+4 > *alloc)
+    {
+      *alloc*=2;
+      errno=0;
+      grid->cells=realloc(grid->cells, *alloc * sizeof *grid->cells);
+      if(grid->cells==NULL)
+        error(EXIT_FAILURE, errno, "%s: couldn't re-allocate %zu bytes "
+              "for 'grid->cells'", __func__, *alloc * sizeof *grid->cells);
+    }
+
+  /* Put the 3x3 points of the cell in order (from the bottom-left). */
+  cell=&grid->cells[ind];
+  gx[0]=cell->ix[0]; gx[1]=px[0]; gx[2]=cell->ix[1];
+  gx[3]=px[2];       gx[4]=px[4]; gx[5]=px[3];
+  gx[6]=cell->ix[2]; gx[7]=px[1]; gx[8]=cell->ix[3];
+  gy[0]=cell->iy[0]; gy[1]=py[0]; gy[2]=cell->iy[1];
+  gy[3]=py[2];       gy[4]=py[4]; gy[5]=py[3];
+  gy[6]=cell->iy[2]; gy[7]=py[1]; gy[8]=cell->iy[3];
+
+  /* Build the children. */
+  h=cell->size/2;
+  cell->child=grid->ncells;
+  for(c=0;c<4;++c)
+    {
+      child=&grid->cells[grid->ncells++];
+      child->size=h;
+      child->exact=0;
+      child->child=GAL_BLANK_SIZE_T;
+      child->x0=cell->x0 + (c%2 ? h : 0);
+      child->y0=cell->y0 + (c/2 ? h : 0);
+      for(i=0;i<4;++i)
+        {
+          child->ix[i]=gx[ corners[c][i] ];
+          child->iy[i]=gy[ corners[c][i] ];
+        }
+    }
+}
+
+
+
+
+
+/* Build the WCS interpolation grid. */
+static void
+warp_wcsgrid_build(struct warp_wcsgrid *grid)
+{
+  gal_warp_wcsalign_t *wa=grid->wa;
+  struct wcsprm *iwcs=wa->input->wcs;
+  struct wcsprm *owcs=wa->output->wcs;
+  int quietmmap=wa->input->quietmmap;
+  size_t minmapsize=wa->input->minmapsize;
+
+  double h, err, d, *px, *py, ix[5], iy[5];
+  struct warp_wcsgrid_cell *cell;
+  size_t os0=wa->output->dsize[0], os1=wa->output->dsize[1];
+  size_t i, j, k, n, nx, alloc, npending, nnext, *pending, *next;
+
+  /* Number of top-level cells along each dimension. */
+  grid->ncx = os1/WARP_WCSGRID_STEP + (os1%WARP_WCSGRID_STEP ? 1 : 0);
+  grid->ncy = os0/WARP_WCSGRID_STEP + (os0%WARP_WCSGRID_STEP ? 1 : 0);
+  nx=grid->ncx+1;
+
+  /* Do the full conversion on the corners of the top-level cells. */
+  n=nx*(grid->ncy+1);
+  px=gal_pointer_allocate(GAL_TYPE_FLOAT64, n, 0, __func__, "px");
+  py=gal_pointer_allocate(GAL_TYPE_FLOAT64, n, 0, __func__, "py");
+  for(i=0;i<n;++i)
+    {
+      px[i]=0.5f+(i%nx)*WARP_WCSGRID_STEP;
+      py[i]=0.5f+(i/nx)*WARP_WCSGRID_STEP;
+    }
+  warp_wcsalign_convert(px, py, n, owcs, iwcs, minmapsize, quietmmap);
+
+  /* Allocate the cells and fill the top level. */
+  grid->ncells=grid->ncx*grid->ncy;
+  alloc=2*grid->ncells;
+  grid->cells=gal_pointer_allocate(GAL_TYPE_UINT8,
+                                   alloc*sizeof *grid->cells, 0,
+                                   __func__, "grid->cells");
+  for(k=0;k<grid->ncells;++k)
+    {
+      cell=&grid->cells[k];
+      i=k%grid->ncx;
+      j=k/grid->ncx;
+      cell->exact=0;
+      cell->child=GAL_BLANK_SIZE_T;
+      cell->size=WARP_WCSGRID_STEP;
+      cell->x0=0.5f+i*WARP_WCSGRID_STEP;
+      cell->y0=0.5f+j*WARP_WCSGRID_STEP;
+      cell->ix[0]=px[j*nx+i];       cell->iy[0]=py[j*nx+i];
+      cell->ix[1]=px[j*nx+i+1];     cell->iy[1]=py[j*nx+i+1];
+      cell->ix[2]=px[(j+1)*nx+i];   cell->iy[2]=py[(j+1)*nx+i];
+      cell->ix[3]=px[(j+1)*nx+i+1]; cell->iy[3]=py[(j+1)*nx+i+1];
+    }
+  free(px);
+  free(py);
+
+  /* All the top-level cells need to be checked. */
+  npending=grid->ncells;
+  pending=gal_pointer_allocate(GAL_TYPE_SIZE_T, npending, 0, __func__,
+                               "pending");
+  for(k=0;k<npending;++k) pending[k]=k;
+
+  /* Check the cells, level by level. */
+  while(npending)
+    {
+      /* Do the full conversion on the middle of the four sides and the
+         center of every pending cell. */
+      px=gal_pointer_allocate(GAL_TYPE_FLOAT64, 5*npending, 0, __func__,
+                              "px");
+      py=gal_pointer_allocate(GAL_TYPE_FLOAT64, 5*npending, 0, __func__,
+                              "py");
+      for(k=0;k<npending;++k)
+        {
+          cell=&grid->cells[pending[k]];
+          h=cell->size/2;
+          px[5*k  ]=cell->x0+h;          py[5*k  ]=cell->y0;
+          px[5*k+1]=cell->x0+h;          py[5*k+1]=cell->y0+cell->size;
+          px[5*k+2]=cell->x0;            py[5*k+2]=cell->y0+h;
+          px[5*k+3]=cell->x0+cell->size; py[5*k+3]=cell->y0+h;
+          px[5*k+4]=cell->x0+h;          py[5*k+4]=cell->y0+h;
+        }
+      warp_wcsalign_convert(px, py, 5*npending, owcs, iwcs, minmapsize,
+                            quietmmap);
+
+      /* Compare them with the interpolated values. */
+      nnext=0;
+      next=gal_pointer_allocate(GAL_TYPE_SIZE_T, 4*npending, 0, __func__,
+                                "next");
+      for(k=0;k<npending;++k)
+        {
+          /* Interpolated positions (in the same order as above). */
+          cell=&grid->cells[pending[k]];
+          ix[0]=(cell->ix[0]+cell->ix[1])/2;
+          ix[1]=(cell->ix[2]+cell->ix[3])/2;
+          ix[2]=(cell->ix[0]+cell->ix[2])/2;
+          ix[3]=(cell->ix[1]+cell->ix[3])/2;
+          ix[4]=(ix[0]+ix[1])/2;
+          iy[0]=(cell->iy[0]+cell->iy[1])/2;
+          iy[1]=(cell->iy[2]+cell->iy[3])/2;
+          iy[2]=(cell->iy[0]+cell->iy[2])/2;
+          iy[3]=(cell->iy[1]+cell->iy[3])/2;
+          iy[4]=(iy[0]+iy[1])/2;
+
+          /* Largest difference. If any of the points is NaN (for example
+             outside the domain of the projection), the difference will be
+             NaN and the cell will be divided. */
+          err=0.0f;
+          for(i=0;i<5;++i)
+            {
+              d=hypot(ix[i]-px[5*k+i], iy[i]-py[5*k+i]);
+              if(isnan(d)) d=INFINITY;
+              if(d>err) err=d;
+            }
+
+          /* If the interpolation isn't accurate enough, divide the cell
+             (or use the full conversion when it is already too small). */
+          if(err>wa->wcsinterp)
+            {
+              if(cell->size/2 < WARP_WCSGRID_MINSTEP)
+                cell->exact=1;
+              else
+                {
+                  warp_wcsgrid_divide(grid, pending[k], &alloc, px+5*k,
+                                      py+5*k);
+                  for(i=4;i>0;--i) next[nnext++]=grid->ncells-i;
+                }
+            }
+        }
+
+      /* Clean up and go onto the next level. */
+      free(px);
+      free(py);
+      free(pending);
+      pending=next;
+      npending=nnext;
+    }
+
+  /* Clean up. */
+  free(pending);
+}
+
+
+
+
+
+/* Return the leaf cell of the grid that contains the given point (in
+   output pixel coordinates). */
+static struct warp_wcsgrid_cell *
+warp_wcsgrid_find(struct warp_wcsgrid *grid, double x, double y)
+{
+  double h;
+  size_t i=(x-0.5f)/WARP_WCSGRID_STEP, j=(y-0.5f)/WARP_WCSGRID_STEP;
+  struct warp_wcsgrid_cell *cell;
+
+  /* The vertices on the top and right edges of the image may be exactly
+     on the last edge of the grid. */
+  if(i>=grid->ncx) i=grid->ncx-1;
+  if(j>=grid->ncy) j=grid->ncy-1;
+
+  /* Go down the levels until we get to a cell without children. */
+  cell=&grid->cells[ j*grid->ncx+i ];
+  while(cell->child!=GAL_BLANK_SIZE_T)
+    {
+      h=cell->size/2;
+      cell=&grid->cells[ cell->child + (x>=cell->x0+h)
+                         + 2*(y>=cell->y0+h) ];
+    }
+  return cell;
+}
+
+
+
+
+
+/* Convert the vertices using the grid (similar to
+   'warp_wcsalign_init_convert'). */
+static void *
+warp_wcsgrid_convert(void *in_prm)
+{
+  /* Low-level definitions to be done first. */
+  struct gal_threads_params *tprm=(struct gal_threads_params *)in_prm;
+  struct warp_wcsgrid *grid=(struct warp_wcsgrid *)tprm->params;
+  gal_warp_wcsalign_t *wa=grid->wa;
+
+  /* Higher-level variables. */
+  struct wcsprm *iwcs, *owcs;
+  struct warp_wcsgrid_cell *cell;
+  double *xarr=wa->vertices->array;
+  double *yarr=wa->vertices->next->array;
+  double u, v, *x, *y, *ex=NULL, *ey=NULL;
+  size_t i, n, first, size, nexact=0, *eind=NULL;
+  size_t nt=wa->numthreads, vsize=wa->vertices->size;
+
+  /* Find the first vertice index to use in this thread. For the last
+     thread, the size will not be pre-defined. */
+  size  = vsize/nt;
+  first = vsize/nt*tprm->id;
+  if(tprm->id==nt-1 && nt>1) size=vsize-(nt-1)*size;
+  x=xarr+first;
+  y=yarr+first;
+
+  /* Count the vertices that need the full conversion. */
+  for(i=0;i<size;++i)
+    if( warp_wcsgrid_find(grid, x[i], y[i])->exact ) ++nexact;
+  if(nexact)
+    {
+      ex=gal_pointer_allocate(GAL_TYPE_FLOAT64, nexact, 0, __func__, "ex");
+      ey=gal_pointer_allocate(GAL_TYPE_FLOAT64, nexact, 0, __func__, "ey");
+      eind=gal_pointer_allocate(GAL_TYPE_SIZE_T, nexact, 0, __func__,
+                                "eind");
+    }
+
+  /* Interpolate the positions of the vertices (or keep them for the full
+     conversion). */
+  n=0;
+  for(i=0;i<size;++i)
+    {
+      cell=warp_wcsgrid_find(grid, x[i], y[i]);
+      if(cell->exact)
+        { eind[n]=i; ex[n]=x[i]; ey[n]=y[i]; ++n; }
+      else
+        {
+          u=(x[i]-cell->x0)/cell->size;
+          v=(y[i]-cell->y0)/cell->size;
+          x[i] = ( (1-v) * ( (1-u)*cell->ix[0] + u*cell->ix[1] )
+                   + v   * ( (1-u)*cell->ix[2] + u*cell->ix[3] ) );
+          y[i] = ( (1-v) * ( (1-u)*cell->iy[0] + u*cell->iy[1] )
+                   + v   * ( (1-u)*cell->iy[2] + u*cell->iy[3] ) );
+        }
+    }
+
+  /* Do the full conversion on the remaining vertices and put them in
+     their place. WCSLIB's conversion functions write intermediate
+     processing steps in the 'wcsprm', so each thread should use its own
+     copy. */
+  if(nexact)
+    {
+      iwcs=gal_wcs_copy(wa->input->wcs);
+      owcs=gal_wcs_copy(wa->output->wcs);
+      warp_wcsalign_convert(ex, ey, nexact, owcs, iwcs,
+                            wa->vertices->minmapsize,
+                            wa->vertices->quietmmap);
+      for(n=0;n<nexact;++n) { x[eind[n]]=ex[n]; y[eind[n]]=ey[n]; }
+      gal_wcs_free(iwcs);
+      gal_wcs_free(owcs);
+      free(eind);
+      free(ex);
+      free(ey);
+    }
+
+  /* Wait for all the other threads to finish, then return. */
+  if(tprm->b) pthread_barrier_wait(tprm->b);
+  return NULL;
+}
+
+
+
+
+
 /* Determine the final image size and allocate the output array
    accordingly.
 
@@ -857,6 +1245,7 @@ void
 gal_warp_wcsalign_init(gal_warp_wcsalign_t *wa)
 {
   gal_data_t *output=NULL;
+  struct warp_wcsgrid grid;
   int quietmmap=wa->input->quietmmap;
   size_t minmapsize=wa->input->minmapsize, *dsize=NULL;
 
@@ -875,12 +1264,23 @@ gal_warp_wcsalign_init(gal_warp_wcsalign_t *wa)
   /* Set up the output image corners in pixel coords */
   warp_wcsalign_init_vertices(wa);
 
-  /* Project the output image corners to the input image pixel coords. We
-     only want one job per thread, so the number of jobs and the number of
-     threads are the same. */
-  gal_threads_spin_off(warp_wcsalign_init_convert, wa, wa->output->size,
-                       wa->numthreads, wa->input->minmapsize,
-                       wa->input->quietmmap);
+  /* Project the output image corners to the input image pixel coords
+     (directly, or by interpolating over a grid when 'wcsinterp' is
+     given). We only want one job per thread, so the number of jobs and
+     the number of threads are the same. */
+  if(wa->wcsinterp>0.0f)
+    {
+      grid.wa=wa;
+      warp_wcsgrid_build(&grid);
+      gal_threads_spin_off(warp_wcsgrid_convert, &grid, wa->output->size,
+                           wa->numthreads, wa->input->minmapsize,
+                           wa->input->quietmmap);
+      free(grid.cells);
+    }
+  else
+    gal_threads_spin_off(warp_wcsalign_init_convert, wa, wa->output->size,
+                         wa->numthreads, wa->input->minmapsize,
+                         wa->input->quietmmap);
 
   /* Now that the output image is ready, initialize the helper internal
      variables for future processing. */
@@ -898,16 +1298,15 @@ gal_warp_wcsalign_onpix(gal_warp_wcsalign_t *wa, size_t ind)
   gal_data_t *input=wa->input;
   gal_data_t *output=wa->output;
   double xmin, xmax, ymin, ymax;
-  long xstart, ystart, xend, yend, x, y; /* Might be negative */
-  double filledarea, v, *ocrn=NULL, pcrn[8], opixarea;
+  long xstart, ystart, xend, yend, x, y, k, nx; /* Might be negative */
+  double filledarea, v, *ocrn=NULL, opixarea;
 
-  size_t numcrn=0;
   size_t ncrn=wa->ncrn;
   size_t is0=input->dsize[0];
   size_t is1=input->dsize[1];
   double *inputarr=input->array;
   double *outputarr=output->array;
-  double ccrn[GAL_POLYGON_MAX_CORNERS], area;
+  double areas[WARP_WCSALIGN_ROW_CHUNK];
   double *maxfrac=output->next ? output->next->array : NULL;
 
   /* Initialize if asked for each pixel's maximum coverage fraction. */
@@ -945,54 +1344,42 @@ gal_warp_wcsalign_onpix(gal_warp_wcsalign_t *wa, size_t ind)
   xend   = GAL_DIMENSION_NEARESTINT_HALFLOWER(  xmax ) + 1;
   yend   = GAL_DIMENSION_NEARESTINT_HALFLOWER(  ymax ) + 1;
 
-  /* Check which input pixels we are covering */
-  for(y=ystart;y<yend;++y)
-    {
-      /* If the pixel isn't in the image (note that the pixel
-         coordinates start from 1), skip this pixel. */
-      if( y<1 || y>is0 ) continue;
-
-      /* Y of base pixel vertices, in pixel coords. */
-      pcrn[1]=y-0.5f; pcrn[3]=y-0.5f;
-      pcrn[5]=y+0.5f; pcrn[7]=y+0.5f;
-
-      for(x=xstart;x<xend;++x)
-        {
-          if( x<1 || x>is1 ) continue;
+  /* Keep the range within the input image (note that the pixel
+     coordinates start from 1). */
+  if(xstart<1) xstart=1;
+  if(ystart<1) ystart=1;
+  if(xend>(long)is1+1) xend=is1+1;
+  if(yend>(long)is0+1) yend=is0+1;
 
-          /* X of base pixel vertices, in pixel coords. */
-          pcrn[0]=x-0.5f; pcrn[2]=x+0.5f;
-          pcrn[4]=x+0.5f; pcrn[6]=x-0.5f;
-
-          /* Read the value of the input pixel. */
-          v=inputarr[(y-1)*is1+x-1];
-
-          /* Find the overlapping (clipped) polygon: */
-          numcrn=0; /* initialize it. */
-          gal_polygon_clip(ocrn, ncrn, pcrn, 4, ccrn, &numcrn);
-          area=gal_polygon_area(ccrn, numcrn);
-
-          /* Write each pixel's maximum coverage fraction if asked. */
-          if( maxfrac ) maxfrac[ind] = fmax(area, maxfrac[ind]);
-
-          /* Add the fractional value of this pixel. If this output
-             pixel covers a NaN pixel in the input grid, then
-             calculate the area of this NaN pixel to account for it
-             later. */
-          if( !isnan(v) )
-            {
-              numinput+=1;
-              filledarea+=area;
-              outputarr[ind]+=v*area;
-
-              /* Check
-                 printf("Check: numinput %zu filledarea %f "
-                 "outputarr[%zu]=%f\n",
-                 filledarea, ind, outputarr[ind]);
-              */
-            }
-        }
-    }
+  /* Check which input pixels we are covering. The areas of the overlap
+     with the pixels along each row are found together (in groups of
+     'WARP_WCSALIGN_ROW_CHUNK'). */
+  for(y=ystart;y<yend;++y)
+    for(x=xstart;x<xend;x+=nx)
+      {
+        nx = ( xend-x < WARP_WCSALIGN_ROW_CHUNK
+               ? xend-x : WARP_WCSALIGN_ROW_CHUNK );
+        gal_polygon_clip_area_row(ocrn, ncrn, x-0.5f, y-0.5f, nx, areas);
+        for(k=0;k<nx;++k)
+          {
+            /* Read the value of the input pixel. */
+            v=inputarr[(y-1)*is1+x+k-1];
+
+            /* Write each pixel's maximum coverage fraction if asked. */
+            if( maxfrac ) maxfrac[ind] = fmax(areas[k], maxfrac[ind]);
+
+            /* Add the fractional value of this pixel. If this output
+               pixel covers a NaN pixel in the input grid, then
+               calculate the area of this NaN pixel to account for it
+               later. */
+            if( !isnan(v) )
+              {
+                numinput+=1;
+                filledarea+=areas[k];
+                outputarr[ind]+=v*areas[k];
+              }
+          }
+      }
 
   /* Replace untouched pixels with NAN in the 'maxfrac' array. */
   if( maxfrac && maxfrac[ind]==-DBL_MAX ) maxfrac[ind]=NAN;
@@ -1066,6 +1453,7 @@ gal_warp_wcsalign_template()
   wa.nhor=GAL_BLANK_SIZE_T;
   wa.numthreads=GAL_BLANK_SIZE_T;
   wa.coveredfrac=GAL_BLANK_FLOAT64;
+  wa.wcsinterp=0.0f;
   wa.edgesampling=GAL_BLANK_SIZE_T;
 
   return wa;
@@ -39,13 +39,13 @@ main(int argc, char *argv[])
     }
 
   /* Read the image into memory. */
-  image=gal_fits_img_read(argv[1], argv[2], -1, 1);
+  image=gal_fits_img_read(argv[1], argv[2], 1, -1, 1);
 
   /* Let the user know. */
   printf("%s (hdu %s) is read into memory.\n", argv[1], argv[2]);
 
   /* Save the image in memory into another file. */
-  gal_fits_img_write(image, outname, NULL, "BuildProgram's Simpleio");
+  gal_fits_img_write(image, outname, NULL, "BuildProgram's Simpleio", 0);
 
   /* Let the user know. */
   printf("%s created.\n", outname);
@@ -0,0 +1,111 @@
+# Crop many objects from one image in image-mode and compare them with
+# separate crops of each object.
+#
+# See the Tests subsection of the manual for a complete explanation
+# (in the Installing gnuastro section).
+#
+# Original author:
+#     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+# Contributing author(s):
+# Copyright (C) 2022 Free Software Foundation, Inc.
+#
+# Copying and distribution of this file, with or without modification,
+# are permitted in any medium without royalty provided the copyright
+# notice and this notice are preserved.  This file is offered as-is,
+# without any warranty.
+
+
+
+
+
+# Preliminaries
+# =============
+#
+# Set the variables (The executable is in the build tree). Do the
+# basic checks to see if the executable is made or if the defaults
+# file exists (basicchecks.sh is in the source tree).
+prog=crop
+img=mkprofcat1.fits
+execname=../bin/$prog/ast$prog
+convertt=../bin/convertt/astconvertt
+cat=crop-imgbands.txt
+dir=crop-imgbands-catalog
+
+
+
+
+
+# Skip?
+# =====
+#
+# If the dependencies of the test don't exist, then skip it. There are two
+# types of dependencies:
+#
+#   - The executables were not made (for example due to a configure
+#     option),
+#
+#   - The input data was not made (for example the test that created the
+#     data file failed).
+if [ ! -f $execname  ]; then echo "$execname not created.";  exit 77; fi
+if [ ! -f $convertt  ]; then echo "$convertt not created.";  exit 77; fi
+if [ ! -f $img       ]; then echo "$img does not exist.";    exit 77; fi
+
+
+
+
+
+# Actual test script
+# ==================
+#
+# The crops of a catalog are sorted by their position and each thread
+# reads bands of the input image that are shared by several of its crops
+# (other crops are read directly from the input). Most of the crops below
+# are on a few neighboring rows (so they share bands), some are alone and
+# some are on the edges of the image or outside of it. Each crop of the
+# catalog must be identical to a separate crop of the same object (with no
+# catalog) and the same crops must be written.
+#
+# 'check_with_program' can be something like Valgrind or an empty
+# string. Such programs will execute the command if present and help in
+# debugging when the developer doesn't have access to the user's system.
+$AWK 'BEGIN{for(i=0;i<30;++i) print (i*137)%540-20, (i*7)%80+200;
+            print 250, 3; print 497, 498; print 100, 40; print 400, 420;
+            print 700, 700}' > $cat
+
+rm -rf $dir
+$mkdir_p $dir
+$check_with_program $execname $img --catalog=$cat --mode=img --width=21 \
+                              --coordcol=1 --coordcol=2 --numthreads=4  \
+                              --output=$dir/
+if [ $? != 0 ]; then exit 1; fi
+
+# Crop each object separately and compare the pixels.
+i=0
+ncompared=0
+for center in $(grep -v '^#' $cat | $AWK '{print $1","$2}'); do
+    i=$((i+1))
+    rm -f crop-imgbands-one.fits
+    $execname $img --mode=img --center=$center --width=21 \
+              --output=crop-imgbands-one.fits > /dev/null 2>&1
+    if [ -f crop-imgbands-one.fits ]; then
+        if [ ! -f $dir/${i}_cropped.fits ]; then
+            echo "Crop $i ($center) wasn't written with the catalog."
+            exit 1
+        fi
+        for f in crop-imgbands-one.fits $dir/${i}_cropped.fits; do
+            $convertt $f --output=crop-imgbands.txt
+            if [ $? != 0 ]; then exit 1; fi
+            grep -v '^#' crop-imgbands.txt > $f.pix
+        done
+        if ! cmp crop-imgbands-one.fits.pix $dir/${i}_cropped.fits.pix; then
+            echo "Crop $i ($center) is different with the catalog."
+            exit 1
+        fi
+        ncompared=$((ncompared+1))
+    elif [ -f $dir/${i}_cropped.fits ]; then
+        echo "Crop $i ($center) was only written with the catalog."
+        exit 1
+    fi
+done
+echo "$ncompared crops (out of $i) are identical."
+if [ $ncompared = 0 ]; then exit 1; fi
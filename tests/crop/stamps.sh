@@ -0,0 +1,116 @@
+# Write all the crops from a catalog into one file ('--stamps') and
+# compare them with the crops in separate files.
+#
+# See the Tests subsection of the manual for a complete explanation
+# (in the Installing gnuastro section).
+#
+# Original author:
+#     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+# Contributing author(s):
+# Copyright (C) 2022 Free Software Foundation, Inc.
+#
+# Copying and distribution of this file, with or without modification,
+# are permitted in any medium without royalty provided the copyright
+# notice and this notice are preserved.  This file is offered as-is,
+# without any warranty.
+
+
+
+
+
+# Preliminaries
+# =============
+#
+# Set the variables (The executable is in the build tree). Do the
+# basic checks to see if the executable is made or if the defaults
+# file exists (basicchecks.sh is in the source tree).
+prog=crop
+img=mkprofcat1.fits
+execname=../bin/$prog/ast$prog
+fitsprog=../bin/fits/astfits
+tableprog=../bin/table/asttable
+arithprog=../bin/arithmetic/astarithmetic
+cat=crop-stamps.txt
+dir=crop-stamps-individual
+
+
+
+
+
+# Skip?
+# =====
+#
+# If the dependencies of the test don't exist, then skip it. There are two
+# types of dependencies:
+#
+#   - The executables were not made (for example due to a configure
+#     option),
+#
+#   - The input data was not made (for example the test that created the
+#     data file failed).
+if [ ! -f $execname  ]; then echo "$execname not created.";  exit 77; fi
+if [ ! -f $fitsprog  ]; then echo "$fitsprog not created.";  exit 77; fi
+if [ ! -f $tableprog ]; then echo "$tableprog not created."; exit 77; fi
+if [ ! -f $arithprog ]; then echo "$arithprog not created."; exit 77; fi
+if [ ! -f $img       ]; then echo "$img does not exist.";    exit 77; fi
+
+
+
+
+
+# Actual test script
+# ==================
+#
+# The catalog has crops that are fully within the image, crops on its
+# edges and one crop that is fully outside of it (its stamp is blank, but
+# it has no separate file). So the number of stamps should be the number
+# of rows in the catalog and the sum of all the stamps should be the sum
+# of all the separate crops. '--noblank' should be rejected with
+# '--stamps'.
+#
+# 'check_with_program' can be something like Valgrind or an empty
+# string. Such programs will execute the command if present and help in
+# debugging when the developer doesn't have access to the user's system.
+$AWK 'BEGIN{for(i=0;i<25;++i) print (i*137)%500+1, (i*211)%500+1;
+            print 700, 700}' > $cat
+nrows=26
+
+$check_with_program $execname $img --catalog=$cat --mode=img --width=41 \
+                              --coordcol=1 --coordcol=2 --numthreads=4  \
+                              --stamps=cube --output=crop-stamps.fits
+if [ $? != 0 ]; then exit 1; fi
+
+$check_with_program $execname $img --catalog=$cat --mode=img --width=41 \
+                              --coordcol=1 --coordcol=2 --numthreads=4  \
+                              --stamps=table --output=crop-stamps-table.fits
+if [ $? != 0 ]; then exit 1; fi
+
+rm -rf $dir
+$mkdir_p $dir
+$check_with_program $execname $img --catalog=$cat --mode=img --width=41 \
+                              --coordcol=1 --coordcol=2 --numthreads=4  \
+                              --output=$dir/
+if [ $? != 0 ]; then exit 1; fi
+
+if $execname $img --catalog=$cat --mode=img --width=41 --coordcol=1 \
+             --coordcol=2 --stamps=cube --noblank \
+             --output=crop-stamps-noblank.fits; then
+    echo "'--noblank' was not rejected with '--stamps'."
+    exit 1
+fi
+
+# Number of stamps.
+n3=$($fitsprog crop-stamps.fits -h1 --keyvalue=NAXIS3 -q)
+ntable=$($tableprog crop-stamps-table.fits -h1 -cID | wc -l)
+if [ $n3 != $nrows ] || [ $ntable != $nrows ]; then
+    echo "Number of stamps: $n3 (cube), $ntable (table), expected $nrows"
+    exit 1
+fi
+
+# Sum of the pixels.
+stampsum=$($arithprog crop-stamps.fits sumvalue -h1)
+cropsum=$(for f in $dir/*.fits; do $arithprog $f sumvalue -h1; done \
+              | $AWK '{s+=$1} END{printf "%.10g", s}')
+echo "Sum of stamps: $stampsum, sum of crops: $cropsum"
+echo $stampsum $cropsum \
+    | $AWK '{d=$1-$2; if(d<0) d=-d; exit (d<=1e-5*$2 ? 0 : 1)}'
@@ -0,0 +1,118 @@
+# Crop many objects from several images in WCS-mode and compare them with
+# separate crops of each object.
+#
+# See the Tests subsection of the manual for a complete explanation
+# (in the Installing gnuastro section).
+#
+# Original author:
+#     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+# Contributing author(s):
+# Copyright (C) 2022 Free Software Foundation, Inc.
+#
+# Copying and distribution of this file, with or without modification,
+# are permitted in any medium without royalty provided the copyright
+# notice and this notice are preserved.  This file is offered as-is,
+# without any warranty.
+
+
+
+
+
+# Preliminaries
+# =============
+#
+# Set the variables (The executable is in the build tree). Do the
+# basic checks to see if the executable is made or if the defaults
+# file exists (basicchecks.sh is in the source tree).
+prog=crop
+img="mkprofcat1.fits mkprofcat2.fits mkprofcat3.fits mkprofcat4.fits"
+execname=../bin/$prog/ast$prog
+tableprog=../bin/table/asttable
+convertt=../bin/convertt/astconvertt
+cat=crop-wcsindex.txt
+dir=crop-wcsindex-catalog
+
+
+
+
+
+# Skip?
+# =====
+#
+# If the dependencies of the test don't exist, then skip it. There are two
+# types of dependencies:
+#
+#   - The executables were not made (for example due to a configure
+#     option),
+#
+#   - The input data was not made (for example the test that created the
+#     data file failed).
+if [ ! -f $execname  ]; then echo "$execname not created.";  exit 77; fi
+if [ ! -f $tableprog ]; then echo "$tableprog not created."; exit 77; fi
+if [ ! -f $convertt  ]; then echo "$convertt not created.";  exit 77; fi
+for fn in $img; do
+    if [ ! -f $fn ]; then echo "$fn doesn't exist."; exit 77; fi;
+done
+
+
+
+
+
+# Actual test script
+# ==================
+#
+# The crops of a catalog are done with an index of the input images over
+# declination (only the images whose declination range overlaps with a
+# crop are checked), they are sorted over the index and each thread keeps
+# its recently used input images open. The crops are placed on a grid
+# that covers all the input images and their borders (so some crops are
+# stitched from several images and some are outside all of them). Each
+# crop of the catalog must be identical to a separate crop of the same
+# object (with no catalog) and the same crops must be written.
+#
+# 'check_with_program' can be something like Valgrind or an empty
+# string. Such programs will execute the command if present and help in
+# debugging when the developer doesn't have access to the user's system.
+$AWK 'BEGIN{for(y=-40;y<1100;y+=180) for(x=-40;x<1100;x+=180)
+              print x, y}' > crop-wcsindex-pix.txt
+$tableprog crop-wcsindex-pix.txt -c'arith $1 $2 img-to-wcs' \
+           --wcsfile=mkprofcat1.fits --wcshdu=1 --output=$cat
+if [ $? != 0 ]; then exit 1; fi
+
+rm -rf $dir
+$mkdir_p $dir
+$check_with_program $execname $img --catalog=$cat --mode=wcs       \
+                              --coordcol=1 --coordcol=2 --width=3/3600 \
+                              --numthreads=4 --output=$dir/
+if [ $? != 0 ]; then exit 1; fi
+
+# Crop each object separately and compare the pixels.
+i=0
+ncompared=0
+for center in $(grep -v '^#' $cat | $AWK '{print $1","$2}'); do
+    i=$((i+1))
+    rm -f crop-wcsindex-one.fits
+    $execname $img --mode=wcs --center=$center --width=3/3600 \
+              --output=crop-wcsindex-one.fits > /dev/null 2>&1
+    if [ -f crop-wcsindex-one.fits ]; then
+        if [ ! -f $dir/${i}_cropped.fits ]; then
+            echo "Crop $i ($center) wasn't written with the catalog."
+            exit 1
+        fi
+        for f in crop-wcsindex-one.fits $dir/${i}_cropped.fits; do
+            $convertt $f --output=crop-wcsindex.txt
+            if [ $? != 0 ]; then exit 1; fi
+            grep -v '^#' crop-wcsindex.txt > $f.pix
+        done
+        if ! cmp crop-wcsindex-one.fits.pix $dir/${i}_cropped.fits.pix; then
+            echo "Crop $i ($center) is different with the catalog."
+            exit 1
+        fi
+        ncompared=$((ncompared+1))
+    elif [ -f $dir/${i}_cropped.fits ]; then
+        echo "Crop $i ($center) was only written with the catalog."
+        exit 1
+    fi
+done
+echo "$ncompared crops (out of $i) are identical."
+if [ $ncompared = 0 ]; then exit 1; fi
@@ -0,0 +1,220 @@
+/*********************************************************************
+A test program for writing tile-compressed FITS images and reading them
+in parallel.
+
+Original author:
+     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+Contributing author(s):
+Copyright (C) 2022 Free Software Foundation, Inc.
+
+Gnuastro is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+Gnuastro is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
+**********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gnuastro/fits.h"
+#include "gnuastro/blank.h"
+#include "gnuastro/pointer.h"
+
+
+/* Name of the output ('.fz' is the conventional suffix of tile-compressed
+   images, it doesn't affect the writing). */
+#define FILENAME "fits-compress.fits.fz"
+
+/* Number of threads to read the images with. */
+#define NUMTHREADS 4
+
+
+
+
+
+/* Value of the pixel at (x, y). Each group of four rows has different
+   properties for the compression: constant (all differences are zero),
+   random over the full range of the type, a slow ramp and low-level
+   noise. Some pixels are also blank. */
+static uint64_t
+pixel_value(size_t x, size_t y, uint64_t *seed)
+{
+  *seed = *seed * 6364136223846793005ULL + 1442695040888963407ULL;
+  switch(y%4)
+    {
+    case 0:  return 7;
+    case 1:  return *seed;
+    case 2:  return x*3+y;
+    default: return *seed>>60;
+    }
+}
+
+
+
+
+
+/* Make an integer image of the given type and size. */
+static gal_data_t *
+make_image(uint8_t type, size_t ndim, size_t *dsize)
+{
+  size_t i, width;
+  uint64_t v, seed=1;
+  gal_data_t *img=gal_data_alloc(NULL, type, ndim, dsize, NULL, 0, -1, 1,
+                                 NULL, NULL, NULL);
+
+  width=dsize[ndim-1];
+  for(i=0;i<img->size;++i)
+    {
+      v=pixel_value(i%width, i/width, &seed);
+      switch(type)
+        {
+        case GAL_TYPE_UINT8:  ((uint8_t  *)(img->array))[i]=v; break;
+        case GAL_TYPE_INT8:   ((int8_t   *)(img->array))[i]=v; break;
+        case GAL_TYPE_UINT16: ((uint16_t *)(img->array))[i]=v; break;
+        case GAL_TYPE_INT16:  ((int16_t  *)(img->array))[i]=v; break;
+        case GAL_TYPE_UINT32: ((uint32_t *)(img->array))[i]=v; break;
+        case GAL_TYPE_INT32:  ((int32_t  *)(img->array))[i]=v; break;
+        case GAL_TYPE_UINT64: ((uint64_t *)(img->array))[i]=v; break;
+        case GAL_TYPE_INT64:  ((int64_t  *)(img->array))[i]=v; break;
+        }
+      if( (i%width + i/width)%13==0 )
+        gal_blank_write(gal_pointer_increment(img->array, i, type), type);
+    }
+  return img;
+}
+
+
+
+
+
+/* Read the image directly with CFITSIO (not with Gnuastro's parallel
+   decompression) to make sure that it is compressed and that it is read
+   correctly by other programs. The blank pixels are identified by the
+   BLANK keyword, and replaced by Gnuastro's blank value for the type. */
+static gal_data_t *
+read_with_cfitsio(gal_data_t *img)
+{
+  void *blank;
+  fitsfile *fptr;
+  gal_data_t *out;
+  long fpixel[3]={1,1,1};
+  int anynul=0, status=0;
+
+  out=gal_data_alloc(NULL, img->type, img->ndim, img->dsize, NULL, 0, -1,
+                     1, NULL, NULL, NULL);
+  blank=gal_blank_alloc_write(img->type);
+  fits_open_file(&fptr, FILENAME"[1]", READONLY, &status);
+  if( fits_is_compressed_image(fptr, &status)==0 && status==0 )
+    {
+      fprintf(stderr, "%s: image isn't tile-compressed\n",
+              gal_type_name(img->type, 1));
+      fits_close_file(fptr, &status);
+      free(blank);
+      gal_data_free(out);
+      return NULL;
+    }
+  fits_read_pix(fptr, gal_fits_type_to_datatype(img->type), fpixel,
+                out->size, blank, out->array, &anynul, &status);
+  fits_close_file(fptr, &status);
+  free(blank);
+  if(status)
+    {
+      fits_report_error(stderr, status);
+      gal_data_free(out);
+      return NULL;
+    }
+  if(anynul==0)
+    {
+      fprintf(stderr, "%s: CFITSIO found no blank pixels\n",
+              gal_type_name(img->type, 1));
+      gal_data_free(out);
+      return NULL;
+    }
+  return out;
+}
+
+
+
+
+
+/* Compare the pixels of the two images. */
+static int
+check_same(gal_data_t *img, gal_data_t *read, char *how)
+{
+  if(read==NULL) return 0;
+  if( read->type!=img->type || read->size!=img->size
+      || memcmp(read->array, img->array,
+                img->size*gal_type_sizeof(img->type)) )
+    {
+      fprintf(stderr, "%s (%zu dimensions): different pixels when read "
+              "%s\n", gal_type_name(img->type, 1), img->ndim, how);
+      gal_data_free(read);
+      return 0;
+    }
+  gal_data_free(read);
+  return 1;
+}
+
+
+
+
+
+/* Write the image as a tile-compressed file and read it back. */
+static int
+check_type(uint8_t type, size_t ndim, size_t *dsize)
+{
+  int out=1;
+  gal_data_t *img=make_image(type, ndim, dsize);
+
+  /* Write the image (the output must not exist or the image will be
+     appended to it). */
+  remove(FILENAME);
+  gal_fits_img_write(img, FILENAME, NULL, NULL, 1);
+
+  /* Read it back on one and multiple threads and with CFITSIO. */
+  if( check_same(img, gal_fits_img_read(FILENAME, "1", 1, -1, 1),
+                 "on one thread")==0
+      || check_same(img, gal_fits_img_read(FILENAME, "1", NUMTHREADS,
+                                           -1, 1),
+                    "on multiple threads")==0
+      || check_same(img, read_with_cfitsio(img), "with CFITSIO")==0 )
+    out=0;
+
+  /* Clean up and return. */
+  gal_data_free(img);
+  return out;
+}
+
+
+
+
+
+int
+main(void)
+{
+  size_t i;
+  size_t dsize2[2]={45, 61}, dsize3[3]={3, 9, 35};
+  uint8_t types[]={GAL_TYPE_UINT8,  GAL_TYPE_INT8,  GAL_TYPE_UINT16,
+                   GAL_TYPE_INT16,  GAL_TYPE_UINT32, GAL_TYPE_INT32,
+                   GAL_TYPE_UINT64, GAL_TYPE_INT64};
+
+  /* CFITSIO can't Rice-compress the 64-bit types (they are compressed
+     with GZIP), but they should also be read correctly. */
+  for(i=0;i<sizeof types/sizeof *types;++i)
+    if( check_type(types[i], 2, dsize2)==0
+        || check_type(types[i], 3, dsize3)==0 )
+      return EXIT_FAILURE;
+
+  /* Clean up and return. */
+  remove(FILENAME);
+  printf("Tile-compressed images are written and read correctly.\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,148 @@
+/*********************************************************************
+A test program for reading FITS images by directly mapping them into
+memory.
+
+Original author:
+     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+Contributing author(s):
+Copyright (C) 2022 Free Software Foundation, Inc.
+
+Gnuastro is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+Gnuastro is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
+**********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gnuastro/fits.h"
+#include "gnuastro/blank.h"
+#include "gnuastro/pointer.h"
+
+
+/* Name of the output. */
+#define FILENAME "fits-map.fits"
+
+/* Number of threads to read the images with. */
+#define NUMTHREADS 4
+
+
+
+
+
+/* Make an image of the given type with some blank pixels. */
+static gal_data_t *
+make_image(uint8_t type)
+{
+  size_t i, dsize[2]={37, 101};
+  gal_data_t *img=gal_data_alloc(NULL, type, 2, dsize, NULL, 0, -1, 1,
+                                 NULL, NULL, NULL);
+
+  for(i=0;i<img->size;++i)
+    switch(type)
+      {
+      case GAL_TYPE_UINT8:   ((uint8_t  *)(img->array))[i]=i%200;     break;
+      case GAL_TYPE_UINT16:  ((uint16_t *)(img->array))[i]=i*7;       break;
+      case GAL_TYPE_INT16:   ((int16_t  *)(img->array))[i]=i*7-1000;  break;
+      case GAL_TYPE_INT32:   ((int32_t  *)(img->array))[i]=i*i-5000;  break;
+      case GAL_TYPE_INT64:   ((int64_t  *)(img->array))[i]=i*i*i-9;   break;
+      case GAL_TYPE_FLOAT32: ((float    *)(img->array))[i]=i/3.0f;    break;
+      case GAL_TYPE_FLOAT64: ((double   *)(img->array))[i]=-(i/7.0);  break;
+      }
+  for(i=0;i<img->size;i+=17)
+    gal_blank_write(gal_pointer_increment(img->array, i, type), type);
+  return img;
+}
+
+
+
+
+
+/* Compare the pixels of the two images. */
+static int
+check_same(gal_data_t *img, gal_data_t *read, char *how)
+{
+  if( read->type!=img->type || read->size!=img->size
+      || memcmp(read->array, img->array,
+                img->size*gal_type_sizeof(img->type)) )
+    {
+      fprintf(stderr, "%s: different pixels when read %s\n",
+              gal_type_name(img->type, 1), how);
+      return 0;
+    }
+  return 1;
+}
+
+
+
+
+
+/* Write the image, read it by mapping and compare it with the input. The
+   'mapped' argument is 1 when the image should be mapped and 0 when it
+   can't be (so it should be read normally). */
+static int
+check_type(uint8_t type, int mapped)
+{
+  int out=1;
+  gal_data_t *read, *again, *img=make_image(type);
+
+  /* Write the image (the output must not exist or the image will be
+     appended to it). */
+  remove(FILENAME);
+  gal_fits_img_write(img, FILENAME, NULL, NULL, 0);
+
+  /* Read it by mapping, check if it was mapped and compare the values. */
+  read=gal_fits_img_read_map(FILENAME, "1", NUMTHREADS, -1, 1);
+  if( gal_pointer_mmap_file_is(read->array)!=mapped )
+    {
+      fprintf(stderr, "%s: image was%s mapped\n", gal_type_name(type, 1),
+              mapped ? " not" : "");
+      out=0;
+    }
+  if( check_same(img, read, "by mapping")==0 ) out=0;
+
+  /* Changing the mapped array must not change the file. */
+  memset(read->array, 0, read->size*gal_type_sizeof(type));
+  again=gal_fits_img_read(FILENAME, "1", 1, -1, 1);
+  if( check_same(img, again, "after changing the mapped array")==0 )
+    out=0;
+
+  /* Clean up and return ('gal_data_free' should un-map the array). */
+  gal_data_free(again);
+  gal_data_free(read);
+  gal_data_free(img);
+  return out;
+}
+
+
+
+
+
+int
+main(void)
+{
+  /* Unsigned 16-bit types are stored with 'BZERO' in FITS, so they can't
+     be mapped (but they should still be read correctly). */
+  if( check_type(GAL_TYPE_UINT8,   1)==0
+      || check_type(GAL_TYPE_INT16,   1)==0
+      || check_type(GAL_TYPE_INT32,   1)==0
+      || check_type(GAL_TYPE_INT64,   1)==0
+      || check_type(GAL_TYPE_FLOAT32, 1)==0
+      || check_type(GAL_TYPE_FLOAT64, 1)==0
+      || check_type(GAL_TYPE_UINT16,  0)==0 )
+    return EXIT_FAILURE;
+
+  /* Clean up and return. */
+  remove(FILENAME);
+  printf("Mapped FITS images are read correctly.\n");
+  return EXIT_SUCCESS;
+}
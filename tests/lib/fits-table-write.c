@@ -0,0 +1,247 @@
+/*********************************************************************
+A test program for writing FITS binary tables row-by-row in parallel.
+
+Original author:
+     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+Contributing author(s):
+Copyright (C) 2022 Free Software Foundation, Inc.
+
+Gnuastro is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+Gnuastro is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
+**********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gnuastro/fits.h"
+#include "gnuastro/list.h"
+#include "gnuastro/blank.h"
+#include "gnuastro/table.h"
+#include "gnuastro/pointer.h"
+
+
+/* Name of the outputs. */
+#define FILENAME1 "fits-table-write-1.fits"
+#define FILENAMEN "fits-table-write-n.fits"
+
+/* Number of rows and threads. */
+#define NUMROWS    10007
+#define NUMTHREADS 4
+
+
+
+
+
+/* Add a numeric column of the given type to the list. When 'withblank' is
+   zero, no element will be blank. */
+static void
+add_column(gal_data_t **cols, uint8_t type, size_t ndim, int withblank,
+           char *name)
+{
+  void *p;
+  size_t i;
+  uint64_t v, seed=type;
+  size_t dsize[2]={NUMROWS, 3};
+  gal_data_t *col;
+
+  gal_list_data_add_alloc(cols, NULL, type, ndim, dsize, NULL, 0, -1, 1,
+                          name, NULL, NULL);
+  col=*cols;
+  for(i=0;i<col->size;++i)
+    {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      v = i%3 ? seed : seed>>(seed%64);
+      p=gal_pointer_increment(col->array, i, type);
+      switch(type)
+        {
+        case GAL_TYPE_UINT8:   *(uint8_t  *)p=v;                   break;
+        case GAL_TYPE_INT8:    *(int8_t   *)p=v;                   break;
+        case GAL_TYPE_UINT16:  *(uint16_t *)p=v;                   break;
+        case GAL_TYPE_INT16:   *(int16_t  *)p=v;                   break;
+        case GAL_TYPE_UINT32:  *(uint32_t *)p=v;                   break;
+        case GAL_TYPE_INT32:   *(int32_t  *)p=v;                   break;
+        case GAL_TYPE_UINT64:  *(uint64_t *)p=v;                   break;
+        case GAL_TYPE_INT64:   *(int64_t  *)p=v;                   break;
+        case GAL_TYPE_FLOAT32: *(float    *)p=(v>>40)/1024.0f-8e3; break;
+        case GAL_TYPE_FLOAT64: *(double   *)p=(v>>11)/1e9-4e6;     break;
+        }
+      if(withblank ? i%11==0 : gal_blank_is(p, type))
+        {
+          if(withblank) gal_blank_write(p, type);
+          else          memset(p, 0, gal_type_sizeof(type));
+        }
+    }
+}
+
+
+
+
+
+/* Make the table. The columns of 'int8', 'uint16' and 'uint32' that
+   contain blank values are written by CFITSIO (after the other columns
+   are written directly), so there is one of each. */
+static gal_data_t *
+make_table(void)
+{
+  size_t i, j;
+  char **strarr;
+  size_t dsize=NUMROWS;
+  gal_data_t *cols=NULL;
+
+  add_column(&cols, GAL_TYPE_UINT32,  1, 1, "U32BLANK");
+  add_column(&cols, GAL_TYPE_FLOAT64, 1, 1, "F64");
+  add_column(&cols, GAL_TYPE_INT16,   2, 0, "I16VEC");
+
+  /* String column. */
+  gal_list_data_add_alloc(&cols, NULL, GAL_TYPE_STRING, 1, &dsize, NULL, 0,
+                          -1, 1, "STRING", NULL, NULL);
+  strarr=cols->array;
+  for(i=0;i<NUMROWS;++i)
+    {
+      strarr[i]=gal_pointer_allocate(GAL_TYPE_UINT8, i%9+2, 0, __func__,
+                                     "strarr[i]");
+      for(j=0;j<i%9+1;++j) strarr[i][j]='a'+(i+j)%26;
+      strarr[i][j]='\0';
+    }
+
+  add_column(&cols, GAL_TYPE_FLOAT32, 1, 1, "F32");
+  add_column(&cols, GAL_TYPE_INT64,   1, 1, "I64");
+  add_column(&cols, GAL_TYPE_INT32,   1, 1, "I32");
+  add_column(&cols, GAL_TYPE_UINT32,  1, 0, "U32");
+  add_column(&cols, GAL_TYPE_INT16,   1, 1, "I16");
+  add_column(&cols, GAL_TYPE_UINT16,  1, 1, "U16BLANK");
+  add_column(&cols, GAL_TYPE_UINT16,  1, 0, "U16");
+  add_column(&cols, GAL_TYPE_INT8,    1, 1, "I8BLANK");
+  add_column(&cols, GAL_TYPE_INT8,    1, 0, "I8");
+  add_column(&cols, GAL_TYPE_UINT8,   1, 1, "U8");
+  return cols;
+}
+
+
+
+
+
+/* Read all the bytes of the table's data (or NULL). When 'rewrite' is
+   non-zero, the data are first over-written by CFITSIO, one column at a
+   time (like Gnuastro did before the rows were written directly). */
+static unsigned char *
+read_table_bytes(char *filename, gal_data_t *cols, int rewrite,
+                 size_t *numbytes)
+{
+  void *blank;
+  size_t colnum;
+  fitsfile *fptr;
+  long naxis1, naxis2;
+  gal_data_t *col;
+  int status=0;
+  unsigned char *out;
+  char name[100];
+
+  /* Open the table and read its size. */
+  sprintf(name, "%s[1]", filename);
+  fits_open_file(&fptr, name, rewrite ? READWRITE : READONLY, &status);
+  fits_read_key(fptr, TLONG, "NAXIS1", &naxis1, NULL, &status);
+  fits_read_key(fptr, TLONG, "NAXIS2", &naxis2, NULL, &status);
+  if(status) { fits_report_error(stderr, status); return NULL; }
+  *numbytes=naxis1*naxis2;
+
+  /* Over-write the data with zeros, then write the columns with
+     CFITSIO. Blank values are only given to CFITSIO for the types that
+     aren't native to FITS tables (that have 'TZERO'). */
+  if(rewrite)
+    {
+      out=gal_pointer_allocate(GAL_TYPE_UINT8, *numbytes, 1, __func__,
+                               "out");
+      fits_write_tblbytes(fptr, 1, 1, *numbytes, out, &status);
+      free(out);
+      colnum=1;
+      for(col=cols; col!=NULL; col=col->next)
+        {
+          blank = ( ( col->type==GAL_TYPE_INT8
+                      || col->type==GAL_TYPE_UINT16
+                      || col->type==GAL_TYPE_UINT32 )
+                    && gal_blank_present(col, 0)
+                    ? gal_blank_alloc_write(col->type)
+                    : NULL );
+          fits_write_colnull(fptr, gal_fits_type_to_datatype(col->type),
+                             colnum++, 1, 1, col->size, col->array, blank,
+                             &status);
+          free(blank);
+        }
+    }
+
+  /* Read the bytes. */
+  out=gal_pointer_allocate(GAL_TYPE_UINT8, *numbytes, 0, __func__, "out");
+  fits_read_tblbytes(fptr, 1, 1, *numbytes, out, &status);
+  fits_close_file(fptr, &status);
+  if(status)
+    {
+      fits_report_error(stderr, status);
+      free(out);
+      return NULL;
+    }
+  return out;
+}
+
+
+
+
+
+int
+main(void)
+{
+  int out=1;
+  gal_data_t *cols=make_table();
+  size_t size1=0, sizen=0, sizec=0;
+  unsigned char *bytes1, *bytesn, *bytesc;
+
+  /* Write the table on one and multiple threads. */
+  remove(FILENAME1);
+  remove(FILENAMEN);
+  gal_fits_tab_write(cols, NULL, GAL_TABLE_FORMAT_BFITS, FILENAME1,
+                     "TABLE", NULL, 1);
+  gal_fits_tab_write(cols, NULL, GAL_TABLE_FORMAT_BFITS, FILENAMEN,
+                     "TABLE", NULL, NUMTHREADS);
+
+  /* Read the bytes of the tables, then over-write the second with
+     CFITSIO and read its bytes again. */
+  bytes1=read_table_bytes(FILENAME1, cols, 0, &size1);
+  bytesn=read_table_bytes(FILENAMEN, cols, 0, &sizen);
+  bytesc=read_table_bytes(FILENAMEN, cols, 1, &sizec);
+
+  /* Compare the bytes. */
+  if(bytes1==NULL || bytesn==NULL || bytesc==NULL) out=0;
+  else if( sizen!=size1 || memcmp(bytes1, bytesn, size1) )
+    {
+      fprintf(stderr, "Tables on one and multiple threads are "
+              "different\n");
+      out=0;
+    }
+  else if( sizec!=size1 || memcmp(bytes1, bytesc, size1) )
+    {
+      fprintf(stderr, "Table is different from the table written by "
+              "CFITSIO (one column at a time)\n");
+      out=0;
+    }
+
+  /* Clean up and return. */
+  free(bytes1);
+  free(bytesn);
+  free(bytesc);
+  gal_list_data_free(cols);
+  if(out==0) return EXIT_FAILURE;
+  remove(FILENAME1);
+  remove(FILENAMEN);
+  printf("FITS binary tables are written correctly.\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,198 @@
+/*********************************************************************
+A test program for the nearest-neighbor interpolation of blank elements
+('gal_interpolate_neighbors').
+
+Original author:
+     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+Contributing author(s):
+Copyright (C) 2022 Free Software Foundation, Inc.
+
+Gnuastro is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+Gnuastro is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
+**********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gnuastro/data.h"
+#include "gnuastro/list.h"
+#include "gnuastro/tile.h"
+#include "gnuastro/blank.h"
+#include "gnuastro/pointer.h"
+#include "gnuastro/interpolate.h"
+
+
+/* Size of the dataset. */
+#define NUMROWS 40
+#define NUMCOLS 52
+
+/* Number of neighbors and threads for the interpolation. */
+#define NUMNGB     9
+#define NUMTHREADS 4
+
+
+
+
+
+/* Make a list of two datasets (32-bit floating point and 32-bit integer)
+   with the same blank elements: a large rectangular blank region and
+   scattered blank elements. */
+static gal_data_t *
+make_data(void)
+{
+  uint64_t r, seed=1;
+  size_t i, x, y, dsize[2]={NUMROWS, NUMCOLS};
+  gal_data_t *in=gal_data_alloc(NULL, GAL_TYPE_FLOAT32, 2, dsize, NULL, 0,
+                                -1, 1, NULL, NULL, NULL);
+  in->next=gal_data_alloc(NULL, GAL_TYPE_INT32, 2, dsize, NULL, 0, -1, 1,
+                          NULL, NULL, NULL);
+
+  for(i=0;i<in->size;++i)
+    {
+      y=i/NUMCOLS;
+      x=i%NUMCOLS;
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      r = seed>>33;
+      if( (y>5 && y<25 && x>10 && x<35) || r%7==0 )
+        {
+          ((float   *)(in->array))[i]       = GAL_BLANK_FLOAT32;
+          ((int32_t *)(in->next->array))[i] = GAL_BLANK_INT32;
+        }
+      else
+        {
+          ((float   *)(in->array))[i]       = r/2147483648.0f;
+          ((int32_t *)(in->next->array))[i] = r%1000;
+        }
+    }
+  return in;
+}
+
+
+
+
+
+/* Compare the outputs. */
+static int
+check_same(gal_data_t *a, gal_data_t *b, char *what)
+{
+  gal_data_t *ta, *tb;
+
+  for(ta=a, tb=b; ta!=NULL && tb!=NULL; ta=ta->next, tb=tb->next)
+    if( memcmp(ta->array, tb->array, ta->size*gal_type_sizeof(ta->type)) )
+      {
+        fprintf(stderr, "%s: %s\n", gal_type_name(ta->type, 1), what);
+        return 0;
+      }
+  return 1;
+}
+
+
+
+
+
+/* Interpolate the blank elements on one and multiple threads and compare
+   them with each other and with the interpolation of all the elements
+   (where each element's neighbors are found independently, without the
+   copying of the input or the list of blank elements). */
+static int
+check_interpolation(gal_data_t *in, struct gal_tile_two_layer_params *tl,
+                    uint8_t metric, int function, char *what)
+{
+  size_t i;
+  int out=1;
+  void *inp, *onep;
+  gal_data_t *tin, *tone, *tall;
+  gal_data_t *one, *multi, *all;
+
+  /* Do the three interpolations. */
+  one  =gal_interpolate_neighbors(in, tl, metric, NUMNGB, 1, 1, 1,
+                                  function);
+  multi=gal_interpolate_neighbors(in, tl, metric, NUMNGB, NUMTHREADS, 1,
+                                  1, function);
+  all  =gal_interpolate_neighbors(in, tl, metric, NUMNGB, NUMTHREADS, 0,
+                                  1, function);
+
+  /* The number of threads shouldn't affect the result. */
+  if( check_same(one, multi, "different result on multiple threads")==0 )
+    out=0;
+
+  /* Non-blank elements should be the same as the input and blank elements
+     should be the same as the interpolation of all the elements. */
+  else
+    for(tin=in, tone=one, tall=all; tin!=NULL;
+        tin=tin->next, tone=tone->next, tall=tall->next)
+      {
+        for(i=0;i<tin->size;++i)
+          {
+            inp=gal_pointer_increment(tin->array, i, tin->type);
+            onep=gal_pointer_increment(tone->array, i, tin->type);
+            if( memcmp(onep,
+                       ( gal_blank_is(inp, tin->type)
+                         ? gal_pointer_increment(tall->array, i, tin->type)
+                         : inp ),
+                       gal_type_sizeof(tin->type)) )
+              {
+                fprintf(stderr, "%s: %s: element %zu is different from "
+                        "the interpolation of all elements\n",
+                        gal_type_name(tin->type, 1), what, i);
+                out=0;
+                break;
+              }
+          }
+        if(out==0) break;
+      }
+
+  /* Clean up and return. */
+  gal_list_data_free(one);
+  gal_list_data_free(multi);
+  gal_list_data_free(all);
+  return out;
+}
+
+
+
+
+
+int
+main(void)
+{
+  struct gal_tile_two_layer_params tl;
+  size_t numtilesinch[2]={NUMROWS, NUMCOLS/2};
+  gal_data_t *in=make_data();
+
+  /* Interpolate over the full dataset. */
+  if( check_interpolation(in, NULL, GAL_INTERPOLATE_NEIGHBORS_METRIC_RADIAL,
+                          GAL_INTERPOLATE_NEIGHBORS_FUNC_MEDIAN,
+                          "radial median")==0
+      || check_interpolation(in, NULL,
+                             GAL_INTERPOLATE_NEIGHBORS_METRIC_MANHATTAN,
+                             GAL_INTERPOLATE_NEIGHBORS_FUNC_MEAN,
+                             "manhattan mean")==0 )
+    return EXIT_FAILURE;
+
+  /* Interpolate the values of two channels independently (the values of
+     each channel are contiguous in memory). */
+  memset(&tl, 0, sizeof tl);
+  tl.totchannels=2;
+  tl.numtilesinch=numtilesinch;
+  tl.tottilesinch=numtilesinch[0]*numtilesinch[1];
+  if( check_interpolation(in, &tl, GAL_INTERPOLATE_NEIGHBORS_METRIC_RADIAL,
+                          GAL_INTERPOLATE_NEIGHBORS_FUNC_MIN,
+                          "radial minimum on channels")==0 )
+    return EXIT_FAILURE;
+
+  /* Clean up and return. */
+  gal_list_data_free(in);
+  printf("Blank elements are interpolated correctly.\n");
+  return EXIT_SUCCESS;
+}
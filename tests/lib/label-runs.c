@@ -0,0 +1,127 @@
+/*********************************************************************
+A test program for the runs of each label ('gal_label_runs').
+
+Original author:
+     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+Contributing author(s):
+Copyright (C) 2022 Free Software Foundation, Inc.
+
+Gnuastro is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+Gnuastro is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
+**********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "gnuastro/data.h"
+#include "gnuastro/label.h"
+
+
+/* Size of the labeled image and the number of labels. */
+#define NUMROWS 23
+#define NUMCOLS 37
+#define NUMLABS 5
+
+
+
+
+
+/* Build a labeled image with some blank and undetected elements: the
+   labels are constant along short horizontal segments, so some runs end
+   at the end of a row and the next row starts with the same label. */
+static gal_data_t *
+make_labels(void)
+{
+  size_t i, dsize[2]={NUMROWS, NUMCOLS};
+  gal_data_t *labels=gal_data_alloc(NULL, GAL_TYPE_INT32, 2, dsize, NULL,
+                                    0, -1, 1, NULL, NULL, NULL);
+  int32_t *l=labels->array;
+
+  for(i=0;i<labels->size;++i)
+    l[i] = ( (i*7)%13==0
+             ? GAL_BLANK_INT32
+             : (int32_t)( (i/5 * 2654435761u) % (NUMLABS+1) ) );
+  return labels;
+}
+
+
+
+
+
+/* Check the runs of every label with a direct parsing of the image: each
+   labeled element must be in exactly one run of its label, the runs must
+   be sorted, not cross a row and be as long as possible. */
+int
+main(void)
+{
+  int32_t *l;
+  size_t lab, i, j, start, len, *r, nruns, count;
+  gal_data_t *labels=make_labels(), *runs;
+
+  runs=gal_label_runs(labels, NUMLABS, -1, 1);
+  l=labels->array;
+  for(lab=1;lab<=NUMLABS;++lab)
+    {
+      /* All the runs of this label. */
+      count=0;
+      r=runs[lab].array;
+      nruns=runs[lab].size/2;
+      for(i=0;i<nruns;++i)
+        {
+          start=r[2*i];
+          len=r[2*i+1];
+          if( len==0
+              || start/NUMCOLS != (start+len-1)/NUMCOLS
+              || (i && start<=r[2*i-2]) )
+            {
+              fprintf(stderr, "label %zu: bad run %zu (%zu, %zu)\n",
+                      lab, i, start, len);
+              return EXIT_FAILURE;
+            }
+          for(j=start;j<start+len;++j)
+            if(l[j]!=(int32_t)lab)
+              {
+                fprintf(stderr, "label %zu: element %zu has label %d\n",
+                        lab, j, l[j]);
+                return EXIT_FAILURE;
+              }
+          if( start%NUMCOLS && l[start-1]==(int32_t)lab )
+            {
+              fprintf(stderr, "label %zu: run %zu doesn't start at the "
+                      "first element\n", lab, i);
+              return EXIT_FAILURE;
+            }
+          if( (start+len)%NUMCOLS && l[start+len]==(int32_t)lab )
+            {
+              fprintf(stderr, "label %zu: run %zu doesn't finish at the "
+                      "last element\n", lab, i);
+              return EXIT_FAILURE;
+            }
+          count+=len;
+        }
+
+      /* The total number of elements in the runs. */
+      for(i=0;i<labels->size;++i) if(l[i]==(int32_t)lab) --count;
+      if(count)
+        {
+          fprintf(stderr, "label %zu: wrong number of elements\n", lab);
+          return EXIT_FAILURE;
+        }
+    }
+
+  /* Clean up and return. */
+  gal_data_free(labels);
+  gal_data_array_free(runs, NUMLABS+1, 1);
+  printf("Runs of %d labels in a %dx%d image are correct.\n", NUMLABS,
+         NUMROWS, NUMCOLS);
+  return EXIT_SUCCESS;
+}
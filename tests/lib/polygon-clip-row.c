@@ -0,0 +1,153 @@
+/*********************************************************************
+A test program for the overlap of a polygon with the pixels of a row
+('gal_polygon_clip_area_row').
+
+Original author:
+     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+Contributing author(s):
+Copyright (C) 2022 Free Software Foundation, Inc.
+
+Gnuastro is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+Gnuastro is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
+**********************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "gnuastro/polygon.h"
+
+
+/* Number of pixels in each row (and number of rows) that are checked. */
+#define NUMPIX 24
+
+/* Acceptable difference in the areas. */
+#define TOLERANCE 1e-9
+
+
+
+
+
+/* Put the 'n' vertices of a polygon (in counter-clockwise order) into
+   'v'. Its vertices are on a circle of radius 'r' centered on (cx, cy),
+   starting from angle 'a0'. When 'star' is non-zero, every second vertex
+   is on a circle of half that radius (so the polygon is concave). */
+static void
+make_polygon(double *v, size_t n, double cx, double cy, double r,
+             double a0, int star)
+{
+  size_t i;
+  double a, rr;
+
+  for(i=0;i<n;++i)
+    {
+      a=a0+2*M_PI*i/n;
+      rr = star && i%2 ? r/2 : r;
+      v[i*2  ] = cx + rr*cos(a);
+      v[i*2+1] = cy + rr*sin(a);
+    }
+}
+
+
+
+
+
+/* Compare the areas of every pixel with those found by clipping the
+   polygon with each pixel independently. */
+static int
+check_with_clip(double *v, size_t n)
+{
+  size_t x, y, nc;
+  double sq[8], o[2*(GAL_POLYGON_MAX_CORNERS+4)], areas[NUMPIX], a;
+
+  for(y=0;y<NUMPIX;++y)
+    {
+      gal_polygon_clip_area_row(v, n, 0.5f, y+0.5f, NUMPIX, areas);
+      for(x=0;x<NUMPIX;++x)
+        {
+          sq[0]=x+0.5f; sq[1]=y+0.5f;  sq[2]=x+1.5f; sq[3]=y+0.5f;
+          sq[4]=x+1.5f; sq[5]=y+1.5f;  sq[6]=x+0.5f; sq[7]=y+1.5f;
+          gal_polygon_clip(v, n, sq, 4, o, &nc);
+          a = nc ? gal_polygon_area(o, nc) : 0.0f;
+          if( fabs(a-areas[x])>TOLERANCE )
+            {
+              fprintf(stderr, "%zu vertices: pixel (%zu, %zu) has an "
+                      "area of %g, but clipping gives %g\n", n, x+1, y+1,
+                      areas[x], a);
+              return 0;
+            }
+        }
+    }
+  return 1;
+}
+
+
+
+
+
+/* The sum of the areas over all the pixels must be the area of the
+   polygon (that is fully within the checked pixels). */
+static int
+check_sum(double *v, size_t n)
+{
+  size_t x, y;
+  double sum=0.0f, areas[NUMPIX], a=gal_polygon_area(v, n);
+
+  for(y=0;y<NUMPIX;++y)
+    {
+      gal_polygon_clip_area_row(v, n, 0.5f, y+0.5f, NUMPIX, areas);
+      for(x=0;x<NUMPIX;++x) sum+=areas[x];
+    }
+  if( fabs(sum-a)>TOLERANCE*a )
+    {
+      fprintf(stderr, "%zu vertices: sum of pixel areas is %g, but the "
+              "polygon's area is %g\n", n, sum, a);
+      return 0;
+    }
+  return 1;
+}
+
+
+
+
+
+int
+main(void)
+{
+  size_t i, nsmall[]={3, 4, 12, 40};
+  size_t nlarge[]={GAL_POLYGON_MAX_CORNERS+1, 4*999+4};
+  double *v=malloc(2*nlarge[1]*sizeof *v);
+
+  /* Small convex polygons can also be clipped with 'gal_polygon_clip'. */
+  for(i=0;i<sizeof nsmall/sizeof *nsmall;++i)
+    {
+      make_polygon(v, nsmall[i], 11.3, 12.7, 7.9, 0.3*i, 0);
+      if( check_with_clip(v, nsmall[i])==0 ) return EXIT_FAILURE;
+      if( check_sum(v, nsmall[i])==0 ) return EXIT_FAILURE;
+    }
+
+  /* Polygons with more vertices than 'GAL_POLYGON_MAX_CORNERS' (for
+     example the output pixels of Warp with a large '--edgesampling') and
+     concave polygons (that need more space after clipping). */
+  for(i=0;i<sizeof nlarge/sizeof *nlarge;++i)
+    {
+      make_polygon(v, nlarge[i], 12.1, 11.6, 9.7, 0.1, 0);
+      if( check_sum(v, nlarge[i])==0 ) return EXIT_FAILURE;
+      make_polygon(v, nlarge[i], 12.1, 11.6, 9.7, 0.1, 1);
+      if( check_sum(v, nlarge[i])==0 ) return EXIT_FAILURE;
+    }
+
+  /* Clean up and return. */
+  free(v);
+  printf("Polygon areas over pixel rows are correct.\n");
+  return EXIT_SUCCESS;
+}
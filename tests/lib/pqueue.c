@@ -0,0 +1,141 @@
+/*********************************************************************
+A test program for the priority queue ('gal_pqueue_*' functions).
+
+Original author:
+     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+Contributing author(s):
+Copyright (C) 2022 Free Software Foundation, Inc.
+
+Gnuastro is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+Gnuastro is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
+**********************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "gnuastro/list.h"
+#include "gnuastro/blank.h"
+#include "gnuastro/pqueue.h"
+
+
+/* Number of values to add (there are many equal sorting values, to check
+   that ties are popped in the order they were added). */
+#define NUMVALUES 2000
+
+
+
+
+
+/* The sorting value of each added value. */
+static float
+sortvalue(size_t i)
+{
+  return (float)( (i * 2654435761u) % 97 );
+}
+
+
+
+
+
+/* Pop all the nodes and check that they come out sorted (by the
+   sorting value, then by the order they were added). */
+static int
+check_pop_all(gal_pqueue_t *pq, size_t num)
+{
+  float s, prevs=-INFINITY;
+  size_t i, v, prevv=GAL_BLANK_SIZE_T;
+
+  for(i=0;i<num;++i)
+    {
+      v=gal_pqueue_pop_smallest(pq, &s);
+      if( v==GAL_BLANK_SIZE_T || s!=sortvalue(v) || s<prevs
+          || (s==prevs && v<prevv) )
+        {
+          fprintf(stderr, "pop %zu: value %zu (%g) after %zu (%g)\n", i,
+                  v, s, prevv, prevs);
+          return 0;
+        }
+      prevs=s;
+      prevv=v;
+    }
+
+  /* The queue must be empty now. */
+  v=gal_pqueue_pop_smallest(pq, &s);
+  if( v!=GAL_BLANK_SIZE_T || !isnan(s) )
+    {
+      fprintf(stderr, "empty queue returned %zu (%g)\n", v, s);
+      return 0;
+    }
+  return 1;
+}
+
+
+
+
+
+int
+main(void)
+{
+  float s;
+  size_t i, v, n;
+  gal_list_sizet_t *list=NULL, *tmp;
+  gal_pqueue_t *pq=gal_pqueue_alloc(1);   /* To check the growth. */
+
+  /* Add all the values and pop them all. */
+  for(i=0;i<NUMVALUES;++i) gal_pqueue_add(pq, i, sortvalue(i));
+  if( check_pop_all(pq, NUMVALUES)==0 ) return EXIT_FAILURE;
+
+  /* Add values and pop some of them in between (as in the region
+     growing algorithms that use this queue): every popped value must
+     be the smallest of those remaining in the queue. */
+  gal_pqueue_reset(pq);
+  for(i=0;i<NUMVALUES;++i)
+    {
+      gal_pqueue_add(pq, i, sortvalue(i));
+      if(i%3==2)
+        {
+          v=gal_pqueue_pop_smallest(pq, &s);
+          for(n=0;n<pq->size;++n)
+            if( pq->nodes[n].s < s )
+              {
+                fprintf(stderr, "%zu (%g) popped before %zu (%g)\n", v, s,
+                        pq->nodes[n].v, pq->nodes[n].s);
+                return EXIT_FAILURE;
+              }
+        }
+    }
+  if( check_pop_all(pq, pq->size)==0 ) return EXIT_FAILURE;
+
+  /* Convert a queue to a list: the smallest must be at the top. */
+  gal_pqueue_reset(pq);
+  for(i=0;i<NUMVALUES;++i) gal_pqueue_add(pq, i, sortvalue(i));
+  gal_pqueue_to_sizet(pq, &list);
+  for(n=0, tmp=list; tmp!=NULL; tmp=tmp->next, ++n)
+    if( tmp->next && sortvalue(tmp->v) > sortvalue(tmp->next->v) )
+      {
+        fprintf(stderr, "list not sorted at element %zu\n", n);
+        return EXIT_FAILURE;
+      }
+  if( n!=NUMVALUES || pq->size!=0 )
+    {
+      fprintf(stderr, "%zu elements in the list, %zu left in the queue\n",
+              n, pq->size);
+      return EXIT_FAILURE;
+    }
+
+  /* Clean up and return. */
+  gal_list_sizet_free(list);
+  gal_pqueue_free(pq);
+  printf("Priority queue of %d values is correct.\n", NUMVALUES);
+  return EXIT_SUCCESS;
+}
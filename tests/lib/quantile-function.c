@@ -0,0 +1,185 @@
+/*********************************************************************
+A test program for the quantile function of a value when the input isn't
+sorted ('gal_statistics_quantile_function' with 'inplace=0').
+
+Original author:
+     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+Contributing author(s):
+Copyright (C) 2022 Free Software Foundation, Inc.
+
+Gnuastro is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+Gnuastro is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
+**********************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gnuastro/data.h"
+#include "gnuastro/blank.h"
+#include "gnuastro/pointer.h"
+#include "gnuastro/statistics.h"
+
+
+/* Size of the dataset. */
+#define NUMROWS 31
+#define NUMCOLS 47
+
+
+
+
+
+/* Make a 2D dataset of the given type. Integer types have many repeated
+   values ('range' possible values), floating point types don't. Some
+   elements are blank. */
+static gal_data_t *
+make_data(uint8_t type, size_t range)
+{
+  uint64_t r, seed=1;
+  size_t i, dsize[2]={NUMROWS, NUMCOLS};
+  gal_data_t *data=gal_data_alloc(NULL, type, 2, dsize, NULL, 0, -1, 1,
+                                  NULL, NULL, NULL);
+
+  for(i=0;i<data->size;++i)
+    {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      r = seed>>33;
+      switch(type)
+        {
+        case GAL_TYPE_UINT8:
+          ((uint8_t *)(data->array))[i] = r%range;                break;
+        case GAL_TYPE_INT32:
+          ((int32_t *)(data->array))[i] = (int32_t)(r%range) - 500; break;
+        case GAL_TYPE_FLOAT32:
+          ((float *)(data->array))[i] = r/2147483648.0f - 0.5f;   break;
+        }
+      if(i%19==0)
+        gal_blank_write(gal_pointer_increment(data->array, i, type), type);
+    }
+  return data;
+}
+
+
+
+
+
+/* Compare the quantile function of 'value' (an element of the same type
+   as 'in') without sorting (the new path) and with sorting a copy of the
+   input (the old path). */
+static int
+check_value(gal_data_t *in, gal_data_t *value, char *what)
+{
+  int out=1;
+  gal_data_t *copy=gal_data_copy(in);
+  gal_data_t *nosort=gal_statistics_quantile_function(in, value, 0);
+  gal_data_t *sorted=gal_statistics_quantile_function(copy, value, 1);
+  double n=*(double *)(nosort->array), s=*(double *)(sorted->array);
+
+  if( !( n==s || (isnan(n) && isnan(s)) ) )
+    {
+      fprintf(stderr, "%s (%s): quantile function is %g without sorting "
+              "and %g with sorting\n", gal_type_name(in->type, 1), what,
+              n, s);
+      out=0;
+    }
+  gal_data_free(copy);
+  gal_data_free(nosort);
+  gal_data_free(sorted);
+  return out;
+}
+
+
+
+
+
+/* Make a single-element dataset of the given type from a double. */
+static gal_data_t *
+make_value(uint8_t type, double v)
+{
+  size_t one=1;
+  gal_data_t *value=gal_data_alloc(NULL, GAL_TYPE_FLOAT64, 1, &one, NULL,
+                                   0, -1, 1, NULL, NULL, NULL);
+  *(double *)(value->array)=v;
+  return gal_data_copy_to_new_type_free(value, type);
+}
+
+
+
+
+
+/* Check the quantile function of the elements of the dataset (and the
+   given values that may not be in it), on the full dataset and on a tile
+   within it. */
+static int
+check_type(uint8_t type, size_t range, double *extra, size_t numextra)
+{
+  int out=1;
+  size_t i, one=1, tdsize[2]={NUMROWS-10, NUMCOLS-20};
+  gal_data_t *value, *tile, *data=make_data(type, range);
+
+  /* A tile in the middle of the dataset. */
+  tile=gal_data_alloc(gal_pointer_increment(data->array, 5*NUMCOLS+10,
+                                            type),
+                      type, 2, tdsize, NULL, 0, -1, 1, NULL, NULL, NULL);
+  tile->block=data;
+
+  /* Go over the values (some elements of the dataset and the extra
+     values). */
+  for(i=0; out && i<data->size/3+numextra; ++i)
+    {
+      /* Make the value. */
+      if(i<data->size/3)
+        {
+          value=gal_data_alloc(NULL, type, 1, &one, NULL, 0, -1, 1, NULL,
+                               NULL, NULL);
+          memcpy(value->array,
+                 gal_pointer_increment(data->array, i*3, type),
+                 gal_type_sizeof(type));
+        }
+      else
+        value=make_value(type, extra[i-data->size/3]);
+
+      /* Compare the two paths. */
+      if( check_value(data, value, "full dataset")==0
+          || check_value(tile, value, "tile")==0 )
+        out=0;
+      gal_data_free(value);
+    }
+
+  /* Clean up and return. */
+  tile->array=NULL;
+  tile->block=NULL;
+  gal_data_free(tile);
+  gal_data_free(data);
+  return out;
+}
+
+
+
+
+
+int
+main(void)
+{
+  double u8[]={0, 3, 7, 100}, i32[]={-600, -1, 0, 600};
+  double f32[]={-1, -0.123, 0.3, 1};
+
+  if( check_type(GAL_TYPE_UINT8,      7, u8,  4)==0
+      || check_type(GAL_TYPE_INT32,  1000, i32, 4)==0
+      || check_type(GAL_TYPE_FLOAT32,    0, f32, 4)==0 )
+    return EXIT_FAILURE;
+
+  printf("Quantile functions without sorting are the same as with "
+         "sorting.\n");
+  return EXIT_SUCCESS;
+}
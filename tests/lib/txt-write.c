@@ -0,0 +1,264 @@
+/*********************************************************************
+A test program for writing plain-text tables in parallel.
+
+Original author:
+     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+Contributing author(s):
+Copyright (C) 2022 Free Software Foundation, Inc.
+
+Gnuastro is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+Gnuastro is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Gnuastro. If not, see <http://www.gnu.org/licenses/>.
+**********************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gnuastro/txt.h"
+#include "gnuastro/list.h"
+#include "gnuastro/blank.h"
+#include "gnuastro/table.h"
+#include "gnuastro/pointer.h"
+
+
+/* Name of the outputs. */
+#define FILENAME1 "txt-write-1.txt"
+#define FILENAMEN "txt-write-n.txt"
+#define FILENAMEP "txt-write-printf.txt"
+
+/* Number of rows (the rows are written in chunks of 10000 rows, so with
+   one thread, there will be several batches of one chunk and with
+   multiple threads, there will be one batch of several chunks). */
+#define NUMROWS 30017
+
+/* Number of threads to write with. */
+#define NUMTHREADS 4
+
+
+
+
+
+/* Make the table: one column of each integer type (including the extreme
+   values of each type and blank elements), a floating point column, a
+   string column and a vector column (as the last column). */
+static gal_data_t *
+make_table(void)
+{
+  char **strarr;
+  size_t i, j, k;
+  uint64_t v, seed=1;
+  gal_data_t *col, *cols=NULL;
+  size_t dsize[2]={NUMROWS, 3};
+  uint8_t types[]={GAL_TYPE_UINT8,  GAL_TYPE_INT8,  GAL_TYPE_UINT16,
+                   GAL_TYPE_INT16,  GAL_TYPE_UINT32, GAL_TYPE_INT32,
+                   GAL_TYPE_UINT64, GAL_TYPE_INT64};
+  size_t numtypes=sizeof types/sizeof *types;
+
+  /* The vector column (it is the last column, so it is added first). */
+  gal_list_data_add_alloc(&cols, NULL, GAL_TYPE_INT32, 2, dsize, NULL, 0,
+                          -1, 1, "VECTOR", NULL, NULL);
+  for(i=0;i<cols->size;++i)
+    ((int32_t *)(cols->array))[i] = i%5 ? (int32_t)(i*7919)-100000 : 0;
+
+  /* The string column. */
+  gal_list_data_add_alloc(&cols, NULL, GAL_TYPE_STRING, 1, dsize, NULL, 0,
+                          -1, 1, "STRING", NULL, NULL);
+  strarr=cols->array;
+  for(i=0;i<NUMROWS;++i)
+    {
+      strarr[i]=gal_pointer_allocate(GAL_TYPE_UINT8, i%17+2, 0, __func__,
+                                     "strarr[i]");
+      if(i%23==0) strcpy(strarr[i], GAL_BLANK_STRING);
+      else
+        {
+          for(j=0;j<i%17+1;++j) strarr[i][j]='a'+(i+j)%26;
+          strarr[i][j]='\0';
+        }
+    }
+
+  /* The floating point column. */
+  gal_list_data_add_alloc(&cols, NULL, GAL_TYPE_FLOAT64, 1, dsize, NULL, 0,
+                          -1, 1, "FLOAT", NULL, NULL);
+  for(i=0;i<NUMROWS;++i)
+    ((double *)(cols->array))[i] = i%13 ? (double)i/7.0-1000.0 : NAN;
+
+  /* The integer columns. The first rows have the minimum, maximum and
+     zero (the maximum of unsigned types and the minimum of signed types
+     are the blank values). */
+  for(k=numtypes;k>0;--k)
+    {
+      gal_list_data_add_alloc(&cols, NULL, types[k-1], 1, dsize, NULL, 0,
+                              -1, 1, (char *)gal_type_name(types[k-1], 1),
+                              NULL, NULL);
+      col=cols;
+      for(i=0;i<NUMROWS;++i)
+        {
+          seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+          v = i%3 ? seed : seed>>(seed%64);
+          switch(col->type)
+            {
+            case GAL_TYPE_UINT8:  ((uint8_t  *)(col->array))[i]=v; break;
+            case GAL_TYPE_INT8:   ((int8_t   *)(col->array))[i]=v; break;
+            case GAL_TYPE_UINT16: ((uint16_t *)(col->array))[i]=v; break;
+            case GAL_TYPE_INT16:  ((int16_t  *)(col->array))[i]=v; break;
+            case GAL_TYPE_UINT32: ((uint32_t *)(col->array))[i]=v; break;
+            case GAL_TYPE_INT32:  ((int32_t  *)(col->array))[i]=v; break;
+            case GAL_TYPE_UINT64: ((uint64_t *)(col->array))[i]=v; break;
+            case GAL_TYPE_INT64:  ((int64_t  *)(col->array))[i]=v; break;
+            }
+        }
+      gal_type_min(col->type, col->array);
+      gal_type_max(col->type, gal_pointer_increment(col->array, 1,
+                                                    col->type));
+      memset(gal_pointer_increment(col->array, 2, col->type), 0,
+             gal_type_sizeof(col->type));
+    }
+
+  /* Return the table. */
+  return cols;
+}
+
+
+
+
+
+/* Return the contents of a file (or NULL). */
+static char *
+read_file(char *filename, size_t *size)
+{
+  FILE *fp;
+  long len;
+  char *out;
+
+  fp=fopen(filename, "rb");
+  if(fp==NULL) { fprintf(stderr, "%s: couldn't open\n", filename);
+                 return NULL; }
+  fseek(fp, 0, SEEK_END);
+  len=ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  out=gal_pointer_allocate(GAL_TYPE_UINT8, len+1, 0, __func__, "out");
+  *size=fread(out, 1, len, fp);
+  fclose(fp);
+  return out;
+}
+
+
+
+
+
+/* Compare the two files. */
+static int
+check_same_file(char *file1, char *file2)
+{
+  int out=1;
+  size_t size1=0, size2=0;
+  char *c1=read_file(file1, &size1), *c2=read_file(file2, &size2);
+
+  if(c1==NULL || c2==NULL || size1!=size2 || memcmp(c1, c2, size1))
+    {
+      fprintf(stderr, "%s and %s are different\n", file1, file2);
+      out=0;
+    }
+  free(c1);
+  free(c2);
+  return out;
+}
+
+
+
+
+
+/* Read the table back and compare the integer and string columns with
+   the written table (the floating point column is written with a fixed
+   precision, so it isn't compared). */
+static int
+check_read(gal_data_t *cols)
+{
+  int out=1;
+  size_t i;
+  gal_data_t *in, *tin, *tcol;
+
+  in=gal_table_read(FILENAME1, NULL, NULL, NULL, GAL_TABLE_SEARCH_NAME, 0,
+                    NUMTHREADS, -1, 1, NULL);
+  for(tin=in, tcol=cols; tin!=NULL && tcol!=NULL;
+      tin=tin->next, tcol=tcol->next)
+    {
+      if(tcol->type==GAL_TYPE_FLOAT64) continue;
+      if( tin->type!=tcol->type || tin->size!=tcol->size )
+        out=0;
+      else if(tcol->type==GAL_TYPE_STRING)
+        {
+          for(i=0;i<tcol->size;++i)
+            if( strcmp(((char **)(tin->array))[i],
+                       ((char **)(tcol->array))[i]) )
+              { out=0; break; }
+        }
+      else if( memcmp(tin->array, tcol->array,
+                      tcol->size*gal_type_sizeof(tcol->type)) )
+        out=0;
+      if(out==0)
+        {
+          fprintf(stderr, "%s: column '%s' isn't read correctly\n",
+                  FILENAME1, tcol->name);
+          break;
+        }
+    }
+  if(out && (tin!=NULL || tcol!=NULL))
+    {
+      fprintf(stderr, "%s: wrong number of columns\n", FILENAME1);
+      out=0;
+    }
+  gal_list_data_free(in);
+  return out;
+}
+
+
+
+
+
+int
+main(void)
+{
+  int out=1;
+  gal_data_t *col, *cols=make_table();
+
+  /* Write the table on one and multiple threads. */
+  remove(FILENAME1);
+  remove(FILENAMEN);
+  gal_txt_write(cols, NULL, NULL, FILENAME1, 0, 0, 1);
+  gal_txt_write(cols, NULL, NULL, FILENAMEN, 0, 0, NUMTHREADS);
+
+  /* With a precision of one digit, the integers are written the same way
+     (all the digits are always printed), but with 'printf' (like
+     before). */
+  for(col=cols;col!=NULL;col=col->next)
+    if(col->type!=GAL_TYPE_STRING && col->type!=GAL_TYPE_FLOAT64)
+      col->disp_precision=1;
+  remove(FILENAMEP);
+  gal_txt_write(cols, NULL, NULL, FILENAMEP, 0, 0, NUMTHREADS);
+
+  /* Compare the outputs. */
+  if( check_same_file(FILENAME1, FILENAMEN)==0
+      || check_same_file(FILENAME1, FILENAMEP)==0
+      || check_read(cols)==0 )
+    out=0;
+
+  /* Clean up and return. */
+  gal_list_data_free(cols);
+  if(out==0) return EXIT_FAILURE;
+  remove(FILENAME1);
+  remove(FILENAMEN);
+  remove(FILENAMEP);
+  printf("Plain-text tables are written correctly.\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,86 @@
+# Measure two extra bands in one call and compare them with separate
+# single-band calls.
+#
+# See the Tests subsection of the manual for a complete explanation
+# (in the Installing gnuastro section).
+#
+# Original author:
+#     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+# Contributing author(s):
+# Copyright (C) 2022 Free Software Foundation, Inc.
+#
+# Copying and distribution of this file, with or without modification,
+# are permitted in any medium without royalty provided the copyright
+# notice and this notice are preserved.  This file is offered as-is,
+# without any warranty.
+
+
+
+
+
+# Preliminaries
+# =============
+#
+# Set the variables (The executable is in the build tree). Do the
+# basic checks to see if the executable is made or if the defaults
+# file exists (basicchecks.sh is in the source tree).
+prog=mkcatalog
+execname=../bin/$prog/ast$prog
+table=../bin/table/asttable
+img=convolve_spatial_noised_detected_segmented.fits
+
+
+
+
+
+# Skip?
+# =====
+#
+# If the dependencies of the test don't exist, then skip it. There are two
+# types of dependencies:
+#
+#   - The executable was not made (for example due to a configure option),
+#
+#   - The input data was not made (for example the test that created the
+#     data file failed).
+if [ ! -f $execname ]; then echo "$execname not created."; exit 77; fi
+if [ ! -f $table    ]; then echo "$table not created.";    exit 77; fi
+if [ ! -f $img      ]; then echo "$img does not exist.";   exit 77; fi
+
+
+
+
+
+# Actual test script
+# ==================
+#
+# The two bands have different Sky values and Sky standard deviations
+# (one from a file, one a single value), so all the Sky-dependent
+# columns (including the random upper-limit magnitudes, with a fixed
+# seed) should be identical to the respective single-band calls.
+#
+# 'check_with_program' can be something like 'Valgrind' or an empty
+# string. Such programs will execute the command if present and help in
+# debugging when the developer doesn't have access to the user's system.
+export GSL_RNG_SEED=1
+cols="--ids --x --y --sum --sky --std --sn --magnitude --magnitudeerror \
+      --upperlimitmag --clumpscat --subtractsky --envseed --stdhdu=SKY_STD"
+$check_with_program $execname $img $cols --insky=0 --bandhdu=1        \
+                    --bandhdu=1 --bandsky=0.1 --bandsky=-0.2          \
+                    --bandstd=$img --bandstd=0.5 --bandstdhdu=SKY_STD \
+                    --bandstdhdu=SKY_STD --output=mkcatalog-bands.fits
+$execname $img $cols --insky=0.1 --output=mkcatalog-band1.fits
+$execname $img $cols --insky=-0.2 --instd=0.5 --output=mkcatalog-band2.fits
+
+# Compare the tables of each band.
+for b in 1 2; do
+    for cat in OBJECTS CLUMPS; do
+        $table mkcatalog-bands.fits --hdu=${cat}_BAND$b > bands-all.txt
+        $table mkcatalog-band$b.fits --hdu=$cat        > bands-one.txt
+        if ! cmp bands-all.txt bands-one.txt; then
+            echo "$cat catalog of band $b differs from single-band call."
+            exit 1
+        fi
+    done
+done
+rm bands-all.txt bands-one.txt
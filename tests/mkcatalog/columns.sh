@@ -0,0 +1,110 @@
+# Make sure that the columns of a catalog don't depend on the other columns
+# that are requested with them.
+#
+# See the Tests subsection of the manual for a complete explanation
+# (in the Installing gnuastro section).
+#
+# Original author:
+#     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+# Contributing author(s):
+# Copyright (C) 2022 Free Software Foundation, Inc.
+#
+# Copying and distribution of this file, with or without modification,
+# are permitted in any medium without royalty provided the copyright
+# notice and this notice are preserved.  This file is offered as-is,
+# without any warranty.
+
+
+
+
+
+# Preliminaries
+# =============
+#
+# Set the variables (The executable is in the build tree). Do the
+# basic checks to see if the executable is made or if the defaults
+# file exists (basicchecks.sh is in the source tree).
+prog=mkcatalog
+execname=../bin/$prog/ast$prog
+table=../bin/table/asttable
+img=convolve_spatial_noised_detected_segmented.fits
+
+
+
+
+
+# Skip?
+# =====
+#
+# If the dependencies of the test don't exist, then skip it. There are two
+# types of dependencies:
+#
+#   - The executable was not made (for example due to a configure option),
+#
+#   - The input data was not made (for example the test that created the
+#     data file failed).
+if [ ! -f $execname ]; then echo "$execname not created."; exit 77; fi
+if [ ! -f $table    ]; then echo "$table not created.";    exit 77; fi
+if [ ! -f $img      ]; then echo "$img does not exist.";   exit 77; fi
+
+
+
+
+
+# Actual test script
+# ==================
+#
+# Each group of columns below is measured in a separate call. During the
+# parsing of the pixels, only the necessary groups of measurements are
+# done, so each call only does some of them. The catalogs must be
+# identical to the same columns of a catalog with all the groups. The
+# last group only has columns of the objects catalog, so it is the last in
+# the catalog with all the groups (the positions of the clumps columns
+# don't change) and it isn't checked in the clumps catalog.
+#
+# 'check_with_program' can be something like 'Valgrind' or an empty
+# string. Such programs will execute the command if present and help in
+# debugging when the developer doesn't have access to the user's system.
+groups="--area,--areaxy
+        --geox,--geoy,--geosemimajor
+        --sum,--mean,--median
+        --x,--y,--semimajor,--weightarea
+        --sumerr,--sn,--magnitudeerr
+        --minx,--maxx,--miny,--maxy"
+objonly="--clumpssum,--clumpsx,--clumpsgeoy,--clumpsarea,--numclumps"
+all=$(echo $groups $objonly | tr , ' ')
+$check_with_program $execname $img --ids $all --clumpscat \
+                              --output=mkcatalog-columns-all.fits
+if [ $? != 0 ]; then exit 1; fi
+
+# Compare the catalog of each group with the same columns in the catalog
+# of all the groups ('ocol' and 'ccol' are the last column of the
+# previous group in the objects and clumps catalogs).
+ocol=1
+ccol=2
+for g in $groups $objonly; do
+    cols=$(echo $g | tr , ' ')
+    num=$(echo $cols | wc -w)
+    $execname $img --ids $cols --clumpscat \
+              --output=mkcatalog-columns-one.fits
+    if [ $? != 0 ]; then exit 1; fi
+
+    for cat in OBJECTS CLUMPS; do
+        if [ $cat = OBJECTS ]; then c=1;   last=$ocol
+        else
+            if [ $g = $objonly ]; then continue; fi
+            c=1,2; last=$ccol
+        fi
+        i=1
+        while [ $i -le $num ]; do c=$c,$((last+i)); i=$((i+1)); done
+        $table mkcatalog-columns-all.fits --hdu=$cat -c$c > columns-all.txt
+        $table mkcatalog-columns-one.fits --hdu=$cat      > columns-one.txt
+        if ! cmp columns-all.txt columns-one.txt; then
+            echo "$cat catalog of '$cols' differs from all columns."
+            exit 1
+        fi
+    done
+    ocol=$((ocol+num))
+    ccol=$((ccol+num))
+done
+rm columns-all.txt columns-one.txt
@@ -0,0 +1,106 @@
+# Make sure that the upper-limit measurements only use the footprint of
+# the object (and don't depend on the number of threads).
+#
+# See the Tests subsection of the manual for a complete explanation
+# (in the Installing gnuastro section).
+#
+# Original author:
+#     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+# Contributing author(s):
+# Copyright (C) 2022 Free Software Foundation, Inc.
+#
+# Copying and distribution of this file, with or without modification,
+# are permitted in any medium without royalty provided the copyright
+# notice and this notice are preserved.  This file is offered as-is,
+# without any warranty.
+
+
+
+
+
+# Preliminaries
+# =============
+#
+# Set the variables (The executable is in the build tree). Do the
+# basic checks to see if the executable is made or if the defaults
+# file exists (basicchecks.sh is in the source tree).
+prog=mkcatalog
+execname=../bin/$prog/ast$prog
+table=../bin/table/asttable
+arithmetic=../bin/arithmetic/astarithmetic
+img=convolve_spatial_noised_detected_segmented.fits
+
+
+
+
+
+# Skip?
+# =====
+#
+# If the dependencies of the test don't exist, then skip it. There are two
+# types of dependencies:
+#
+#   - The executable was not made (for example due to a configure option),
+#
+#   - The input data was not made (for example the test that created the
+#     data file failed).
+if [ ! -f $execname   ]; then echo "$execname not created.";   exit 77; fi
+if [ ! -f $table      ]; then echo "$table not created.";      exit 77; fi
+if [ ! -f $arithmetic ]; then echo "$arithmetic not created."; exit 77; fi
+if [ ! -f $img        ]; then echo "$img does not exist.";     exit 77; fi
+
+
+
+
+
+# Actual test script
+# ==================
+#
+# With a fixed seed, the upper-limit columns must not depend on the
+# number of threads.
+#
+# On an image where all the (non-blank) pixels have a value of 1, the sum
+# at every successful random position must be equal to the area of the
+# object: only the footprint of the object (not its full bounding box) is
+# placed over each random position. The random sums are printed with
+# '--checkuplim'.
+#
+# 'check_with_program' can be something like 'Valgrind' or an empty
+# string. Such programs will execute the command if present and help in
+# debugging when the developer doesn't have access to the user's system.
+export GSL_RNG_SEED=1
+cols="--ids --area --upperlimit --upperlimitmag --upperlimitonesigma \
+      --upperlimitsigma --upperlimitquantile --envseed --clumpscat"
+$check_with_program $execname $img $cols --numthreads=1 \
+                              --output=mkcatalog-uplim-1.fits
+if [ $? != 0 ]; then exit 1; fi
+$execname $img $cols --numthreads=4 --output=mkcatalog-uplim-4.fits
+if [ $? != 0 ]; then exit 1; fi
+for cat in OBJECTS CLUMPS; do
+    $table mkcatalog-uplim-1.fits --hdu=$cat > uplim-1.txt
+    $table mkcatalog-uplim-4.fits --hdu=$cat > uplim-4.txt
+    if ! cmp uplim-1.txt uplim-4.txt; then
+        echo "$cat upper-limit columns depend on the number of threads."
+        exit 1
+    fi
+done
+rm uplim-1.txt uplim-4.txt
+
+# Upper-limit sums on an image of ones.
+$arithmetic $img 0 x 1 + --hdu=1 --output=mkcatalog-uplim-ones.fits
+if [ $? != 0 ]; then exit 1; fi
+$execname $img --valuesfile=mkcatalog-uplim-ones.fits --valueshdu=1 \
+          --ids --area --upperlimit --envseed --checkuplim=1      \
+          --output=mkcatalog-uplim-area.fits
+if [ $? != 0 ]; then exit 1; fi
+area=$($table mkcatalog-uplim-area.fits --hdu=OBJECTS -cAREA --head=1)
+$table mkcatalog-uplim-area_upcheck.fits --noblank=RANDOM_SUM \
+       -cRANDOM_SUM > uplim-sums.txt
+if [ $(cat uplim-sums.txt | wc -l) = 0 ]; then
+    echo "No successful random position for object 1."; exit 1
+fi
+if ! awk -v a=$area '$1!=a {exit 1}' uplim-sums.txt; then
+    echo "A random sum of object 1 isn't equal to its area ($area)."
+    exit 1
+fi
+rm uplim-sums.txt
@@ -0,0 +1,83 @@
+# Merge many overlapping profiles in parallel ('--parallelmerge') and
+# compare the result with merging them on one thread.
+#
+# See the Tests subsection of the manual for a complete explanation
+# (in the Installing gnuastro section).
+#
+# Original author:
+#     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+# Contributing author(s):
+# Copyright (C) 2022 Free Software Foundation, Inc.
+#
+# Copying and distribution of this file, with or without modification,
+# are permitted in any medium without royalty provided the copyright
+# notice and this notice are preserved.  This file is offered as-is,
+# without any warranty.
+
+
+
+
+
+# Preliminaries
+# =============
+#
+# Set the variables (The executable is in the build tree). Do the
+# basic checks to see if the executable is made or if the defaults
+# file exists (basicchecks.sh is in the source tree).
+prog=mkprof
+execname=../bin/$prog/ast$prog
+fitsprog=../bin/fits/astfits
+cat=mkprof-parallelmerge.txt
+
+
+
+
+
+# Skip?
+# =====
+#
+# If the dependencies of the test don't exist, then skip it. There are two
+# types of dependencies:
+#
+#   - The executable was not made (for example due to a configure option).
+#
+#   - The Fits program (to compare the outputs) was not made.
+if [ ! -f $execname ]; then echo "$execname not created."; exit 77; fi
+if [ ! -f $fitsprog ]; then echo "$fitsprog not created."; exit 77; fi
+
+
+
+
+
+# Actual test script
+# ==================
+#
+# A catalog of many overlapping profiles is built first. With one thread,
+# the profiles are added to the merged image in the order of the
+# catalog, which is the same order that '--parallelmerge' uses on any
+# number of threads. So the two merged images must be identical (the
+# random number generator's seed is taken from the environment, so it is
+# the same in both runs).
+#
+# 'check_with_program' can be something like Valgrind or an empty
+# string. Such programs will execute the command if present and help in
+# debugging when the developer doesn't have access to the user's system.
+$AWK 'BEGIN{for(i=1;i<=60;++i)
+              printf "%d %d %d sersic %d 2.5 %d 0.7 %d 5\n", i,
+                     10+(i*37)%180, 10+(i*53)%180, 3+i%5, (i*17)%180,
+                     -10-i%5}' > $cat
+export GSL_RNG_SEED=1
+
+$check_with_program $execname $cat --mergedsize=200,200 --numthreads=1 \
+                    --envseed --output=mkprof-merge-serial.fits
+if [ $? != 0 ]; then exit 1; fi
+
+$check_with_program $execname $cat --mergedsize=200,200 --numthreads=4 \
+                    --envseed --parallelmerge --output=mkprof-merge-parallel.fits
+if [ $? != 0 ]; then exit 1; fi
+
+serial=$($fitsprog mkprof-merge-serial.fits -h1 --datasum)
+parallel=$($fitsprog mkprof-merge-parallel.fits -h1 --datasum)
+if [ x"$serial" != x"$parallel" ]; then
+    echo "Merged images differ (DATASUM: $serial, $parallel)"; exit 1
+fi
@@ -0,0 +1,88 @@
+# Build profiles with a quasi-random sequence ('--qrng') for the central
+# pixels and make sure the result doesn't depend on the number of threads
+# or the random number generator seed.
+#
+# See the Tests subsection of the manual for a complete explanation
+# (in the Installing gnuastro section).
+#
+# Original author:
+#     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+# Contributing author(s):
+# Copyright (C) 2022 Free Software Foundation, Inc.
+#
+# Copying and distribution of this file, with or without modification,
+# are permitted in any medium without royalty provided the copyright
+# notice and this notice are preserved.  This file is offered as-is,
+# without any warranty.
+
+
+
+
+
+# Preliminaries
+# =============
+#
+# Set the variables (The executable is in the build tree). Do the
+# basic checks to see if the executable is made or if the defaults
+# file exists (basicchecks.sh is in the source tree).
+prog=mkprof
+execname=../bin/$prog/ast$prog
+fitsprog=../bin/fits/astfits
+cat=mkprof-qrng.txt
+
+
+
+
+
+# Skip?
+# =====
+#
+# If the dependencies of the test don't exist, then skip it. There are two
+# types of dependencies:
+#
+#   - The executable was not made (for example due to a configure option).
+#
+#   - The Fits program (to compare the outputs) was not made.
+if [ ! -f $execname ]; then echo "$execname not created."; exit 77; fi
+if [ ! -f $fitsprog ]; then echo "$fitsprog not created."; exit 77; fi
+
+
+
+
+
+# Actual test script
+# ==================
+#
+# The seed of the random number generator is not fixed (it is based on
+# the time), so the two outputs will only be identical if the points in
+# the central pixels are taken from the quasi-random sequence. The
+# profiles don't overlap, so the order they are added into the merged
+# image doesn't matter. A wrong sequence name should be rejected.
+#
+# 'check_with_program' can be something like Valgrind or an empty
+# string. Such programs will execute the command if present and help in
+# debugging when the developer doesn't have access to the user's system.
+$AWK 'BEGIN{for(i=0;i<16;++i)
+              printf "%d %d %d sersic %d 2.5 %d 0.7 %d 5\n", i+1,
+                     25+(i%4)*50, 25+int(i/4)*50, 1+i%3, (i*17)%180,
+                     -10-i%5}' > $cat
+
+$check_with_program $execname $cat --mergedsize=200,200 --numthreads=1 \
+                    --qrng=sobol --numrandom=1000 --output=mkprof-qrng-1.fits
+if [ $? != 0 ]; then exit 1; fi
+
+$check_with_program $execname $cat --mergedsize=200,200 --numthreads=3 \
+                    --qrng=sobol --numrandom=1000 --output=mkprof-qrng-3.fits
+if [ $? != 0 ]; then exit 1; fi
+
+if $execname $cat --mergedsize=200,200 --qrng=notasequence \
+             --output=mkprof-qrng-bad.fits; then
+    echo "A wrong name to '--qrng' was not rejected."
+    exit 1
+fi
+
+one=$($fitsprog mkprof-qrng-1.fits -h1 --datasum)
+three=$($fitsprog mkprof-qrng-3.fits -h1 --datasum)
+if [ x"$one" != x"$three" ]; then
+    echo "Outputs differ (DATASUM: $one, $three)"; exit 1
+fi
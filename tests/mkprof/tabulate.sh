@@ -0,0 +1,82 @@
+# Build profiles from a table of their radial function ('--tabulate')
+# and compare them with the profiles that are built on every pixel.
+#
+# See the Tests subsection of the manual for a complete explanation
+# (in the Installing gnuastro section).
+#
+# Original author:
+#     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+# Contributing author(s):
+# Copyright (C) 2022 Free Software Foundation, Inc.
+#
+# Copying and distribution of this file, with or without modification,
+# are permitted in any medium without royalty provided the copyright
+# notice and this notice are preserved.  This file is offered as-is,
+# without any warranty.
+
+
+
+
+
+# Preliminaries
+# =============
+#
+# Set the variables (The executable is in the build tree). Do the
+# basic checks to see if the executable is made or if the defaults
+# file exists (basicchecks.sh is in the source tree).
+prog=mkprof
+execname=../bin/$prog/ast$prog
+arithprog=../bin/arithmetic/astarithmetic
+cat=mkprof-tabulate.txt
+
+
+
+
+
+# Skip?
+# =====
+#
+# If the dependencies of the test don't exist, then skip it. There are two
+# types of dependencies:
+#
+#   - The executable was not made (for example due to a configure option).
+#
+#   - The Arithmetic program (to compare the outputs) was not made.
+if [ ! -f $execname  ]; then echo "$execname not created.";  exit 77; fi
+if [ ! -f $arithprog ]; then echo "$arithprog not created."; exit 77; fi
+
+
+
+
+
+# Actual test script
+# ==================
+#
+# The first three profiles are large (have many more pixels than the
+# table), so they are built from the table. The last one is smaller than
+# the table, so it is built on each pixel in both runs. The maximum
+# difference between the two images (relative to the brightest pixel)
+# should be very small.
+#
+# 'check_with_program' can be something like Valgrind or an empty
+# string. Such programs will execute the command if present and help in
+# debugging when the developer doesn't have access to the user's system.
+echo "1 100 100 sersic   15 2.5  30 0.7 -10 5"  > $cat
+echo "2  60 140 moffat    8 4.0  60 0.8 -10 5" >> $cat
+echo "3 140  60 gaussian  8 0    10 0.9 -10 5" >> $cat
+echo "4 150 150 sersic    2 1.0  80 0.5 -10 5" >> $cat
+export GSL_RNG_SEED=1
+
+$check_with_program $execname $cat --mergedsize=200,200 --oversample=1 \
+                    --envseed --output=mkprof-untabulated.fits
+if [ $? != 0 ]; then exit 1; fi
+
+$check_with_program $execname $cat --mergedsize=200,200 --oversample=1 \
+                    --envseed --tabulate=2000 --output=mkprof-tabulated.fits
+if [ $? != 0 ]; then exit 1; fi
+
+reldiff=$($arithprog mkprof-tabulated.fits mkprof-untabulated.fits - abs \
+                     maxvalue mkprof-untabulated.fits maxvalue / -h1 -h1 -h1)
+if [ $? != 0 ]; then exit 1; fi
+echo "Maximum relative difference: $reldiff"
+echo $reldiff | $AWK '{exit ($1<1e-4 ? 0 : 1)}'
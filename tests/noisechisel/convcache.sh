@@ -0,0 +1,78 @@
+# Re-use the convolved image of an earlier NoiseChisel run with
+# '--convcache'.
+#
+# See the Tests subsection of the manual for a complete explanation
+# (in the Installing gnuastro section).
+#
+# Original author:
+#     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+# Contributing author(s):
+# Copyright (C) 2022 Free Software Foundation, Inc.
+#
+# Copying and distribution of this file, with or without modification,
+# are permitted in any medium without royalty provided the copyright
+# notice and this notice are preserved.  This file is offered as-is,
+# without any warranty.
+
+
+
+
+
+# Preliminaries
+# =============
+#
+# Set the variables (The executable is in the build tree). Do the
+# basic checks to see if the executable is made or if the defaults
+# file exists (basicchecks.sh is in the source tree).
+prog=noisechisel
+execname=../bin/$prog/ast$prog
+img=convolve_spatial_noised.fits
+cachedir=noisechisel-convcache
+
+
+
+
+
+# Skip?
+# =====
+#
+# If the dependencies of the test don't exist, then skip it. There are two
+# types of dependencies:
+#
+#   - The executable was not made (for example due to a configure option),
+#
+#   - The input data was not made (for example the test that created the
+#     data file failed).
+if [ ! -f $execname ]; then echo "$execname not created."; exit 77; fi
+if [ ! -f $img      ]; then echo "$img does not exist.";   exit 77; fi
+
+
+
+
+
+# Actual test script
+# ==================
+#
+# The first run convolves the input and puts the convolved image in the
+# cache directory. The second run must find it there (and not add a new
+# image to the cache).
+#
+# 'check_with_program' can be something like Valgrind or an empty
+# string. Such programs will execute the command if present and help in
+# debugging when the developer doesn't have access to the user's system.
+rm -rf $cachedir
+$check_with_program $execname $img --convcache=$cachedir \
+                              --output=noisechisel-convcache-1.fits
+if [ $? != 0 ]; then exit 1; fi
+if [ $(ls $cachedir | wc -l) != 1 ]; then
+    echo "$cachedir: convolved image not stored in the cache"; exit 1
+fi
+
+$check_with_program $execname $img --convcache=$cachedir \
+                              --output=noisechisel-convcache-2.fits \
+                              > noisechisel-convcache.txt
+if [ $? != 0 ]; then exit 1; fi
+if [ $(ls $cachedir | wc -l) != 1 ]; then
+    echo "$cachedir: a new convolved image was added"; exit 1
+fi
+grep "from cache" noisechisel-convcache.txt
@@ -0,0 +1,81 @@
+# Make sure that the erosion and opening on large tiles (with a halo) give
+# the same detections as the erosion and opening over the full image.
+#
+# See the Tests subsection of the manual for a complete explanation
+# (in the Installing gnuastro section).
+#
+# Original author:
+#     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+# Contributing author(s):
+# Copyright (C) 2022 Free Software Foundation, Inc.
+#
+# Copying and distribution of this file, with or without modification,
+# are permitted in any medium without royalty provided the copyright
+# notice and this notice are preserved.  This file is offered as-is,
+# without any warranty.
+
+
+
+
+
+# Preliminaries
+# =============
+#
+# Set the variables (The executable is in the build tree). Do the
+# basic checks to see if the executable is made or if the defaults
+# file exists (basicchecks.sh is in the source tree).
+prog=noisechisel
+execname=../bin/$prog/ast$prog
+convertt=../bin/convertt/astconvertt
+img=convolve_spatial_noised.fits
+
+
+
+
+
+# Skip?
+# =====
+#
+# If the dependencies of the test don't exist, then skip it. There are two
+# types of dependencies:
+#
+#   - The executable was not made (for example due to a configure option),
+#
+#   - The input data was not made (for example the test that created the
+#     data file failed).
+if [ ! -f $execname ]; then echo "$execname not created."; exit 77; fi
+if [ ! -f $convertt ]; then echo "$convertt not created."; exit 77; fi
+if [ ! -f $img      ]; then echo "$img does not exist.";   exit 77; fi
+
+
+
+
+
+# Actual test script
+# ==================
+#
+# The erosion and opening are done on large tiles when there is more than
+# one large tile and thread. When '--checkdetection' is called, they are
+# done over the full image (like before). All other steps are the same in
+# both runs, so the detections must be identical.
+#
+# 'check_with_program' can be something like Valgrind or an empty
+# string. Such programs will execute the command if present and help in
+# debugging when the developer doesn't have access to the user's system.
+opts="--largetilesize=40,40 --numthreads=4"
+$check_with_program $execname $img $opts \
+                              --output=noisechisel-tiles.fits
+if [ $? != 0 ]; then exit 1; fi
+
+$check_with_program $execname $img $opts --checkdetection \
+                              --continueaftercheck \
+                              --output=noisechisel-full.fits
+if [ $? != 0 ]; then exit 1; fi
+
+for name in tiles full; do
+    $convertt noisechisel-$name.fits --hdu=DETECTIONS \
+              --output=noisechisel-$name.txt
+    if [ $? != 0 ]; then exit 1; fi
+    grep -v '^#' noisechisel-$name.txt > noisechisel-$name-pix.txt
+done
+cmp noisechisel-tiles-pix.txt noisechisel-full-pix.txt
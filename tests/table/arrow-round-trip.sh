@@ -0,0 +1,115 @@
+# Write a table into an Arrow IPC file and read it back.
+#
+# See the Tests subsection of the manual for a complete explanation
+# (in the Installing gnuastro section).
+#
+# Original author:
+#     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+# Contributing author(s):
+# Copyright (C) 2022 Free Software Foundation, Inc.
+#
+# Copying and distribution of this file, with or without modification,
+# are permitted in any medium without royalty provided the copyright
+# notice and this notice are preserved.  This file is offered as-is,
+# without any warranty.
+
+
+
+
+
+# Preliminaries
+# =============
+#
+# Set the variables (The executable is in the build tree). Do the
+# basic checks to see if the executable is made or if the defaults
+# file exists (basicchecks.sh is in the source tree).
+prog=table
+execname=../bin/$prog/ast$prog
+table=$topsrc/tests/$prog/table.txt
+arrow=table-round-trip.arrow
+
+
+
+
+
+# Skip?
+# =====
+#
+# If the dependencies of the test don't exist, then skip it. There are two
+# types of dependencies:
+#
+#   - The executable was not made (for example due to a configure option),
+#
+#   - The input data was not made (for example the test that created the
+#     data file failed).
+if [ ! -f $execname ]; then echo "$execname not created."; exit 77; fi
+if [ ! -f $table    ]; then echo "$table does not exist."; exit 77; fi
+
+
+
+
+
+# Actual test script
+# ==================
+#
+# The input table has columns of all numeric types, a string column, a
+# vector column and blank values in all the columns. After writing it
+# into an Arrow file, reading that file (with any number of threads)
+# should give exactly the same values as reading the plain-text table.
+#
+# 'check_with_program' can be something like Valgrind or an empty
+# string. Such programs will execute the command if present and help in
+# debugging when the developer doesn't have access to the user's system.
+rm -f $arrow
+$check_with_program $execname $table --output=$arrow
+if [ $? != 0 ]; then exit 1; fi
+
+$execname $table > table-round-trip-txt.txt
+if [ $? != 0 ]; then exit 1; fi
+for nt in 1 4; do
+    $check_with_program $execname $arrow --numthreads=$nt \
+                        > table-round-trip-arrow.txt
+    if [ $? != 0 ]; then exit 1; fi
+    if ! cmp table-round-trip-txt.txt table-round-trip-arrow.txt; then
+        echo "Reading $arrow with $nt thread(s) doesn't give the values" \
+             "of $table"
+        exit 1
+    fi
+done
+
+# Files written by other software (when PyArrow is available): the
+# values are written in two record batches and have nulls, so they are
+# copied (not memory-mapped) when read. The expected values are also
+# written in a plain-text table (with Gnuastro's blank values).
+if python3 -c "import pyarrow" > /dev/null 2>&1; then
+    rm -f table-pyarrow.arrow
+    python3 -c "
+import pyarrow as pa
+import pyarrow.feather as feather
+t=pa.table({'A': pa.array([1, None, 3], pa.int32()),
+            'B': pa.array([1.5, 2.5, None], pa.float64()),
+            'S': pa.array(['a', None, 'ccc']),
+            'V': pa.array([[1, 2], [3, 4], [5, 6]],
+                          pa.list_(pa.float32(), 2))})
+feather.write_feather(t, 'table-pyarrow.arrow', chunksize=2,
+                      compression='uncompressed')"
+    if [ $? != 0 ]; then exit 1; fi
+    cat > table-pyarrow-expected.txt <<EOF
+# Column 1: A [,i32]
+# Column 2: B [,f64]
+# Column 3: S [,str3]
+# Column 4: V [,f32(2)]
+1           1.5 a   1 2
+-2147483648 2.5 n/a 3 4
+3           nan ccc 5 6
+EOF
+    $execname table-pyarrow-expected.txt > table-pyarrow-expected-out.txt
+    if [ $? != 0 ]; then exit 1; fi
+    $check_with_program $execname table-pyarrow.arrow \
+                        > table-pyarrow-out.txt
+    if [ $? != 0 ]; then exit 1; fi
+    if ! cmp table-pyarrow-expected-out.txt table-pyarrow-out.txt; then
+        echo "Values read from a PyArrow-written file are not correct"
+        exit 1
+    fi
+fi
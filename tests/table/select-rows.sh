@@ -0,0 +1,89 @@
+# Select rows of a FITS table while reading it and compare the result with
+# the same selection on a plain-text copy of the table (that is fully read
+# before the selection).
+#
+# See the Tests subsection of the manual for a complete explanation
+# (in the Installing gnuastro section).
+#
+# Original author:
+#     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+# Contributing author(s):
+# Copyright (C) 2022 Free Software Foundation, Inc.
+#
+# Copying and distribution of this file, with or without modification,
+# are permitted in any medium without royalty provided the copyright
+# notice and this notice are preserved.  This file is offered as-is,
+# without any warranty.
+
+
+
+
+
+# Preliminaries
+# =============
+#
+# Set the variables (The executable is in the build tree). Do the
+# basic checks to see if the executable is made or if the defaults
+# file exists (basicchecks.sh is in the source tree).
+prog=table
+execname=../bin/$prog/ast$prog
+txt=table-select-rows.txt
+fits=table-select-rows.fits
+
+
+
+
+
+# Skip?
+# =====
+#
+# If the dependencies of the test don't exist, then skip it. There is
+# only one type of dependency:
+#
+#   - The executable was not made (for example due to a configure option).
+if [ ! -f $execname ]; then echo "$execname not created."; exit 77; fi
+
+
+
+
+
+# Actual test script
+# ==================
+#
+# A table of 3000 rows is built (with blank values in one column) and
+# converted to FITS. When the input is a FITS table, Table selects the
+# rows while reading it (only reading the selected rows from the other
+# columns), or stops reading as soon as enough rows are found. This is
+# not done for plain-text tables, so the outputs of the two should be
+# identical.
+#
+# 'check_with_program' can be something like Valgrind or an empty
+# string. Such programs will execute the command if present and help in
+# debugging when the developer doesn't have access to the user's system.
+$AWK 'BEGIN{print "# Column 1: ID   [counter, i32] Row number";
+            print "# Column 2: X    [pix,     f64] Value";
+            print "# Column 3: NAME [,       str8] Name of the row";
+            for(i=1;i<=3000;++i)
+              printf "%d %s r%d\n", i,
+                     i%97 ? sprintf("%g", ((i*7919)%1000)/10) : "nan", i}' \
+     > $txt
+$check_with_program $execname $txt --output=$fits
+if [ $? != 0 ]; then exit 1; fi
+
+for opts in "--range=X,20:30" \
+            "--equal=ID,5,17,2999" \
+            "--noblank=X --head=50" \
+            "--range=X,90:99.9 --tail=5" \
+            "--head=7" \
+            "--tail=9" \
+            "--rowrange=100,130"; do
+    $check_with_program $execname $fits $opts > table-select-rows-fits.txt
+    if [ $? != 0 ]; then exit 1; fi
+    $execname $txt $opts > table-select-rows-txt.txt
+    if [ $? != 0 ]; then exit 1; fi
+    if ! cmp -s table-select-rows-fits.txt table-select-rows-txt.txt \
+         || [ ! -s table-select-rows-txt.txt ]; then
+        echo "Different (or empty) outputs with '$opts'."
+        exit 1
+    fi
+done
@@ -0,0 +1,85 @@
+# Read a plain-text table whose last line doesn't finish with a new-line
+# character, and whose size is a multiple of the memory page size.
+#
+# See the Tests subsection of the manual for a complete explanation
+# (in the Installing gnuastro section).
+#
+# Original author:
+#     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+# Contributing author(s):
+# Copyright (C) 2022 Free Software Foundation, Inc.
+#
+# Copying and distribution of this file, with or without modification,
+# are permitted in any medium without royalty provided the copyright
+# notice and this notice are preserved.  This file is offered as-is,
+# without any warranty.
+
+
+
+
+
+# Preliminaries
+# =============
+#
+# Set the variables (The executable is in the build tree). Do the
+# basic checks to see if the executable is made or if the defaults
+# file exists (basicchecks.sh is in the source tree).
+prog=table
+execname=../bin/$prog/ast$prog
+txt=table-unterminated.txt
+
+
+
+
+
+# Skip?
+# =====
+#
+# If the dependencies of the test don't exist, then skip it. There is
+# only one type of dependency:
+#
+#   - The executable was not made (for example due to a configure option).
+if [ ! -f $execname ]; then echo "$execname not created."; exit 77; fi
+
+
+
+
+
+# Actual test script
+# ==================
+#
+# Plain-text tables are memory-mapped for reading. The table built here
+# has exactly 65536 bytes (a multiple of the common page sizes), so there
+# is nothing mapped after its last character (that is not a new-line).
+# All the rows (including the last) should be read, with any number of
+# threads.
+#
+# 'check_with_program' can be something like Valgrind or an empty
+# string. Such programs will execute the command if present and help in
+# debugging when the developer doesn't have access to the user's system.
+$AWK 'BEGIN{size=65536; r=0;
+            h="# Column 1: A [counter, i32] First\n"\
+              "# Column 2: B [counter, i32] Second\n";
+            printf "%s", h; n=length(h);
+            while(size-n>40)
+              { l=sprintf("%d %d\n", r+1, 2*(r+1));
+                printf "%s", l; n+=length(l); ++r }
+            ++r; a=sprintf("%d", r); b=sprintf("%d", 2*r);
+            printf "%s", a;
+            for(i=n+length(a)+length(b); i<size; ++i) printf " ";
+            printf "%s", b}' > $txt
+nrows=$(grep -vc '^#' $txt)
+lastrow=$(tail -n1 $txt | $AWK '{print $1, $2}')
+
+for nt in 1 4; do
+    $check_with_program $execname $txt --numthreads=$nt \
+                        > table-unterminated-out.txt
+    if [ $? != 0 ]; then exit 1; fi
+    n=$(wc -l < table-unterminated-out.txt)
+    last=$(tail -n1 table-unterminated-out.txt | $AWK '{print $1, $2}')
+    if [ $n != $nrows ] || [ x"$last" != x"$lastrow" ]; then
+        echo "With $nt thread(s): $n rows (last: $last), expected $nrows" \
+             "rows (last: $lastrow)"
+        exit 1
+    fi
+done
@@ -0,0 +1,104 @@
+# Compare linear warps (where the pixel corners are shared between
+# neighboring output pixels) with their expected outputs.
+#
+# See the Tests subsection of the manual for a complete explanation
+# (in the Installing gnuastro section).
+#
+# Original author:
+#     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+# Contributing author(s):
+# Copyright (C) 2022 Free Software Foundation, Inc.
+#
+# Copying and distribution of this file, with or without modification,
+# are permitted in any medium without royalty provided the copyright
+# notice and this notice are preserved.  This file is offered as-is,
+# without any warranty.
+
+
+
+
+
+# Preliminaries
+# =============
+#
+# Set the variables (The executable is in the build tree). Do the
+# basic checks to see if the executable is made or if the defaults
+# file exists (basicchecks.sh is in the source tree).
+prog=warp
+img=convolve_spatial.fits
+execname=../bin/$prog/ast$prog
+convertt=../bin/convertt/astconvertt
+
+
+
+
+
+# Skip?
+# =====
+#
+# If the dependencies of the test don't exist, then skip it. There are two
+# types of dependencies:
+#
+#   - The executable was not made (for example due to a configure option),
+#
+#   - The input data was not made (for example the test that created the
+#     data file failed).
+if [ ! -f $execname ]; then echo "$execname not created."; exit 77; fi
+if [ ! -f $convertt ]; then echo "$convertt not created."; exit 77; fi
+if [ ! -f $img      ]; then echo "$img does not exist.";   exit 77; fi
+
+
+
+
+
+# Actual test script
+# ==================
+#
+# Each output pixel is calculated from the positions of its four corners
+# on the input, but the corners along each row are only transformed once
+# (and kept for the next row) within each strip of rows given to a
+# thread. So the outputs are checked in two ways:
+#
+#   - A general linear warp must be identical on one and multiple threads
+#     (which have strips with different starting rows).
+#
+#   - With a flip, the corners of every output pixel are exactly on the
+#     corners of one input pixel. So the output pixels must be identical
+#     to the input pixels (reversed along each row). The translation also
+#     has this property, but it adds blank rows and columns to the output.
+#
+# The pixel values are compared as plain text (made by ConvertType).
+#
+# 'check_with_program' can be something like Valgrind or an empty
+# string. Such programs will execute the command if present and help in
+# debugging when the developer doesn't have access to the user's system.
+pixels() {
+    $convertt $1 --output=$1.txt
+    if [ $? != 0 ]; then exit 1; fi
+    grep -v '^#' $1.txt | awk '{$1=$1; print}' > $2
+    rm $1.txt
+}
+
+# Same warp on one and multiple threads.
+for n in 1 7; do
+    $check_with_program $execname $img --rotate=20 --scale=0.7 \
+                                  --numthreads=$n \
+                                  --output=warp-linear-$n.fits
+    if [ $? != 0 ]; then exit 1; fi
+    pixels warp-linear-$n.fits warp-linear-$n.txt
+done
+if ! cmp warp-linear-1.txt warp-linear-7.txt; then
+    echo "Linear warp depends on the number of threads."; exit 1
+fi
+
+# Flip (on the same type as the input).
+pixels $img warp-linear-input.txt
+$check_with_program $execname $img --flip=0,1 --type=float32 \
+                              --output=warp-linear-flipped.fits
+if [ $? != 0 ]; then exit 1; fi
+pixels warp-linear-flipped.fits warp-linear-flipped.txt
+awk '{for(i=NF;i>1;--i) printf "%s ", $i; print $1}' \
+    warp-linear-input.txt > warp-linear-reversed.txt
+if ! cmp warp-linear-reversed.txt warp-linear-flipped.txt; then
+    echo "Flip doesn't give the reversed input pixels."; exit 1
+fi
@@ -0,0 +1,89 @@
+# Align an image to a new WCS by interpolating the vertex positions over
+# a grid ('--wcsinterp') and compare it with the full WCS conversion.
+#
+# See the Tests subsection of the manual for a complete explanation
+# (in the Installing gnuastro section).
+#
+# Original author:
+#     Mohammad Akhlaghi <mohammad@akhlaghi.org>
+# Contributing author(s):
+# Copyright (C) 2022 Free Software Foundation, Inc.
+#
+# Copying and distribution of this file, with or without modification,
+# are permitted in any medium without royalty provided the copyright
+# notice and this notice are preserved.  This file is offered as-is,
+# without any warranty.
+
+
+
+
+
+# Preliminaries
+# =============
+#
+# Set the variables (The executable is in the build tree). Do the
+# basic checks to see if the executable is made or if the defaults
+# file exists (basicchecks.sh is in the source tree).
+prog=warp
+img=convolve_spatial.fits
+execname=../bin/$prog/ast$prog
+arithprog=../bin/arithmetic/astarithmetic
+
+
+
+
+
+# Skip?
+# =====
+#
+# If the dependencies of the test don't exist, then skip it. There are
+# three types of dependencies:
+#
+#   - The executable was not made (for example due to a configure option),
+#
+#   - The Arithmetic program (to compare the outputs) was not made.
+#
+#   - The input data was not made (for example the test that created the
+#     data file failed).
+if [ ! -f $execname  ]; then echo "$execname not created.";  exit 77; fi
+if [ ! -f $arithprog ]; then echo "$arithprog not created."; exit 77; fi
+if [ ! -f $img       ]; then echo "$img does not exist.";    exit 77; fi
+
+
+
+
+
+# Actual test script
+# ==================
+#
+# The image is aligned to a different projection and pixel scale, once
+# with the full WCS conversion of every vertex and once with the
+# interpolation. The maximum difference between the two (relative to the
+# brightest pixel) should be very small. Since '--wcsinterp' is only
+# relevant for aligning with the WCS, it should be rejected with a linear
+# warp.
+#
+# 'check_with_program' can be something like Valgrind or an empty
+# string. Such programs will execute the command if present and help in
+# debugging when the developer doesn't have access to the user's system.
+$check_with_program $execname $img --ctype=RA---SIN,DEC--SIN \
+                              --cdelt=0.035/3600 --coveredfrac=0.5 \
+                              --output=wcsinterp-full.fits
+if [ $? != 0 ]; then exit 1; fi
+
+$check_with_program $execname $img --ctype=RA---SIN,DEC--SIN \
+                              --cdelt=0.035/3600 --coveredfrac=0.5 \
+                              --wcsinterp=1e-4 --output=wcsinterp.fits
+if [ $? != 0 ]; then exit 1; fi
+
+if $execname $img --scale=1/2 --wcsinterp=1e-4 \
+             --output=wcsinterp-scale.fits; then
+    echo "'--wcsinterp' was not rejected with a linear warp."
+    exit 1
+fi
+
+reldiff=$($arithprog wcsinterp.fits wcsinterp-full.fits - abs maxvalue \
+                     wcsinterp-full.fits maxvalue / -h1 -h1 -h1)
+if [ $? != 0 ]; then exit 1; fi
+echo "Maximum relative difference: $reldiff"
+echo $reldiff | $AWK '{exit ($1<1e-3 ? 0 : 1)}'